@@ -33,6 +33,17 @@ endif()
    
 ##############################################################################
 
+# GOMGEN_INCREMENTAL: generate one file per header instead of a single
+# gomgenerated_xxx.cpp per library (see gomgen macro below).
+option(GOMGEN_INCREMENTAL "Incremental GOM code generation" ON)
+
+# GOMGEN_STATIC_TABLES: generate the GOM meta-information as constant tables,
+# materialized the first time each class is used, instead of creating all the
+# meta-classes at startup. Use graphite profile_startup=true to compare.
+option(GOMGEN_STATIC_TABLES "Lazily materialized GOM meta-information" OFF)
+
+##############################################################################
+
 # Usage: gomgen(library_name)
 # Starts the gomgen code generator for the specified library (i.e. generates
 # GOM meta-information for all classes declared as 'gom_class').
@@ -49,6 +60,10 @@ macro(gomgen __lib)
   foreach(INCLUDE_DIR IN LISTS INCLUDE_PATH)
     list_append(GOMGEN_INCLUDES "-I${INCLUDE_DIR}")
   endforeach()
+  set(GOMGEN_OPTIONS "")
+  if(GOMGEN_STATIC_TABLES)
+    set(GOMGEN_OPTIONS "-static_tables")
+  endif()
 
 # We make the gom generated file dependent on all the header files
 # This adds too many dependencies (thus launches gomgen too often),
@@ -56,7 +71,15 @@ macro(gomgen __lib)
 # (I'd like to find a means of sending the output of gomgen -deps in there
 #  but it seems too complicated...)
 
-  file(GLOB_RECURSE GOMGEN_DEPS "*.h")
+# CONFIGURE_DEPENDS re-runs the glob at build time, so that a new header
+# is taken into account (and registered) without re-running cmake by hand.
+
+  if(CMAKE_VERSION VERSION_LESS 3.12)
+    set(GOMGEN_GLOB_OPTIONS "")
+  else()
+    set(GOMGEN_GLOB_OPTIONS CONFIGURE_DEPENDS)
+  endif()
+  file(GLOB_RECURSE GOMGEN_DEPS ${GOMGEN_GLOB_OPTIONS} "*.h")
 
 # The arguments passed to gomgen.  
 # Note: to save preprocessor output to gomgenerated.cpp.I,
@@ -65,16 +88,126 @@ macro(gomgen __lib)
   set(
     GOMGEN_ARGS -ogomgenerated_${__lib}.cpp  
     -i${CMAKE_CURRENT_SOURCE_DIR}/../${__lib} ${GOMGEN_INCLUDES}
+    ${GOMGEN_OPTIONS}
   )
-  
-  add_custom_command(
-    OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/gomgenerated_${__lib}.cpp
-    DEPENDS ${GOMGEN_EXE} ${GOMGEN_DEPS}
-    COMMAND ${GOMGEN_EXE}
-    ARGS    ${GOMGEN_ARGS}
+
+# The manifest lists the classes of the library, so that graphite can load
+# the module the first time one of them is used (lazy_modules=true). It is
+# written next to the libraries, where ModuleManager finds the modules. The
+# file extensions and languages registered by the module are cached per user
+# by ModuleManager when the module is loaded.
+
+  if(WIN32)
+    set(
+      GOMGEN_MANIFEST
+      ${GRAPHITE_SOURCE_DIR}/${RELATIVE_BIN_DIR}/${__lib}.gom_manifest
+    )
+  else()
+    set(
+      GOMGEN_MANIFEST
+      ${GRAPHITE_SOURCE_DIR}/${RELATIVE_LIB_DIR}/${__lib}.gom_manifest
+    )
+  endif()
+
+# Incremental mode: one generated file per header that declares gom classes,
+# each one depending on the headers it includes (depfile written by gomgen),
+# plus a registration file that calls all of them. Modifying a header only
+# regenerates and recompiles the code for this header. Needs DEPFILE support
+# in add_custom_command() (Ninja, or any generator with CMake >= 3.20).
+
+  if(
+     GOMGEN_INCREMENTAL AND
+     (CMAKE_GENERATOR MATCHES "Ninja" OR NOT CMAKE_VERSION VERSION_LESS 3.20)
   )
-  
-  set(SOURCES ${SOURCES} ${CMAKE_CURRENT_BINARY_DIR}/gomgenerated_${__lib}.cpp)
+    set(GOMGEN_OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/gomgenerated_${__lib})
+    file(MAKE_DIRECTORY ${GOMGEN_OUTPUT_DIR})
+    file(GLOB_RECURSE GOMGEN_SKIP ${GOMGEN_GLOB_OPTIONS} "gomgen.skip")
+    set(GOMGEN_HEADERS "")
+    foreach(HEADER IN LISTS GOMGEN_DEPS)
+      set(SKIP_HEADER FALSE)
+      foreach(SKIP IN LISTS GOMGEN_SKIP)
+        get_filename_component(SKIP_DIR ${SKIP} DIRECTORY)
+        string(FIND ${HEADER} "${SKIP_DIR}/" SKIP_POS)
+        if(SKIP_POS EQUAL 0)
+          set(SKIP_HEADER TRUE)
+        endif()
+      endforeach()
+      if(NOT SKIP_HEADER)
+        file(STRINGS ${HEADER} GOM_CLASSES REGEX "gom_class")
+        if(GOM_CLASSES)
+          list(APPEND GOMGEN_HEADERS ${HEADER})
+        endif()
+      endif()
+    endforeach()
+    # The .hash file written by gomgen is the stamp of each command (it is
+    # always rewritten), the generated code is a byproduct that keeps its
+    # timestamp when it did not change, so that it is not recompiled.
+    set(GOMGEN_HEADER_NAMES "")
+    foreach(HEADER IN LISTS GOMGEN_HEADERS)
+      file(
+        RELATIVE_PATH HEADER_NAME ${CMAKE_CURRENT_SOURCE_DIR}/../.. ${HEADER}
+      )
+      list(APPEND GOMGEN_HEADER_NAMES ${HEADER_NAME})
+      string(MAKE_C_IDENTIFIER ${HEADER_NAME} HEADER_ID)
+      set(HEADER_OUTPUT ${GOMGEN_OUTPUT_DIR}/${HEADER_ID}.cpp)
+      add_custom_command(
+        OUTPUT ${HEADER_OUTPUT}.hash
+        BYPRODUCTS ${HEADER_OUTPUT}
+        DEPENDS ${GOMGEN_EXE} ${HEADER}
+        DEPFILE ${HEADER_OUTPUT}.d
+        COMMAND ${GOMGEN_EXE}
+        ARGS -o${HEADER_OUTPUT} -header${HEADER_NAME} -MF${HEADER_OUTPUT}.d
+             -i${CMAKE_CURRENT_SOURCE_DIR}/../${__lib} ${GOMGEN_INCLUDES}
+             ${GOMGEN_OPTIONS}
+        WORKING_DIRECTORY ${GOMGEN_OUTPUT_DIR}
+      )
+      set(SOURCES ${SOURCES} ${HEADER_OUTPUT} ${HEADER_OUTPUT}.hash)
+    endforeach()
+    # The registration and the manifest use the headers selected above
+    # (gomgen does not search them again). The list is only rewritten
+    # when it changes.
+    set(GOMGEN_HEADER_LIST ${GOMGEN_OUTPUT_DIR}/gom_headers.txt)
+    string(
+      REPLACE ";" "\n" GOMGEN_HEADER_LIST_CONTENT "${GOMGEN_HEADER_NAMES}\n"
+    )
+    set(GOMGEN_HEADER_LIST_PREVIOUS_CONTENT "")
+    if(EXISTS ${GOMGEN_HEADER_LIST})
+      file(READ ${GOMGEN_HEADER_LIST} GOMGEN_HEADER_LIST_PREVIOUS_CONTENT)
+    endif()
+    if(
+      NOT GOMGEN_HEADER_LIST_PREVIOUS_CONTENT STREQUAL
+      GOMGEN_HEADER_LIST_CONTENT
+    )
+      file(WRITE ${GOMGEN_HEADER_LIST} "${GOMGEN_HEADER_LIST_CONTENT}")
+    endif()
+    add_custom_command(
+      OUTPUT ${GOMGEN_OUTPUT_DIR}/gom_package.cpp
+      DEPENDS ${GOMGEN_EXE} ${GOMGEN_HEADERS} ${GOMGEN_HEADER_LIST}
+      COMMAND ${GOMGEN_EXE}
+      ARGS -o${GOMGEN_OUTPUT_DIR}/gom_package.cpp -register
+           -header_list${GOMGEN_HEADER_LIST}
+           -i${CMAKE_CURRENT_SOURCE_DIR}/../${__lib} ${GOMGEN_INCLUDES}
+    )
+    set(SOURCES ${SOURCES} ${GOMGEN_OUTPUT_DIR}/gom_package.cpp)
+    add_custom_command(
+      OUTPUT ${GOMGEN_MANIFEST}
+      DEPENDS ${GOMGEN_EXE} ${GOMGEN_HEADERS} ${GOMGEN_HEADER_LIST}
+      COMMAND ${GOMGEN_EXE}
+      ARGS -manifest${GOMGEN_MANIFEST} -header_list${GOMGEN_HEADER_LIST}
+           -i${CMAKE_CURRENT_SOURCE_DIR}/../${__lib} ${GOMGEN_INCLUDES}
+      WORKING_DIRECTORY ${GOMGEN_OUTPUT_DIR}
+    )
+    set(SOURCES ${SOURCES} ${GOMGEN_MANIFEST})
+  else()
+    add_custom_command(
+      OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/gomgenerated_${__lib}.cpp
+      BYPRODUCTS ${GOMGEN_MANIFEST}
+      DEPENDS ${GOMGEN_EXE} ${GOMGEN_DEPS}
+      COMMAND ${GOMGEN_EXE}
+      ARGS    ${GOMGEN_ARGS} -manifest${GOMGEN_MANIFEST}
+    )
+    set(SOURCES ${SOURCES} ${CMAKE_CURRENT_BINARY_DIR}/gomgenerated_${__lib}.cpp)
+  endif()
 
   # Under Windows, I do not manage to update the dependencies for gomgenerated,
   # therefore I create an additional target to launch it manually (not
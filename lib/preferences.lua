@@ -233,6 +233,18 @@ preferences_window['draw_Appearance and rendering'] = function()
       if sel then
          gom.set_environment_value('gui:undo_depth',undo_depth)
       end
+      local undo_memory = tonumber(gom.get_environment_value('gui:undo_memory'))
+      if undo_memory == nil then
+         undo_memory = 1024
+      end
+      imgui.Text('Undo memory (Mb)')
+      imgui.SameLine()
+      imgui.PushItemWidth(-1)
+      sel,undo_memory = imgui.InputInt('##undo_memory',undo_memory)
+      imgui.PopItemWidth()
+      if sel then
+         gom.set_environment_value('gui:undo_memory',undo_memory)
+      end
    end
 
 end
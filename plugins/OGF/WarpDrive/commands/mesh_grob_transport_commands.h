@@ -313,6 +313,7 @@ namespace OGF {
 	 * \param[in] no_transport if true, just use non-optimized
 	 *  Voronoi diagram
          */
+	gom_attribute(long_running,"true")
 	void Euler2d(
             const MeshGrobName& omega,
             double tau=0.001,
@@ -354,6 +355,7 @@ namespace OGF {
 	 * \param[in] physical if true, then update using Newton second law,
 	 *  else update as in initial article.
          */
+        gom_attribute(long_running,"true")
         void Euler3d(
             const MeshGrobName& omega,
             double tau=0.001,
@@ -387,6 +389,7 @@ namespace OGF {
 	 * \param[in] physical if true, then update using Newton second law,
 	 *  else update as in initial article.
          */
+        gom_attribute(long_running,"true")
         void Euler_on_surface(
             const MeshGrobName& omega,
             double tau=0.001,
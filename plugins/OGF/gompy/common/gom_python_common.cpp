@@ -42,6 +42,7 @@
 #include <OGF/gompy/common/common.h>
 #include <OGF/gompy/interpreter/python_interpreter.h>
 #include <OGF/basic/modules/module.h>
+#include <OGF/basic/os/startup_profiler.h>
 #include <OGF/gom/types/gom_defs.h>
 #include <OGF/scene_graph/types/scene_graph_library.h>
 
@@ -64,6 +65,7 @@ namespace OGF {
 
         // Insert package initialization stuff here ...
 	if(!Py_IsInitialized()) {
+	    StartupTimer timer("interpreter", "Python");
 	    Interpreter* interp = new PythonInterpreter();
 	    Interpreter::initialize(interp, "Python", "py");
 	}
@@ -51,6 +51,8 @@ namespace OGF {
 
     PythonCallable::~PythonCallable() {
         geo_assert(impl_ != nullptr);
+	// Can be destroyed by C++ code that does not hold the GIL.
+	GILAcquirer GIL;
         Py_DECREF(impl_);
         impl_ = nullptr;
     }
@@ -60,6 +62,10 @@ namespace OGF {
 	//   (Python: inspect.signature(func).parameters)
         // TODO: check reference counting, is this correct ?
 
+	// Can be called from a command invoked by Python, that
+	// released the GIL (e.g., if connected to a signal).
+	GILAcquirer GIL;
+
 	bool FPE_bkp = Process::FPE_enabled();
 	Process::enable_FPE(false);
 
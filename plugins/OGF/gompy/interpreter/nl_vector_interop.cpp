@@ -35,8 +35,12 @@
  */
 
 #include <OGF/gompy/interpreter/nl_vector_interop.h>
+#include <OGF/gompy/interpreter/py_graphite_object.h>
 #include <OGF/gom/reflection/meta.h>
 
+#include <algorithm>
+#include <cstring>
+
 
 /************** NumPy Interop **********************************/
 
@@ -90,6 +94,75 @@ namespace {
 	delete array_interface;
     }
 
+    /**
+     * \brief Gets the struct module format of buffer elements.
+     * \param[in] type the MetaType of the elements
+     * \param[in] size the size of the elements, in bytes
+     * \return the format, or nullptr if the type is not supported
+     */
+    const char* buffer_format(MetaType* type, size_t size) {
+	if(type == ogf_meta<double>::type() && size == sizeof(double)) {
+	    return "d";
+	} else if(type == ogf_meta<float>::type() && size == sizeof(float)) {
+	    return "f";
+	} else if(
+	    (type == ogf_meta<int>::type() ||
+	     type == ogf_meta<signed_index_t>::type()) && size == 4
+	) {
+	    return "i";
+	} else if(
+	    (type == ogf_meta<unsigned int>::type() ||
+	     type == ogf_meta<index_t>::type()) && size == 4
+	) {
+	    return "I";
+	} else if(type == ogf_meta<bool>::type() && size == 1) {
+	    // Attribute<bool> is stored as bytes.
+	    return "?";
+	} else if(type == ogf_meta<Numeric::uint8>::type() && size == 1) {
+	    return "B";
+	}
+	return nullptr;
+    }
+
+    /**
+     * \brief What graphite_get_buffer() stores in a buffer view.
+     */
+    struct BufferViewInternal {
+	/**
+	 * \brief The shape (2 entries) then the strides (2 entries).
+	 */
+	Py_ssize_t shape_and_strides[4];
+
+	/**
+	 * \brief The checksum of the elements when the view was created,
+	 *  used to detect writes (writable views only).
+	 */
+	Numeric::uint64 checksum;
+    };
+
+    /**
+     * \brief Computes the checksum of a memory area.
+     * \param[in] data a pointer to the memory area
+     * \param[in] size the size of the memory area, in bytes
+     * \return a 64 bits checksum of the bytes
+     */
+    Numeric::uint64 buffer_checksum(const void* data, size_t size) {
+	const Numeric::uint8* bytes = static_cast<const Numeric::uint8*>(data);
+	Numeric::uint64 result = 14695981039346656037ull;
+	const size_t word_size = sizeof(Numeric::uint64);
+	size_t i = 0;
+	for(; i + word_size <= size; i += word_size) {
+	    Numeric::uint64 word;
+	    memcpy(&word, bytes + i, word_size);
+	    result = (result ^ word) * 1099511628211ull;
+	    result ^= (result >> 32);
+	}
+	for(; i < size; ++i) {
+	    result = (result ^ Numeric::uint64(bytes[i])) * 1099511628211ull;
+	}
+	return result;
+    }
+
 }
 
 
@@ -277,5 +350,97 @@ namespace OGF {
 		array_interface, nullptr, delete_array_interface
 	    );
 	}
+
+	/**********************************************************************/
+
+	int graphite_get_buffer(PyObject* self, Py_buffer* view, int flags) {
+	    view->obj = nullptr;
+	    Object* object = PyGraphite_GetObject(self);
+	    ElementBuffer buffer;
+	    if(object == nullptr || !object->get_element_buffer(buffer)) {
+		PyErr_SetString(
+		    PyExc_BufferError, "Graphite object has no element buffer"
+		);
+		return -1;
+	    }
+
+	    const char* format = buffer_format(
+		buffer.element_meta_type, buffer.element_size
+	    );
+	    if(format == nullptr) {
+		PyErr_SetString(
+		    PyExc_BufferError, "Unsupported element type"
+		);
+		return -1;
+	    }
+
+	    if((flags & PyBUF_WRITABLE) != 0 && buffer.read_only) {
+		PyErr_SetString(
+		    PyExc_BufferError, "Graphite object is read-only"
+		);
+		return -1;
+	    }
+
+	    index_t dim = std::max(buffer.dimension, index_t(1));
+	    index_t size = buffer.nb_elements / dim;
+
+	    // Shape and strides, stored in the view (freed by
+	    // graphite_release_buffer()).
+	    BufferViewInternal* internal = new BufferViewInternal;
+	    Py_ssize_t* shape_and_strides = internal->shape_and_strides;
+	    shape_and_strides[0] = Py_ssize_t(size);
+	    shape_and_strides[1] = Py_ssize_t(dim);
+	    shape_and_strides[2] = Py_ssize_t(dim * buffer.element_size);
+	    shape_and_strides[3] = Py_ssize_t(buffer.element_size);
+
+	    view->buf = buffer.data;
+	    view->obj = self;
+	    Py_INCREF(self);
+	    view->len = Py_ssize_t(buffer.nb_elements * buffer.element_size);
+	    view->itemsize = Py_ssize_t(buffer.element_size);
+	    view->readonly = buffer.read_only ? 1 : 0;
+	    view->format = (flags & PyBUF_FORMAT) != 0 ?
+		const_cast<char*>(format) : nullptr;
+	    view->ndim = (dim == 1) ? 1 : 2;
+	    view->shape = (flags & PyBUF_ND) != 0 ?
+		shape_and_strides : nullptr;
+	    // Strides are the last ndim entries of shape_and_strides.
+	    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ?
+		shape_and_strides + 4 - view->ndim : nullptr;
+	    view->suboffsets = nullptr;
+	    view->internal = internal;
+
+	    // Writes through the view are not seen by Graphite: the contents
+	    // are compared when the view is released.
+	    internal->checksum = view->readonly ? 0 : buffer_checksum(
+		view->buf, size_t(view->len)
+	    );
+
+	    // The NumPy array may outlive this call: the elements cannot be
+	    // reallocated until the view is released.
+	    object->pin_element_buffer();
+	    return 0;
+	}
+
+	void graphite_release_buffer(PyObject* self, Py_buffer* view) {
+	    Object* object = PyGraphite_GetObject(self);
+	    BufferViewInternal* internal =
+		static_cast<BufferViewInternal*>(view->internal);
+	    if(object != nullptr) {
+		// Writes to a writable view are not tracked individually:
+		// the object is notified once, when the view is released,
+		// if its contents changed.
+		if(
+		    !view->readonly &&
+		    buffer_checksum(view->buf, size_t(view->len)) !=
+		    internal->checksum
+		) {
+		    object->element_buffer_modified();
+		}
+		object->unpin_element_buffer();
+	    }
+	    delete internal;
+	    view->internal = nullptr;
+	}
     }
 }
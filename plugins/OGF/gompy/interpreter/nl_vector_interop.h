@@ -81,6 +81,33 @@ namespace OGF {
 	 * \details Used for NumPy interop.
 	 */
 	void delete_array_interface(PyObject* capsule);
+
+	/**
+	 * \brief Exports the elements of a Graphite object through the
+	 *  Python buffer protocol (PEP 3118).
+	 * \details Implements bf_getbuffer for Graphite objects that
+	 *  expose their elements with Object::get_element_buffer() (for
+	 *  instance NL::Vector views of mesh attributes, vertices or facet
+	 *  indices). The view refers directly to the memory of the elements
+	 *  (no copy). It keeps the Python wrapper, and thus the Graphite
+	 *  object, alive, and the elements are pinned until the view is
+	 *  released.
+	 * \param[in] self the Python wrapper of the Graphite object
+	 * \param[out] view the buffer view to be initialized
+	 * \param[in] flags the PyBUF_xxx flags of the request
+	 * \retval 0 on success
+	 * \retval -1 if the object cannot be exported, with a BufferError
+	 */
+	int graphite_get_buffer(PyObject* self, Py_buffer* view, int flags);
+
+	/**
+	 * \brief Releases a buffer view created by graphite_get_buffer().
+	 * \details If the view was writable and its contents changed,
+	 *  the Graphite object is notified that its elements were modified.
+	 * \param[in] self the Python wrapper of the Graphite object
+	 * \param[in] view the buffer view
+	 */
+	void graphite_release_buffer(PyObject* self, Py_buffer* view);
     }
 }
 
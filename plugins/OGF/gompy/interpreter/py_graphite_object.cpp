@@ -43,6 +43,10 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/types/callable.h>
 #include <OGF/scene_graph/NL/vector.h>
+#include <OGF/gom/reflection/dynamic_object.h>
+
+#include <map>
+#include <set>
 
 namespace OGF {
     namespace GOMPY {
@@ -66,7 +70,6 @@ namespace OGF {
 	    graphite_Object *self = (graphite_Object *)type->tp_alloc(type, 0);
 	    self->object = nullptr;
 	    self->managed = true;
-	    self->array_struct = nullptr;
 	    return (PyObject*)self;
 	}
 
@@ -78,8 +81,6 @@ namespace OGF {
 	    }
 	    self->object = nullptr;
 	    Py_TYPE(self)->tp_free((PyObject*)self);
-	    Py_XDECREF(self->array_struct);
-	    self->array_struct = nullptr;
 	}
 
 	PyObject* graphite_Object_richcompare(
@@ -147,7 +148,12 @@ namespace OGF {
 	    MetaProperty* mprop = object->meta_class()->find_property(name);
 	    if(mprop != nullptr) {
 		Any value;
-		if(!object->get_property(name, value)) {
+		bool ok = false;
+		{
+		    GOMLock lock;
+		    ok = object->get_property(name, value);
+		}
+		if(!ok) {
 		    Py_INCREF(Py_None);
 		    return Py_None;
 		}
@@ -176,7 +182,11 @@ namespace OGF {
 	    // Case 3: resolving symbol in Scope.
 	    Scope* scope = dynamic_cast<Scope*>(object);
 	    if(scope != nullptr && !graphite_Object_has_getter(name)) {
-		Any prop = scope->resolve(name);
+		Any prop;
+		{
+		    GOMLock lock;
+		    prop = scope->resolve(name);
+		}
 		PyObject* result = graphite_to_python(prop);
 		Py_INCREF(result);
 		return result;
@@ -213,7 +223,9 @@ namespace OGF {
 	    if(mprop != nullptr) {
 		mtype = mprop->type();
 	    }
-	    if(!object->set_property(name, python_to_graphite(value, mtype))) {
+	    Any gom_value = python_to_graphite(value, mtype);
+	    GOMLock lock;
+	    if(!object->set_property(name, gom_value)) {
 		return -1;
 	    }
 	    return 0;
@@ -233,6 +245,58 @@ namespace OGF {
 	    return string_to_python(out.str());
 	}
 
+	PyObject* graphite_invoke_method(
+	    Object* object, MetaMethod* method,
+	    PyObject* args, PyObject* keywords
+	) {
+	    ArgList gom_args;
+
+	    // Special case: method has a single argument of type ArgList
+	    // -> pack all the arguments in a ArgList
+	    if(
+		method->nb_args() == 1 &&
+		method->ith_arg_type(0) == ogf_meta<OGF::ArgList>::type()
+	    ) {
+		python_tographiteargs(args, keywords, gom_args);
+	    } else {
+		// Regular case: identify each individual argument according
+		// to method declaration. Add default values if need be.
+		python_tographiteargs(args, keywords, gom_args, method);
+	    }
+
+	    // Methods declared with gom_attribute(long_running,"true")
+	    // release the GIL, so that other Python threads can run
+	    // meanwhile (functions implemented in Python re-acquire it).
+	    // Short methods keep it: releasing it around each call would make
+	    // the threads hand it back and forth. In both cases, the GOM lock
+	    // serializes the accesses to Graphite objects.
+	    bool long_running =
+		method->has_custom_attribute("long_running") &&
+		method->custom_attribute_value("long_running") == "true";
+
+	    // Note: same as Request::invoke(), without creating a Request.
+	    Any result;
+	    bool ok = false;
+	    if(long_running) {
+		GILReleaser no_GIL;
+		std::lock_guard<std::recursive_mutex> lock(GOMLock::mutex());
+		ok = object->invoke_method(method->name(), gom_args, result);
+	    } else {
+		GOMLock lock;
+		ok = object->invoke_method(method->name(), gom_args, result);
+	    }
+	    if(!ok) {
+		Logger::err("GOMPy")
+		    << "error while invoking " +
+		    method->container_meta_class()->name() +
+		    "::" + method->name()
+		    << std::endl;
+		Py_INCREF(Py_None);
+		return Py_None;
+	    }
+	    return graphite_to_python(result, method->return_type());
+	}
+
 	PyObject* graphite_call(
 	    PyObject* self, PyObject* args, PyObject* keywords
 	) {
@@ -246,27 +310,26 @@ namespace OGF {
 		return Py_None;
 	    }
 
-
-	    Callable_var c;
-	    MetaClass*  mclass = dynamic_cast<MetaClass*>(object);
-	    MetaMethod* method = nullptr;
-
 	    // If target is a meta_class, try to invoke constructor
+	    MetaClass*  mclass = dynamic_cast<MetaClass*>(object);
 	    if(mclass != nullptr) {
-		method = mclass->meta_class()->find_method("create");
+		MetaMethod* method = mclass->meta_class()->find_method("create");
 		if(method != nullptr) {
-		    c = new Request(mclass, method);
-		}
-	    } else {
-		// Else, test if target is a callable
-		c = dynamic_cast<Callable*>(object);
-		Request* r = dynamic_cast<Request*>(c.get());
-		if(r != nullptr) {
-		    method = r->method();
+		    return graphite_invoke_method(mclass, method, args, keywords);
 		}
 	    }
 
-	    if(c.is_null()) {
+	    // If target is a request, invoke the method
+	    Request* r = dynamic_cast<Request*>(object);
+	    if(r != nullptr) {
+		return graphite_invoke_method(
+		    r->object(), r->method(), args, keywords
+		);
+	    }
+
+	    // Else, test if target is a callable
+	    Callable_var c = dynamic_cast<Callable*>(object);
+	    if(mclass != nullptr || c.is_null()) {
 		Logger::err("GOMPy")
 		    << "Error in graphite_call(): target is not a Callable"
 		    << std::endl;
@@ -274,39 +337,19 @@ namespace OGF {
 		return Py_None;
 	    }
 
-
 	    ArgList gom_args;
-
-	    // Special case: method has a single argument of type ArgList
-	    // -> pack all the arguments in a ArgList
-	    if(
-		method != nullptr &&
-		method->nb_args() == 1 &&
-		method->ith_arg_type(0) == ogf_meta<OGF::ArgList>::type()
-	    ) {
-		python_tographiteargs(args, keywords, gom_args);
-	    } else {
-		// Regular case: identify each individual argument according
-		// to method declaration. Add default values if need be.
-		python_tographiteargs(args, keywords, gom_args, method);
-	    }
-
+	    python_tographiteargs(args, keywords, gom_args);
 	    Any result;
-	    bool ok = c->invoke(gom_args, result);
+	    bool ok = false;
+	    {
+		GOMLock lock;
+		ok = c->invoke(gom_args, result);
+	    }
 	    if(!ok) {
-		if(method != nullptr) {
-		    Logger::err("GOMPy")
-			<< "error while invoking " +
-			method->container_meta_class()->name() +
-			"::" + method->name()
-			<< std::endl;
-		}
 		Py_INCREF(Py_None);
 		return Py_None;
 	    }
-	    return graphite_to_python(
-		result, method == nullptr ? nullptr : method->return_type()
-	    );
+	    return graphite_to_python(result);
 	}
 
 	Py_ssize_t graphite_array_len(PyObject* self) {
@@ -317,6 +360,7 @@ namespace OGF {
 				     << std::endl;
 		return 0;
 	    }
+	    GOMLock lock;
 	    return Py_ssize_t(object->get_nb_elements());
 	}
 
@@ -334,9 +378,12 @@ namespace OGF {
 				     << std::endl;
 		return graphite_to_python(result);
 	    }
-	    object->get_element(
-		index_t(PyLong_AsLong(index)), result
-	    );
+	    {
+		GOMLock lock;
+		object->get_element(
+		    index_t(PyLong_AsLong(index)), result
+		);
+	    }
 	    return graphite_to_python(result);
 	}
 
@@ -356,6 +403,7 @@ namespace OGF {
 		return -1;
 	    }
 	    Any value = python_to_graphite(value_in);
+	    GOMLock lock;
 	    object->set_element(
 		index_t(PyLong_AsLong(index)), value
 	    );
@@ -490,9 +538,16 @@ namespace OGF {
 	PyObject* graphite_get_array_struct(PyObject* self_in, void* closure) {
 	    geo_argused(closure);
 	    geo_debug_assert(PyGraphite_Check(self_in));
-	    graphite_Object* self = reinterpret_cast<graphite_Object*>(self_in);
-	    Py_XINCREF(self->array_struct);
-	    return self->array_struct;
+	    NL::Vector* vector = dynamic_cast<NL::Vector*>(
+		PyGraphite_GetObject(self_in)
+	    );
+	    if(vector == nullptr) {
+		PyErr_SetString(PyExc_AttributeError, "__array_struct__");
+		return nullptr;
+	    }
+	    // Created each time: the elements may have been reallocated
+	    // since last time.
+	    return create_array_interface(vector);
 	}
 
 	PyObject* graphite_get_doc(PyObject* self, void* closure) {
@@ -577,6 +632,15 @@ namespace OGF {
 	    graphite_array_ass_index /* mp_ass_subscript */
 	};
 
+	/**
+	 * \brief Buffer protocol of the Python wrapper around Graphite
+	 *  objects.
+	 */
+	PyBufferProcs graphite_BufferProcs = {
+	    graphite_get_buffer,     /* bf_getbuffer */
+	    graphite_release_buffer  /* bf_releasebuffer */
+	};
+
 	PyTypeObject graphite_ObjectType = {
 	    PyVarObject_HEAD_INIT(nullptr, 0)
 	    "graphite.Object",        // tp_name
@@ -587,10 +651,12 @@ namespace OGF {
 	void init_graphite_ObjectType() {
 	    graphite_ObjectType.tp_dealloc     = graphite_Object_dealloc;
 	    graphite_ObjectType.tp_as_mapping  = &graphite_MappingMethods;
+	    graphite_ObjectType.tp_as_buffer   = &graphite_BufferProcs;
 	    graphite_ObjectType.tp_str         = graphite_str;
 	    graphite_ObjectType.tp_getattro    = graphite_Object_getattro;
 	    graphite_ObjectType.tp_setattro    = graphite_Object_setattro;
-	    graphite_ObjectType.tp_flags       = Py_TPFLAGS_DEFAULT;
+	    graphite_ObjectType.tp_flags       = Py_TPFLAGS_DEFAULT |
+		                                 Py_TPFLAGS_BASETYPE;
 	    graphite_ObjectType.tp_methods     = graphite_Object_methods;
 	    graphite_ObjectType.tp_getset      = graphite_Object_getsets;
 	    graphite_ObjectType.tp_new         = graphite_Object_new;
@@ -598,6 +664,263 @@ namespace OGF {
 	    graphite_ObjectType.tp_hash        = graphite_Object_hash;
 	}
 
+	/************** Python types of Graphite classes *********************/
+
+	/**
+	 * \brief A Python descriptor for a Graphite method.
+	 * \details Stored in the Python type of a Graphite class. Since it
+	 *  is flagged as a method descriptor, object.method(args) directly
+	 *  calls it with the object as first argument, without creating a
+	 *  Request. Obtaining object.method without calling it still creates
+	 *  a Request.
+	 */
+	struct graphite_Method {
+	    PyObject_HEAD
+
+	    /** \brief The Graphite method. */
+	    MetaMethod* method;
+	};
+
+	PyObject* graphite_Method_descr_get(
+	    PyObject* self, PyObject* obj, PyObject* type
+	) {
+	    geo_argused(type);
+	    if(obj == nullptr || obj == Py_None) {
+		Py_INCREF(self);
+		return self;
+	    }
+	    MetaMethod* method = reinterpret_cast<graphite_Method*>(self)->method;
+	    Object* object = PyGraphite_GetObject(obj);
+	    // If object is an interpreter, do not do reference counting,
+	    // else this creates circular references, preventing objects from
+	    // being deallocated.
+	    bool managed = (dynamic_cast<Interpreter*>(object) == nullptr);
+	    return PyGraphiteObject_New(new Request(object, method, managed));
+	}
+
+	PyObject* graphite_Method_call(
+	    PyObject* self, PyObject* args, PyObject* keywords
+	) {
+	    MetaMethod* method = reinterpret_cast<graphite_Method*>(self)->method;
+	    Py_ssize_t nb_args = PyTuple_Size(args);
+	    if(
+		nb_args < 1 ||
+		!PyGraphiteObject_Check(PyTuple_GetItem(args, 0))
+	    ) {
+		PyErr_SetString(
+		    PyExc_TypeError,
+		    ("Graphite method " + method->name() +
+		     "() called without object").c_str()
+		);
+		return nullptr;
+	    }
+	    Object* object = PyGraphite_GetObject(PyTuple_GetItem(args, 0));
+	    if(object == nullptr) {
+		Logger::err("GOMPy")
+		    << "Graphite request: missing object" << std::endl;
+		Py_INCREF(Py_None);
+		return Py_None;
+	    }
+	    PyObject* method_args = PyTuple_GetSlice(args, 1, nb_args);
+	    PyObject* result = graphite_invoke_method(
+		object, method, method_args, keywords
+	    );
+	    Py_DECREF(method_args);
+	    return result;
+	}
+
+	PyObject* graphite_Method_repr(PyObject* self) {
+	    MetaMethod* method = reinterpret_cast<graphite_Method*>(self)->method;
+	    return string_to_python(
+		"<GOM method " + method->container_meta_class()->name() +
+		"::" + method->name() + ">"
+	    );
+	}
+
+	void graphite_Method_dealloc(PyObject* self) {
+	    Py_TYPE(self)->tp_free(self);
+	}
+
+	PyTypeObject graphite_MethodType = {
+	    PyVarObject_HEAD_INIT(nullptr, 0)
+	    "graphite.Method",        // tp_name
+	    sizeof(graphite_Method)   // tp_basicsize
+	    // The rest is initialized in init_graphite_MethodType()
+	};
+
+	void init_graphite_MethodType() {
+	    graphite_MethodType.tp_dealloc    = graphite_Method_dealloc;
+	    graphite_MethodType.tp_call       = graphite_Method_call;
+	    graphite_MethodType.tp_repr       = graphite_Method_repr;
+	    graphite_MethodType.tp_descr_get  = graphite_Method_descr_get;
+	    graphite_MethodType.tp_flags      = Py_TPFLAGS_DEFAULT;
+#ifdef Py_TPFLAGS_METHOD_DESCRIPTOR
+	    graphite_MethodType.tp_flags     |= Py_TPFLAGS_METHOD_DESCRIPTOR;
+#endif
+	}
+
+	/**
+	 * \brief Gets a Graphite property.
+	 * \details Used as the getter of the properties stored in the
+	 *  Python type of a Graphite class.
+	 * \param[in] self the Python wrapper
+	 * \param[in] closure a pointer to the MetaProperty
+	 */
+	PyObject* graphite_get_property(PyObject* self, void* closure) {
+	    MetaProperty* mprop = static_cast<MetaProperty*>(closure);
+	    Object* object = PyGraphite_GetObject(self);
+	    Any value;
+	    bool ok = false;
+	    if(object != nullptr) {
+		GOMLock lock;
+		ok = mprop->get_value(object, value);
+	    }
+	    if(!ok) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	    }
+	    return graphite_to_python(value, mprop->type());
+	}
+
+	/**
+	 * \brief The Python type created for a Graphite class.
+	 * \details The getset table is referenced by the descriptors of
+	 *  the type, it needs to stay alive as long as the type.
+	 */
+	struct GraphiteClassType {
+	    MetaClass_var meta_class;
+	    std::string name;
+	    std::vector<PyGetSetDef> getsets;
+	    PyTypeObject* type;
+	};
+
+	static std::map<MetaClass*, GraphiteClassType*> graphite_class_types_;
+
+	void graphite_class_type_dealloc(PyObject* self) {
+	    PyTypeObject* type = Py_TYPE(self);
+	    graphite_Object_dealloc(self);
+	    // Instances of heap types hold a reference to their type.
+	    Py_DECREF(type);
+	}
+
+	/**
+	 * \brief Gets the Python type for the objects of a Graphite class.
+	 * \details The type is created the first time. Its dictionary has
+	 *  a getter for each property and a graphite_Method for each method,
+	 *  so that attribute lookup is done by Python (the hash of the
+	 *  interned name is cached) instead of by a string lookup in the
+	 *  MetaClass. Dynamic classes, that can be modified, use the generic
+	 *  graphite_ObjectType.
+	 * \param[in] mclass the MetaClass
+	 * \return a pointer to the Python type
+	 */
+	PyTypeObject* graphite_class_type(MetaClass* mclass) {
+	    auto it = graphite_class_types_.find(mclass);
+	    if(it != graphite_class_types_.end()) {
+		return it->second->type;
+	    }
+
+	    if(dynamic_cast<DynamicMetaClass*>(mclass) != nullptr) {
+		return &graphite_ObjectType;
+	    }
+
+	    GraphiteClassType* entry = new GraphiteClassType;
+	    entry->meta_class = mclass;
+	    entry->name = "graphite." + mclass->name();
+	    entry->type = nullptr;
+
+	    // Resolve each member name the same way as
+	    // graphite_Object_getattro(): properties first, then methods.
+	    std::vector<MetaMember*> members;
+	    mclass->get_members(members);
+	    std::set<std::string> names;
+	    std::vector<MetaMethod*> methods;
+	    for(MetaMember* member : members) {
+		if(!names.insert(member->name()).second) {
+		    continue;
+		}
+		MetaProperty* mprop = mclass->find_property(member->name());
+		if(mprop != nullptr) {
+		    PyGetSetDef getset;
+		    getset.name = mprop->name().c_str();
+		    getset.get = graphite_get_property;
+		    getset.set = nullptr;
+		    getset.doc = nullptr;
+		    getset.closure = mprop;
+		    entry->getsets.push_back(getset);
+		    continue;
+		}
+		MetaMethod* mmethod = mclass->find_method(member->name());
+		if(
+		    mmethod != nullptr &&
+		    dynamic_cast<MetaConstructor*>(mmethod) == nullptr
+		) {
+		    methods.push_back(mmethod);
+		}
+	    }
+
+	    // Else PyType_FromSpec() sets __doc__ to None.
+	    if(names.find("__doc__") == names.end()) {
+		PyGetSetDef doc;
+		doc.name = "__doc__";
+		doc.get = graphite_get_doc;
+		doc.set = nullptr;
+		doc.doc = nullptr;
+		doc.closure = nullptr;
+		entry->getsets.push_back(doc);
+	    }
+	    entry->getsets.push_back(PyGetSetDef{});
+
+	    PyType_Slot slots[] = {
+		{Py_tp_getattro, reinterpret_cast<void*>(PyObject_GenericGetAttr)},
+		{Py_tp_dealloc, reinterpret_cast<void*>(graphite_class_type_dealloc)},
+		{Py_tp_getset, entry->getsets.data()},
+		{0, nullptr}
+	    };
+	    PyType_Spec spec;
+	    spec.name = entry->name.c_str();
+	    spec.basicsize = 0; // same as graphite_Object
+	    spec.itemsize = 0;
+	    spec.flags = Py_TPFLAGS_DEFAULT;
+	    spec.slots = slots;
+
+	    PyObject* type = PyType_FromSpecWithBases(
+		&spec, reinterpret_cast<PyObject*>(&graphite_ObjectType)
+	    );
+	    if(type == nullptr) {
+		PyErr_Clear();
+		Logger::warn("GOMPy")
+		    << "Could not create Python type for "
+		    << mclass->name() << std::endl;
+		delete entry;
+		return &graphite_ObjectType;
+	    }
+
+	    for(MetaMethod* mmethod : methods) {
+		graphite_Method* descr = PyObject_New(
+		    graphite_Method, &graphite_MethodType
+		);
+		descr->method = mmethod;
+		PyObject_SetAttrString(
+		    type, mmethod->name().c_str(),
+		    reinterpret_cast<PyObject*>(descr)
+		);
+		Py_DECREF(descr);
+	    }
+
+	    entry->type = reinterpret_cast<PyTypeObject*>(type);
+	    graphite_class_types_[mclass] = entry;
+	    return entry->type;
+	}
+
+	void clear_graphite_ObjectTypes() {
+	    // Called after Py_Finalize(): the Python types no longer exist.
+	    for(auto& it : graphite_class_types_) {
+		delete it.second;
+	    }
+	    graphite_class_types_.clear();
+	}
+
 	/***************************************************************/
 
 	PyObject* PyGraphiteObject_New(Object* object, bool managed) {
@@ -610,6 +933,10 @@ namespace OGF {
 		is_meta_class = true;
 	    } else if(dynamic_cast<Callable*>(object) != nullptr) {
 		type = &graphite_CallableType;
+	    } else if(object != nullptr && dynamic_cast<Scope*>(object) == nullptr) {
+		// Scopes resolve names dynamically, they use the generic
+		// graphite_Object_getattro().
+		type = graphite_class_type(object->meta_class());
 	    } else {
 		type = &graphite_ObjectType;
 	    }
@@ -633,16 +960,6 @@ namespace OGF {
 		    Counted::ref(impl->object);
 		}
 
-		// If object is a vector, create information for interop
-		// with numpy.
-		NL::Vector* object_as_vector = dynamic_cast<NL::Vector*>(object);
-		if(object_as_vector != nullptr) {
-		    PyObject* array_interface =
-			create_array_interface(object_as_vector);
-		    Py_INCREF(array_interface);
-		    impl->array_struct = array_interface;
-		}
-
 		impl->magic = graphite_Object_MAGIC;
 	    }
 
@@ -85,8 +85,8 @@ namespace OGF {
 	 *  false otherwise. Reference counting is disabled for the interpreter
 	 *  itself, else it creates a circular reference.
 	 * \details Returns an object, a callable or a meta-class depending on
-	 *  \p object type. If \p object is an NL::Vector, creates also the
-	 *  array interface for numpy interop.
+	 *  \p object type. Objects that expose their elements (for instance
+	 *  NL::Vector) support the buffer protocol for numpy interop.
 	 */
 	PyObject* PyGraphiteObject_New(Object* object, bool managed=true);
 
@@ -104,9 +104,6 @@ namespace OGF {
 	    /** \brief true if reference-counted, false otherwise. */
 	    bool managed;
 
-	    /** \brief Pointer to array interface or nullptr. */
-	    PyObject* array_struct;
-
 	    Numeric::uint32 magic;
 	};
 
@@ -120,6 +117,23 @@ namespace OGF {
 	extern PyTypeObject graphite_ObjectType;
 	extern PyGetSetDef graphite_Object_getsets[];
 
+	/**
+	 * \brief Function to initialize graphite_MethodType
+	 */
+	void init_graphite_MethodType();
+
+	/**
+	 * \brief The type of the descriptors of Graphite methods, stored
+	 *  in the Python types created for Graphite classes.
+	 */
+	extern PyTypeObject graphite_MethodType;
+
+	/**
+	 * \brief Forgets the Python types created for Graphite classes.
+	 * \details To be called after Py_Finalize().
+	 */
+	void clear_graphite_ObjectTypes();
+
 	PyObject* graphite_get_doc(PyObject* self, void* closure);
 	PyObject* graphite_Object_new(
 	    PyTypeObject *type, PyObject *args, PyObject *kwds
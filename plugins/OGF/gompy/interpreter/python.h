@@ -66,4 +66,123 @@
 #  include <Python.h>
 #endif
 
+#include <mutex>
+
+namespace OGF {
+    namespace GOMPY {
+
+	/**
+	 * \brief Releases the Python global interpreter lock (GIL) in
+	 *  the current scope.
+	 * \details Used around long computations in C++ that do not access
+	 *  Python objects, so that other Python threads can run in the
+	 *  meanwhile. The GIL is re-acquired when this object is destroyed.
+	 * \pre the current thread holds the GIL.
+	 */
+	class GILReleaser {
+	public:
+	    /**
+	     * \brief GILReleaser constructor.
+	     * \details Releases the GIL.
+	     */
+	    GILReleaser() : state_(PyEval_SaveThread()) {
+	    }
+
+	    /**
+	     * \brief GILReleaser destructor.
+	     * \details Re-acquires the GIL.
+	     */
+	    ~GILReleaser() {
+		PyEval_RestoreThread(state_);
+	    }
+
+	    GILReleaser(const GILReleaser&) = delete;
+	    GILReleaser& operator=(const GILReleaser&) = delete;
+
+	private:
+	    PyThreadState* state_;
+	};
+
+	/**
+	 * \brief Acquires the Python global interpreter lock (GIL) in
+	 *  the current scope.
+	 * \details Needs to be used by all the functions that call Python
+	 *  from C++ code that may run without the GIL, for instance a
+	 *  Python function connected to a signal emitted by a command.
+	 *  Can be nested, and can be used by a thread that already holds
+	 *  the GIL.
+	 */
+	class GILAcquirer {
+	public:
+	    /**
+	     * \brief GILAcquirer constructor.
+	     * \details Acquires the GIL if the current thread does not
+	     *  hold it already.
+	     */
+	    GILAcquirer() : state_(PyGILState_Ensure()) {
+	    }
+
+	    /**
+	     * \brief GILAcquirer destructor.
+	     * \details Restores the previous state of the GIL.
+	     */
+	    ~GILAcquirer() {
+		PyGILState_Release(state_);
+	    }
+
+	    GILAcquirer(const GILAcquirer&) = delete;
+	    GILAcquirer& operator=(const GILAcquirer&) = delete;
+
+	private:
+	    PyGILState_STATE state_;
+	};
+
+	/**
+	 * \brief Serializes the accesses to GOM objects from Python
+	 *  threads in the current scope.
+	 * \details Python threads can run concurrently while a long-running
+	 *  method releases the GIL. All the calls from Python to Graphite
+	 *  take this lock, so that two threads never access the scene graph
+	 *  at the same time. The lock is recursive: a Python function called
+	 *  by a Graphite method (e.g., connected to a signal) can call
+	 *  Graphite again. The GIL is released while waiting for the lock,
+	 *  so that the thread that holds it can call Python.
+	 * \pre the current thread holds the GIL.
+	 */
+	class gompy_API GOMLock {
+	public:
+	    /**
+	     * \brief GOMLock constructor.
+	     * \details Acquires the GOM lock. If another thread holds it,
+	     *  the GIL is released while waiting.
+	     */
+	    GOMLock() {
+		if(!mutex().try_lock()) {
+		    GILReleaser no_GIL;
+		    mutex().lock();
+		}
+	    }
+
+	    /**
+	     * \brief GOMLock destructor.
+	     * \details Releases the GOM lock.
+	     */
+	    ~GOMLock() {
+		mutex().unlock();
+	    }
+
+	    GOMLock(const GOMLock&) = delete;
+	    GOMLock& operator=(const GOMLock&) = delete;
+
+	    /**
+	     * \brief Gets the mutex of the GOM lock.
+	     * \details Used directly by the long-running methods, that
+	     *  release the GIL before waiting for the lock.
+	     * \return a reference to the mutex.
+	     */
+	    static std::recursive_mutex& mutex();
+	};
+    }
+}
+
 #endif
@@ -52,6 +52,8 @@
 #include <geogram/basic/file_system.h>
 #include <geogram/basic/command_line.h>
 
+#include <atomic>
+
 /*************************************************************************/
 
 // TODO:
@@ -106,6 +108,7 @@ namespace {
 	init_graphite_ObjectType();
 	init_graphite_CallableType();
 	init_graphite_MetaClassType();
+	init_graphite_MethodType();
         PyObject* m = PyModule_Create(&graphite_moduledef);
         if(m == nullptr) {
 	    Py_INCREF(Py_None);
@@ -123,18 +126,57 @@ namespace {
 	    Py_INCREF(Py_None);
             return Py_None;
         }
+        if (PyType_Ready(&graphite_MethodType) < 0) {
+	    Py_INCREF(Py_None);
+            return Py_None;
+        }
         Py_INCREF(&graphite_ObjectType);
         PyModule_AddObject(m, "Object",  (PyObject *)&graphite_ObjectType);
         return m;
     }
 
+    /*****************************************************************/
+
+    /**
+     * \brief True if PythonInterpreter::interrupt() was called while
+     *  a command was running.
+     */
+    std::atomic<bool> interrupt_requested(false);
+
+    /**
+     * \brief Stops the running Python code with a KeyboardInterrupt.
+     * \details Scheduled by PythonInterpreter::interrupt() with
+     *  Py_AddPendingCall(), it is called by the main thread with the GIL.
+     *  It does nothing if the command already finished.
+     * \param[in] arg unused
+     * \retval 0 if there was no interruption to raise
+     * \retval -1 otherwise
+     */
+    int python_interrupt(void* arg) {
+	geo_argused(arg);
+	if(!interrupt_requested.exchange(false)) {
+	    return 0;
+	}
+	PyErr_SetString(PyExc_KeyboardInterrupt, "interrupted");
+	return -1;
+    }
+
 }
 
    /*****************************************************************/
 
 namespace OGF {
 
-    PythonInterpreter::PythonInterpreter() : main_module_(nullptr) {
+    namespace GOMPY {
+	std::recursive_mutex& GOMLock::mutex() {
+	    static std::recursive_mutex result;
+	    return result;
+	}
+    }
+
+    PythonInterpreter::PythonInterpreter() :
+	main_module_(nullptr),
+	main_thread_state_(nullptr) {
 	use_embedded_interpreter_ = (Py_IsInitialized() == 0);
 
 	bool FPE_bkp = Process::FPE_enabled();
@@ -234,18 +276,35 @@ namespace OGF {
 	    );
 	}
 	Process::enable_FPE(FPE_bkp);
+
+	//   The embedded interpreter releases the GIL, that is acquired
+	// again each time Python is called (see GILAcquirer), so that
+	// Python threads can run while Graphite is idle.
+	if(use_embedded_interpreter_) {
+	    main_thread_state_ = PyEval_SaveThread();
+	}
     }
 
     PythonInterpreter::~PythonInterpreter() {
 	if(use_embedded_interpreter_) {
+	    if(main_thread_state_ != nullptr) {
+		PyEval_RestoreThread(main_thread_state_);
+		main_thread_state_ = nullptr;
+	    }
 	    Py_Finalize();
+	    clear_graphite_ObjectTypes();
 	}
 	main_module_ = nullptr;
     }
 
     void PythonInterpreter::reset() {
 	if(use_embedded_interpreter_) {
+	    if(main_thread_state_ != nullptr) {
+		PyEval_RestoreThread(main_thread_state_);
+		main_thread_state_ = nullptr;
+	    }
 	    Py_Finalize();
+	    clear_graphite_ObjectTypes();
 	}
 	main_module_ = nullptr;
 	// TODO: restart
@@ -258,10 +317,17 @@ namespace OGF {
             Logger::out("GOMpy") << command << std::endl;
         }
 
-	bool FPE_bkp = Process::FPE_enabled();
-	Process::enable_FPE(false);
-        int res = PyRun_SimpleString(const_cast<char*>(command.c_str()));
-	Process::enable_FPE(FPE_bkp);
+	int res = 0;
+	{
+	    GILAcquirer GIL;
+	    bool FPE_bkp = Process::FPE_enabled();
+	    Process::enable_FPE(false);
+	    res = PyRun_SimpleString(const_cast<char*>(command.c_str()));
+	    Process::enable_FPE(FPE_bkp);
+	}
+	// An interruption that arrived too late must not stop the next
+	// command.
+	interrupt_requested = false;
 
         if(res == -1) {
             return false;
@@ -273,6 +339,14 @@ namespace OGF {
         return true;
     }
 
+    void PythonInterpreter::interrupt() {
+	// Py_AddPendingCall() can be called from any thread without the
+	// GIL (PyErr_SetInterrupt() does nothing in an embedded interpreter
+	// that does not handle SIGINT).
+	interrupt_requested = true;
+	Py_AddPendingCall(python_interrupt, nullptr);
+    }
+
     bool PythonInterpreter::execute_file(const std::string& file_name) {
 
         Environment::instance()->set_value("current_gel_file", file_name);
@@ -299,6 +373,7 @@ namespace OGF {
             file_buff << buff << std::endl;
         }
 
+	GILAcquirer GIL;
 	bool FPE_bkp = Process::FPE_enabled();
 	Process::enable_FPE(false);
         int res = PyRun_SimpleString(file_buff.str().c_str());
@@ -321,10 +396,14 @@ namespace OGF {
             return false;
         }
 
-	bool FPE_bkp = Process::FPE_enabled();
-	Process::enable_FPE(false);
-        int res = PyRun_SimpleFile(f, const_cast<char*>(gel_file.c_str()));
-	Process::enable_FPE(FPE_bkp);
+	int res = 0;
+	{
+	    GILAcquirer GIL;
+	    bool FPE_bkp = Process::FPE_enabled();
+	    Process::enable_FPE(false);
+	    res = PyRun_SimpleFile(f, const_cast<char*>(gel_file.c_str()));
+	    Process::enable_FPE(FPE_bkp);
+	}
 
         fclose(f);
         if(res == -1){
@@ -335,6 +414,7 @@ namespace OGF {
     }
 
     void PythonInterpreter::bind(const std::string& id, const Any& value) {
+	GILAcquirer GIL;
 	PyObject* obj = graphite_to_python(value);
 	Py_INCREF(obj);
         PyObject_SetAttrString(main_module_, id.c_str(), obj);
@@ -343,6 +423,7 @@ namespace OGF {
     Any PythonInterpreter::resolve(
 	const std::string& id, bool quiet
     ) const {
+	GILAcquirer GIL;
 	Any any_result;
 	PyObject* result =
 	    PyObject_GetAttrString(main_module_, id.c_str());
@@ -362,6 +443,7 @@ namespace OGF {
 	const std::string& expression, bool quiet
     ) const {
 	// return resolve(expression, quiet);
+	GILAcquirer GIL;
 	Any any_result;
 	PyCodeObject* code = (PyCodeObject*) Py_CompileString(
 	    expression.c_str(), "immediate", Py_eval_input
@@ -399,6 +481,7 @@ namespace OGF {
     }
 
     void PythonInterpreter::list_names(std::vector<std::string>& names) const {
+	GILAcquirer GIL;
 	names.clear();
 	PyObject* globals = PyModule_GetDict(main_module_);
 	Py_ssize_t nb = PyDict_Size(globals);
@@ -46,6 +46,7 @@
  */
 
 struct _object;
+struct _ts;
 
 namespace OGF {
 
@@ -85,6 +86,12 @@ namespace OGF {
          */
          bool execute_file(const std::string& file_name) override;
 
+	/**
+	 * \copydoc Interpreter::interrupt()
+	 * \details Raises a KeyboardInterrupt in the running Python code.
+	 */
+	void interrupt() override;
+
 	/**
 	 * \copydoc Interpreter::bind()
 	 */
@@ -126,6 +133,14 @@ namespace OGF {
       private:
 	struct _object* main_module_;
 	bool use_embedded_interpreter_;
+
+	/**
+	 * \brief The state of the main thread of the embedded interpreter.
+	 * \details The embedded interpreter releases the GIL when it is not
+	 *  executing Python code, so that Python threads can run while
+	 *  Graphite is idle.
+	 */
+	struct _ts* main_thread_state_;
     };
 
 }
@@ -56,6 +56,16 @@ static bool strip_keyword(std::string& line, const std::string& kw) {
     return false;
 }
 
+// Same as strip_keyword(), but the keyword needs to be at the beginning
+// of the line (used for the keywords that are common English words).
+static bool strip_leading_keyword(std::string& line, const std::string& kw) {
+    if(line.compare(0, kw.length(), kw) == 0) {
+        line = line.substr(kw.length());
+        return true;
+    }
+    return false;
+}
+
 static void strip_leading_spaces(std::string& line) {
     size_t i=0;
     for(i=0; i<line.length(); ++i) {
@@ -170,6 +180,12 @@ void doxyparse(String* text_in, String* preprocessor_output) {
                     current_arg = "help"; 
                 } else if(strip_keyword(line, "menu")) {
                     current_arg = "menu";
+                } else if(strip_leading_keyword(line, "modifies")) {
+                    current_arg = "modifies";
+                } else if(strip_leading_keyword(line, "readonly")) {
+                    args["readonly"] = "true";
+                    current_arg = "";
+                    continue;
                 } else if(strip_keyword(line, "advanced")) {
                     advanced_arg = true;
                     continue;
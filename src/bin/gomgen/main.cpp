@@ -49,6 +49,9 @@
 #include "gom.h"
 #include "doxyparse.h"
 
+#include <sstream>
+#include <set>
+
 //   A dlsym-visible variable to check whether
 // main Graphite module is loaded.
 //   Its presence just changes the behavior of
@@ -124,6 +127,12 @@ namespace {
     std::string output_path;
     bool dependencies=false;
     bool save_preprocessor_output=false;
+    bool registration=false;
+    bool static_tables=false;
+    std::string header;
+    std::string header_list_path;
+    std::string depfile_path;
+    std::string manifest_path;
 
     void parse_command_line(int argc, char** argv) {
 	for (int i = 1; i < argc; i++) {
@@ -156,6 +165,36 @@ namespace {
 			std::string(argv[i] + 2)
 		    );
 		    Swig_mark_arg(i);
+		} else if(!strncmp(argv[i], "-header_list", 12)) {
+		    // The headers of the package, one per line, relative to
+		    // the include path (instead of searching the input path).
+		    header_list_path = std::string(argv[i] + 12);
+		    Swig_mark_arg(i);
+		} else if(!strncmp(argv[i], "-header", 7)) {
+		    // Generate the code for a single header (relative to
+		    // the include path).
+		    header = std::string(argv[i] + 7);
+		    Swig_mark_arg(i);
+		} else if(!strcmp(argv[i], "-static_tables")) {
+		    // Generate constant tables, materialized on demand,
+		    // instead of creating all the MetaClasses at startup.
+		    static_tables = true;
+		    Swig_mark_arg(i);
+		} else if(!strcmp(argv[i], "-register")) {
+		    // Generate the package initialization function that
+		    // calls the initializers of all the headers.
+		    registration = true;
+		    Swig_mark_arg(i);
+		} else if(!strncmp(argv[i], "-manifest", 9)) {
+		    // Also write the list of the classes of the package
+		    // (alone, without -o, only writes the manifest).
+		    manifest_path = OGF::FileSystem::normalized_path(
+			std::string(argv[i] + 9)
+		    );
+		    Swig_mark_arg(i);
+		} else if(!strncmp(argv[i], "-MF", 3)) {
+		    depfile_path = std::string(argv[i] + 3);
+		    Swig_mark_arg(i);
 		} else if(!strncmp(argv[i], "-o", 2)) {
 		    output_path = OGF::FileSystem::normalized_path(
 			std::string(argv[i] + 2)
@@ -198,7 +237,7 @@ namespace {
 	    }
 	}
 
-	if(output_path == "") {
+	if(output_path == "" && manifest_path == "") {
 	    OGF::Logger::err("Gom::CodeGen")
 		<< "Output file was not specified (missing -oFileName.cpp)"
 		<< std::endl;
@@ -264,8 +303,44 @@ namespace {
 	}
     }
 
+    /**
+     * \brief Reads the list of the headers of the package.
+     * \details The list is written by the build system, so that the
+     *  package registration and the manifest use the same headers as
+     *  the ones it generates code for.
+     * \param[in] path the name of the file, with one header per line,
+     *  relative to the include path
+     * \param[out] gom_headers the headers
+     */
+    void read_header_list(
+	const std::string& path, std::vector<std::string>& gom_headers
+    ) {
+	std::ifstream in(path.c_str());
+	if(!in) {
+	    OGF::Logger::err("Gom::CodeGen")
+		<< "Could not open header list \'" << path << "\'"
+		<< std::endl;
+	    exit(EXIT_FAILURE);
+	}
+	std::string line;
+	while(std::getline(in, line)) {
+	    if(line.length() != 0 && line[line.length()-1] == '\r') {
+		line.resize(line.length()-1);
+	    }
+	    if(line.length() != 0) {
+		gom_headers.push_back(line);
+	    }
+	}
+    }
+
+    std::string swig_source;
+
     void assemble_swig_source(const std::vector<std::string>& gom_headers) {
-	input_file = const_cast<char*>("tmp_gomgen.cpp");
+	// In single-header mode, several instances of gomgen may run in
+	// parallel, each one needs its own temporary file.
+	swig_source = (header == "") ? std::string("tmp_gomgen.cpp") :
+	    (output_path + ".tmp_gomgen.cpp");
+	input_file = const_cast<char*>(swig_source.c_str());
 	std::ofstream out((char*)input_file);
 	for(size_t i=0; i<gom_headers.size(); ++i) {
 	    out << "#include <" << gom_headers[i] << ">" << std::endl;
@@ -315,9 +390,129 @@ namespace {
 	return result;
     }
 
+    /**
+     * \brief Writes a file only if its content changed.
+     * \details Keeps the timestamp of the generated files that did not
+     *  change, so that they are not recompiled.
+     * \param[in] filename the name of the file
+     * \param[in] content the new content of the file
+     * \retval true if the file was written
+     * \retval false if the file already had the same content
+     */
+    bool write_file_if_changed(
+	const std::string& filename, const std::string& content
+    ) {
+	if(OGF::FileSystem::is_file(filename)) {
+	    std::ifstream in(filename.c_str(), std::ios::binary);
+	    std::ostringstream old_content;
+	    old_content << in.rdbuf();
+	    if(old_content.str() == content) {
+		return false;
+	    }
+	}
+	std::ofstream out(filename.c_str(), std::ios::binary);
+	out << content;
+	return true;
+    }
+
+    /**
+     * \brief Computes the key used to cache the generated code.
+     * \details The generated code only depends on the preprocessed
+     *  input, on the command line and on gomgen itself.
+     */
+    std::string compute_cache_key(DOH* cpps, int argc, char** argv) {
+	// FNV-1a: std::hash is not required to be stable.
+	GEO::Numeric::uint64 hash = 14695981039346656037ULL;
+	auto hash_string = [&hash](const char* str, size_t len) {
+	    for(size_t i=0; i<len; ++i) {
+		hash ^= GEO::Numeric::uint64((unsigned char)(str[i]));
+		hash *= 1099511628211ULL;
+	    }
+	};
+	for(int i=0; i<argc; ++i) {
+	    hash_string(argv[i], strlen(argv[i]) + 1);
+	}
+	std::string gomgen_stamp = OGF::String::to_string(
+	    OGF::FileSystem::get_time_stamp(argv[0])
+	);
+	hash_string(gomgen_stamp.c_str(), gomgen_stamp.length());
+	const char* cpps_string = Char(cpps);
+	hash_string(cpps_string, strlen(cpps_string));
+	std::ostringstream out;
+	out << std::hex << hash;
+	return out.str();
+    }
+
+    /**
+     * \brief Writes the files the generated code depends on, as a
+     *  Makefile-style depfile, understood by Ninja and by CMake's DEPFILE.
+     * \details The dependencies are the files included by the SWIG
+     *  preprocessor, marked with \%includefile in its output.
+     */
+    void write_depfile(DOH* cpps) {
+	static const std::string marker = "%includefile \"";
+	std::set<std::string> deps;
+	std::string cpps_string(Char(cpps));
+	size_t pos = cpps_string.find(marker);
+	while(pos != std::string::npos) {
+	    pos += marker.length();
+	    size_t end = cpps_string.find('"', pos);
+	    if(end == std::string::npos) {
+		break;
+	    }
+	    std::string dep = cpps_string.substr(pos, end-pos);
+	    if(dep != swig_source) {
+		deps.insert(dep);
+	    }
+	    pos = cpps_string.find(marker, end);
+	}
+	// The target is the .hash file, that is the stamp of the build
+	// system (see main()).
+	std::ostringstream out;
+	out << output_path << ".hash:";
+	for(const std::string& dep : deps) {
+	    out << " \\" << std::endl << "  ";
+	    for(char c : dep) {
+		if(c == ' ') {
+		    out << '\\';
+		}
+		out << c;
+	    }
+	}
+	out << std::endl;
+	write_file_if_changed(depfile_path, out.str());
+    }
+
+    /**
+     * \brief Writes the manifest of the package, with the names of the
+     *  classes it declares.
+     * \details Read by ModuleManager::defer_module(), that loads the
+     *  module the first time one of these classes is used. The file
+     *  extensions and languages that the module registers are not known
+     *  here, ModuleManager caches them per user when it loads the
+     *  module.
+     * \param[in] classes the classes parsed by SWIG, including the ones
+     *  declared by the other packages, that are ignored.
+     */
+    void write_manifest(const std::vector<OGF::MetaClass*>& classes) {
+	std::string package_name = get_package_name(input_path);
+	std::ostringstream out;
+	out << "# GOMGEN automatically generated module manifest" << std::endl;
+	out << "# Do not edit." << std::endl;
+	for(OGF::MetaClass* mclass : classes) {
+	    if(
+		mclass->has_custom_attribute("package") &&
+		mclass->custom_attribute_value("package") == package_name
+	    ) {
+		out << mclass->name() << std::endl;
+	    }
+	}
+	write_file_if_changed(manifest_path, out.str());
+    }
+
     void run_generator(
 	Language* lang, const std::vector<std::string>& sources,
-	DOH* cpps, std::ofstream& out,
+	DOH* cpps, std::ostream& out,
 	int argc, char** argv
     ) {
 	Node *top = Swig_cparse(cpps);
@@ -350,8 +545,29 @@ namespace {
 	    out << std::endl;
 	    out << std::endl;
 
-	    for(size_t i =0; i<sources.size(); ++i) {
-		out << "#include <" << sources[i] << ">" << std::endl;
+	    const std::vector<OGF::MetaClass*> classes =
+		get_swig_gom_generated_classes();
+
+	    if(manifest_path != "") {
+		write_manifest(classes);
+	    }
+
+	    OGF::GomCodeGenerator generator;
+	    generator.set_static_tables(static_tables);
+
+	    if(header == "") {
+		for(size_t i =0; i<sources.size(); ++i) {
+		    out << "#include <" << sources[i] << ">" << std::endl;
+		}
+	    } else {
+		// Only include what the classes of the header need, so
+		// that modifying another header does not trigger a
+		// recompilation.
+		std::set<std::string> includes;
+		generator.get_header_includes(classes, header, includes);
+		for(const std::string& include : includes) {
+		    out << "#include <" << include << ">" << std::endl;
+		}
 	    }
 	    out << "#include <OGF/gom/types/gom_implementation.h>" << std::endl;
 	    out << std::endl;
@@ -384,12 +600,14 @@ namespace {
 	    out << std::endl;
 	    out << std::endl;
 
-	    const std::vector<OGF::MetaClass*> classes =
-		get_swig_gom_generated_classes();
-
-	    OGF::GomCodeGenerator generator;
 	    OGF::Logger::out("Gom::CodeGen") << ">>" << std::endl;
-	    generator.generate(out, classes, get_package_name(input_path));
+	    if(header == "") {
+		generator.generate(out, classes, get_package_name(input_path));
+	    } else {
+		generator.generate_header(
+		    out, classes, get_package_name(input_path), header
+		);
+	    }
 	}
     }
 }
@@ -455,13 +673,72 @@ int main(int argc, char** argv) {
     install_opts(argc, argv);
 
     std::vector<std::string> gom_headers;
-    find_gom_headers(input_path, gom_headers);
+    if(header_list_path != "") {
+        read_header_list(header_list_path, gom_headers);
+    } else {
+        find_gom_headers(input_path, gom_headers);
+    }
 
     if(dependencies) {
         std::ofstream out(output_path.c_str());
         for(size_t i=0; i<gom_headers.size(); ++i) {
             out << gom_headers[i] << std::endl;
         }
+    } else if(registration) {
+        std::ostringstream out;
+        out << "// GOMGEN automatically generated code" << std::endl;
+        out << "// Do not edit." << std::endl;
+        out << std::endl;
+        OGF::GomCodeGenerator generator;
+        generator.generate_package_registration(
+            out, get_package_name(input_path), gom_headers
+        );
+        write_file_if_changed(output_path, out.str());
+    } else if(header != "") {
+        // Incremental mode: generate the code for a single header. The
+        // output is only regenerated if the preprocessed input changed,
+        // and only rewritten if the generated code changed, so that the
+        // build system does not recompile it.
+        std::vector<std::string> sources;
+        sources.push_back(header);
+        assemble_swig_source(sources);
+        Preprocessor_register_comment_CB(doxyparse);
+        DOH* cpps = run_preprocessor(argc,argv);
+        cleanup_swig_source();
+        if(depfile_path != "") {
+            write_depfile(cpps);
+        }
+        std::string hash_path = output_path + ".hash";
+        std::string cache_key = compute_cache_key(cpps, argc, argv);
+        bool up_to_date = false;
+        if(
+            OGF::FileSystem::is_file(output_path) &&
+            OGF::FileSystem::is_file(hash_path)
+        ) {
+            std::ifstream in(hash_path.c_str());
+            std::string previous_key;
+            in >> previous_key;
+            up_to_date = (previous_key == cache_key);
+        }
+        if(up_to_date) {
+            OGF::Logger::out("Gom::CodeGen")
+                << header << ": up to date" << std::endl;
+        } else {
+            Seek(cpps, 0, SEEK_SET);
+            Swig_register_filebyname("null", NewString(""));
+            std::ostringstream out;
+            run_generator(lang,sources,cpps,out,argc,argv);
+            if(swig_gom_error_occured()) {
+                return -1;
+            }
+            write_file_if_changed(output_path, out.str());
+        }
+        // The .hash file is always rewritten: it is the stamp of the
+        // build system (the output of the command), whereas the generated
+        // code is a byproduct that keeps its timestamp when it did not
+        // change, so that it is not recompiled.
+        std::ofstream hash_out(hash_path.c_str());
+        hash_out << cache_key << std::endl;
     } else {
         assemble_swig_source(gom_headers);
         Preprocessor_register_comment_CB(doxyparse);
@@ -469,8 +746,13 @@ int main(int argc, char** argv) {
         cleanup_swig_source();
         // Register a null file with the file handler
         Swig_register_filebyname("null", NewString(""));
-        std::ofstream out(output_path.c_str());
-        run_generator(lang,gom_headers,cpps,out,argc,argv);
+        if(output_path == "") {
+            std::ostringstream out;
+            run_generator(lang,gom_headers,cpps,out,argc,argv);
+        } else {
+            std::ofstream out(output_path.c_str());
+            run_generator(lang,gom_headers,cpps,out,argc,argv);
+        }
     }
 
     return swig_gom_error_occured() ? -1 : 0;
@@ -0,0 +1,454 @@
+/*
+ *  Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2015 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include "batch_server.h"
+#include <OGF/gom/interpreter/interpreter.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/progress.h>
+#include <geogram/basic/stopwatch.h>
+
+#ifdef GEO_OS_UNIX
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#endif
+
+#ifdef GEO_OS_UNIX
+
+namespace {
+
+    using namespace OGF;
+
+    /**
+     * \brief Time given to a job to stop after it was interrupted,
+     *  in seconds.
+     */
+    const double INTERRUPT_GRACE_DELAY = 5.0;
+
+    /**
+     * \brief The connection with a client of the batch server.
+     * \details While a job runs, it is registered as a LoggerClient,
+     *  so that the messages are streamed back to the client.
+     */
+    class BatchServerConnection : public LoggerClient {
+    public:
+	/**
+	 * \brief BatchServerConnection constructor.
+	 * \param[in] fd the file descriptor of the connected socket.
+	 */
+	BatchServerConnection(int fd) : fd_(fd), broken_(false) {
+	}
+
+	/**
+	 * \copydoc LoggerClient::div()
+	 */
+	void div(const std::string& title) override {
+	    send("out", title);
+	}
+
+	/**
+	 * \copydoc LoggerClient::out()
+	 */
+	void out(const std::string& str) override {
+	    send("out", str);
+	}
+
+	/**
+	 * \copydoc LoggerClient::warn()
+	 */
+	void warn(const std::string& str) override {
+	    send("warn", str);
+	}
+
+	/**
+	 * \copydoc LoggerClient::err()
+	 */
+	void err(const std::string& str) override {
+	    send("err", str);
+	}
+
+	/**
+	 * \copydoc LoggerClient::status()
+	 */
+	void status(const std::string& str) override {
+	    send("status", str);
+	}
+
+	/**
+	 * \brief Sends a message to the client.
+	 * \details Can be called from any thread. Each line of the message
+	 *  is prefixed by the channel.
+	 * \param[in] channel one of "out", "warn", "err", "status", "end"
+	 * \param[in] message the message, that may have several lines.
+	 */
+	void send(const std::string& channel, const std::string& message) {
+	    std::string lines;
+	    size_t begin = 0;
+	    while(begin < message.length()) {
+		size_t end = message.find('\n', begin);
+		if(end == std::string::npos) {
+		    end = message.length();
+		}
+		lines += channel + " " + message.substr(begin, end-begin) + "\n";
+		begin = end + 1;
+	    }
+	    if(message.empty()) {
+		lines = channel + "\n";
+	    }
+	    std::lock_guard<std::mutex> lock(mutex_);
+	    write_all(lines);
+	}
+
+	/**
+	 * \brief Closes the connection with the client.
+	 * \details Used when a job is abandoned: the client gets its
+	 *  status, and the messages of the job are no longer sent. Can be
+	 *  called from any thread.
+	 */
+	void close_client() {
+	    std::lock_guard<std::mutex> lock(mutex_);
+	    broken_ = true;
+	    ::shutdown(fd_, SHUT_RDWR);
+	}
+
+	/**
+	 * \brief Reads a line sent by the client.
+	 * \param[out] line the line, without the end-of-line character.
+	 * \retval true if a complete line could be read.
+	 * \retval false otherwise.
+	 */
+	bool read_line(std::string& line) {
+	    line.clear();
+	    char c;
+	    while(::read(fd_, &c, 1) == 1) {
+		if(c == '\n') {
+		    return true;
+		}
+		if(line.length() >= MAX_LINE_LENGTH) {
+		    return false;
+		}
+		line.push_back(c);
+	    }
+	    return false;
+	}
+
+	/**
+	 * \brief Reads a given number of bytes sent by the client.
+	 * \param[out] data the bytes.
+	 * \param[in] size the number of bytes to be read.
+	 * \retval true if all the bytes could be read.
+	 * \retval false otherwise.
+	 */
+	bool read_bytes(std::string& data, size_t size) {
+	    data.resize(size);
+	    size_t offset = 0;
+	    while(offset < size) {
+		ssize_t nb = ::read(fd_, &data[offset], size - offset);
+		if(nb < 0 && errno == EINTR) {
+		    continue;
+		}
+		if(nb <= 0) {
+		    return false;
+		}
+		offset += size_t(nb);
+	    }
+	    return true;
+	}
+
+    protected:
+	/**
+	 * \brief Writes a string to the socket.
+	 * \details If the client disconnected, the remaining messages
+	 *  are ignored (the job keeps running).
+	 * \param[in] str the string
+	 */
+	void write_all(const std::string& str) {
+	    size_t offset = 0;
+	    while(!broken_ && offset < str.length()) {
+		ssize_t nb = ::write(
+		    fd_, str.data() + offset, str.length() - offset
+		);
+		if(nb < 0 && errno == EINTR) {
+		    continue;
+		}
+		if(nb <= 0) {
+		    broken_ = true;
+		} else {
+		    offset += size_t(nb);
+		}
+	    }
+	}
+
+    private:
+	static const size_t MAX_LINE_LENGTH = 1024;
+	int fd_;
+	bool broken_;
+	std::mutex mutex_;
+    };
+
+    /**
+     * \brief Clears the scene graph, so that each job starts from
+     *  an empty scene.
+     */
+    void clear_scene_graph() {
+	Interpreter* lua = Interpreter::instance_by_language("Lua");
+	Object* scene_graph = (lua == nullptr) ?
+	    nullptr : lua->resolve_object("scene_graph");
+	if(scene_graph != nullptr) {
+	    scene_graph->invoke_method("clear");
+	}
+    }
+
+    /**
+     * \brief Executes one job sent by a client.
+     * \param[in] connection the connection with the client.
+     * \param[in] default_timeout the maximum duration of the job if the
+     *  client does not specify it, in seconds, or 0 for no limit.
+     * \param[out] quit true if the client asked the server to quit.
+     * \return the status of the job, one of "ok", "error", "timeout".
+     */
+    std::string execute_job(
+	BatchServerConnection* connection, double default_timeout, bool& quit
+    ) {
+	std::string header;
+	std::string language;
+	double timeout = 0.0;
+	size_t size = 0;
+	if(connection->read_line(header)) {
+	    std::istringstream in(header);
+	    in >> language >> timeout >> size;
+	}
+	if(language == "quit") {
+	    quit = true;
+	    return "ok";
+	}
+
+	std::string source;
+	if(language.empty() || !connection->read_bytes(source, size)) {
+	    connection->send("err", "invalid job header: " + header);
+	    return "error";
+	}
+
+	Interpreter* interpreter =
+	    Interpreter::instance_by_file_extension(language);
+	if(interpreter == nullptr) {
+	    interpreter = Interpreter::instance_by_language(language);
+	}
+	if(interpreter == nullptr) {
+	    connection->send("err", language + ": no such language");
+	    return "error";
+	}
+
+	// Global variables created by a job are stored in its own
+	// environment. In LUA, it is defined on the first line to keep line
+	// numbers. In Python, the job is executed with a copy of the globals
+	// of __main__.
+	if(interpreter->get_language() == "Lua") {
+	    source = "local _ENV = setmetatable({}, {__index = _G}); " + source;
+	} else if(interpreter->get_language() == "Python") {
+	    Any job_source;
+	    job_source.set_value(source);
+	    interpreter->bind("_graphite_job_source", job_source);
+	    source =
+		"exec(compile(_graphite_job_source, '<job>', 'exec'), "
+		"{ k:v for k,v in globals().items() "
+		"if k != '_graphite_job_source' })";
+	}
+	if(timeout <= 0.0) {
+	    timeout = default_timeout;
+	}
+
+	// The watchdog interrupts the job when it exceeds its timeout. The
+	// mutex ensures that it does not interrupt a job that is finished.
+	std::mutex mutex;
+	std::condition_variable finished;
+	bool done = false;
+	bool timed_out = false;
+	std::thread watchdog;
+	if(timeout > 0.0) {
+	    watchdog = std::thread(
+		[&]() {
+		    std::unique_lock<std::mutex> lock(mutex);
+		    auto is_done = [&]() { return done; };
+		    if(finished.wait_for(
+			   lock, std::chrono::duration<double>(timeout), is_done
+		    )) {
+			return;
+		    }
+		    timed_out = true;
+		    // Stops the script, and the C++ commands that report
+		    // their progress.
+		    interpreter->interrupt();
+		    Progress::cancel();
+		    if(finished.wait_for(
+			   lock,
+			   std::chrono::duration<double>(INTERRUPT_GRACE_DELAY),
+			   is_done
+		    )) {
+			return;
+		    }
+		    // The job is stuck in C++ code that cannot be interrupted.
+		    // The client gets its status now, the server waits for the
+		    // job and then serves the next ones.
+		    connection->send(
+			"err", "job does not stop, abandoned"
+		    );
+		    connection->send("end", "timeout");
+		    connection->close_client();
+		    Logger::warn("Server")
+			<< "Job does not stop after its timeout, waiting for it"
+			<< std::endl;
+		}
+	    );
+	}
+
+	bool result = interpreter->execute(source, false, false);
+
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+	    done = true;
+	}
+	finished.notify_all();
+	if(watchdog.joinable()) {
+	    watchdog.join();
+	}
+	if(timed_out) {
+	    // Consumes the interruption if it arrived after the end
+	    // of the job.
+	    interpreter->execute("", false, false);
+	    Progress::clear_canceled();
+	    return "timeout";
+	}
+	return result ? "ok" : "error";
+    }
+
+}
+
+#endif
+
+namespace OGF {
+
+    void run_batch_server(const std::string& socket_path, double timeout) {
+#ifdef GEO_OS_UNIX
+	// A client that disconnects must not kill the server.
+	::signal(SIGPIPE, SIG_IGN);
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(socket_path.length() >= sizeof(address.sun_path)) {
+	    Logger::err("Server") << socket_path << ": socket path too long"
+				  << std::endl;
+	    return;
+	}
+	strcpy(address.sun_path, socket_path.c_str());
+
+	int server_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	::unlink(socket_path.c_str());
+	// Jobs run with the rights of the server: only its user can
+	// connect (the socket is created with mode 0600).
+	mode_t mask = ::umask(0077);
+	bool bound = (
+	    server_fd >= 0 &&
+	    ::bind(server_fd, (sockaddr*)&address, sizeof(address)) == 0
+	);
+	::umask(mask);
+	if(
+	    !bound ||
+	    ::chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+	    ::listen(server_fd, 16) != 0
+	) {
+	    Logger::err("Server") << socket_path << ": " << strerror(errno)
+				  << std::endl;
+	    if(server_fd >= 0) {
+		::close(server_fd);
+	    }
+	    return;
+	}
+
+	Logger::out("Server") << "Listening on " << socket_path << std::endl;
+
+	index_t nb_jobs = 0;
+	bool quit = false;
+	while(!quit) {
+	    int fd = ::accept(server_fd, nullptr, nullptr);
+	    if(fd < 0) {
+		if(errno == EINTR) {
+		    continue;
+		}
+		Logger::err("Server") << strerror(errno) << std::endl;
+		break;
+	    }
+	    double start = Stopwatch::now();
+	    SmartPointer<BatchServerConnection> connection =
+		new BatchServerConnection(fd);
+	    clear_scene_graph();
+	    Logger::instance()->register_client(connection);
+	    std::string status = execute_job(connection, timeout, quit);
+	    Logger::instance()->unregister_client(connection);
+	    clear_scene_graph();
+	    connection->send("end", status);
+	    ::close(fd);
+	    if(!quit) {
+		++nb_jobs;
+		Logger::out("Server")
+		    << "Job " << nb_jobs << ": " << status << " ("
+		    << Stopwatch::now() - start << " s)" << std::endl;
+	    }
+	}
+
+	::close(server_fd);
+	::unlink(socket_path.c_str());
+	Logger::out("Server") << "Stopped after " << nb_jobs << " job(s)"
+			      << std::endl;
+#else
+	geo_argused(socket_path);
+	geo_argused(timeout);
+	Logger::err("Server") << "Batch server is only supported under Unix"
+			      << std::endl;
+#endif
+    }
+
+}
@@ -0,0 +1,82 @@
+/*
+ *  Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2015 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_GRAPHITE_BATCH_SERVER_H
+#define H_GRAPHITE_BATCH_SERVER_H
+
+#include <OGF/basic/common/common.h>
+#include <string>
+
+/**
+ * \file graphite/batch_server.h
+ * \brief Runs Graphite as a server that executes batch jobs, so that
+ *  scripted pipelines do not pay the startup time for each script.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief Executes the jobs sent to a UNIX domain socket until a
+     *  client asks the server to quit.
+     * \details Each client connection sends one job, as a header line
+     *  followed by the source of the script:
+     *  \code
+     *  <language> <timeout> <size>\n
+     *  <size bytes of source>
+     *  \endcode
+     *  where language is the name of an interpreter ("Lua", "Python") or
+     *  its file extension ("lua", "py"), or "quit" to stop the server,
+     *  and timeout is the maximum duration of the job in seconds (0 to
+     *  use the default one). The scene graph is cleared before each job,
+     *  and jobs have their own global variables. The server answers
+     *  with the logged messages, one per line prefixed by the channel
+     *  ("out", "warn", "err" or "status") and a space, then with a last
+     *  line "end ok", "end error" or "end timeout". A job that exceeds
+     *  its timeout is interrupted. If it does not stop after a grace delay
+     *  (for instance in a C++ command that does not report its progress),
+     *  the client gets "end timeout" and the server waits for the job
+     *  before serving the next ones.
+     * \param[in] socket_path the path of the socket, created by the
+     *  server with mode 0600 (an existing file with the same name is
+     *  replaced).
+     * \param[in] timeout default maximum duration of a job in seconds,
+     *  or 0 for no limit.
+     */
+    void run_batch_server(const std::string& socket_path, double timeout);
+
+}
+
+#endif
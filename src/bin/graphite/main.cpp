@@ -40,6 +40,9 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/basic/modules/modmgr.h>
 #include <OGF/basic/os/file_manager.h>
+#include <OGF/basic/os/startup_profiler.h>
+
+#include "batch_server.h"
 
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/file_system.h>
@@ -210,6 +213,13 @@ namespace {
             "batch", false, "batch mode (i.e., no GUI)"
         );
 
+        CmdLine::declare_arg(
+            "lazy_modules", true,
+	    "in batch mode, load the modules the first time one of their "
+	    "classes is used (needs the .gom_manifest files generated "
+	    "by gomgen)"
+        );
+
         CmdLine::declare_arg(
             "interactive", false,
 	    "interactive mode (i.e., open a GEL shell after startup)"
@@ -220,6 +230,29 @@ namespace {
 	    "shorthand for batch=true and interactive=true"
         );
 
+        CmdLine::declare_arg(
+            "server", "",
+	    "run as a batch server that executes the jobs sent to this "
+	    "UNIX domain socket (see graphite_client)"
+        );
+
+        CmdLine::declare_arg(
+            "server:timeout", 0.0,
+	    "default maximum duration of a batch server job in seconds "
+	    "(0 for no limit)"
+        );
+
+        CmdLine::declare_arg(
+            "profile_startup", false,
+	    "display the time and memory taken by each step of the "
+	    "startup, and save them as JSON"
+        );
+
+        CmdLine::declare_arg(
+            "profile_startup:file", "startup_profile.json",
+	    "file where the startup profile is saved (JSON)"
+        );
+
         std::vector<std::string> filenames;
         if(!CmdLine::parse(argc,argv,filenames,"<inputfile>*")) {
             exit(-1);
@@ -282,6 +315,16 @@ namespace {
 	    "gui:undo_depth", 4, "number of memorized states for undo"
 	);
 
+        Preferences::declare_preference_variable(
+	    "gui:undo_memory", 1024,
+	    "memory used by undo (in Mb), beyond which states go to disk"
+	);
+
+        Preferences::declare_preference_variable(
+	    "gui:undo_check_writes", false,
+	    "check that commands only modify what they declare (slow)"
+	);
+
         Preferences::declare_preference_variable(
 	    "gfx:default_full_screen_effect", "Plain",
 	    "full-screen effect enabled by default"
@@ -353,7 +396,16 @@ namespace {
     void load_modules(const std::string& modules_str) {
         std::vector<std::string> modules;
         String::split_string(modules_str, ';', modules);
+	// The GUI lists the classes, commands and file extensions
+	// registered by all the modules, they are only deferred
+	// in batch mode.
+	bool lazy =
+	    CmdLine::get_arg_bool("batch") &&
+	    CmdLine::get_arg_bool("lazy_modules");
         for(unsigned int i=0; i<modules.size(); i++) {
+	    if(lazy && ModuleManager::instance()->defer_module(modules[i])) {
+		continue;
+	    }
             ModuleManager::instance()->load_module(modules[i]);
         }
     }
@@ -644,6 +696,9 @@ int main(int argc, char** argv) {
 
     declare_preference_variables();
     parse_command_line(argc, argv);
+    if(CmdLine::get_arg_bool("profile_startup")) {
+	StartupProfiler::enable(CmdLine::get_arg("profile_startup:file"));
+    }
     add_libpath();
 
 
@@ -661,6 +716,10 @@ int main(int argc, char** argv) {
 	CmdLine::set_arg("interactive", true);
     }
 
+    if(CmdLine::get_arg("server") != "") {
+	CmdLine::set_arg("batch", true);
+    }
+
     if(CmdLine::get_arg_bool("batch")) {
         CmdLine::set_arg("skin", "none");
         CmdLine::set_arg("main", "lib/graphite_batch.lua");
@@ -669,7 +728,10 @@ int main(int argc, char** argv) {
     load_base_modules();
     load_skin();
     load_plugin_modules();
-    load_interpreter();
+    {
+	StartupTimer timer("interpreter", "Lua");
+	load_interpreter();
+    }
 
     Logger::out("Graphite///") << "Hello, world !!" << std::endl;
     Logger::out("Graphite///") << "Starting main GEL script" << std::endl;
@@ -683,6 +745,7 @@ int main(int argc, char** argv) {
                     << gel_filename << std::endl;
                 exit(-1);
             }
+	    StartupTimer timer("script", gel_filename);
             get_interpreter()->execute_file(gel_filename);
         }
 
@@ -690,6 +753,7 @@ int main(int argc, char** argv) {
 	    CmdLine::get_arg_bool("batch") &&
 	    CmdLine::get_arg("gel") == "Lua"
 	) {
+	    StartupTimer timer("script", "post_init()");
             get_interpreter()->execute("post_init()",false,false);
         }
 
@@ -703,7 +767,16 @@ int main(int argc, char** argv) {
 	    app->invoke_method("start");
 	}
 
-        if(
+	// In batch mode, startup is complete here (with a GUI, it is
+	// complete after the first frame, see skin_imgui).
+	StartupProfiler::finish();
+
+        if(CmdLine::get_arg("server") != "") {
+	    run_batch_server(
+		CmdLine::get_arg("server"),
+		CmdLine::get_arg_double("server:timeout")
+	    );
+	} else if(
             gel_filename == "none" ||
             CmdLine::get_arg_bool("interactive")
         ) {
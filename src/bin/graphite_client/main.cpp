@@ -0,0 +1,251 @@
+/*
+ *  Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2015 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+/*
+ * A minimal client for the Graphite batch server (graphite server=<socket>).
+ * Each script given on the command line is sent as a job, and the messages
+ * logged by the job are printed as they arrive. It only depends on the
+ * system libraries, so that it starts instantly.
+ *
+ * Usage: graphite_client [-t timeout] <socket> <script.lua|script.py>...
+ *        graphite_client <socket> quit
+ *
+ * Exit status: 0 if all the jobs succeeded, 1 if a job failed, 2 if a job
+ * exceeded its timeout, 3 if the server could not be reached.
+ */
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    enum ExitStatus {
+	EXIT_OK = 0,
+	EXIT_JOB_ERROR = 1,
+	EXIT_JOB_TIMEOUT = 2,
+	EXIT_NO_SERVER = 3
+    };
+
+    /**
+     * \brief Connects to the batch server.
+     * \param[in] socket_path the path of the UNIX domain socket.
+     * \return the file descriptor of the connected socket, or -1
+     *  on failure.
+     */
+    int connect_to_server(const std::string& socket_path) {
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(socket_path.length() >= sizeof(address.sun_path)) {
+	    std::cerr << socket_path << ": socket path too long" << std::endl;
+	    return -1;
+	}
+	strcpy(address.sun_path, socket_path.c_str());
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if(
+	    fd < 0 ||
+	    ::connect(fd, (sockaddr*)&address, sizeof(address)) != 0
+	) {
+	    std::cerr << socket_path << ": " << strerror(errno) << std::endl;
+	    if(fd >= 0) {
+		::close(fd);
+	    }
+	    return -1;
+	}
+	return fd;
+    }
+
+    /**
+     * \brief Writes a string to a socket.
+     * \param[in] fd the file descriptor of the socket.
+     * \param[in] str the string.
+     * \retval true if the string could be written.
+     * \retval false otherwise.
+     */
+    bool write_all(int fd, const std::string& str) {
+	size_t offset = 0;
+	while(offset < str.length()) {
+	    ssize_t nb = ::write(fd, str.data() + offset, str.length() - offset);
+	    if(nb < 0 && errno == EINTR) {
+		continue;
+	    }
+	    if(nb <= 0) {
+		return false;
+	    }
+	    offset += size_t(nb);
+	}
+	return true;
+    }
+
+    /**
+     * \brief Prints the messages sent by the server until the end
+     *  of the job.
+     * \param[in] fd the file descriptor of the socket.
+     * \return the status of the job ("ok", "error", "timeout"), or an
+     *  empty string if the connection was lost.
+     */
+    std::string receive_job_output(int fd) {
+	std::string line;
+	char buffer[4096];
+	for(;;) {
+	    ssize_t nb = ::read(fd, buffer, sizeof(buffer));
+	    if(nb < 0 && errno == EINTR) {
+		continue;
+	    }
+	    if(nb <= 0) {
+		return "";
+	    }
+	    for(ssize_t i=0; i<nb; ++i) {
+		if(buffer[i] != '\n') {
+		    line.push_back(buffer[i]);
+		    continue;
+		}
+		size_t space = line.find(' ');
+		std::string channel = line.substr(0, space);
+		std::string message = (space == std::string::npos) ?
+		    std::string() : line.substr(space+1);
+		line.clear();
+		if(channel == "end") {
+		    return message;
+		}
+		if(channel == "warn" || channel == "err") {
+		    std::cerr << message << std::endl;
+		} else {
+		    std::cout << message << std::endl;
+		}
+	    }
+	}
+    }
+
+    /**
+     * \brief Sends a job to the server and prints its output.
+     * \param[in] socket_path the path of the UNIX domain socket.
+     * \param[in] language the language or file extension of the script,
+     *  or "quit" to stop the server.
+     * \param[in] source the source of the script.
+     * \param[in] timeout the maximum duration of the job in seconds,
+     *  or 0 to use the default one of the server.
+     * \return the exit status.
+     */
+    ExitStatus run_job(
+	const std::string& socket_path, const std::string& language,
+	const std::string& source, double timeout
+    ) {
+	int fd = connect_to_server(socket_path);
+	if(fd < 0) {
+	    return EXIT_NO_SERVER;
+	}
+	std::ostringstream header;
+	header << language << " " << timeout << " " << source.length() << "\n";
+	std::string status;
+	if(write_all(fd, header.str()) && write_all(fd, source)) {
+	    status = receive_job_output(fd);
+	}
+	::close(fd);
+	if(status == "ok") {
+	    return EXIT_OK;
+	}
+	if(status == "timeout") {
+	    std::cerr << "job exceeded its timeout" << std::endl;
+	    return EXIT_JOB_TIMEOUT;
+	}
+	if(status.empty()) {
+	    std::cerr << "lost connection with the server" << std::endl;
+	    return EXIT_NO_SERVER;
+	}
+	return EXIT_JOB_ERROR;
+    }
+
+    void usage(const char* program) {
+	std::cerr << "usage: " << program
+		  << " [-t timeout] <socket> <script.lua|script.py>..."
+		  << std::endl
+		  << "       " << program << " <socket> quit"
+		  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    double timeout = 0.0;
+    int arg = 1;
+    if(arg+1 < argc && std::string(argv[arg]) == "-t") {
+	timeout = atof(argv[arg+1]);
+	arg += 2;
+    }
+    if(argc - arg < 2) {
+	usage(argv[0]);
+	return EXIT_JOB_ERROR;
+    }
+    std::string socket_path = argv[arg];
+    ++arg;
+
+    if(argc - arg == 1 && std::string(argv[arg]) == "quit") {
+	return run_job(socket_path, "quit", "", 0.0);
+    }
+
+    int result = EXIT_OK;
+    for(; arg < argc; ++arg) {
+	std::string filename = argv[arg];
+	size_t dot = filename.rfind('.');
+	std::string extension = (dot == std::string::npos) ?
+	    std::string("lua") : filename.substr(dot+1);
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if(!in) {
+	    std::cerr << filename << ": cannot open file" << std::endl;
+	    result = EXIT_JOB_ERROR;
+	    continue;
+	}
+	std::ostringstream source;
+	source << in.rdbuf();
+	ExitStatus status = run_job(socket_path, extension, source.str(), timeout);
+	if(status == EXIT_NO_SERVER) {
+	    return status;
+	}
+	if(status != EXIT_OK) {
+	    result = status;
+	}
+    }
+    return result;
+}
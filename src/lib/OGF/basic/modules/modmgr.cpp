@@ -37,11 +37,17 @@
 #include <OGF/basic/modules/modmgr.h>
 #include <OGF/basic/modules/module.h>
 #include <OGF/basic/os/file_manager.h>
+#include <OGF/basic/os/startup_profiler.h>
 #include <geogram/basic/file_system.h>
 
 #include <string>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <stdlib.h>
 #include <string.h>
 
@@ -174,6 +180,248 @@ namespace OGF {
 	memcpy(&result, &gptr, sizeof(void*));
 	return result;
     }
+
+    bool ModuleManager::defer_module(const std::string& module_name) {
+        std::string manifest_file_name = module_name + ".gom_manifest";
+        if(!FileManager::instance()->find_file(
+               manifest_file_name, false,
+               FileManager::instance()->libraries_subdirectory()
+        )) {
+            return false;
+        }
+        std::ifstream in(manifest_file_name.c_str());
+        if(!in) {
+            return false;
+        }
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        std::string line;
+        while(std::getline(in, line)) {
+            if(line.length() != 0 && line[line.length()-1] == '\r') {
+                line.resize(line.length()-1);
+            }
+            if(line.length() == 0 || line[0] == '#') {
+                continue;
+            }
+            deferred_classes_[line] = module_name;
+        }
+        read_registrations_cache(module_name);
+        deferred_modules_.push_back(module_name);
+        Logger::out("ModuleMgr") << "Deferred module: "
+                                 << module_name << std::endl;
+        return true;
+    }
+
+    bool ModuleManager::load_module_for_class(const std::string& class_name) {
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        auto it = deferred_classes_.find(class_name);
+        if(it == deferred_classes_.end()) {
+            return false;
+        }
+        std::string module_name = it->second;
+        return load_deferred_module(module_name);
+    }
+
+    bool ModuleManager::load_module_for_registration(
+        const std::string& kind, const std::string& name
+    ) {
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        auto it = deferred_registrations_.find(kind + " " + name);
+        if(it != deferred_registrations_.end()) {
+            std::string module_name = it->second;
+            return load_deferred_module(module_name);
+        }
+        // What the modules that were not recorded yet register is unknown,
+        // they need to be loaded (once, then their manifest is complete).
+        std::vector<std::string> unrecorded_modules;
+        for(const std::string& module_name : deferred_modules_) {
+            if(recorded_modules_.find(module_name) ==
+               recorded_modules_.end()) {
+                unrecorded_modules.push_back(module_name);
+            }
+        }
+        bool result = false;
+        for(const std::string& module_name : unrecorded_modules) {
+            if(load_deferred_module(module_name)) {
+                result = true;
+            }
+        }
+        return result;
+    }
+
+    void ModuleManager::record_registration(
+        const std::string& kind, const std::string& name
+    ) {
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        if(loading_modules_.empty()) {
+            return;
+        }
+        registrations_[loading_modules_.back()].insert(kind + " " + name);
+    }
+
+    void ModuleManager::load_deferred_modules() {
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        while(!deferred_modules_.empty()) {
+            std::string module_name = deferred_modules_.front();
+            load_deferred_module(module_name);
+        }
+    }
+
+    bool ModuleManager::load_module(
+        const std::string& module_name, bool quiet
+    ) {
+        // Locked during the whole loading, so that the registrations of
+        // the module are not attributed to a module loaded by another
+        // thread.
+        std::lock_guard<std::recursive_mutex> lock(deferred_mutex_);
+        loading_modules_.push_back(module_name);
+        registrations_[module_name].clear();
+        bool result = do_load_module(module_name, quiet);
+        loading_modules_.pop_back();
+        if(result) {
+            write_registrations_cache(module_name);
+        }
+        return result;
+    }
+
+    std::string ModuleManager::registrations_cache_file_name(
+        const std::string& module_name
+    ) const {
+        return FileSystem::home_directory() +
+            "/.graphite/module_registrations/" + module_name +
+            ".gom_registrations";
+    }
+
+    std::string ModuleManager::module_time_stamp(
+        const std::string& module_name
+    ) const {
+        std::string file_name = module_name;
+        if(!FileManager::instance()->find_binary_file(file_name, false)) {
+            return "";
+        }
+        return String::to_string(FileSystem::get_time_stamp(file_name));
+    }
+
+    void ModuleManager::read_registrations_cache(
+        const std::string& module_name
+    ) {
+        std::ifstream in(registrations_cache_file_name(module_name).c_str());
+        if(!in) {
+            return;
+        }
+        // The first line is the time stamp of the library that
+        // registered the following "kind name" lines.
+        std::string line;
+        if(
+            !std::getline(in, line) ||
+            line != "library " + module_time_stamp(module_name)
+        ) {
+            return;
+        }
+        while(std::getline(in, line)) {
+            if(line.length() != 0) {
+                deferred_registrations_[line] = module_name;
+            }
+        }
+        recorded_modules_.insert(module_name);
+    }
+
+    void ModuleManager::write_registrations_cache(
+        const std::string& module_name
+    ) {
+        std::string time_stamp = module_time_stamp(module_name);
+        if(time_stamp == "") {
+            return;
+        }
+        std::string content = "library " + time_stamp + "\n";
+        for(const std::string& registration : registrations_[module_name]) {
+            content += registration + "\n";
+        }
+        std::string file_name = registrations_cache_file_name(module_name);
+        {
+            std::ifstream in(file_name.c_str());
+            if(in) {
+                std::ostringstream old_content;
+                old_content << in.rdbuf();
+                if(old_content.str() == content) {
+                    return;
+                }
+            }
+        }
+        std::string dir_name = FileSystem::dir_name(file_name);
+        if(
+            !FileSystem::is_directory(dir_name) &&
+            !FileSystem::create_directory(dir_name)
+        ) {
+            return;
+        }
+        // Several Graphite processes may write the same file: each one
+        // writes its own temporary file, then renames it (atomic under
+        // POSIX systems).
+        static std::atomic<unsigned int> counter(0);
+        std::string tmp_file_name = file_name + String::format(
+            ".%llx_%u.tmp",
+            (unsigned long long)(
+                std::chrono::system_clock::now().time_since_epoch().count()
+            ),
+            (unsigned int)(counter++)
+        );
+        {
+            std::ofstream out(tmp_file_name.c_str());
+            if(!out) {
+                return;
+            }
+            out << content;
+            if(!out) {
+                out.close();
+                FileSystem::delete_file(tmp_file_name);
+                return;
+            }
+        }
+        if(
+            !FileSystem::rename_file(tmp_file_name, file_name) &&
+            !(FileSystem::delete_file(file_name) &&
+              FileSystem::rename_file(tmp_file_name, file_name))
+        ) {
+            // Under Windows, rename() fails if the file exists. If another
+            // process won the race, its content is as good as ours.
+            FileSystem::delete_file(tmp_file_name);
+            Logger::out("ModuleMgr")
+                << "Could not update " << file_name << std::endl;
+        }
+    }
+
+    bool ModuleManager::load_deferred_module(const std::string& module_name) {
+        // Forgotten before loading, because the module resolves its own
+        // classes while it is initialized.
+        deferred_modules_.erase(
+            std::remove(
+                deferred_modules_.begin(), deferred_modules_.end(),
+                module_name
+            ),
+            deferred_modules_.end()
+        );
+        for(auto it = deferred_classes_.begin();
+            it != deferred_classes_.end();
+        ) {
+            if(it->second == module_name) {
+                it = deferred_classes_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // Else a stale registration would load the module a second time.
+        for(auto it = deferred_registrations_.begin();
+            it != deferred_registrations_.end();
+        ) {
+            if(it->second == module_name) {
+                it = deferred_registrations_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        recorded_modules_.erase(module_name);
+        return load_module(module_name);
+    }
 }
 
 /******************************************************************************/
@@ -197,9 +445,11 @@ namespace OGF {
         }
     }
 
-    bool ModuleManager::load_module(
+    bool ModuleManager::do_load_module(
         const std::string& module_name, bool quiet
     ) {
+        // Includes the static initializers of the module.
+        StartupTimer timer("module", module_name);
         std::string module_file_name = module_name;
         
         if(! FileManager::instance()->find_binary_file(
@@ -386,9 +636,11 @@ namespace OGF {
         */
     }
 
-    bool ModuleManager::load_module(
+    bool ModuleManager::do_load_module(
         const std::string& module_name, bool quiet
     ) {
+        // Includes the static initializers of the module.
+        StartupTimer timer("module", module_name);
 	if(!quiet) {
 	    Logger::out("ModuleMgr") << "Loading module: "
 				     << module_name << std::endl;
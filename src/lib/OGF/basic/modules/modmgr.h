@@ -43,6 +43,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <mutex>
 
 
 /**
@@ -115,6 +117,80 @@ namespace OGF {
          */
         bool load_module(const std::string& module_name, bool quiet = false) ;
 
+        /**
+         * \brief Declares a dynamic module that is loaded the first time
+         *  one of its classes is used.
+         * \details Reads the manifest generated by gomgen with the names
+         *  of the GOM classes of the module (module_name.gom_manifest, in
+         *  the same directory as the dynamic library), and the file
+         *  extensions and languages that the module registered the last
+         *  time it was loaded, from the per-user cache (see
+         *  record_registration()). Then the module
+         *  is loaded by load_module_for_class() (called by Meta when a
+         *  class cannot be resolved), by load_module_for_registration()
+         *  or by load_deferred_modules().
+         * \param[in] module_name the name of the module, as in
+         *  load_module()
+         * \retval true if the manifest of the module was found
+         * \retval false otherwise. Then the module needs to be loaded
+         *  with load_module()
+         */
+        bool defer_module(const std::string& module_name) ;
+
+        /**
+         * \brief Loads the deferred module that provides a class.
+         * \param[in] class_name the name of the class, with its
+         *  namespace (e.g. "OGF::VoxelGrob")
+         * \retval true if a deferred module declares the class in its
+         *  manifest, and could be loaded
+         * \retval false otherwise
+         * \see defer_module()
+         */
+        bool load_module_for_class(const std::string& class_name) ;
+
+        /**
+         * \brief Loads the deferred module that registers a file extension
+         *  or a language.
+         * \details If no module recorded the registration, the deferred
+         *  modules whose registrations are not recorded (never loaded
+         *  since they were built) are loaded, the other ones are not.
+         * \param[in] kind the kind of registration, as in
+         *  record_registration()
+         * \param[in] name the registered name, e.g. "obj"
+         * \retval true if a module was loaded
+         * \retval false otherwise
+         * \see defer_module()
+         */
+        bool load_module_for_registration(
+            const std::string& kind, const std::string& name
+        ) ;
+
+        /**
+         * \brief Records a file extension or a language registered by the
+         *  module that is being loaded.
+         * \details Once the module is loaded, its registrations are
+         *  written in the per-user cache, so that the next time the module
+         *  is deferred, load_module_for_registration() can find it. They
+         *  are tagged with the time stamp of the dynamic library, and
+         *  ignored once it is rebuilt. Called
+         *  by SceneGraphLibrary and Interpreter, ignored when no module
+         *  is being loaded.
+         * \param[in] kind the kind of registration, one of
+         *  "file_extension" (files read by a Grob class), "language" and
+         *  "language_file_extension" (interpreters)
+         * \param[in] name the registered name
+         */
+        void record_registration(
+            const std::string& kind, const std::string& name
+        ) ;
+
+        /**
+         * \brief Loads all the modules declared by defer_module() that
+         *  are not loaded yet.
+         * \details Used when the list of all classes is needed.
+         */
+        void load_deferred_modules() ;
+
 
         /**
          * \brief Declares a Module object to the ModuleManager.
@@ -219,10 +295,114 @@ namespace OGF {
          */
         void do_terminate_modules() ;
 
+        /**
+         * \brief Loads a deferred module and forgets the classes and
+         *  the registrations that its manifest and cache declare.
+         * \details Needs to be called with deferred_mutex_ locked.
+         * \param[in] module_name the name of the module
+         * \retval true if the module could be loaded
+         * \retval false otherwise
+         */
+        bool load_deferred_module(const std::string& module_name) ;
+
+        /**
+         * \brief Loads a dynamic module.
+         * \details OS-dependent part of load_module().
+         * \param[in] module_name the name of the module
+         * \param[in] quiet if true, status messages are displayed
+         * \retval true if the module was successfully loaded
+         * \retval false otherwise
+         */
+        bool do_load_module(const std::string& module_name, bool quiet) ;
+
+        /**
+         * \brief Gets the file where the registrations of a module are
+         *  cached.
+         * \details The manifest generated by gomgen is left untouched
+         *  (it is rewritten when the module is rebuilt, and the directory
+         *  of the libraries may be shared or read-only).
+         * \param[in] module_name the name of the module
+         * \return the name of the file, in the home directory of the user
+         */
+        std::string registrations_cache_file_name(
+            const std::string& module_name
+        ) const ;
+
+        /**
+         * \brief Gets the time stamp of the dynamic library of a module.
+         * \details Used to invalidate the cached registrations when the
+         *  module is rebuilt.
+         * \param[in] module_name the name of the module
+         * \return the time stamp as a string, or an empty string if the
+         *  library was not found
+         */
+        std::string module_time_stamp(const std::string& module_name) const ;
+
+        /**
+         * \brief Reads the cached registrations of a deferred module.
+         * \details Ignores them if they were recorded for another build
+         *  of the module. Needs to be called with deferred_mutex_ locked.
+         * \param[in] module_name the name of the module
+         */
+        void read_registrations_cache(const std::string& module_name) ;
+
+        /**
+         * \brief Writes in the per-user cache the file extensions and
+         *  languages that a module registered while it was loaded.
+         * \details The cache file is written to a temporary file, then
+         *  renamed, so that concurrent Graphite processes never read a
+         *  partial file. Does nothing if its content did not change.
+         *  Needs to be called with deferred_mutex_ locked.
+         * \param[in] module_name the name of the module
+         */
+        void write_registrations_cache(const std::string& module_name) ;
+
     private:
         std::vector<ModuleTerminateFunc> to_terminate_ ;
         std::vector<void*> module_handles_ ;
         std::map<std::string, Module_var> modules_ ;
+
+        /**
+         * \brief Deferred modules that are not loaded yet, in the order
+         *  they were declared.
+         */
+        std::vector<std::string> deferred_modules_ ;
+
+        /**
+         * \brief Maps the name of a class to the deferred module that
+         *  provides it.
+         */
+        std::map<std::string, std::string> deferred_classes_ ;
+
+        /**
+         * \brief Maps "kind name" (e.g. "file_extension obj") to the
+         *  deferred module that registers it.
+         */
+        std::map<std::string, std::string> deferred_registrations_ ;
+
+        /**
+         * \brief The deferred modules whose registrations are
+         *  cached.
+         */
+        std::set<std::string> recorded_modules_ ;
+
+        /**
+         * \brief The modules being loaded, the last one is the one that
+         *  record_registration() attributes the registrations to.
+         */
+        std::vector<std::string> loading_modules_ ;
+
+        /**
+         * \brief The "kind name" registrations of the modules, recorded
+         *  while they were loaded.
+         */
+        std::map<std::string, std::set<std::string> > registrations_ ;
+
+        /**
+         * \brief Protects the deferred modules. Recursive because loading
+         *  a module can use classes of other deferred modules.
+         */
+        mutable std::recursive_mutex deferred_mutex_ ;
         static ModuleManager* instance_ ;
     } ;
 
@@ -0,0 +1,301 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ */
+
+#include <OGF/basic/os/startup_profiler.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/logger.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#ifdef GEO_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+    using namespace OGF;
+
+    /**
+     * \brief A step of the startup measured by a StartupTimer.
+     */
+    struct StartupStep {
+        std::string category;
+        std::string name;
+        std::string details;
+        index_t parent;
+        index_t count;
+        double start;
+        double elapsed;
+        double children_elapsed;
+        Numeric::int64 start_memory;
+        Numeric::int64 memory_delta;
+    };
+
+    std::mutex steps_lock;
+    std::vector<StartupStep> steps;
+    std::vector<index_t> open_steps;
+    std::string json_file_name;
+    double start_time = 0.0;
+    Numeric::int64 start_memory = 0;
+
+    /**
+     * \brief Gets the resident memory of the process.
+     * \return the resident memory in bytes under Linux, or the memory
+     *  used by the process as reported by Process::used_memory() on
+     *  other systems.
+     */
+    Numeric::int64 resident_memory() {
+#ifdef GEO_OS_LINUX
+        std::ifstream in("/proc/self/statm");
+        Numeric::int64 size = 0;
+        Numeric::int64 resident = 0;
+        if(in >> size >> resident) {
+            return resident * Numeric::int64(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return Numeric::int64(Process::used_memory());
+    }
+
+    /**
+     * \brief Converts a memory size to megabytes.
+     */
+    double to_MB(Numeric::int64 bytes) {
+        return double(bytes) / (1024.0 * 1024.0);
+    }
+
+    /**
+     * \brief Quotes and escapes a string for JSON.
+     */
+    std::string json_string(const std::string& str) {
+        std::ostringstream out;
+        out << '"';
+        for(char c : str) {
+            if(c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if((unsigned char)(c) < 32) {
+                out << "\\u" << std::hex << std::setw(4)
+                    << std::setfill('0') << int(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+        return out.str();
+    }
+
+    /**
+     * \brief Saves the measured steps as JSON.
+     * \param[in] filename the name of the file
+     * \param[in] order the indices of the steps, sorted by duration
+     * \param[in] total the total startup time, in seconds
+     * \param[in] memory the variation of the resident memory during
+     *  startup, in bytes
+     * \retval true if the file could be written
+     * \retval false otherwise
+     */
+    bool save_json(
+        const std::string& filename, const std::vector<index_t>& order,
+        double total, Numeric::int64 memory
+    ) {
+        std::ofstream out(filename.c_str());
+        if(!out) {
+            return false;
+        }
+        out << "{" << std::endl;
+        out << "  \"total_ms\": " << total * 1000.0 << "," << std::endl;
+        out << "  \"memory_delta_MB\": " << to_MB(memory) << ","
+            << std::endl;
+        out << "  \"steps\": [" << std::endl;
+        for(index_t i=0; i<order.size(); ++i) {
+            const StartupStep& step = steps[order[i]];
+            out << "    {"
+                << "\"category\": " << json_string(step.category) << ", "
+                << "\"name\": " << json_string(step.name) << ", "
+                << "\"details\": " << json_string(step.details) << ", "
+                << "\"parent\": " << (
+                    step.parent == NO_INDEX ? std::string("null") :
+                    json_string(steps[step.parent].name)
+                ) << ", "
+                << "\"count\": " << step.count << ", "
+                << "\"ms\": " << step.elapsed * 1000.0 << ", "
+                << "\"self_ms\": "
+                << (step.elapsed - step.children_elapsed) * 1000.0 << ", "
+                << "\"memory_delta_MB\": " << to_MB(step.memory_delta)
+                << "}" << (i+1 == order.size() ? "" : ",") << std::endl;
+        }
+        out << "  ]" << std::endl;
+        out << "}" << std::endl;
+        return true;
+    }
+}
+
+namespace OGF {
+
+    std::atomic<bool> StartupProfiler::enabled_(false);
+
+    void StartupProfiler::enable(const std::string& json_file_name_in) {
+        std::lock_guard<std::mutex> lock(steps_lock);
+        json_file_name = json_file_name_in;
+        start_time = Stopwatch::now();
+        start_memory = resident_memory();
+        enabled_ = true;
+    }
+
+    index_t StartupProfiler::begin(
+        const std::string& category, const std::string& name
+    ) {
+        std::lock_guard<std::mutex> lock(steps_lock);
+        index_t parent = open_steps.empty() ? NO_INDEX : open_steps.back();
+        index_t result = NO_INDEX;
+        for(index_t i=0; i<steps.size(); ++i) {
+            if(
+                steps[i].parent == parent &&
+                steps[i].category == category &&
+                steps[i].name == name
+            ) {
+                result = i;
+                break;
+            }
+        }
+        if(result == NO_INDEX) {
+            StartupStep step;
+            step.category = category;
+            step.name = name;
+            step.parent = parent;
+            step.count = 0;
+            step.elapsed = 0.0;
+            step.children_elapsed = 0.0;
+            step.memory_delta = 0;
+            steps.push_back(step);
+            result = index_t(steps.size()-1);
+        }
+        ++steps[result].count;
+        steps[result].start = Stopwatch::now();
+        steps[result].start_memory = resident_memory();
+        open_steps.push_back(result);
+        return result;
+    }
+
+    void StartupProfiler::end(index_t step_index) {
+        std::lock_guard<std::mutex> lock(steps_lock);
+        auto it = std::find(open_steps.begin(), open_steps.end(), step_index);
+        if(it == open_steps.end()) {
+            // finish() was called in-between
+            return;
+        }
+        open_steps.erase(it);
+        StartupStep& step = steps[step_index];
+        double elapsed = Stopwatch::now() - step.start;
+        step.elapsed += elapsed;
+        step.memory_delta += resident_memory() - step.start_memory;
+        if(step.parent != NO_INDEX) {
+            steps[step.parent].children_elapsed += elapsed;
+        }
+    }
+
+    void StartupProfiler::set_details(
+        index_t step_index, const std::string& details
+    ) {
+        std::lock_guard<std::mutex> lock(steps_lock);
+        if(step_index < steps.size()) {
+            steps[step_index].details = details;
+        }
+    }
+
+    void StartupProfiler::finish() {
+        if(!enabled_) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(steps_lock);
+        enabled_ = false;
+        open_steps.clear();
+        double total = Stopwatch::now() - start_time;
+        Numeric::int64 memory = resident_memory() - start_memory;
+
+        std::vector<index_t> order(steps.size());
+        std::iota(order.begin(), order.end(), index_t(0));
+        std::stable_sort(
+            order.begin(), order.end(),
+            [](index_t i, index_t j) {
+                return steps[i].elapsed > steps[j].elapsed;
+            }
+        );
+
+        Logger::out("Startup")
+            << "Total: " << total * 1000.0 << " ms, resident memory: "
+            << std::showpos << to_MB(memory) << std::noshowpos << " MB"
+            << std::endl;
+        for(index_t i : order) {
+            const StartupStep& step = steps[i];
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1)
+                 << std::setw(9) << step.elapsed * 1000.0 << " ms (self "
+                 << std::setw(8)
+                 << (step.elapsed - step.children_elapsed) * 1000.0
+                 << " ms) " << std::showpos << std::setw(8)
+                 << to_MB(step.memory_delta) << std::noshowpos << " MB  "
+                 << std::left << std::setw(12) << step.category
+                 << step.name;
+            if(step.count > 1) {
+                line << " (x" << step.count << ")";
+            }
+            if(step.details != "") {
+                line << ": " << step.details;
+            }
+            if(step.parent != NO_INDEX) {
+                line << " [in " << steps[step.parent].name << "]";
+            }
+            Logger::out("Startup") << line.str() << std::endl;
+        }
+
+        if(json_file_name != "") {
+            if(save_json(json_file_name, order, total, memory)) {
+                Logger::out("Startup") << "Saved report to "
+                                       << json_file_name << std::endl;
+            } else {
+                Logger::err("Startup") << "Could not save report to "
+                                       << json_file_name << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ */
+
+#ifndef H_OGF_BASIC_OS_STARTUP_PROFILER_H
+#define H_OGF_BASIC_OS_STARTUP_PROFILER_H
+
+#include <OGF/basic/common/common.h>
+
+#include <string>
+#include <atomic>
+
+/**
+ * \file OGF/basic/os/startup_profiler.h
+ * \brief Measures the time and memory taken by the steps of the
+ *  startup of Graphite.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief Records where the startup time goes.
+     * \details When enabled (graphite profile_startup=true), the
+     *  StartupTimer objects placed in the ModuleManager, in the GOM
+     *  package initialization, in the interpreters and in the Application
+     *  record their duration and the variation of the resident memory.
+     *  Nested timers are recorded as children of the enclosing one, and
+     *  timers with the same name and parent are merged. The report is
+     *  displayed and saved as JSON by finish(), called once startup is
+     *  complete (before the interactive loop, or after the first frame
+     *  of the GUI).
+     */
+    class BASIC_API StartupProfiler {
+    public:
+        /**
+         * \brief Starts recording.
+         * \param[in] json_file_name the name of the file where the report
+         *  is saved by finish(), or an empty string to only display it.
+         */
+        static void enable(const std::string& json_file_name);
+
+        /**
+         * \brief Tests whether the startup is being recorded.
+         * \retval true if enable() was called and finish() was not
+         *  called yet
+         * \retval false otherwise
+         */
+        static bool is_enabled() {
+            return enabled_;
+        }
+
+        /**
+         * \brief Starts measuring a step.
+         * \details Used by StartupTimer, client code is not supposed to
+         *  call this function directly.
+         * \param[in] category the kind of step ("module", "package",
+         *  "interpreter", "gui", ...)
+         * \param[in] name the name of the step
+         * \return an index to be passed to end()
+         */
+        static index_t begin(
+            const std::string& category, const std::string& name
+        );
+
+        /**
+         * \brief Stops measuring a step.
+         * \param[in] step the index returned by begin()
+         */
+        static void end(index_t step);
+
+        /**
+         * \brief Attaches a description to a step, displayed after its
+         *  name in the report.
+         * \param[in] step the index returned by begin()
+         * \param[in] details the description, e.g. what the step created.
+         *  Replaces the previous one.
+         */
+        static void set_details(index_t step, const std::string& details);
+
+        /**
+         * \brief Stops recording, displays the report sorted by duration
+         *  and saves it as JSON.
+         * \details Does nothing if not enabled or if already called.
+         */
+        static void finish();
+
+    private:
+        static std::atomic<bool> enabled_;
+    };
+
+    /**
+     * \brief Measures a step of the startup, from its construction to
+     *  its destruction.
+     * \details Does nothing if the StartupProfiler is not enabled.
+     */
+    class StartupTimer {
+    public:
+        /**
+         * \brief StartupTimer constructor.
+         * \param[in] category the kind of step
+         * \param[in] name the name of the step
+         * \see StartupProfiler::begin()
+         */
+        StartupTimer(const std::string& category, const std::string& name) :
+            step_(NO_INDEX) {
+            if(StartupProfiler::is_enabled()) {
+                step_ = StartupProfiler::begin(category, name);
+            }
+        }
+
+        /**
+         * \brief StartupTimer destructor.
+         * \details Records the duration of the step.
+         */
+        ~StartupTimer() {
+            if(step_ != NO_INDEX) {
+                StartupProfiler::end(step_);
+            }
+        }
+
+        /**
+         * \brief Attaches a description to the step.
+         * \param[in] details the description
+         * \see StartupProfiler::set_details()
+         */
+        void set_details(const std::string& details) {
+            if(step_ != NO_INDEX) {
+                StartupProfiler::set_details(step_, details);
+            }
+        }
+
+        /**
+         * \brief Forbids copy.
+         */
+        StartupTimer(const StartupTimer&) = delete;
+
+        /**
+         * \brief Forbids copy.
+         */
+        StartupTimer& operator=(const StartupTimer&) = delete;
+
+    private:
+        index_t step_;
+    };
+}
+
+#endif
@@ -44,9 +44,13 @@
 #include <OGF/gom/reflection/meta_slot.h>
 #include <OGF/gom/reflection/meta_signal.h>
 
+#include <cctype>
+
 namespace OGF {
 
-    GomCodeGenerator::GomCodeGenerator() : out_(nullptr) {
+    GomCodeGenerator::GomCodeGenerator() :
+        out_(nullptr),
+        static_tables_(false) {
         pass_by_value_.insert("int");
         pass_by_value_.insert("unsigned int");
         pass_by_value_.insert("long");
@@ -94,6 +98,153 @@ namespace OGF {
 #endif
     }
 
+    void GomCodeGenerator::generate_header(
+        std::ostream& out_in,
+        std::vector<MetaClass*> classes,
+        const std::string& package_name,
+        const std::string& header
+    ) {
+        to_generate_.clear();
+        sorted_.clear();
+        out_ = &out_in;
+        package_name_ = package_name;
+        for(unsigned int i=0; i<classes.size(); i++) {
+            if(class_header(classes[i]) == header) {
+                to_generate_.insert(classes[i]);
+            }
+        }
+        while(to_generate_.size() != 0) {
+            MetaClass* cur = *(to_generate_.begin());
+            generate(cur);
+        }
+
+        // The base classes declared in other headers of the package
+        // need to be declared first (the headers of the package are
+        // initialized in arbitrary order).
+        std::set<std::string> base_headers;
+        for(unsigned int i=0; i<sorted_.size(); i++) {
+            MetaClass* base_class = sorted_[i]->super_class();
+            if(
+                base_class != nullptr &&
+                base_class->has_custom_attribute("package") &&
+                base_class->custom_attribute_value("package") ==
+                package_name &&
+                class_header(base_class) != "" &&
+                class_header(base_class) != header
+            ) {
+                base_headers.insert(class_header(base_class));
+            }
+        }
+
+#ifndef GEO_OS_WINDOWS
+        out() << "namespace OGF {" << std::endl;
+#endif
+        for(auto& it : base_headers) {
+            out() << "   void "
+                  << header_initializer_name(package_name, it)
+                  << "();" << std::endl;
+        }
+        out() << "   void "
+              << header_initializer_name(package_name, header)
+              << "() {" << std::endl;
+        out() << "      static bool initialized = false;" << std::endl;
+        out() << "      if(initialized) {" << std::endl;
+        out() << "         return;" << std::endl;
+        out() << "      }" << std::endl;
+        out() << "      initialized = true;" << std::endl;
+        for(auto& it : base_headers) {
+            out() << "      "
+                  << header_initializer_name(package_name, it)
+                  << "();" << std::endl;
+        }
+        for(unsigned int i=0; i<sorted_.size(); i++) {
+            out() << "      OGF::"
+                  << "gom_class_initialize_"
+                  << colons_to_underscores(sorted_[i]->name())
+                  << "();" << std::endl;
+        }
+        out() << "   }" << std::endl;
+#ifndef GEO_OS_WINDOWS
+        out() << "}" << std::endl;
+#endif
+    }
+
+    void GomCodeGenerator::get_header_includes(
+        const std::vector<MetaClass*>& classes,
+        const std::string& header, std::set<std::string>& includes
+    ) {
+        includes.clear();
+        includes.insert(header);
+        for(unsigned int i=0; i<classes.size(); i++) {
+            if(class_header(classes[i]) != header) {
+                continue;
+            }
+            std::set<std::string> used_types;
+            classes[i]->get_used_types(used_types, false);
+            for(auto& it : used_types) {
+                std::string class_name = it;
+                while(
+                    class_name.length() != 0 &&
+                    class_name[class_name.length()-1] == '*'
+                ) {
+                    class_name = class_name.substr(0, class_name.length()-1);
+                }
+                MetaClass* used_class =
+                    Meta::instance()->resolve_meta_class(class_name);
+                if(used_class != nullptr) {
+                    std::string used_header = class_header(used_class);
+                    if(used_header != "") {
+                        includes.insert(used_header);
+                    }
+                }
+            }
+        }
+    }
+
+    void GomCodeGenerator::generate_package_registration(
+        std::ostream& out_in, const std::string& package_name,
+        const std::vector<std::string>& headers
+    ) {
+        out_ = &out_in;
+#ifndef GEO_OS_WINDOWS
+        out() << "namespace OGF {" << std::endl;
+#endif
+        for(unsigned int i=0; i<headers.size(); i++) {
+            out() << "   void "
+                  << header_initializer_name(package_name, headers[i])
+                  << "();" << std::endl;
+        }
+        out() << std::endl;
+        out() << "   void gom_package_initialize_"
+              << package_name << "() {" << std::endl;
+        for(unsigned int i=0; i<headers.size(); i++) {
+            out() << "      "
+                  << header_initializer_name(package_name, headers[i])
+                  << "();" << std::endl;
+        }
+        out() << "   }" << std::endl;
+#ifndef GEO_OS_WINDOWS
+        out() << "}" << std::endl;
+#endif
+    }
+
+    std::string GomCodeGenerator::header_initializer_name(
+        const std::string& package_name, const std::string& header
+    ) {
+        std::string result = "gom_header_initialize_" + package_name + "__";
+        for(char c : header) {
+            result.push_back(isalnum(static_cast<unsigned char>(c)) ? c : '_');
+        }
+        return result;
+    }
+
+    std::string GomCodeGenerator::class_header(const MetaClass* mclass) {
+        if(!mclass->has_custom_attribute("file")) {
+            return "";
+        }
+        return mclass->custom_attribute_value("file");
+    }
+
     void GomCodeGenerator::generate(MetaClass* type) {
 
         MetaClass* base_class = type->super_class();
@@ -191,6 +342,7 @@ namespace OGF {
                 generate_method_adapter_arglist(mslot);
             } else {
                 generate_method_adapter(mslot);
+                generate_typed_method_adapter(mslot);
             }
         }
 
@@ -219,6 +371,10 @@ namespace OGF {
             generate_signal_adapter(meta_signals[i]);
         }
 
+        if(static_tables_) {
+            generate_class_table(mclass, used_types);
+            return;
+        }
 
         out() << "void " << "gom_class_initialize_"
               << colons_to_underscores(mclass->name()) << "() {"
@@ -228,23 +384,7 @@ namespace OGF {
               << "*>(" << stringify(mclass->name() + "*" ) << ");"
               << std::endl;
 
-        for(auto& it : used_types) {
-
-            MetaType* cur_type = Meta::instance()->resolve_meta_type(it);
-
-            MetaEnum* cur_enum = dynamic_cast<MetaEnum*>(cur_type);
-            if(cur_enum != nullptr) {
-                generate_enum(cur_enum);
-                continue;
-            }
-            MetaBuiltinType* cur_builtin = dynamic_cast<MetaBuiltinType*>(
-                cur_type
-            );
-            if(cur_builtin != nullptr) {
-                generate_builtin(cur_builtin);
-                continue;
-            }
-        }
+        generate_used_types(used_types);
 
         if(
             mclass->nb_members(false) != 0 ||
@@ -382,6 +522,13 @@ namespace OGF {
             out() << "      cur_slot->set_method_adapter(" << std::endl
                   << "         " << method_adapter_name(slot) << std::endl
                   << "      );" << std::endl;
+            if(has_typed_method_adapter(slot)) {
+                out() << "      cur_slot->set_typed_method_adapter("
+                      << std::endl
+                      << "         " << typed_method_adapter_ref(slot)
+                      << std::endl
+                      << "      );" << std::endl;
+            }
 
             generate_attributes(slot, "cur_slot");
 
@@ -430,6 +577,228 @@ namespace OGF {
         out() <<"}" << std::endl;
     }
 
+    void GomCodeGenerator::generate_used_types(
+        const std::set<std::string>& used_types
+    ) {
+        for(auto& it : used_types) {
+
+            MetaType* cur_type = Meta::instance()->resolve_meta_type(it);
+
+            MetaEnum* cur_enum = dynamic_cast<MetaEnum*>(cur_type);
+            if(cur_enum != nullptr) {
+                generate_enum(cur_enum);
+                continue;
+            }
+            MetaBuiltinType* cur_builtin = dynamic_cast<MetaBuiltinType*>(
+                cur_type
+            );
+            if(cur_builtin != nullptr) {
+                generate_builtin(cur_builtin);
+                continue;
+            }
+        }
+    }
+
+    void GomCodeGenerator::generate_class_table(
+        MetaClass* mclass, const std::set<std::string>& used_types
+    ) {
+        std::string cname = colons_to_underscores(mclass->name());
+
+        // The function that declares the class, called the first time
+        // the class is resolved.
+        out() << "static MetaClass* gom_class_declare_" << cname << "() {"
+              << std::endl;
+        out() << "   " << "ogf_declare_pointer_type<" << mclass->name()
+              << "*>(" << stringify(mclass->name() + "*" ) << ");"
+              << std::endl;
+        generate_used_types(used_types);
+        out() << "   return ";
+        if(mclass->is_abstract()) {
+            out() << "ogf_declare_abstract_class<";
+        } else {
+            out() << "ogf_declare_class<";
+        }
+        out() << mclass->name() << ">(" << stringify(mclass->name());
+        if(mclass->super_class() != nullptr) {
+            out() << ", " << stringify(mclass->super_class()->name());
+        }
+        out() << ");" << std::endl;
+        out() << "}" << std::endl;
+        out() << std::endl;
+
+        // Same order as in the default mode (constructors, properties,
+        // slots, signals).
+        std::vector<MetaMember*> members;
+        std::vector<MetaConstructor*> meta_constructors;
+        mclass->get_constructors(meta_constructors);
+        members.insert(
+            members.end(), meta_constructors.begin(), meta_constructors.end()
+        );
+        std::vector<MetaProperty*> meta_properties;
+        mclass->get_properties(meta_properties, false);
+        members.insert(
+            members.end(), meta_properties.begin(), meta_properties.end()
+        );
+        std::vector<MetaSlot*> meta_slots;
+        mclass->get_slots(meta_slots, false);
+        members.insert(members.end(), meta_slots.begin(), meta_slots.end());
+        std::vector<MetaSignal*> meta_signals;
+        mclass->get_signals(meta_signals, false);
+        members.insert(
+            members.end(), meta_signals.begin(), meta_signals.end()
+        );
+
+        for(index_t i=0; i<members.size(); ++i) {
+            std::string member_id = cname + "_" + String::to_string(i);
+            generate_attributes_table(members[i], member_id);
+            MetaMethod* method = dynamic_cast<MetaMethod*>(members[i]);
+            if(method != nullptr && method->nb_args() != 0) {
+                for(index_t j=0; j<method->nb_args(); ++j) {
+                    generate_attributes_table(
+                        method->ith_arg(j),
+                        member_id + "_" + String::to_string(j)
+                    );
+                }
+                out() << "static const MetaArgTable gom_args_"
+                      << member_id << "[] = {" << std::endl;
+                for(index_t j=0; j<method->nb_args(); ++j) {
+                    const MetaArg* arg = method->ith_arg(j);
+                    std::string arg_id = 
+                        member_id + "_" + String::to_string(j);
+                    out() << "   { " << stringify(arg->name()) << ", "
+                          << stringify(arg->type_name()) << ", ";
+                    if(arg->has_default_value()) {
+                        out() << "[](Any& gom__value__) { "
+                              << "gom__value__.set_value("
+                              << stringify_default_value(arg) << "); }";
+                    } else {
+                        out() << "nullptr";
+                    }
+                    out() << ", " << attributes_table_ref(arg, arg_id)
+                          << " }," << std::endl;
+                }
+                out() << "};" << std::endl;
+                out() << std::endl;
+            }
+        }
+
+        if(members.size() != 0) {
+            out() << "static const MetaMemberTable gom_members_" << cname
+                  << "[] = {" << std::endl;
+            for(index_t i=0; i<members.size(); ++i) {
+                std::string member_id = cname + "_" + String::to_string(i);
+                MetaMember* member = members[i];
+                MetaMethod* method = dynamic_cast<MetaMethod*>(member);
+                MetaProperty* prop = dynamic_cast<MetaProperty*>(member);
+                out() << "   { ";
+                if(dynamic_cast<MetaConstructor*>(member) != nullptr) {
+                    out() << "GOM_MEMBER_CONSTRUCTOR, "
+                          << stringify(member->name()) << ", nullptr, false, "
+                          << "nullptr, nullptr, "
+                          << "[]() -> Factory* { return new "
+                          << factory_name(
+                              dynamic_cast<MetaConstructor*>(member)
+                          )
+                          << "(); }, ";
+                } else if(prop != nullptr) {
+                    out() << "GOM_MEMBER_PROPERTY, "
+                          << stringify(prop->name()) << ", "
+                          << stringify(prop->type_name()) << ", "
+                          << (prop->read_only() ? "true" : "false") << ", "
+                          << method_adapter_name(prop->meta_method_get())
+                          << ", ";
+                    if(prop->read_only()) {
+                        out() << "nullptr, ";
+                    } else {
+                        out() << method_adapter_name(prop->meta_method_set())
+                              << ", ";
+                    }
+                    out() << "nullptr, ";
+                } else if(dynamic_cast<MetaSlot*>(member) != nullptr) {
+                    out() << "GOM_MEMBER_SLOT, "
+                          << stringify(method->name()) << ", "
+                          << stringify(method->return_type_name()) << ", "
+                          << "false, "
+                          << method_adapter_name(method) << ", "
+                          << "nullptr, nullptr, ";
+                } else {
+                    out() << "GOM_MEMBER_SIGNAL, "
+                          << stringify(member->name()) << ", nullptr, false, "
+                          << "nullptr, nullptr, nullptr, ";
+                }
+                if(method != nullptr && method->nb_args() != 0) {
+                    out() << "gom_args_" << member_id << ", "
+                          << method->nb_args() << ", ";
+                } else {
+                    out() << "nullptr, 0, ";
+                }
+                out() << attributes_table_ref(member, member_id);
+                if(
+                    dynamic_cast<MetaSlot*>(member) != nullptr &&
+                    has_typed_method_adapter(method)
+                ) {
+                    out() << ", " << typed_method_adapter_ref(method);
+                } else {
+                    out() << ", nullptr, nullptr";
+                }
+                out() << " }," << std::endl;
+            }
+            out() << "};" << std::endl;
+            out() << std::endl;
+        }
+
+        generate_attributes_table(mclass, cname);
+
+        out() << "static const MetaClassTable gom_class_table_" << cname
+              << " = {" << std::endl;
+        out() << "   " << stringify(mclass->name()) << ", "
+              << "&typeid(" << mclass->name() << "), "
+              << "&typeid(" << mclass->name() << "*), " << std::endl;
+        out() << "   gom_class_declare_" << cname << ", ";
+        if(members.size() != 0) {
+            out() << "gom_members_" << cname << ", " << members.size();
+        } else {
+            out() << "nullptr, 0";
+        }
+        out() << ", " << attributes_table_ref(mclass, cname) << std::endl;
+        out() << "};" << std::endl;
+        out() << std::endl;
+
+        out() << "void " << "gom_class_initialize_" << cname << "() {"
+              << std::endl;
+        out() << "   Meta::instance()->declare_meta_class_table("
+              << "&gom_class_table_" << cname << ");" << std::endl;
+        out() << "}" << std::endl;
+    }
+
+    void GomCodeGenerator::generate_attributes_table(
+        const CustomAttributes* info, const std::string& id
+    ) {
+        if(info->nb_custom_attributes() == 0) {
+            return;
+        }
+        out() << "static const MetaAttributeTable gom_attributes_" << id
+              << "[] = {" << std::endl;
+        for(index_t i=0; i<info->nb_custom_attributes(); i++) {
+            out() << "   { "
+                  << stringify(info->ith_custom_attribute_name(i)) << ", "
+                  << stringify(info->ith_custom_attribute_value(i))
+                  << " }," << std::endl;
+        }
+        out() << "};" << std::endl;
+        out() << std::endl;
+    }
+
+    std::string GomCodeGenerator::attributes_table_ref(
+        const CustomAttributes* info, const std::string& id
+    ) {
+        if(info->nb_custom_attributes() == 0) {
+            return "nullptr, 0";
+        }
+        return "gom_attributes_" + id + ", " +
+            String::to_string(info->nb_custom_attributes());
+    }
+
     void GomCodeGenerator::generate_method_adapter_arglist(
         MetaMethod* method
     ) {
@@ -463,7 +832,7 @@ namespace OGF {
 
         if(method->return_type_name() != "void") {
             out() << "   gom__result_any__.set_value("
-                  << "gom__result__);"
+                  << "std::move(gom__result__));"
                   << std::endl;
 	    out() << "   return true;" << std::endl;
         } else {
@@ -494,6 +863,10 @@ namespace OGF {
         out() << "   if(gom__target__ == nullptr) { return false; }"
               << std::endl;
 
+        if(method->nb_args() != 0) {
+            generate_method_adapter_positional(method);
+        }
+
         for(index_t i=0; i<method->nb_args(); i++) {
             const MetaArg* arg = method->ith_arg(i);
             std::string name = arg->name();
@@ -524,7 +897,7 @@ namespace OGF {
 
         if(method->return_type_name() != "void") {
             out() << "   gom__result_any__.set_value("
-                  << "gom__result__);"
+                  << "std::move(gom__result__));"
                   << std::endl;
 	    out() << "   return true;" << std::endl;
         } else {
@@ -535,6 +908,90 @@ namespace OGF {
         out() << std::endl;
     }
 
+    void GomCodeGenerator::generate_method_adapter_positional(
+        MetaMethod* method
+    ) {
+        // Fast path, taken when all the arguments are given in declaration
+        // order with the exact types: they are passed by reference to the
+        // method, without any name lookup nor conversion. Else we fallback
+        // to the generic path (get_arg<T>() by name, with conversions).
+        out() << "   if(" << std::endl;
+        out() << "      gom__args__.nb_args() == " << method->nb_args();
+        for(index_t i=0; i<method->nb_args(); i++) {
+            const MetaArg* arg = method->ith_arg(i);
+            out() << " &&" << std::endl
+                  << "      gom__args__.ith_arg_has_type<"
+                  << arg->type()->name() << ">("
+                  << i << "," << stringify(arg->name()) << ")";
+        }
+        out() << std::endl << "   ) {" << std::endl;
+
+        out() << "      ";
+        if(method->return_type_name() != "void") {
+            out() << method->return_type()->name() << " "
+                  << " gom__result__ = ";
+        }
+        out() << "gom__target__->" << method->name() << "(" << std::endl;
+        for(index_t i=0; i<method->nb_args(); i++) {
+            const MetaArg* arg = method->ith_arg(i);
+            out() << "         gom__args__.ith_arg_value_ref<"
+                  << arg->type()->name() << ">(" << i << ")";
+            if(i < method->nb_args() - 1) {
+                out() << ",";
+            }
+            out() << std::endl;
+        }
+        out() << "      );" << std::endl;
+        if(method->return_type_name() != "void") {
+            out() << "      gom__result_any__.set_value("
+                  << "std::move(gom__result__));"
+                  << std::endl;
+        }
+        out() << "      return true;" << std::endl;
+        out() << "   }" << std::endl;
+    }
+
+    void GomCodeGenerator::generate_typed_method_adapter(MetaMethod* method) {
+        out() << "static void " << typed_method_adapter_name(method)
+              << "(" << std::endl
+              << "   Object* gom__target_in__";
+        for(index_t i=0; i<method->nb_args(); i++) {
+            const MetaArg* arg = method->ith_arg(i);
+            out() << "," << std::endl
+                  << "   " << arg->type()->name() << " const& "
+                  << arg->name();
+        }
+        out() << std::endl << ") {" << std::endl;
+
+        out() << "   " << method->container_meta_class()->name()
+              << "* gom__target__ = "
+              << "dynamic_cast<" << method->container_meta_class()->name()
+              << "*>(" << std::endl
+              << "      gom__target_in__" << std::endl
+              << "   );" << std::endl;
+
+        out() << "   if(gom__target__ == nullptr) { return; }"
+              << std::endl;
+
+        out() << "   gom__target__->" << method->name() << "(";
+        for(index_t i=0; i<method->nb_args(); i++) {
+            out() << method->ith_arg(i)->name();
+            if(i < method->nb_args() - 1) {
+                out() << ", ";
+            }
+        }
+        out() << ");" << std::endl;
+        out() << "}" << std::endl;
+        out() << std::endl;
+    }
+
+    bool GomCodeGenerator::has_typed_method_adapter(MetaMethod* method) {
+        return !(
+            method->nb_args() == 1 &&
+            method->ith_arg(0)->type_name() == "OGF::ArgList"
+        );
+    }
+
     void GomCodeGenerator::generate_signal_adapter(MetaSignal* signal) {
         out() << "void "
               << signal->container_meta_class()->name()
@@ -554,18 +1011,43 @@ namespace OGF {
             }
         }
         out() << ") {" << std::endl;
-        out() << "   ArgList gom__args__;" << std::endl;
+        // The signal index is resolved once. The connected slots with
+        // the same arguments are directly called by their typed method
+        // adapter, the argument list is only built for the other ones.
+        out() << "   static const index_t gom__signal__ = "
+              << "Object::signal_index("
+              << stringify(signal->name()) << ");" << std::endl;
+        out() << "   ConnectionList* gom__connections__ = "
+              << "connected_slots(gom__signal__);" << std::endl;
+        out() << "   if(gom__connections__ == nullptr) {" << std::endl;
+        out() << "      return;" << std::endl;
+        out() << "   }" << std::endl;
+        out() << "   gom__connections__->invoke_typed<";
+        for(index_t i=0; i<signal->nb_args(); i++) {
+            out() << signal->ith_arg(i)->type()->name();
+            if(i < signal->nb_args() - 1) {
+                out() << ", ";
+            }
+        }
+        out() << ">(" << std::endl;
+        out() << "      [&](ArgList& gom__args__) {" << std::endl;
         for(index_t i=0; i<signal->nb_args(); i++) {
             const MetaArg* arg = signal->ith_arg(i);
             std::string name = arg->name();
-            out() << "   gom__args__.create_arg("
+            out() << "         gom__args__.create_arg("
                   << stringify(name)
                   << "," << name
                   << ");" << std::endl;
         }
-        out() << "   emit_signal("
-              << stringify(signal->name())
-              << ", gom__args__);" << std::endl;
+        if(signal->nb_args() == 0) {
+            out() << "         geo_argused(gom__args__);" << std::endl;
+        }
+        out() << "      }";
+        for(index_t i=0; i<signal->nb_args(); i++) {
+            out() << "," << std::endl
+                  << "      " << signal->ith_arg(i)->name();
+        }
+        out() << std::endl << "   );" << std::endl;
         out() << "}" << std::endl;
         out() << std::endl;
     }
@@ -682,6 +1164,20 @@ namespace OGF {
             "__" + method->name() + "__";
     }
 
+    std::string GomCodeGenerator::typed_method_adapter_name(
+        MetaMethod* method
+    ) {
+        return method_adapter_name(method) + "typed__";
+    }
+
+    std::string GomCodeGenerator::typed_method_adapter_ref(
+        MetaMethod* method
+    ) {
+        std::string name = typed_method_adapter_name(method);
+        return "reinterpret_cast<gom_typed_method_adapter>(" + name + "), " +
+            "&typeid(&" + name + ")";
+    }
+
     std::string GomCodeGenerator::factory_name(MetaConstructor* method) {
         return "GOM__" +
             colons_to_underscores(method->container_meta_class()->name()) +
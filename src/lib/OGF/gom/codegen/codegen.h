@@ -98,8 +98,97 @@ namespace OGF {
             const std::string& package_name
         );
 
+        /**
+         * \brief Generates C++ code to create the Meta information
+         *  and adapters for the classes declared in a single header.
+         * \details Used by gomgen to generate one translation unit per
+         *  header, so that modifying a header only regenerates and
+         *  recompiles the code of the classes it declares. The generated
+         *  code defines the function named by header_initializer_name(),
+         *  called by the code generated by generate_package_registration().
+         *  It first calls the initialization functions of the headers that
+         *  declare the base classes, so that the headers can be initialized
+         *  in any order.
+         * \param[out] out a reference to the stream that will
+         *  receive the generated C++ code
+         * \param[in] classes the list of parsed classes, specified as a
+         *  vector of pointers to MetaClass objects. Only the ones declared
+         *  in \p header are generated.
+         * \param[in] package_name the name of the package
+         * \param[in] header the header, relative to the include path
+         *  (e.g., "OGF/scene_graph/grob/grob.h")
+         */
+        void generate_header(
+            std::ostream& out, std::vector<MetaClass*> classes,
+            const std::string& package_name, const std::string& header
+        );
+
+        /**
+         * \brief Gets the headers to be included by the code generated
+         *  by generate_header().
+         * \details These are \p header and the headers that declare the
+         *  classes used by the members of the classes declared in
+         *  \p header.
+         * \param[in] classes the list of parsed classes
+         * \param[in] header the header, relative to the include path
+         * \param[out] includes the headers to be included
+         */
+        void get_header_includes(
+            const std::vector<MetaClass*>& classes,
+            const std::string& header, std::set<std::string>& includes
+        );
+
+        /**
+         * \brief Generates the package initialization function that calls
+         *  the initialization functions of all the headers.
+         * \param[out] out a reference to the stream that will
+         *  receive the generated C++ code
+         * \param[in] package_name the name of the package
+         * \param[in] headers all the headers of the package, relative to
+         *  the include path
+         * \see generate_header()
+         */
+        void generate_package_registration(
+            std::ostream& out, const std::string& package_name,
+            const std::vector<std::string>& headers
+        );
+
+        /**
+         * \brief Gets the name of the initialization function generated
+         *  for a header.
+         * \param[in] package_name the name of the package
+         * \param[in] header the header, relative to the include path
+         * \return the name of the function
+         */
+        static std::string header_initializer_name(
+            const std::string& package_name, const std::string& header
+        );
+
+        /**
+         * \brief Selects the static tables mode.
+         * \details In static tables mode, the meta-information of each
+         *  class is generated as constant tables (names, signatures,
+         *  custom attributes and adapters), registered at initialization
+         *  and only materialized as a MetaClass the first time the class
+         *  is resolved. In the default mode, all the MetaClasses are
+         *  created at initialization.
+         * \param[in] x true to generate static tables, false otherwise
+         * \see MetaClassTable, Meta::declare_meta_class_table()
+         */
+        void set_static_tables(bool x) {
+            static_tables_ = x;
+        }
+
     protected:
 
+        /**
+         * \brief Gets the header where a class is declared.
+         * \param[in] mclass a pointer to the MetaClass
+         * \return the header, relative to the include path, or an empty
+         *  string if unknown
+         */
+        static std::string class_header(const MetaClass* mclass);
+
         /**
          * \brief Generates C++ code that creates the meta information 
          *  associated with a class.
@@ -139,6 +228,50 @@ namespace OGF {
          */
         void generate_class(MetaClass* mclass);
 
+        /**
+         * \brief Generates C++ code that declares the builtin types and
+         *  enums used by a class.
+         * \param[in] used_types the names of the types used by the class
+         */
+        void generate_used_types(const std::set<std::string>& used_types);
+
+        /**
+         * \brief Generates the constant table that describes a class,
+         *  in static tables mode.
+         * \details C++ code is generated in the stream returned by out().
+         *  The method adapters, factories and signal adapters are supposed
+         *  to be already generated.
+         * \param[in] mclass pointer to the MetaClass
+         * \param[in] used_types the names of the types used by the class
+         * \see set_static_tables()
+         */
+        void generate_class_table(
+            MetaClass* mclass, const std::set<std::string>& used_types
+        );
+
+        /**
+         * \brief Generates the constant table with the custom attributes
+         *  of a language construct, in static tables mode.
+         * \details Nothing is generated if there is no custom attribute.
+         * \param[in] info pointer to an object that inherits CustomAttributes
+         * \param[in] id a unique identifier used to name the table
+         */
+        void generate_attributes_table(
+            const CustomAttributes* info, const std::string& id
+        );
+
+        /**
+         * \brief Gets the pointer and size of a table generated by
+         *  generate_attributes_table().
+         * \param[in] info pointer to an object that inherits CustomAttributes
+         * \param[in] id the identifier used to name the table
+         * \return the C++ code for the pointer and size, separated by a
+         *  comma
+         */
+        std::string attributes_table_ref(
+            const CustomAttributes* info, const std::string& id
+        );
+
         /**
          * \brief Generates a method adapter.
          * \details C++ code is generated in the stream returned by out(). 
@@ -156,6 +289,38 @@ namespace OGF {
          */
         void generate_method_adapter_arglist(MetaMethod* method);
 
+        /**
+         * \brief Generates the positional fast path of a method adapter.
+         * \details The generated code directly forwards the arguments to
+         *  the method if they are given in declaration order with the
+         *  exact types, else the generic by-name path is used.
+         *  C++ code is generated in the stream returned by out().
+         * \param[in] method a pointer to the MetaMethod
+         * \see generate_method_adapter()
+         */
+        void generate_method_adapter_positional(MetaMethod* method);
+
+        /**
+         * \brief Generates the typed method adapter of a slot.
+         * \details The generated function directly calls the slot with
+         *  its arguments, without any ArgList. It is used by the signal
+         *  adapters when the slot is connected to a signal with the same
+         *  arguments (see SlotConnection).
+         *  C++ code is generated in the stream returned by out().
+         * \param[in] method a pointer to the MetaMethod
+         * \see has_typed_method_adapter(), gom_typed_method_adapter
+         */
+        void generate_typed_method_adapter(MetaMethod* method);
+
+        /**
+         * \brief Tests whether a typed method adapter is generated for
+         *  a method.
+         * \param[in] method a pointer to the MetaMethod
+         * \retval true if \p method does not take an ArgList
+         * \retval false otherwise
+         */
+        static bool has_typed_method_adapter(MetaMethod* method);
+
         /**
          * \brief Generates a signal adapter.
          * \details C++ code is generated in the stream returned by out(). 
@@ -226,6 +391,23 @@ namespace OGF {
          */
         std::string method_adapter_name(MetaMethod* method);
 
+        /**
+         * \brief Generates a C++ name for a typed method adapter from
+         *  a MetaMethod.
+         * \param[in] method a pointer to the MetaMethod
+         * \return a valid and unique C++ name for a typed method adapter
+         */
+        std::string typed_method_adapter_name(MetaMethod* method);
+
+        /**
+         * \brief Generates the C++ expressions that cast a typed method
+         *  adapter to a gom_typed_method_adapter and get its actual type.
+         * \param[in] method a pointer to the MetaMethod
+         * \return the two expressions, separated by a comma, as expected
+         *  by MetaMethod::set_typed_method_adapter()
+         */
+        std::string typed_method_adapter_ref(MetaMethod* method);
+
         /**
          * \brief Generates a C++ name for a factory from
          *  a MetaMethod.
@@ -262,6 +444,7 @@ namespace OGF {
         std::set<MetaClass*> to_generate_;
         std::vector<MetaClass*> sorted_;
         std::string package_name_;
+        bool static_tables_;
     };
     
 }
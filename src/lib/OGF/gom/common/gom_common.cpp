@@ -38,6 +38,7 @@
 #include <OGF/gom/common/common.h>
 #include <OGF/gom/types/gom.h>
 #include <OGF/gom/types/gom_implementation.h>
+#include <OGF/gom/services/converter.h>
 #include <OGF/gom/interpreter/interpreter.h>
 #include <OGF/basic/modules/module.h>
 #include <geogram/basic/geometry.h>
@@ -127,6 +128,8 @@ namespace OGF {
 	ogf_declare_builtin_type<mat3>("OGF::mat3");
 	ogf_declare_builtin_type<mat4>("OGF::mat4");
 
+	Converters::initialize();
+
         //_____________________________________________________________
 
         Module* module_info = new Module ;
@@ -145,6 +148,7 @@ namespace OGF {
 
         //_____________________________________________________________
 
+        Converters::terminate();
         Meta::terminate();
 	Interpreter::terminate();
 
@@ -43,8 +43,11 @@
 #include <OGF/basic/modules/modmgr.h>
 
 #include <geogram/basic/file_system.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/stopwatch.h>
 
 #include <fstream>
+#include <atomic>
 
 namespace OGF {
 
@@ -75,6 +78,13 @@ namespace OGF {
 	instance->set_filename_extension(extension);
         instance_[language] = instance;
 	instance_by_file_extension_[extension] = instance;
+	ModuleManager* module_manager = ModuleManager::instance();
+	if(module_manager != nullptr) {
+	    module_manager->record_registration("language", language);
+	    module_manager->record_registration(
+		"language_file_extension", extension
+	    );
+	}
     }
 
     void Interpreter::terminate(
@@ -360,6 +370,10 @@ namespace OGF {
 	Logger::status() << message << std::endl;
     }
 
+    double Interpreter::wall_clock_time() const {
+	return Stopwatch::now();
+    }
+
     bool Interpreter::load_module(const std::string& module_name) {
 	return ModuleManager::instance()->load_module(module_name);
     }
@@ -368,6 +382,47 @@ namespace OGF {
 	ModuleManager::append_dynamic_libraries_path(path);
     }
 
+    void Interpreter::interrupt() {
+    }
+
+    bool Interpreter::parallel_for(
+	index_t from, index_t to, Callable* body
+    ) {
+	if(body == nullptr) {
+	    Logger::err("GOM") << "parallel_for(): missing body" << std::endl;
+	    return false;
+	}
+	if(!body->is_thread_safe()) {
+	    ArgList args;
+	    Any& index = args.create_unnamed_arg();
+	    Any ret_val;
+	    for(index_t i=from; i<to; ++i) {
+		index.set_value(i);
+		if(!body->invoke(args, ret_val)) {
+		    return false;
+		}
+	    }
+	    return true;
+	}
+	std::atomic<bool> result(true);
+	GEO::parallel_for(
+	    from, to,
+	    [body, &result](index_t i) {
+		if(!result) {
+		    return;
+		}
+		// Each thread has its own arguments.
+		ArgList args;
+		args.create_unnamed_arg().set_value(i);
+		Any ret_val;
+		if(!body->invoke(args, ret_val)) {
+		    result = false;
+		}
+	    }
+	);
+	return result;
+    }
+
     Connection* Interpreter::connect(Request* from, Callable* to) {
 	// Special case: target is a Request.
 	// We create a SlotConnection, that does not do reference counting
@@ -588,6 +643,15 @@ namespace OGF {
     ) {
 	auto it = instance_.find(language);
 	if(it == instance_.end()) {
+	    // Interpreters are registered when their module is initialized
+	    // (see ModuleManager::defer_module()).
+	    if(
+		ModuleManager::instance()->load_module_for_registration(
+		    "language", language
+		)
+	    ) {
+		return instance_by_language(language);
+	    }
 	    return nullptr;
 	}
 	return it->second;
@@ -598,6 +662,13 @@ namespace OGF {
     ) {
 	auto it = instance_by_file_extension_.find(extension);
 	if(it == instance_by_file_extension_.end()) {
+	    if(
+		ModuleManager::instance()->load_module_for_registration(
+		    "language_file_extension", extension
+		)
+	    ) {
+		return instance_by_file_extension(extension);
+	    }
 	    return nullptr;
 	}
 	return it->second;
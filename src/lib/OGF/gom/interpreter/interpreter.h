@@ -461,6 +461,15 @@ namespace OGF {
 	 */
 	virtual void status(const std::string& message);
 
+	/**
+	 * \brief Gets the wall-clock time.
+	 * \details Unlike os.clock() in Lua, that measures the CPU time
+	 *  of the process summed over all its threads, it can be used to
+	 *  measure the speed-up of multithreaded functions.
+	 * \return the elapsed time since an arbitrary origin, in seconds
+	 */
+	double wall_clock_time() const;
+
 	/**
 	 * \brief Adds a path where dynamic libraries can be loaded.
 	 * \details Under Windows, adds the path to the PATH environment
@@ -487,6 +496,23 @@ namespace OGF {
 	 */
 	virtual Connection* connect(Request* from, Callable* to);
 
+	/**
+	 * \brief Calls a function for each index of a range, in parallel
+	 *  when possible.
+	 * \details If \p body is thread-safe (for instance a Request to a
+	 *  C++ method declared with gom_attribute(thread_safe,"true")), it
+	 *  is invoked from several threads. Otherwise, the default
+	 *  implementation invokes it sequentially from the calling thread.
+	 *  Interpreters can override this function to run their own
+	 *  functions in parallel (see LuaInterpreter).
+	 * \param[in] from the first index
+	 * \param[in] to one position past the last index
+	 * \param[in] body the function, called with the index as argument
+	 * \retval true if all the calls succeeded
+	 * \retval false otherwise
+	 */
+	virtual bool parallel_for(index_t from, index_t to, Callable* body);
+
 
 	/**
 	 * \brief Gets an interpreter for a given language.
@@ -587,6 +613,16 @@ namespace OGF {
          */
         ~Interpreter() override;
 
+	/**
+	 * \brief Asks the interpreter to stop the code that it is
+	 *  currently executing.
+	 * \details This function can be called from another thread. The
+	 *  running code is stopped with an error the next time the
+	 *  interpreter gets the control (a C++ command that is running is
+	 *  not interrupted). The default implementation does nothing.
+	 */
+	virtual void interrupt();
+
         /**
          * \brief Initializes the interpreter subsystem, and
          *  defines the interpreter to be used.
@@ -39,6 +39,7 @@
 #include <OGF/gom/types/node.h>
 #include <OGF/gom/types/callable.h>
 #include <OGF/gom/reflection/meta.h>
+#include <OGF/gom/reflection/dynamic_object.h>
 #include <OGF/basic/os/file_manager.h>
 #include <OGF/basic/modules/modmgr.h>
 #include <geogram/basic/process.h>
@@ -51,6 +52,13 @@ extern "C" {
 }
 
 #include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <set>
+#include <mutex>
+#include <atomic>
 
 namespace {
     using namespace OGF;
@@ -134,6 +142,12 @@ namespace OGF {
 	return result;
     }
 
+    void LuaCallable::push_target() const {
+	lua_getfield(lua_state_,LUA_REGISTRYINDEX,"graphite_lua_targets");
+	lua_geti(lua_state_, -1, lua_Integer(instance_id_));
+	lua_remove(lua_state_, -2);
+    }
+
     LuaCallable::~LuaCallable() {
 	// Remove the memorized target from the "graphite_lua_targets"
 	// table (indexed by instance_id_)
@@ -844,6 +858,769 @@ namespace {
 	lua_pushstring(L,as_string.c_str());
     }
 
+    /***************************************************/
+
+    /**
+     * \brief What a member name resolves to in a MetaClass.
+     */
+    struct LuaMemberResolution {
+	MetaClass* mclass;
+	index_t timestamp;
+	MetaProperty* property;
+	MetaMethod* method;
+	bool direct_property_access;
+    };
+
+    /**
+     * \brief The inline cache attached to a Lua string used as a
+     *  member name.
+     * \details Stored in a full userdata, in the member cache table
+     *  indexed by the Lua string (upvalue of graphite_index() and
+     *  graphite_newindex()). Since Lua strings are interned and hashed
+     *  once, finding the cache of a name does not hash it again. Most
+     *  call sites always access the same class, and hit the first entry.
+     */
+    struct LuaMemberCache {
+	std::string name;
+	LuaMemberResolution first;
+	std::unordered_map<MetaClass*, LuaMemberResolution> others;
+    };
+
+    /**
+     * \brief Maximum number of names in the member cache table.
+     * \details Names can be built dynamically (e.g., obj["attr_"..i]),
+     *  thus the table is emptied when it is full. The number of names
+     *  is stored in the table, with an integer key.
+     */
+    const lua_Integer LUA_MEMBER_CACHE_MAX_NAMES = 4096;
+
+    /**
+     * \brief Maximum number of classes cached for a name besides the
+     *  first one (LuaMemberCache::others is emptied when it is full).
+     */
+    const size_t LUA_MEMBER_CACHE_MAX_CLASSES = 16;
+
+    /**
+     * \brief Creates a new cache for a name in the member cache table.
+     * \details Needs to be called from a C closure that has the member
+     *  cache table as its first upvalue. If the table is full, all the
+     *  caches it contains are removed first (they are garbage collected).
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] name_index the stack index of the name (a string).
+     * \return a pointer to the new cache
+     */
+    LuaMemberCache* lua_newmembercache(lua_State* L, int name_index) {
+	name_index = lua_absindex(L, name_index);
+	int table = lua_upvalueindex(1);
+	lua_rawgeti(L, table, 1);
+	lua_Integer nb_names = lua_tointeger(L,-1);
+	lua_pop(L,1);
+	if(nb_names >= LUA_MEMBER_CACHE_MAX_NAMES) {
+	    // Assigning nil to existing fields is allowed while traversing.
+	    lua_pushnil(L);
+	    while(lua_next(L, table) != 0) {
+		lua_pop(L,1);
+		lua_pushvalue(L,-1);
+		lua_pushnil(L);
+		lua_rawset(L, table);
+	    }
+	    nb_names = 0;
+	}
+	lua_pushinteger(L, nb_names + 1);
+	lua_rawseti(L, table, 1);
+
+	void* p = lua_newuserdata(L, sizeof(LuaMemberCache));
+	LuaMemberCache* cache = new(p) LuaMemberCache;
+	cache->name = lua_tostring(L, name_index);
+	cache->first.mclass = nullptr;
+	lua_getfield(L, LUA_REGISTRYINDEX, "graphite_member_cache_vtbl");
+	lua_setmetatable(L,-2);
+	lua_pushvalue(L, name_index);
+	lua_insert(L,-2);
+	lua_rawset(L, table);
+	return cache;
+    }
+
+    /**
+     * \brief Implementation of __gc() metamethod for LuaMemberCache.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack.
+     */
+    int graphite_member_cache_gc(lua_State* L) {
+	LuaMemberCache* cache = static_cast<LuaMemberCache*>(
+	    lua_touserdata(L,1)
+	);
+	cache->~LuaMemberCache();
+	return 0;
+    }
+
+    /**
+     * \brief Looks up a member name in a MetaClass.
+     * \param[out] result the resolved member
+     * \param[in] mclass a pointer to the MetaClass
+     * \param[in] name the name of the member
+     */
+    void lua_resolvemember(
+	LuaMemberResolution& result, MetaClass* mclass, const std::string& name
+    ) {
+	// Read before the lookup: if the indices are invalidated meanwhile,
+	// the result will be considered as stale.
+	result.timestamp = MetaClass::indices_timestamp();
+	result.mclass = mclass;
+	result.property = mclass->find_property(name);
+	result.method = nullptr;
+	if(result.property == nullptr) {
+	    MetaMethod* mmethod = mclass->find_method(name);
+	    if(
+		mmethod != nullptr &&
+		dynamic_cast<MetaConstructor*>(mmethod) == nullptr
+	    ) {
+		result.method = mmethod;
+	    }
+	}
+	// Dynamic objects store their properties, and override
+	// get_property().
+	result.direct_property_access =
+	    (dynamic_cast<DynamicMetaClass*>(mclass) == nullptr);
+    }
+
+    /**
+     * \brief Resolves a member name in a MetaClass, using the inline
+     *  cache of the name.
+     * \details Needs to be called from a C closure that has the member
+     *  cache table as its first upvalue.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] name_index the stack index of the name (a string).
+     * \param[in] mclass a pointer to the MetaClass.
+     * \return the resolved member. It is returned by value, because
+     *  accessing the member may re-enter the cache.
+     */
+    LuaMemberResolution lua_getmember(
+	lua_State* L, int name_index, MetaClass* mclass
+    ) {
+	name_index = lua_absindex(L, name_index);
+	LuaMemberCache* cache = nullptr;
+	lua_pushvalue(L, name_index);
+	if(lua_rawget(L, lua_upvalueindex(1)) == LUA_TUSERDATA) {
+	    cache = static_cast<LuaMemberCache*>(lua_touserdata(L,-1));
+	    lua_pop(L,1);
+	} else {
+	    lua_pop(L,1);
+	    cache = lua_newmembercache(L, name_index);
+	}
+
+	index_t timestamp = MetaClass::indices_timestamp();
+	if(
+	    cache->first.mclass == mclass &&
+	    cache->first.timestamp == timestamp
+	) {
+	    return cache->first;
+	}
+
+	auto it = cache->others.find(mclass);
+	if(it != cache->others.end() && it->second.timestamp == timestamp) {
+	    return it->second;
+	}
+
+	// Cache miss: the first entry is used if it is free or stale.
+	if(
+	    cache->first.mclass == nullptr ||
+	    cache->first.mclass == mclass ||
+	    cache->first.timestamp != timestamp
+	) {
+	    lua_resolvemember(cache->first, mclass, cache->name);
+	    return cache->first;
+	}
+	if(cache->others.size() >= LUA_MEMBER_CACHE_MAX_CLASSES) {
+	    cache->others.clear();
+	}
+	LuaMemberResolution& result = cache->others[mclass];
+	lua_resolvemember(result, mclass, cache->name);
+	return result;
+    }
+
+    /**
+     * \brief Pushes onto the stack a value cached in the user value
+     *  of a graphite object.
+     * \details The Requests and interface scopes created when accessing
+     *  the members of a graphite object are cached in a table stored in
+     *  the user value of the userdata, so that repeated accesses
+     *  (e.g., E.create_vertex in a loop) do not allocate and
+     *  garbage-collect new ones.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] object_index the stack index of the graphite object.
+     * \param[in] key_index the stack index of the key.
+     * \retval true if a value was found and pushed onto the stack.
+     * \retval false otherwise (then nothing is pushed).
+     */
+    bool lua_getgraphitecached(lua_State* L, int object_index, int key_index) {
+	key_index = lua_absindex(L, key_index);
+	if(lua_getuservalue(L, object_index) != LUA_TTABLE) {
+	    lua_pop(L,1);
+	    return false;
+	}
+	lua_pushvalue(L, key_index);
+	if(lua_rawget(L,-2) == LUA_TNIL) {
+	    lua_pop(L,2);
+	    return false;
+	}
+	lua_remove(L,-2);
+	return true;
+    }
+
+    /**
+     * \brief Caches the value on the top of the stack in the user value
+     *  of a graphite object.
+     * \details The value is left on the stack.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] object_index the stack index of the graphite object.
+     * \param[in] key_index the stack index of the key.
+     * \see lua_getgraphitecached()
+     */
+    void lua_setgraphitecached(lua_State* L, int object_index, int key_index) {
+	object_index = lua_absindex(L, object_index);
+	key_index = lua_absindex(L, key_index);
+	if(lua_getuservalue(L, object_index) != LUA_TTABLE) {
+	    lua_pop(L,1);
+	    lua_newtable(L);
+	    lua_pushvalue(L,-1);
+	    lua_setuservalue(L, object_index);
+	}
+	lua_pushvalue(L, key_index);
+	lua_pushvalue(L, -3);
+	lua_rawset(L, -3);
+	lua_pop(L,1);
+    }
+
+    /***************************************************/
+
+    /**
+     * \brief The types of elements that can be read and written
+     *  directly in the memory of an ElementBuffer.
+     */
+    enum LuaBufferElementType {
+	LUA_BUFFER_UNSUPPORTED,
+	LUA_BUFFER_DOUBLE,
+	LUA_BUFFER_FLOAT,
+	LUA_BUFFER_INT32,
+	LUA_BUFFER_UINT32,
+	LUA_BUFFER_UINT8,
+	LUA_BUFFER_BOOL
+    };
+
+    /**
+     * \brief Gets the type of the elements of an ElementBuffer.
+     * \param[in] buffer a const reference to the ElementBuffer
+     * \return the type of the elements or LUA_BUFFER_UNSUPPORTED if the
+     *  elements cannot be accessed directly (then get_element() and
+     *  set_element() need to be used).
+     */
+    LuaBufferElementType lua_bufferelementtype(const ElementBuffer& buffer) {
+	MetaType* mtype = buffer.element_meta_type;
+	if(mtype == nullptr || buffer.data == nullptr) {
+	    return LUA_BUFFER_UNSUPPORTED;
+	}
+	if(
+	    mtype == ogf_meta<double>::type() &&
+	    buffer.element_size == sizeof(double)
+	) {
+	    return LUA_BUFFER_DOUBLE;
+	}
+	if(
+	    mtype == ogf_meta<float>::type() &&
+	    buffer.element_size == sizeof(float)
+	) {
+	    return LUA_BUFFER_FLOAT;
+	}
+	if(
+	    mtype == ogf_meta<Numeric::int32>::type() &&
+	    buffer.element_size == sizeof(Numeric::int32)
+	) {
+	    return LUA_BUFFER_INT32;
+	}
+	if(
+	    mtype == ogf_meta<Numeric::uint32>::type() &&
+	    buffer.element_size == sizeof(Numeric::uint32)
+	) {
+	    return LUA_BUFFER_UINT32;
+	}
+	if(
+	    mtype == ogf_meta<Numeric::uint8>::type() &&
+	    buffer.element_size == sizeof(Numeric::uint8)
+	) {
+	    return LUA_BUFFER_UINT8;
+	}
+	// Attribute<bool> are stored as bytes.
+	if(
+	    mtype == ogf_meta<bool>::type() &&
+	    buffer.element_size == sizeof(Numeric::uint8)
+	) {
+	    return LUA_BUFFER_BOOL;
+	}
+	return LUA_BUFFER_UNSUPPORTED;
+    }
+
+    /**
+     * \brief Pushes an element stored in memory onto the LUA stack.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] type the type of the element.
+     * \param[in] addr the address of the element.
+     */
+    void lua_pushbufferelement(
+	lua_State* L, LuaBufferElementType type, Memory::pointer addr
+    ) {
+	switch(type) {
+	case LUA_BUFFER_DOUBLE: {
+	    double val;
+	    std::memcpy(&val, addr, sizeof(double));
+	    lua_pushnumber(L, lua_Number(val));
+	} break;
+	case LUA_BUFFER_FLOAT: {
+	    float val;
+	    std::memcpy(&val, addr, sizeof(float));
+	    lua_pushnumber(L, lua_Number(val));
+	} break;
+	case LUA_BUFFER_INT32: {
+	    Numeric::int32 val;
+	    std::memcpy(&val, addr, sizeof(Numeric::int32));
+	    lua_pushinteger(L, lua_Integer(val));
+	} break;
+	case LUA_BUFFER_UINT32: {
+	    Numeric::uint32 val;
+	    std::memcpy(&val, addr, sizeof(Numeric::uint32));
+	    lua_pushinteger(L, lua_Integer(val));
+	} break;
+	case LUA_BUFFER_UINT8: {
+	    lua_pushinteger(L, lua_Integer(*addr));
+	} break;
+	case LUA_BUFFER_BOOL: {
+	    lua_pushboolean(L, (*addr != 0) ? 1 : 0);
+	} break;
+	case LUA_BUFFER_UNSUPPORTED: {
+	    lua_pushnil(L);
+	} break;
+	}
+    }
+
+    /**
+     * \brief Stores a LUA value into an element in memory.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] index the stack index of the LUA value.
+     * \param[in] type the type of the element.
+     * \param[in] addr the address of the element.
+     * \retval true if the LUA value could be converted and stored.
+     * \retval false otherwise (then memory is left unchanged).
+     */
+    bool lua_tobufferelement(
+	lua_State* L, int index, LuaBufferElementType type,
+	Memory::pointer addr
+    ) {
+	if(type == LUA_BUFFER_BOOL) {
+	    if(lua_isboolean(L,index)) {
+		*addr = lua_toboolean(L,index) ? 1 : 0;
+		return true;
+	    }
+	    if(lua_isnumber(L,index)) {
+		*addr = (lua_tonumber(L,index) != 0.0) ? 1 : 0;
+		return true;
+	    }
+	    return false;
+	}
+	if(!lua_isnumber(L,index)) {
+	    return false;
+	}
+	switch(type) {
+	case LUA_BUFFER_DOUBLE: {
+	    double val = double(lua_tonumber(L,index));
+	    std::memcpy(addr, &val, sizeof(double));
+	} break;
+	case LUA_BUFFER_FLOAT: {
+	    float val = float(lua_tonumber(L,index));
+	    std::memcpy(addr, &val, sizeof(float));
+	} break;
+	case LUA_BUFFER_INT32: {
+	    Numeric::int32 val = Numeric::int32(lua_tointeger(L,index));
+	    std::memcpy(addr, &val, sizeof(Numeric::int32));
+	} break;
+	case LUA_BUFFER_UINT32: {
+	    Numeric::uint32 val = Numeric::uint32(lua_tointeger(L,index));
+	    std::memcpy(addr, &val, sizeof(Numeric::uint32));
+	} break;
+	case LUA_BUFFER_UINT8: {
+	    *addr = Numeric::uint8(lua_tointeger(L,index));
+	} break;
+	case LUA_BUFFER_BOOL:
+	case LUA_BUFFER_UNSUPPORTED: {
+	    return false;
+	}
+	}
+	return true;
+    }
+
+    /**
+     * \brief The data of a worker LUA state of
+     *  LuaInterpreter::parallel_for().
+     * \details Stored as a light userdata in the "graphite_worker" field
+     *  of the registry of the worker. Nil in the registry of the
+     *  interpreter.
+     */
+    struct LuaWorker {
+	/** \brief the LUA state of the interpreter */
+	lua_State* interpreter_state;
+
+	/** \brief serializes accesses to GOM, shared by all the workers */
+	std::recursive_mutex* gom_lock;
+
+	/** \brief the objects with a modified element buffer */
+	std::set<Object*> modified;
+
+	/** \brief keeps alive the modified objects released by the worker */
+	std::vector<Object_var> modified_alive;
+    };
+
+    /**
+     * \brief Gets the LuaWorker of a LUA state.
+     * \param[in] L a pointer to the LUA state.
+     * \return a pointer to the LuaWorker, or nullptr if \p L is not
+     *  a worker.
+     */
+    LuaWorker* lua_getworker(lua_State* L) {
+	lua_getfield(L,LUA_REGISTRYINDEX,"graphite_worker");
+	LuaWorker* result = static_cast<LuaWorker*>(lua_touserdata(L,-1));
+	lua_pop(L,1);
+	return result;
+    }
+
+    /**
+     * \brief Notifies an object that its element buffer was modified.
+     * \details In a worker, the notification is deferred until all
+     *  the workers are done, and sent from the interpreter thread.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] object a pointer to the object.
+     */
+    void lua_elementbuffermodified(lua_State* L, Object* object) {
+	LuaWorker* worker = lua_getworker(L);
+	if(worker == nullptr) {
+	    object->element_buffer_modified();
+	} else {
+	    worker->modified.insert(object);
+	}
+    }
+
+    /**
+     * \brief Releases the reference of a LUA object to a graphite object.
+     * \details In a worker, keeps alive the objects that have a deferred
+     *  notification.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] object a pointer to the object.
+     */
+    void lua_unrefgraphite(lua_State* L, Object* object) {
+	LuaWorker* worker = lua_getworker(L);
+	if(
+	    worker != nullptr &&
+	    worker->modified.find(object) != worker->modified.end()
+	) {
+	    worker->modified_alive.push_back(object);
+	}
+	object->unref();
+    }
+
+    /**
+     * \brief A view on a range of the elements of an Object that
+     *  exposes an ElementBuffer.
+     * \details Buffer views are obtained from LUA with object.buffer.
+     *  Elements are read and written directly in memory, and bulk
+     *  operations (fill(), to_table(), copy_from_table()) notify the
+     *  object only once. The memory is queried again at each access, so
+     *  that the view remains valid if the object is resized.
+     */
+    struct LuaBufferView {
+	Object* object;
+	index_t offset;
+	index_t nb_elements;
+    };
+
+    /**
+     * \brief Pushes a new buffer view onto the LUA stack.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] object the object, that exposes an ElementBuffer.
+     * \param[in] offset the index of the first element of the view.
+     * \param[in] nb_elements the number of elements of the view,
+     *  or NO_INDEX if the view extends to the last element.
+     */
+    void lua_pushbufferview(
+	lua_State* L, Object* object, index_t offset, index_t nb_elements
+    ) {
+	void* p = lua_newuserdata(L,sizeof(LuaBufferView));
+	LuaBufferView* view = static_cast<LuaBufferView*>(p);
+	view->object = object;
+	view->offset = offset;
+	view->nb_elements = nb_elements;
+	object->ref();
+	lua_getfield(L,LUA_REGISTRYINDEX,"graphite_buffer_vtbl");
+	lua_setmetatable(L,-2);
+    }
+
+    /**
+     * \brief Gets the memory of the elements of a buffer view.
+     * \details Raises a LUA error if the view cannot be accessed
+     *  directly.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] index the stack index of the buffer view.
+     * \param[out] buffer the ElementBuffer, with data and nb_elements
+     *  restricted to the range of the view.
+     * \param[out] type the type of the elements.
+     * \return a pointer to the buffer view.
+     */
+    LuaBufferView* lua_tobufferview(
+	lua_State* L, int index,
+	ElementBuffer& buffer, LuaBufferElementType& type
+    ) {
+	LuaBufferView* view = static_cast<LuaBufferView*>(
+	    luaL_checkudata(L,index,"graphite_buffer_vtbl")
+	);
+	if(view->object == nullptr) {
+	    luaL_error(L, "tried to access a released buffer view");
+	}
+	if(!view->object->get_element_buffer(buffer)) {
+	    luaL_error(L, "object does not expose its elements anymore");
+	}
+	type = lua_bufferelementtype(buffer);
+	if(type == LUA_BUFFER_UNSUPPORTED && buffer.nb_elements != 0) {
+	    luaL_error(L, "unsupported element type in buffer view");
+	}
+	index_t offset = std::min(view->offset, buffer.nb_elements);
+	index_t nb = buffer.nb_elements - offset;
+	if(view->nb_elements != NO_INDEX) {
+	    nb = std::min(nb, view->nb_elements);
+	}
+	buffer.data += size_t(offset) * buffer.element_size;
+	buffer.nb_elements = nb;
+	return view;
+    }
+
+    /**
+     * \brief Gets the index of an element in a buffer view.
+     * \details Raises a LUA error if the index is out of range.
+     * \param[in] L a pointer to the LUA state.
+     * \param[in] index the stack index of the LUA integer.
+     * \param[in] buffer the ElementBuffer of the view.
+     * \return the index of the element, in 0 .. buffer.nb_elements - 1.
+     */
+    index_t lua_tobufferindex(
+	lua_State* L, int index, const ElementBuffer& buffer
+    ) {
+	lua_Integer i = luaL_checkinteger(L,index);
+	if(i < 0 || i >= lua_Integer(buffer.nb_elements)) {
+	    luaL_error(
+		L, "buffer index %d out of range [0..%d]",
+		int(i), int(buffer.nb_elements) - 1
+	    );
+	}
+	return index_t(i);
+    }
+
+    /**
+     * \brief Implementation of __index() metamethod for buffer views.
+     * \details Integer indices access the elements (starting from 0),
+     *  string indices access the functions of the view and the
+     *  dimension.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1).
+     */
+    int graphite_buffer_index(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	lua_tobufferview(L,1,buffer,type);
+	if(lua_type(L,2) == LUA_TNUMBER) {
+	    index_t i = lua_tobufferindex(L,2,buffer);
+	    lua_pushbufferelement(L, type, buffer.data + i*buffer.element_size);
+	    return 1;
+	}
+	const char* name = lua_tostring(L,2);
+	if(name != nullptr && !strcmp(name,"dimension")) {
+	    lua_pushinteger(L, lua_Integer(buffer.dimension));
+	    return 1;
+	}
+	if(name != nullptr && !strcmp(name,"read_only")) {
+	    lua_pushboolean(L, buffer.read_only ? 1 : 0);
+	    return 1;
+	}
+	// Functions are stored in the metatable.
+	lua_getmetatable(L,1);
+	lua_pushvalue(L,2);
+	lua_rawget(L,-2);
+	return 1;
+    }
+
+    /**
+     * \brief Implementation of __newindex() metamethod for buffer views.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 0).
+     */
+    int graphite_buffer_newindex(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	LuaBufferView* view = lua_tobufferview(L,1,buffer,type);
+	if(buffer.read_only) {
+	    return luaL_error(L, "buffer view is read-only");
+	}
+	index_t i = lua_tobufferindex(L,2,buffer);
+	if(!lua_tobufferelement(
+	       L, 3, type, buffer.data + i*buffer.element_size
+	)) {
+	    return luaL_error(L, "invalid value stored in buffer view");
+	}
+	lua_elementbuffermodified(L, view->object);
+	return 0;
+    }
+
+    /**
+     * \brief Implementation of __len() metamethod for buffer views.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1).
+     */
+    int graphite_buffer_len(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	lua_tobufferview(L,1,buffer,type);
+	lua_pushinteger(L, lua_Integer(buffer.nb_elements));
+	return 1;
+    }
+
+    /**
+     * \brief Implementation of __gc() metamethod for buffer views.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 0).
+     */
+    int graphite_buffer_gc(lua_State* L) {
+	LuaBufferView* view = static_cast<LuaBufferView*>(
+	    luaL_checkudata(L,1,"graphite_buffer_vtbl")
+	);
+	if(view->object != nullptr) {
+	    lua_unrefgraphite(L, view->object);
+	    view->object = nullptr;
+	}
+	return 0;
+    }
+
+    /**
+     * \brief Implementation of buffer:fill(value).
+     * \details Sets all the elements of the view to the same value.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 0).
+     */
+    int graphite_buffer_fill(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	LuaBufferView* view = lua_tobufferview(L,1,buffer,type);
+	if(buffer.read_only) {
+	    return luaL_error(L, "buffer view is read-only");
+	}
+	if(buffer.nb_elements == 0) {
+	    return 0;
+	}
+	// Converts the value once, then replicates its bytes.
+	if(!lua_tobufferelement(L, 2, type, buffer.data)) {
+	    return luaL_error(L, "invalid value stored in buffer view");
+	}
+	for(index_t i=1; i<buffer.nb_elements; ++i) {
+	    std::memcpy(
+		buffer.data + i*buffer.element_size, buffer.data,
+		buffer.element_size
+	    );
+	}
+	lua_elementbuffermodified(L, view->object);
+	return 0;
+    }
+
+    /**
+     * \brief Implementation of buffer:to_table().
+     * \details Creates a LUA sequence with all the elements of the view.
+     *  Note that as any LUA sequence, the table is indexed from 1.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1).
+     */
+    int graphite_buffer_to_table(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	lua_tobufferview(L,1,buffer,type);
+	lua_createtable(L, int(buffer.nb_elements), 0);
+	for(index_t i=0; i<buffer.nb_elements; ++i) {
+	    lua_pushbufferelement(L, type, buffer.data + i*buffer.element_size);
+	    lua_rawseti(L, -2, lua_Integer(i+1));
+	}
+	return 1;
+    }
+
+    /**
+     * \brief Implementation of buffer:copy_from_table(table).
+     * \details Copies the elements of a LUA sequence (indexed from 1)
+     *  into the view. Copies at most as many elements as the view has.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1,
+     *  the number of copied elements).
+     */
+    int graphite_buffer_copy_from_table(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	LuaBufferView* view = lua_tobufferview(L,1,buffer,type);
+	if(buffer.read_only) {
+	    return luaL_error(L, "buffer view is read-only");
+	}
+	luaL_checktype(L, 2, LUA_TTABLE);
+	index_t nb = std::min(
+	    buffer.nb_elements, index_t(lua_rawlen(L,2))
+	);
+	for(index_t i=0; i<nb; ++i) {
+	    lua_rawgeti(L, 2, lua_Integer(i+1));
+	    if(!lua_tobufferelement(
+		   L, -1, type, buffer.data + i*buffer.element_size
+	    )) {
+		lua_pop(L,1);
+		lua_elementbuffermodified(L, view->object);
+		return luaL_error(
+		    L, "invalid value at index %d of table", int(i+1)
+		);
+	    }
+	    lua_pop(L,1);
+	}
+	lua_elementbuffermodified(L, view->object);
+	lua_pushinteger(L, lua_Integer(nb));
+	return 1;
+    }
+
+    /**
+     * \brief Implementation of buffer:slice(first, count).
+     * \details Creates a new view on count elements starting from
+     *  first (indexed from 0, relative to this view). If count is
+     *  not specified, the slice extends to the last element.
+     * \param[in] L a pointer to the LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1).
+     */
+    int graphite_buffer_slice(lua_State* L) {
+	ElementBuffer buffer;
+	LuaBufferElementType type;
+	LuaBufferView* view = lua_tobufferview(L,1,buffer,type);
+	lua_Integer first = luaL_checkinteger(L,2);
+	lua_Integer count = luaL_optinteger(
+	    L, 3, lua_Integer(buffer.nb_elements) - first
+	);
+	if(
+	    first < 0 || count < 0 ||
+	    first + count > lua_Integer(buffer.nb_elements)
+	) {
+	    return luaL_error(
+		L, "slice [%d..%d] out of range [0..%d]",
+		int(first), int(first+count)-1, int(buffer.nb_elements)-1
+	    );
+	}
+	lua_pushbufferview(
+	    L, view->object, view->offset + index_t(first), index_t(count)
+	);
+	return 1;
+    }
+
     /**
      * \brief Implementation of __index() metamethod for graphite objects
      *  with array indexing.
@@ -861,6 +1638,17 @@ namespace {
 	Any result;
 	if(lua_isinteger(L,2)) {
 	    index_t index = index_t(lua_tointeger(L,2));
+	    // Fast path: the element is read directly in memory.
+	    ElementBuffer buffer;
+	    if(object->get_element_buffer(buffer) && index < buffer.nb_elements) {
+		LuaBufferElementType type = lua_bufferelementtype(buffer);
+		if(type != LUA_BUFFER_UNSUPPORTED) {
+		    lua_pushbufferelement(
+			L, type, buffer.data + index*buffer.element_size
+		    );
+		    return 1;
+		}
+	    }
 	    object->get_element(index,result);
 	} else {
 	    vec2i index;
@@ -903,15 +1691,22 @@ namespace {
 
 	// Particular case: interfaces scope.
 	if(!strcmp(name,"I")) {
-	    lua_pushgraphite(L,new InterfaceScope(object));
+	    if(!lua_getgraphitecached(L,1,2)) {
+		lua_pushgraphite(L,new InterfaceScope(object));
+		lua_setgraphitecached(L,1,2);
+	    }
 	    return 1;
 	}
 
+	LuaMemberResolution member = lua_getmember(L,2,object->meta_class());
+
 	// Case 1: regular property
-        MetaProperty* mprop = object->meta_class()->find_property(name);
-        if(mprop != nullptr) {
+        if(member.property != nullptr) {
 	    Any value;
-	    if(!object->get_property(name, value)) {
+	    bool ok = member.direct_property_access ?
+		member.property->get_value(object, value) :
+		object->get_property(name, value) ;
+	    if(!ok) {
 		return luaL_error(
 		    L,(
 			object->meta_class()->name() +
@@ -924,21 +1719,39 @@ namespace {
 	}
 
 	// Case 2: assembling a graphite request (object.method to be
-	// called right after).
-	MetaMethod* mmethod = object->meta_class()->find_method(name);
-	if(
-	    mmethod != nullptr &&
-	    dynamic_cast<MetaConstructor*>(mmethod) == nullptr
-	) {
+	// called right after). The request is reused as long as the
+	// method is the same.
+	if(member.method != nullptr) {
+	    if(lua_getgraphitecached(L,1,2)) {
+		Request* request = static_cast<Request*>(lua_tographite(L,-1));
+		if(request->method() == member.method) {
+		    return 1;
+		}
+		lua_pop(L,1);
+	    }
 	    // If object is an interpreter, do not do reference counting, else
 	    // this creates circular references, preventing objects from
 	    // being deallocated.
 	    bool managed = (dynamic_cast<Interpreter*>(object) == nullptr);
-	    lua_pushgraphite(L, new Request(object,mmethod,managed));
+	    lua_pushgraphite(L, new Request(object,member.method,managed));
+	    lua_setgraphitecached(L,1,2);
 	    return 1;
 	}
 
-	// Case 3: resolving symbol in gom.globals
+	// Case 3: direct access to the elements of an array, as a
+	// buffer view.
+	if(!strcmp(name,"buffer")) {
+	    ElementBuffer buffer;
+	    if(object->get_element_buffer(buffer)) {
+		if(!lua_getgraphitecached(L,1,2)) {
+		    lua_pushbufferview(L,object,0,NO_INDEX);
+		    lua_setgraphitecached(L,1,2);
+		}
+		return 1;
+	    }
+	}
+
+	// Case 4: resolving symbol in gom.globals
 	{
 	    Scope* scope = dynamic_cast<Scope*>(object);
 	    if(scope != nullptr) {
@@ -972,6 +1785,23 @@ namespace {
 	    return luaL_error(L, "tried to index nil Graphite object");
 	}
 
+	// Fast path: the element is written directly in memory.
+	if(lua_isinteger(L,2)) {
+	    index_t index = index_t(lua_tointeger(L,2));
+	    ElementBuffer buffer;
+	    if(
+		object->get_element_buffer(buffer) &&
+		!buffer.read_only && index < buffer.nb_elements &&
+		lua_tobufferelement(
+		    L, 3, lua_bufferelementtype(buffer),
+		    buffer.data + index*buffer.element_size
+		)
+	    ) {
+		lua_elementbuffermodified(L, object);
+		return 0;
+	    }
+	}
+
 	Any value;
 	lua_tographiteval(L,3,value);
 
@@ -1015,9 +1845,9 @@ namespace {
 	}
 	Any value;
 	MetaType* mtype = nullptr;
-	MetaProperty* mprop = object->meta_class()->find_property(key);
-	if(mprop != nullptr) {
-	    mtype = mprop->type();
+	LuaMemberResolution member = lua_getmember(L,2,object->meta_class());
+	if(member.property != nullptr) {
+	    mtype = member.property->type();
 	}
 	lua_tographiteval(L,3,value,mtype);
 	object->set_property(key,value);
@@ -1054,7 +1884,7 @@ namespace {
 	    lua_touserdata(L,1)
 	);
 	if(GR->managed && GR->object != nullptr) {
-	    GR->object->unref();
+	    lua_unrefgraphite(L, GR->object);
 	}
 	GR->object = nullptr;
 	return 0;
@@ -1129,24 +1959,41 @@ namespace {
      *  graphite requests, and create the global table
      *  for LUA targets. The global tables are created in the
      *  registry.
+     * \param[in] L a pointer to the LUA state, the one of the
+     *  interpreter or a worker state (see LuaInterpreter::parallel_for()).
      * \param[in] interpreter a pointer to the LuaInterpreter.
      */
-    void init_lua_graphite(LuaInterpreter* interpreter) {
-	lua_State* L = interpreter->lua_state();
+    void init_lua_graphite(lua_State* L, LuaInterpreter* interpreter) {
+
+	// Create the table for the inline caches of member names,
+	// and the "metatable" of the caches.
+	{
+	    lua_newtable(L);
+	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_member_cache");
+
+	    lua_newtable(L);
+	    lua_pushliteral(L,"__gc");
+	    lua_pushcfunction(L,graphite_member_cache_gc);
+	    lua_settable(L,-3);
+	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_member_cache_vtbl");
+	}
 
 	// Create the "metatable" for
 	// graphite objects.
 	{
 	    lua_newtable(L);
 
-	    // Attribute access (read)
+	    // Attribute access (read), the member cache table is
+	    // the upvalue.
 	    lua_pushliteral(L,"__index");
-	    lua_pushcfunction(L,graphite_index);
+	    lua_getfield(L, LUA_REGISTRYINDEX, "graphite_member_cache");
+	    lua_pushcclosure(L,graphite_index,1);
 	    lua_settable(L,-3);
 
 	    // Attribute access (write)
 	    lua_pushliteral(L,"__newindex");
-	    lua_pushcfunction(L,graphite_newindex);
+	    lua_getfield(L, LUA_REGISTRYINDEX, "graphite_member_cache");
+	    lua_pushcclosure(L,graphite_newindex,1);
 	    lua_settable(L,-3);
 
 	    // Length
@@ -1167,6 +2014,46 @@ namespace {
 	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_vtbl");
 	}
 
+	// Create the "metatable" for buffer views. It also stores
+	// the functions of buffer views.
+	{
+	    lua_newtable(L);
+
+	    lua_pushliteral(L,"__index");
+	    lua_pushcfunction(L,graphite_buffer_index);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"__newindex");
+	    lua_pushcfunction(L,graphite_buffer_newindex);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"__len");
+	    lua_pushcfunction(L,graphite_buffer_len);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"__gc");
+	    lua_pushcfunction(L,graphite_buffer_gc);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"fill");
+	    lua_pushcfunction(L,graphite_buffer_fill);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"to_table");
+	    lua_pushcfunction(L,graphite_buffer_to_table);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"copy_from_table");
+	    lua_pushcfunction(L,graphite_buffer_copy_from_table);
+	    lua_settable(L,-3);
+
+	    lua_pushliteral(L,"slice");
+	    lua_pushcfunction(L,graphite_buffer_slice);
+	    lua_settable(L,-3);
+
+	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_buffer_vtbl");
+	}
+
 	// Create the global table for gom2lua connections
 	{
 	    lua_newtable(L);
@@ -1179,6 +2066,315 @@ namespace {
 	lua_setglobal(L, "gom");
     }
 
+    /*************************************************************/
+
+    /**
+     * \brief Appends a chunk of a dumped LUA function to a string.
+     * \details Used as the lua_Writer of lua_dump().
+     */
+    int lua_dumptostring(lua_State* L, const void* p, size_t sz, void* ud) {
+	geo_argused(L);
+	static_cast<std::string*>(ud)->append(
+	    static_cast<const char*>(p), sz
+	);
+	return 0;
+    }
+
+    /**
+     * \brief Copies a value from a LUA state to a worker LUA state.
+     * \details Used to send the function of LuaInterpreter::parallel_for()
+     *  to the workers. Functions are copied with lua_dump() and their
+     *  upvalues are copied recursively, tables are copied, graphite objects
+     *  and buffer views refer to the same objects, and the global table is
+     *  mapped to the one of the worker. Tables that have a metatable are
+     *  not copied: their behavior (and the metatable itself, that may be
+     *  shared with other tables) cannot be reproduced in the worker.
+     *  Each table or function is copied only once in a given worker (the
+     *  copies are memorized in the "graphite_worker_copies" table of the
+     *  registry), so that shared and recursive references are preserved.
+     * \param[in] from the LUA state that contains the value.
+     * \param[in] index the stack index of the value in \p from.
+     * \param[in] to the worker LUA state.
+     * \param[in] depth the recursion depth.
+     * \retval true if the value could be copied. Then the copy is pushed
+     *  onto the stack of \p to.
+     * \retval false otherwise (threads, other userdata or tables with a
+     *  metatable). The stack of \p to is left in an unspecified state.
+     */
+    bool lua_copyvalue(
+	lua_State* from, int index, lua_State* to, index_t depth = 0
+    ) {
+	if(depth > 100 || !lua_checkstack(from, 4) || !lua_checkstack(to, 4)) {
+	    return false;
+	}
+	index = lua_absindex(from, index);
+	int type = lua_type(from, index);
+	switch(type) {
+	case LUA_TNIL:
+	    lua_pushnil(to);
+	    return true;
+	case LUA_TBOOLEAN:
+	    lua_pushboolean(to, lua_toboolean(from, index));
+	    return true;
+	case LUA_TNUMBER:
+	    if(lua_isinteger(from, index)) {
+		lua_pushinteger(to, lua_tointeger(from, index));
+	    } else {
+		lua_pushnumber(to, lua_tonumber(from, index));
+	    }
+	    return true;
+	case LUA_TSTRING: {
+	    size_t len = 0;
+	    const char* str = lua_tolstring(from, index, &len);
+	    lua_pushlstring(to, str, len);
+	    return true;
+	}
+	case LUA_TLIGHTUSERDATA:
+	    lua_pushlightuserdata(to, lua_touserdata(from, index));
+	    return true;
+	case LUA_TUSERDATA: {
+	    if(lua_isgraphite(from, index)) {
+		GraphiteRef* GR = static_cast<GraphiteRef*>(
+		    lua_touserdata(from, index)
+		);
+		lua_pushgraphite(to, GR->object, GR->managed);
+		return true;
+	    }
+	    LuaBufferView* view = static_cast<LuaBufferView*>(
+		luaL_testudata(from, index, "graphite_buffer_vtbl")
+	    );
+	    if(view != nullptr && view->object != nullptr) {
+		lua_pushbufferview(
+		    to, view->object, view->offset, view->nb_elements
+		);
+		return true;
+	    }
+	    return false;
+	}
+	case LUA_TTABLE:
+	case LUA_TFUNCTION:
+	    break;
+	default:
+	    return false;
+	}
+
+	lua_rawgeti(from, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	bool is_globals = (lua_rawequal(from, -1, index) != 0);
+	lua_pop(from, 1);
+	if(is_globals) {
+	    lua_rawgeti(to, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	    return true;
+	}
+
+	const void* key = lua_topointer(from, index);
+	lua_getfield(to, LUA_REGISTRYINDEX, "graphite_worker_copies");
+	lua_rawgetp(to, -1, key);
+	if(!lua_isnil(to, -1)) {
+	    lua_remove(to, -2);
+	    return true;
+	}
+	lua_pop(to, 1);
+
+	if(type == LUA_TTABLE) {
+	    if(lua_getmetatable(from, index) != 0) {
+		lua_pop(from, 1);
+		return false;
+	    }
+	    lua_newtable(to);
+	    lua_pushvalue(to, -1);
+	    lua_rawsetp(to, -3, key);
+	    lua_remove(to, -2);
+	    lua_pushnil(from);
+	    while(lua_next(from, index) != 0) {
+		if(
+		    !lua_copyvalue(from, -2, to, depth+1) ||
+		    !lua_copyvalue(from, -1, to, depth+1)
+		) {
+		    lua_pop(from, 2);
+		    return false;
+		}
+		lua_rawset(to, -3);
+		lua_pop(from, 1);
+	    }
+	    return true;
+	}
+
+	if(lua_iscfunction(from, index)) {
+	    lua_pop(to, 1);
+	    int nb_upvalues = 0;
+	    while(lua_getupvalue(from, index, nb_upvalues+1) != nullptr) {
+		bool ok = lua_copyvalue(from, -1, to, depth+1);
+		lua_pop(from, 1);
+		if(!ok) {
+		    return false;
+		}
+		++nb_upvalues;
+	    }
+	    lua_pushcclosure(to, lua_tocfunction(from, index), nb_upvalues);
+	    return true;
+	}
+
+	std::string code;
+	lua_pushvalue(from, index);
+	int status = lua_dump(from, lua_dumptostring, &code, 0);
+	lua_pop(from, 1);
+	if(
+	    status != 0 ||
+	    luaL_loadbufferx(
+		to, code.data(), code.size(), "=parallel_for", "b"
+	    ) != LUA_OK
+	) {
+	    return false;
+	}
+	// Memorized before copying the upvalues, that may refer to
+	// the function itself.
+	lua_pushvalue(to, -1);
+	lua_rawsetp(to, -3, key);
+	lua_remove(to, -2);
+	for(int i=1; lua_getupvalue(from, index, i) != nullptr; ++i) {
+	    bool ok = lua_copyvalue(from, -1, to, depth+1);
+	    lua_pop(from, 1);
+	    if(!ok) {
+		return false;
+	    }
+	    if(lua_setupvalue(to, -2, i) == nullptr) {
+		lua_pop(to, 1);
+	    }
+	}
+	return true;
+    }
+
+    /**
+     * \brief Calls a metamethod of a worker LUA state while holding
+     *  the GOM lock.
+     * \details GOM objects are shared by the workers, and GOM is not
+     *  thread-safe (reference counts in particular). The metamethods of
+     *  graphite objects are wrapped in this function, with the original
+     *  metamethod as upvalue. Buffer views access elements directly, and
+     *  do not need the lock.
+     * \param[in] L a pointer to the worker LUA state.
+     * \return the number of LUA objects pushed onto the stack.
+     */
+    int graphite_worker_locked_call(lua_State* L) {
+	LuaWorker* worker = lua_getworker(L);
+	int nb_args = lua_gettop(L);
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_insert(L, 1);
+	int status = LUA_OK;
+	{
+	    std::lock_guard<std::recursive_mutex> lock(*worker->gom_lock);
+	    status = lua_pcall(L, nb_args, LUA_MULTRET, 0);
+	}
+	if(status != LUA_OK) {
+	    return lua_error(L);
+	}
+	return lua_gettop(L);
+    }
+
+    /**
+     * \brief Implementation of __index() metamethod for the global table
+     *  of a worker LUA state.
+     * \details Global variables of the interpreter are copied into the
+     *  worker on first access (they are read-only for the worker, since
+     *  modifications are not sent back).
+     * \param[in] L a pointer to the worker LUA state.
+     * \return the number of LUA objects pushed onto the stack (here 1).
+     */
+    int graphite_worker_global(lua_State* L) {
+	LuaWorker* worker = lua_getworker(L);
+	if(lua_type(L,2) != LUA_TSTRING) {
+	    lua_pushnil(L);
+	    return 1;
+	}
+	bool ok = true;
+	{
+	    std::lock_guard<std::recursive_mutex> lock(*worker->gom_lock);
+	    lua_State* interpreter_L = worker->interpreter_state;
+	    int top = lua_gettop(interpreter_L);
+	    lua_getglobal(interpreter_L, lua_tostring(L,2));
+	    ok = lua_copyvalue(interpreter_L, -1, L);
+	    lua_settop(interpreter_L, top);
+	}
+	if(!ok) {
+	    return luaL_error(
+		L, "global %s cannot be used by parallel_for()",
+		lua_tostring(L,2)
+	    );
+	}
+	lua_pushvalue(L,2);
+	lua_pushvalue(L,-2);
+	lua_rawset(L,1);
+	return 1;
+    }
+
+    /**
+     * \brief Wraps functions of a metatable in graphite_worker_locked_call.
+     * \param[in] L a pointer to the worker LUA state.
+     * \param[in] metatable the name of the metatable in the registry.
+     * \param[in] names the names of the functions, terminated by nullptr.
+     */
+    void lua_lockmetamethods(
+	lua_State* L, const char* metatable, const char** names
+    ) {
+	lua_getfield(L, LUA_REGISTRYINDEX, metatable);
+	for(index_t i=0; names[i] != nullptr; ++i) {
+	    lua_getfield(L, -1, names[i]);
+	    lua_pushcclosure(L, graphite_worker_locked_call, 1);
+	    lua_setfield(L, -2, names[i]);
+	}
+	lua_pop(L,1);
+    }
+
+    /**
+     * \brief Creates a worker LUA state for LuaInterpreter::parallel_for().
+     * \param[in] interpreter a pointer to the LuaInterpreter.
+     * \param[in] worker a pointer to the LuaWorker of the new state.
+     * \return a pointer to the new LUA state.
+     */
+    lua_State* lua_newworker(LuaInterpreter* interpreter, LuaWorker* worker) {
+	lua_State* L = luaL_newstate();
+	luaL_openlibs(L);
+	init_lua_graphite(L, interpreter);
+	init_lua_io(L);
+
+	lua_pushlightuserdata(L, worker);
+	lua_setfield(L, LUA_REGISTRYINDEX, "graphite_worker");
+
+	lua_newtable(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, "graphite_worker_copies");
+
+	static const char* graphite_methods[] = {
+	    "__index", "__newindex", "__len", "__gc", "__call", nullptr
+	};
+	lua_lockmetamethods(L, "graphite_vtbl", graphite_methods);
+
+	// Other buffer view functions do not create or release references
+	static const char* buffer_methods[] = { "__gc", "slice", nullptr };
+	lua_lockmetamethods(L, "graphite_buffer_vtbl", buffer_methods);
+
+	lua_pushglobaltable(L);
+	lua_newtable(L);
+	lua_pushcfunction(L, graphite_worker_global);
+	lua_setfield(L, -2, "__index");
+	lua_setmetatable(L, -2);
+	lua_pop(L,1);
+
+	return L;
+    }
+
+    /**
+     * \brief A LUA hook that stops the running code with an error.
+     * \details Installed by LuaInterpreter::interrupt(), it removes
+     *  itself when triggered.
+     * \param[in] L a pointer to the LUA state
+     * \param[in] ar the LUA debug information (unused)
+     */
+    void lua_interrupthook(lua_State* L, lua_Debug* ar) {
+	geo_argused(ar);
+	lua_sethook(L, nullptr, 0, 0);
+	luaL_error(L, "interrupted");
+    }
+
 }
 
 /*************************************************************************/
@@ -1188,7 +2384,7 @@ namespace OGF {
     LuaInterpreter::LuaInterpreter() {
 	lua_state_ = luaL_newstate();
 	luaL_openlibs(lua_state_);
-	init_lua_graphite(this);
+	init_lua_graphite(lua_state_, this);
 	init_lua_io(lua_state_);
     }
 
@@ -1197,10 +2393,12 @@ namespace OGF {
     }
 
     void LuaInterpreter::reset() {
+	// The references of the compiled chunks belong to the old LUA state.
+	chunk_cache_.clear();
 	lua_close(lua_state_);
 	lua_state_ = luaL_newstate();
 	luaL_openlibs(lua_state_);
-	init_lua_graphite(this);
+	init_lua_graphite(lua_state_, this);
 	init_lua_io(lua_state_);
     }
 
@@ -1213,18 +2411,157 @@ namespace OGF {
             Logger::out("GOMLua") << command << std::endl;
         }
 
-	if(luaL_dostring(lua_state_,command.c_str())) {
+	if(
+	    !load_chunk(command) ||
+	    lua_pcall(lua_state_, 0, LUA_MULTRET, 0) != LUA_OK
+	) {
 	    adjust_lua_state();
 	    const char* msg = lua_tostring(lua_state_,-1);
 	    display_error_message(msg);
 	    result = false;
 	}
+	// An interruption that arrived too late must not stop the next
+	// command.
+	if(lua_gethook(lua_state_) == lua_interrupthook) {
+	    lua_sethook(lua_state_, nullptr, 0, 0);
+	}
         if(save_in_history) {
             add_to_history(command);
         }
         return result;
     }
 
+    void LuaInterpreter::interrupt() {
+	// lua_sethook() is the only LUA function that can be called
+	// asynchronously, the hook is triggered at the next instruction.
+	lua_sethook(
+	    lua_state_, lua_interrupthook,
+	    LUA_MASKCALL | LUA_MASKRET | LUA_MASKCOUNT, 1
+	);
+    }
+
+    bool LuaInterpreter::parallel_for(
+	index_t from, index_t to, Callable* body
+    ) {
+	LuaCallable* lua_body = dynamic_cast<LuaCallable*>(body);
+	index_t nb_workers = 0;
+	if(from < to) {
+	    nb_workers = std::min(Process::maximum_concurrent_threads(), to-from);
+	}
+	if(
+	    lua_body == nullptr || lua_body->lua_state() != lua_state_ ||
+	    nb_workers < 2
+	) {
+	    return Interpreter::parallel_for(from, to, body);
+	}
+
+	// Each worker thread has its own LUA state, with a copy of the
+	// function. GOM accesses are serialized by gom_lock.
+	std::recursive_mutex gom_lock;
+	std::vector<LuaWorker> workers(nb_workers);
+	std::vector<lua_State*> states(nb_workers, nullptr);
+	bool copied = true;
+	int top = lua_gettop(lua_state_);
+	lua_body->push_target();
+	for(index_t w=0; w<nb_workers && copied; ++w) {
+	    workers[w].interpreter_state = lua_state_;
+	    workers[w].gom_lock = &gom_lock;
+	    states[w] = lua_newworker(this, &workers[w]);
+	    copied = lua_copyvalue(lua_state_, -1, states[w]);
+	    if(copied) {
+		lua_setfield(
+		    states[w], LUA_REGISTRYINDEX, "graphite_worker_body"
+		);
+	    }
+	}
+	lua_settop(lua_state_, top);
+
+	if(!copied) {
+	    for(lua_State* L : states) {
+		if(L != nullptr) {
+		    lua_close(L);
+		}
+	    }
+	    Logger::warn("Lua")
+		<< "parallel_for(): function uses values that cannot be "
+		<< "sent to worker threads (coroutines, userdata, tables "
+		<< "with a metatable), running it sequentially"
+		<< std::endl;
+	    return Interpreter::parallel_for(from, to, body);
+	}
+
+	std::atomic<bool> result(true);
+	std::vector<std::string> errors(nb_workers);
+	GEO::parallel_for(
+	    0, nb_workers,
+	    [&](index_t w) {
+		lua_State* L = states[w];
+		index_t b = from + index_t(
+		    Numeric::uint64(to-from) * w / nb_workers
+		);
+		index_t e = from + index_t(
+		    Numeric::uint64(to-from) * (w+1) / nb_workers
+		);
+		lua_getfield(L, LUA_REGISTRYINDEX, "graphite_worker_body");
+		for(index_t i=b; i<e && result; ++i) {
+		    lua_pushvalue(L,-1);
+		    lua_pushinteger(L, lua_Integer(i));
+		    if(lua_pcall(L, 1, 0, 0) != LUA_OK) {
+			const char* msg = lua_tostring(L,-1);
+			errors[w] = (msg == nullptr) ? "error" : msg;
+			result = false;
+		    }
+		}
+		lua_settop(L,0);
+	    }
+	);
+
+	// Deferred notifications of modified element buffers, sent from
+	// this thread, before the workers release the objects.
+	std::set<Object*> modified;
+	for(const LuaWorker& worker : workers) {
+	    modified.insert(worker.modified.begin(), worker.modified.end());
+	}
+	for(Object* object : modified) {
+	    object->element_buffer_modified();
+	}
+	for(lua_State* L : states) {
+	    lua_close(L);
+	}
+
+	for(const std::string& error : errors) {
+	    if(!error.empty()) {
+		display_error_message(error);
+		break;
+	    }
+	}
+	return result;
+    }
+
+    bool LuaInterpreter::load_chunk(const std::string& source) {
+	auto it = chunk_cache_.find(source);
+	if(it != chunk_cache_.end()) {
+	    lua_rawgeti(lua_state_, LUA_REGISTRYINDEX, lua_Integer(it->second));
+	    return true;
+	}
+	if(luaL_loadstring(lua_state_, source.c_str()) != LUA_OK) {
+	    return false;
+	}
+	if(chunk_cache_.size() >= MAX_CACHED_CHUNKS) {
+	    clear_chunk_cache();
+	}
+	lua_pushvalue(lua_state_,-1);
+	chunk_cache_[source] = luaL_ref(lua_state_, LUA_REGISTRYINDEX);
+	return true;
+    }
+
+    void LuaInterpreter::clear_chunk_cache() {
+	for(auto& it : chunk_cache_) {
+	    luaL_unref(lua_state_, LUA_REGISTRYINDEX, it.second);
+	}
+	chunk_cache_.clear();
+    }
+
     bool LuaInterpreter::execute_file(const std::string& file_name_in) {
 	std::string file_name = file_name_in;
         Environment::instance()->set_value("current_gel_file", file_name);
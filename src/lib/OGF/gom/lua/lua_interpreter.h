@@ -41,6 +41,8 @@
 #include <OGF/gom/interpreter/interpreter.h>
 #include <OGF/gom/types/callable.h>
 
+#include <unordered_map>
+
 struct lua_State;
 
 /**
@@ -74,6 +76,19 @@ namespace OGF {
 	 * \brief LuaCallable destructor.
 	 */
 	~LuaCallable() override;
+
+	/**
+	 * \brief Gets the LUA state.
+	 * \return a pointer to the LUA state where the target resides.
+	 */
+	lua_State* lua_state() const {
+	    return lua_state_;
+	}
+
+	/**
+	 * \brief Pushes the target onto the stack of the LUA state.
+	 */
+	void push_target() const;
 	
     private:
 	index_t instance_id_;
@@ -120,6 +135,25 @@ namespace OGF {
          */
         bool execute_file(const std::string& file_name) override;
 
+	/**
+	 * \copydoc Interpreter::parallel_for()
+	 * \details If \p body is a LUA function, it is run by worker
+	 *  threads, each one with its own LUA state. The function and its
+	 *  upvalues are copied to the workers, and global variables are
+	 *  copied on first access: they are read-only (modifications are
+	 *  not seen by the other workers nor by the interpreter). Results
+	 *  are written through buffer views (object.buffer), that access
+	 *  the elements directly and are notified when all the workers are
+	 *  done. Accesses to Graphite objects are serialized.
+	 */
+	bool parallel_for(index_t from, index_t to, Callable* body) override;
+
+	/**
+	 * \copydoc Interpreter::interrupt()
+	 * \details Installs a LUA hook that raises an error.
+	 */
+	void interrupt() override;
+
 	/**
 	 * \copydoc Interpreter::resolve()
 	 */
@@ -170,6 +204,24 @@ namespace OGF {
 	 *  activated.
 	 */
 	virtual void adjust_lua_state();
+
+	/**
+	 * \brief Pushes the compiled function of a LUA chunk onto the stack.
+	 * \details Compiled chunks are cached, indexed by their source, so
+	 *  that commands that are executed several times (e.g., by the GUI)
+	 *  are compiled only once.
+	 * \param[in] source the LUA source of the chunk.
+	 * \retval true if the chunk could be compiled. Then the function
+	 *  is pushed onto the stack.
+	 * \retval false otherwise. Then the error message is pushed onto
+	 *  the stack.
+	 */
+	bool load_chunk(const std::string& source);
+
+	/**
+	 * \brief Releases all the compiled chunks stored in the cache.
+	 */
+	void clear_chunk_cache();
 	
 	/**
 	 * \copydoc Interpreter::get_keys()
@@ -188,6 +240,18 @@ namespace OGF {
 	 
     private:
 	lua_State* lua_state_;	
+
+	/**
+	 * \brief Maximum number of compiled chunks in the cache. When
+	 *  it is reached, the cache is cleared.
+	 */
+	static const size_t MAX_CACHED_CHUNKS = 256;
+
+	/**
+	 * \brief Maps the source of the cached chunks to the
+	 *  LUA registry references of their compiled functions.
+	 */
+	std::unordered_map<std::string, int> chunk_cache_;
     }; 
 
 } 
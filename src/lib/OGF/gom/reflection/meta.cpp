@@ -36,14 +36,101 @@
 
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/types/gom_implementation.h>
+#include <OGF/basic/modules/modmgr.h>
+#include <OGF/basic/os/startup_profiler.h>
+
+
+#include <algorithm>
+#include <sstream>
+#include <mutex>
 
 //___________________________________________________
 
 namespace OGF {
 
+    Meta::TypeIndex::Slots::Slots(index_t capacity_in) :
+        capacity(capacity_in),
+        entries(new std::atomic<Entry*>[capacity_in]) {
+        for(index_t i=0; i<capacity; ++i) {
+            entries[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    Meta::TypeIndex::TypeIndex() {
+        all_slots_.emplace_back(new Slots(1024));
+        slots_.store(all_slots_.back().get(), std::memory_order_release);
+    }
+
+    MetaType* Meta::TypeIndex::find(const std::string& name) const {
+        const Slots* slots = slots_.load(std::memory_order_acquire);
+        index_t mask = slots->capacity - 1;
+        index_t i = index_t(std::hash<std::string>()(name)) & mask;
+        for(;;) {
+            const Entry* entry = slots->entries[i].load(
+                std::memory_order_acquire
+            );
+            if(entry == nullptr) {
+                return nullptr;
+            }
+            if(entry->name == name) {
+                return entry->type.load(std::memory_order_acquire);
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    void Meta::TypeIndex::insert(Slots& slots, Entry* entry) {
+        index_t mask = slots.capacity - 1;
+        index_t i = index_t(std::hash<std::string>()(entry->name)) & mask;
+        while(slots.entries[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & mask;
+        }
+        slots.entries[i].store(entry, std::memory_order_release);
+    }
+
+    void Meta::TypeIndex::set(const std::string& name, MetaType* type) {
+        Slots* slots = slots_.load(std::memory_order_relaxed);
+        index_t mask = slots->capacity - 1;
+        index_t i = index_t(std::hash<std::string>()(name)) & mask;
+        for(;;) {
+            Entry* entry = slots->entries[i].load(std::memory_order_relaxed);
+            if(entry == nullptr) {
+                break;
+            }
+            if(entry->name == name) {
+                entry->type.store(type, std::memory_order_release);
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        if(type == nullptr) {
+            return;
+        }
+        // Keeps the load factor below 1/2. The new slots are filled
+        // before being published.
+        if(2 * (entries_.size() + 1) > slots->capacity) {
+            all_slots_.emplace_back(new Slots(2 * slots->capacity));
+            slots = all_slots_.back().get();
+            for(const std::unique_ptr<Entry>& entry : entries_) {
+                insert(*slots, entry.get());
+            }
+            slots_.store(slots, std::memory_order_release);
+        }
+        entries_.emplace_back(new Entry(name, type));
+        insert(*slots, entries_.back().get());
+    }
+
+    void Meta::TypeIndex::clear() {
+        for(const std::unique_ptr<Entry>& entry : entries_) {
+            entry->type.store(nullptr, std::memory_order_release);
+        }
+    }
+
+    /*******************************************************************/
+
     Meta* Meta::instance_ = nullptr ;
 
-    Meta::Meta() {
+    Meta::Meta() : nb_class_tables_(0) {
     }
 
     Meta::~Meta() {
@@ -51,6 +138,12 @@ namespace OGF {
 	// because deleting Any requires to access the LifeCycle objects
 	// that are stored in the Meta information (do not saw the branch...)
 	// Now we are good to go !
+        MetaClass::meta_type_unbound();
+        Any::invalidate_meta_type_caches();
+        type_name_index_.clear();
+        typeid_name_index_.clear();
+        lazy_class_tables_.clear();
+        lazy_class_tables_by_typeid_.clear();
         for(auto& it : type_name_to_meta_type_) {
 	    it.second->pre_delete();
 	}
@@ -74,18 +167,44 @@ namespace OGF {
         return instance_ ;
     }
 
+    MetaType* Meta::find_meta_type(const std::string& type_name) const {
+        auto it = type_name_to_meta_type_.find(type_name) ;
+        if(it == type_name_to_meta_type_.end()) {
+            return nullptr ;
+        }
+        return it->second ;
+    }
+
+    MetaType* Meta::find_meta_type_by_typeid_name(
+        const std::string& typeid_name
+    ) const {
+        auto it = typeid_name_to_meta_type_.find(typeid_name) ;
+        if(it == typeid_name_to_meta_type_.end()) {
+            return nullptr ;
+        }
+        return it->second ;
+    }
+
     bool Meta::meta_type_is_bound(const std::string& name) const {
-        return ( 
-            type_name_to_meta_type_.find(name) != 
-            type_name_to_meta_type_.end()
-        ) ;
+        // Pure lookup: the class tables are not materialized and the
+        // deferred modules are not loaded (see resolve_meta_type()).
+        if(type_name_index_.find(name) != nullptr) {
+            return true;
+        }
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return (lazy_class_tables_.find(name) != lazy_class_tables_.end());
     }
 
     bool Meta::bind_meta_type(MetaType* meta_type) {
-        if(meta_type_is_bound(meta_type->name())) {
-            return false ;
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            if(find_meta_type(meta_type->name()) != nullptr) {
+                return false ;
+            }
+            type_name_to_meta_type_[meta_type->name()] = meta_type ;
+            type_name_index_.set(meta_type->name(), meta_type);
         }
-        type_name_to_meta_type_[meta_type->name()] = meta_type ;
+        MetaClass::meta_type_bound();
         return true ;
     }
 
@@ -97,89 +216,244 @@ namespace OGF {
         // in gom_implementation.h, that creates SmartPointers
         // that are subsequently deallocated if the type is
         // already bound (not very clean)...
-        
-        //  If meta type is already bound with same "user name",
-        // then there is nothing to do (same meta type can be
-        // registered several times in GOMGEN generated code).
-        if(meta_type_is_bound(meta_type->name())) {
-            return false;
-        }
-        //  If meta type is already bound *by typeid name*, then
-        // we are declaring an alias (and we bind the already
-        // registered meta type to the "user name").
-        if(typeid_name_is_bound(typeid_name)) {
-            type_name_to_meta_type_[meta_type->name()] =
-                typeid_name_to_meta_type_[typeid_name];
-        } else {
-            type_name_to_meta_type_[meta_type->name()] = meta_type ;
-            typeid_name_to_meta_type_[typeid_name] = meta_type ;
-            meta_type->set_typeid_name(typeid_name);
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            //  If meta type is already bound with same "user name",
+            // then there is nothing to do (same meta type can be
+            // registered several times in GOMGEN generated code).
+            if(find_meta_type(meta_type->name()) != nullptr) {
+                return false;
+            }
+            //  If meta type is already bound *by typeid name*, then
+            // we are declaring an alias (and we bind the already
+            // registered meta type to the "user name").
+            MetaType* existing = find_meta_type_by_typeid_name(typeid_name);
+            if(existing != nullptr) {
+                type_name_to_meta_type_[meta_type->name()] = existing;
+                type_name_index_.set(meta_type->name(), existing);
+            } else {
+                meta_type->set_typeid_name(typeid_name);
+                type_name_to_meta_type_[meta_type->name()] = meta_type ;
+                typeid_name_to_meta_type_[typeid_name] = meta_type ;
+                type_name_index_.set(meta_type->name(), meta_type);
+                typeid_name_index_.set(typeid_name, meta_type);
+            }
         }
+        MetaClass::meta_type_bound();
         return true ;
     }
     
     bool Meta::unbind_meta_type(const std::string& name) {
-        MetaType* type = nullptr ;            
+        // Classes declared by a constant table are created first, so that
+        // they are completely removed.
+        materialize_class_table(lazy_class_tables_, name);
+        // Keeps the MetaType alive until the lock is released (its
+        // destructor may access the Meta repository).
+        MetaType_var type;
         {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
             auto it = type_name_to_meta_type_.find(name) ;
             if(it == type_name_to_meta_type_.end()) {
                 return false ;
             }
             type = it->second ;
             type_name_to_meta_type_.erase(it) ;
-        }
-
-        {
+            type_name_index_.set(name, nullptr);
             for(
-                auto it = typeid_name_to_meta_type_.begin(); 
-                it != typeid_name_to_meta_type_.end(); ++it
+                auto jt = typeid_name_to_meta_type_.begin(); 
+                jt != typeid_name_to_meta_type_.end(); ++jt
             ) {
-                if(it->second == type) {
-                    typeid_name_to_meta_type_.erase(it) ;
+                if(jt->second == type.get()) {
+                    typeid_name_index_.set(jt->first, nullptr);
+                    typeid_name_to_meta_type_.erase(jt) ;
                     break ;
                 }
             }
         }
+        MetaClass::meta_type_unbound();
+        Any::invalidate_meta_type_caches();
         return true ;
     }
 
     MetaType* Meta::resolve_meta_type(const std::string& type_name) const {
-        auto it = type_name_to_meta_type_.find(type_name) ;
-        if(it == type_name_to_meta_type_.end()) {
-            return nullptr ;
+        MetaType* result = type_name_index_.find(type_name);
+        if(result != nullptr) {
+            return result;
         }
-        return it->second ;
+        bool has_lazy_class_tables = false;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            has_lazy_class_tables = !lazy_class_tables_.empty();
+        }
+        if(has_lazy_class_tables) {
+            materialize_class_table(lazy_class_tables_, type_name);
+            result = type_name_index_.find(type_name);
+            if(result != nullptr) {
+                return result;
+            }
+        }
+        // The type may be declared by a module that is not loaded yet
+        // (see ModuleManager::defer_module()).
+        if(load_module_for_type(type_name)) {
+            return resolve_meta_type(type_name);
+        }
+        return nullptr;
+    }
+
+    bool Meta::load_module_for_type(const std::string& type_name) const {
+        ModuleManager* module_manager = ModuleManager::instance();
+        if(module_manager == nullptr) {
+            return false;
+        }
+        std::string class_name = type_name;
+        if(
+            class_name.length() != 0 &&
+            class_name[class_name.length()-1] == '*'
+        ) {
+            class_name.resize(class_name.length()-1);
+        }
+        return module_manager->load_module_for_class(class_name);
     }
 
     bool Meta::typeid_name_is_bound(const std::string& typeid_name) const {
-        return ( 
-            typeid_name_to_meta_type_.find(typeid_name) != 
-            typeid_name_to_meta_type_.end()
-        ) ;
+        return (resolve_meta_type_by_typeid_name(typeid_name) != nullptr) ;
     }
 
     MetaType* Meta::resolve_meta_type_by_typeid_name(
         const std::string& typeid_name
     ) const {
-        auto it = typeid_name_to_meta_type_.find(typeid_name) ;
-        if(it == typeid_name_to_meta_type_.end()) {
-            return nullptr ;
+        MetaType* result = typeid_name_index_.find(typeid_name);
+        if(result != nullptr) {
+            return result;
+        }
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if(lazy_class_tables_by_typeid_.empty()) {
+                return nullptr;
+            }
+        }
+        materialize_class_table(lazy_class_tables_by_typeid_, typeid_name);
+        return typeid_name_index_.find(typeid_name);
+    }
+
+    void Meta::declare_meta_class_table(const MetaClassTable* table) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        std::string name(table->name);
+        if(
+            find_meta_type(name) != nullptr ||
+            lazy_class_tables_.find(name) != lazy_class_tables_.end()
+        ) {
+            return;
+        }
+        lazy_class_tables_[name] = table;
+        lazy_class_tables_[name + "*"] = table;
+        lazy_class_tables_by_typeid_[table->type->name()] = table;
+        lazy_class_tables_by_typeid_[table->pointer_type->name()] = table;
+        ++nb_class_tables_;
+    }
+
+    void Meta::materialize_class_table(
+        const ClassTablesTable& tables, const std::string& key
+    ) const {
+        // Another thread may be materializing the same class: we wait
+        // for it, then the table is no longer there.
+        std::lock_guard<std::recursive_mutex> guard(materialize_mutex_);
+        const MetaClassTable* table = nullptr;
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            auto it = tables.find(key);
+            if(it == tables.end()) {
+                return;
+            }
+            table = it->second;
+            std::string name(table->name);
+            lazy_class_tables_.erase(name);
+            lazy_class_tables_.erase(name + "*");
+            lazy_class_tables_by_typeid_.erase(table->type->name());
+            lazy_class_tables_by_typeid_.erase(table->pointer_type->name());
+        }
+        // Declares the superclass (resolved by name) if needed, and binds
+        // the new MetaClass (not under the lock).
+        materialize_meta_class(*table);
+    }
+
+    void Meta::materialize_all_class_tables() const {
+        for(;;) {
+            std::string name;
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                if(lazy_class_tables_.empty()) {
+                    return;
+                }
+                name = lazy_class_tables_.begin()->second->name;
+            }
+            materialize_class_table(lazy_class_tables_, name);
         }
-        return it->second ;
+    }
+
+    void Meta::initialize_package(
+        const std::string& name, gom_package_initializer initializer
+    ) {
+        StartupTimer timer("package", name);
+        if(!StartupProfiler::is_enabled()) {
+            initializer();
+            return;
+        }
+        index_t nb_types_before = 0;
+        index_t nb_class_tables_before = 0;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            nb_types_before = index_t(type_name_to_meta_type_.size());
+            nb_class_tables_before = nb_class_tables_;
+        }
+        initializer();
+        index_t nb_bound_types = 0;
+        index_t nb_class_tables = 0;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            nb_bound_types =
+                index_t(type_name_to_meta_type_.size()) - nb_types_before;
+            nb_class_tables = nb_class_tables_ - nb_class_tables_before;
+        }
+        std::ostringstream details;
+        details << nb_bound_types << " types bound, "
+                << nb_class_tables << " class tables";
+        timer.set_details(details.str());
+    }
+
+    void gom_initialize_package(
+        const char* name, gom_package_initializer initializer
+    ) {
+        Meta::instance()->initialize_package(name, initializer);
     }
 
     void Meta::list_types(std::vector<MetaType*>& types) {
+        // Sorted by type name (the table is not ordered).
+        std::vector<std::string> type_names;
+        list_type_names(type_names);
         types.clear() ;
-        for(auto& it : type_name_to_meta_type_) {
-            types.push_back(it.second);
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for(const std::string& type_name : type_names) {
+            MetaType* type = find_meta_type(type_name);
+            if(type != nullptr) {
+                types.push_back(type);
+            }
         }
     }
 
     void Meta::list_type_names(std::vector<std::string>& type_names) {
+        if(ModuleManager::instance() != nullptr) {
+            ModuleManager::instance()->load_deferred_modules();
+        }
+        materialize_all_class_tables();
         type_names.clear() ;
-        for(auto& it : type_name_to_meta_type_) {
-            type_names.push_back(it.first);
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            for(auto& it : type_name_to_meta_type_) {
+                type_names.push_back(it.first);
+            }
         }
+        std::sort(type_names.begin(), type_names.end());
     }
 }
 
@@ -40,10 +40,16 @@
 #include <OGF/gom/common/common.h>
 #include <OGF/gom/reflection/meta_type.h>
 #include <OGF/gom/reflection/meta_class.h>
+#include <OGF/gom/reflection/meta_table.h>
 
 #include <typeinfo>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <sstream>
@@ -86,6 +92,10 @@ namespace OGF {
         /**
          * \brief Tests whether a MetaType exists in the system
          *  by type name.
+         * \details Only looks up the bound types and the declared
+         *  class tables, without creating the MetaClass of a class
+         *  table nor loading a deferred module. Use resolve_meta_type()
+         *  to get the MetaType.
          * \param[in] name type name
          * \retval true if a type with name \p name exists in the
          *  system
@@ -172,6 +182,31 @@ namespace OGF {
          */
         void list_type_names(std::vector<std::string>& type_names);
 
+        /**
+         * \brief Declares a class from its constant table.
+         * \details The MetaClass is only created the first time it is
+         *  resolved, by name, by typeid name, or when listing all the
+         *  types. Used by the code generated by gomgen -static_tables.
+         * \param[in] table a pointer to the constant table, that needs
+         *  to remain valid until the Meta database is terminated
+         * \see materialize_meta_class()
+         */
+        void declare_meta_class_table(const MetaClassTable* table);
+
+        /**
+         * \brief Initializes a package.
+         * \details When the StartupProfiler is enabled (graphite
+         *  profile_startup=true), the initialization is recorded as a
+         *  "package" step, with the number of types it bound and of
+         *  class tables it declared (gomgen -static_tables).
+         * \param[in] name the name of the package
+         * \param[in] initializer the function generated by gomgen that
+         *  declares all the classes of the package
+         */
+        void initialize_package(
+            const std::string& name, gom_package_initializer initializer
+        );
+
         /**
          * \brief Initializes the Meta database
          * \note Does not need to be called by client code, called
@@ -193,12 +228,153 @@ namespace OGF {
          */
         Meta() ;
 
-        typedef std::map<std::string, MetaType_var> MetaTypesTable ;
-        typedef std::map<std::string, MetaType*> TypeidNamesTable ;
+        /**
+         * \brief Finds a MetaType by name, without locking.
+         * \pre the caller holds mutex_
+         */
+        MetaType* find_meta_type(const std::string& type_name) const;
+
+        /**
+         * \brief Finds a MetaType by typeid name, without locking.
+         * \pre the caller holds mutex_
+         */
+        MetaType* find_meta_type_by_typeid_name(
+            const std::string& typeid_name
+        ) const;
+
+        typedef std::unordered_map<std::string, const MetaClassTable*>
+            ClassTablesTable ;
+
+        /**
+         * \brief Creates the MetaClass of a class declared with
+         *  declare_meta_class_table(), if not already done.
+         * \param[in] tables one of lazy_class_tables_ or
+         *  lazy_class_tables_by_typeid_
+         * \param[in] key the type name or typeid name
+         */
+        void materialize_class_table(
+            const ClassTablesTable& tables, const std::string& key
+        ) const;
+
+        /**
+         * \brief Creates the MetaClasses of all the classes declared with
+         *  declare_meta_class_table().
+         */
+        void materialize_all_class_tables() const;
+
+        /**
+         * \brief Loads the deferred module that declares a type, if any.
+         * \param[in] type_name the name of the type
+         * \retval true if a module was loaded
+         * \retval false otherwise
+         * \see ModuleManager::defer_module()
+         */
+        bool load_module_for_type(const std::string& type_name) const;
+
+        typedef std::unordered_map<std::string, MetaType_var> MetaTypesTable ;
+        typedef std::unordered_map<std::string, MetaType*> TypeidNamesTable ;
+
+        /**
+         * \brief A hash table that maps names to MetaTypes, and that can
+         *  be queried without any lock while it is modified.
+         * \details Open addressing with linear probing. Entries are never
+         *  removed (unbinding a type sets its MetaType to nullptr), and
+         *  when the table grows, the replaced array of slots is kept until
+         *  the table is destroyed, so that concurrent queries can finish
+         *  with it. Modifications need to be serialized by the caller.
+         */
+        class TypeIndex {
+        public:
+            /**
+             * \brief TypeIndex constructor.
+             */
+            TypeIndex();
+
+            /**
+             * \brief Finds a MetaType by name.
+             * \details Does not lock anything.
+             * \param[in] name the name
+             * \return the MetaType or nullptr if there is no MetaType
+             *  bound to \p name
+             */
+            MetaType* find(const std::string& name) const;
+
+            /**
+             * \brief Binds a name to a MetaType.
+             * \param[in] name the name
+             * \param[in] type a pointer to the MetaType, or nullptr to
+             *  unbind \p name
+             * \pre modifications are serialized by the caller
+             */
+            void set(const std::string& name, MetaType* type);
+
+            /**
+             * \brief Unbinds all the names.
+             * \pre modifications are serialized by the caller
+             */
+            void clear();
+
+        private:
+            struct Entry {
+                Entry(const std::string& name_in, MetaType* type_in) :
+                    name(name_in), type(type_in) {
+                }
+                std::string name;
+                std::atomic<MetaType*> type;
+            };
+
+            struct Slots {
+                explicit Slots(index_t capacity_in);
+                index_t capacity;
+                std::unique_ptr<std::atomic<Entry*>[]> entries;
+            };
+
+            void insert(Slots& slots, Entry* entry);
+
+            std::atomic<Slots*> slots_;
+            std::vector<std::unique_ptr<Slots> > all_slots_;
+            std::vector<std::unique_ptr<Entry> > entries_;
+        };
 
         static Meta* instance_ ;
         MetaTypesTable   type_name_to_meta_type_ ;
         TypeidNamesTable typeid_name_to_meta_type_ ;
+
+        /**
+         * \brief Copies of the tables that are queried without locking,
+         *  once a type is bound (for instance from parallel_for() bodies).
+         */
+        TypeIndex type_name_index_ ;
+        TypeIndex typeid_name_index_ ;
+
+        /**
+         * \brief Protects the tables. (Un)binding types takes an exclusive
+         *  lock. Queries of types that are bound do not lock anything, the
+         *  other ones take a shared lock to check whether the type is
+         *  declared by a class table that is not materialized yet.
+         */
+        mutable std::shared_mutex mutex_ ;
+
+        /**
+         * \brief The classes declared with declare_meta_class_table() and
+         *  not materialized yet, indexed by name and pointer type name,
+         *  and by typeid names. Protected by mutex_.
+         */
+        mutable ClassTablesTable lazy_class_tables_ ;
+        mutable ClassTablesTable lazy_class_tables_by_typeid_ ;
+
+        /**
+         * \brief Serializes materialization. Recursive, because
+         *  materializing a class materializes its superclass.
+         */
+        mutable std::recursive_mutex materialize_mutex_ ;
+
+        /**
+         * \brief Number of class tables declared by
+         *  declare_meta_class_table(), used to count the ones of each
+         *  package in initialize_package().
+         */
+        index_t nb_class_tables_ ;
     } ;
 
     //___________________________________________________________________
@@ -39,11 +39,19 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/reflection/dynamic_object.h>
 
+#include <mutex>
+
 /*****************************************************************************/
 
 namespace {
     using namespace OGF;
 
+    /**
+     * \brief Protects the members of the MetaClasses while they are
+     *  added or indexed.
+     */
+    std::mutex members_mutex;
+
     /**
      * \brief Gets a member of a specific type by index.
      * \details Indices count only the members of the specified type
@@ -99,10 +107,15 @@ namespace {
 
 namespace OGF {
 
+    std::atomic<index_t> MetaClass::indices_timestamp_(1);
+    std::atomic<index_t> MetaClass::types_bound_timestamp_(0);
+    std::atomic<index_t> MetaClass::types_unbound_timestamp_(0);
+
     MetaClass::MetaClass(
         const std::string& class_name, MetaClass* super_class, bool abstract
     ) : MetaType(class_name),
-        super_class_name_(super_class ? super_class->name() : std::string()) {
+        super_class_name_(super_class ? super_class->name() : std::string()),
+        members_timestamp_(0) {
         abstract_ = abstract;
         if(!abstract) {
             set_factory(new FactoryMetaClass(this));
@@ -112,7 +125,8 @@ namespace OGF {
     MetaClass::MetaClass(
         const std::string& class_name, const std::string& super_class_name,
         bool abstract
-    ) : MetaType(class_name), super_class_name_(super_class_name) {
+    ) : MetaType(class_name), super_class_name_(super_class_name),
+        members_timestamp_(0) {
         abstract_ = abstract;
         if(!abstract) {
             set_factory(new FactoryMetaClass(this));
@@ -185,12 +199,118 @@ namespace OGF {
     }
 
     MetaClass* MetaClass::super_class() const {
+        if(super_class_name_.length() == 0) {
+            return nullptr;
+        }
         MetaType* super_type = Meta::instance()->resolve_meta_type(
             super_class_name_
         );
         return dynamic_cast<MetaClass*>(super_type);
     }
 
+    void MetaClass::add_member(MetaMember* member) {
+        std::lock_guard<std::mutex> lock(members_mutex);
+        members_.push_back(member);
+        members_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+        indices_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    bool MetaClass::member_indices_are_up_to_date(
+        const MemberIndices& indices
+    ) const {
+        if(
+            indices.types_unbound_timestamp !=
+            types_unbound_timestamp_.load(std::memory_order_acquire)
+        ) {
+            return false;
+        }
+        if(
+            indices.has_unresolved_super_class &&
+            indices.types_bound_timestamp !=
+            types_bound_timestamp_.load(std::memory_order_acquire)
+        ) {
+            return false;
+        }
+        // No type was unbound, thus the super classes still exist.
+        for(const auto& it: indices.classes) {
+            if(
+                it.first->members_timestamp_.load(std::memory_order_acquire)
+                != it.second
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const MetaClass::MemberIndices>
+    MetaClass::update_member_indices() const {
+        // Several threads may rebuild the indices of the same class at
+        // the same time: they all build valid indices, and the last one
+        // published wins. No lock is held while resolving the super class
+        // (this may create classes and load modules).
+        std::shared_ptr<MemberIndices> result =
+            std::make_shared<MemberIndices>();
+
+        // Read at the beginning, so that indices invalidated while
+        // rebuilding are rebuilt again on next lookup.
+        result->types_bound_timestamp =
+            types_bound_timestamp_.load(std::memory_order_acquire);
+        result->types_unbound_timestamp =
+            types_unbound_timestamp_.load(std::memory_order_acquire);
+
+        std::shared_ptr<const MemberIndices> super_indices;
+        MetaClass* super = super_class();
+        if(super != nullptr) {
+            super_indices = super->member_indices();
+        }
+        result->has_unresolved_super_class =
+            (super_class_name_.length() != 0 && super_indices == nullptr) ||
+            (super_indices != nullptr &&
+             super_indices->has_unresolved_super_class);
+
+        // If several members have the same name, the first one wins
+        // (emplace() does not overwrite), and members declared in this
+        // class shadow inherited ones.
+        {
+            std::lock_guard<std::mutex> lock(members_mutex);
+            result->classes.push_back(
+                std::make_pair(
+                    this, members_timestamp_.load(std::memory_order_acquire)
+                )
+            );
+            for(const MetaMember_var& cur: members_) {
+                result->local.members.emplace(cur->name(), cur);
+            }
+        }
+        result->all.members = result->local.members;
+        if(super_indices != nullptr) {
+            for(auto& it: super_indices->all.members) {
+                result->all.members.emplace(it.first, it.second);
+            }
+            result->classes.insert(
+                result->classes.end(),
+                super_indices->classes.begin(), super_indices->classes.end()
+            );
+        }
+
+        for(MemberIndex* idx: {&result->local, &result->all}) {
+            for(auto& it: idx->members) {
+                MetaProperty* mprop = dynamic_cast<MetaProperty*>(it.second);
+                if(mprop != nullptr) {
+                    idx->accessors.emplace("get_" + it.first, mprop);
+                    idx->accessors.emplace("set_" + it.first, mprop);
+                }
+            }
+        }
+
+        std::atomic_store_explicit(
+            &indices_, std::shared_ptr<const MemberIndices>(result),
+            std::memory_order_release
+        );
+        return result;
+    }
+
     size_t MetaClass::nb_members(bool super) const {
         size_t result = members_.size();
         if(super && super_class() != nullptr) {
@@ -259,38 +379,31 @@ namespace OGF {
     MetaMember* MetaClass::find_member(
         const std::string& member_name, bool super
     ) const {
-        for(unsigned int i=0; i<members_.size(); i++) {
-            MetaMember* cur = members_[i];
-            if(cur->name() == member_name) {
-                return cur;
-            }
-        }
-        if(super && super_class() != nullptr) {
-            return super_class()->find_member(member_name, true);
-        }
-        return nullptr;
+        std::shared_ptr<const MemberIndices> indices = member_indices();
+        const MemberIndex& idx = super ? indices->all : indices->local;
+        auto it = idx.members.find(member_name);
+        return (it == idx.members.end()) ? nullptr : it->second;
     }
 
     MetaMethod* MetaClass::find_method(
         const std::string& member_name, bool super
     ) const {
-        if(String::string_starts_with(member_name, "get_")) {
-            std::string property_name =
-                member_name.substr(4, member_name.length()-4);
-            MetaProperty* mprop = find_property(property_name, super);
-            if(mprop != nullptr) {
-                return mprop->meta_method_get();
-            }
-        }
-        if(String::string_starts_with(member_name, "set_")) {
-            std::string property_name =
-                member_name.substr(4, member_name.length()-4);
-            MetaProperty* mprop = find_property(property_name, super);
-            if(mprop != nullptr) {
-                return mprop->meta_method_set();
+        std::shared_ptr<const MemberIndices> indices = member_indices();
+        const MemberIndex& idx = super ? indices->all : indices->local;
+        if(
+            String::string_starts_with(member_name, "get_") ||
+            String::string_starts_with(member_name, "set_")
+        ) {
+            auto it = idx.accessors.find(member_name);
+            if(it != idx.accessors.end()) {
+                return (member_name[0] == 'g') ?
+                    it->second->meta_method_get() :
+                    it->second->meta_method_set() ;
             }
         }
-        return dynamic_cast<MetaMethod*>(find_member(member_name, super));
+        auto it = idx.members.find(member_name);
+        return (it == idx.members.end()) ?
+            nullptr : dynamic_cast<MetaMethod*>(it->second);
     }
 
     MetaSignal* MetaClass::find_signal(
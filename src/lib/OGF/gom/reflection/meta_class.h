@@ -48,6 +48,9 @@
 
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
 
 /**
  * \file OGF/gom/reflection/meta_class.h
@@ -317,8 +320,38 @@ namespace OGF {
          *  to be added. Ownership is transfered to this
          *  MetaClass.
          */
-        void add_member(MetaMember* member) {
-            members_.push_back(member);
+        void add_member(MetaMember* member);
+
+        /**
+         * \brief Indicates that a MetaType was bound in Meta.
+         * \details Only the member indices of the classes that have an
+         *  unresolved super class need to be rebuilt.
+         */
+        static void meta_type_bound() {
+            types_bound_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+            indices_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        /**
+         * \brief Indicates that a MetaType was unbound from Meta.
+         * \details The MetaClass may be destroyed, and it may be the super
+         *  class of other classes, thus the member indices of all the
+         *  classes are rebuilt on the next lookup.
+         */
+        static void meta_type_unbound() {
+            types_unbound_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+            indices_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        /**
+         * \brief Gets a timestamp incremented each time a member is
+         *  added to a class or a type is bound or unbound.
+         * \details Can be used to validate caches of lookups made in
+         *  the MetaClasses (for instance, in the interpreters).
+         * \return the current value of the timestamp
+         */
+        static index_t indices_timestamp() {
+            return indices_timestamp_.load(std::memory_order_acquire);
         }
 
         /**
@@ -517,11 +550,127 @@ namespace OGF {
             std::vector<MetaProperty*>& result, bool super = true
         ) const;
 
+        /**
+         * \brief A hashed index of the members of a class.
+         */
+        struct MemberIndex {
+            /**
+             * \brief Maps a member name to the MetaMember.
+             */
+            std::unordered_map<std::string, MetaMember*> members;
+
+            /**
+             * \brief Maps "get_xxx" and "set_xxx" to the MetaProperty "xxx".
+             */
+            std::unordered_map<std::string, MetaProperty*> accessors;
+
+            /**
+             * \brief Removes all the entries.
+             */
+            void clear() {
+                members.clear();
+                accessors.clear();
+            }
+        };
+
+        /**
+         * \brief The member indices of a class and its resolved super
+         *  class.
+         * \details Built once and never modified. A new one replaces it
+         *  when members are added to the class or to one of its super
+         *  classes, and lookups that still use the previous one keep it
+         *  alive.
+         */
+        struct MemberIndices {
+            /**
+             * \brief The index of the members declared in the class.
+             */
+            MemberIndex local;
+
+            /**
+             * \brief The index that also covers the inherited members.
+             */
+            MemberIndex all;
+
+            /**
+             * \brief The class and its super classes, with the value of
+             *  their members_timestamp_ when the indices were built.
+             */
+            std::vector<std::pair<const MetaClass*, index_t> > classes;
+
+            /**
+             * \brief true if the super class of the class or of one of
+             *  its super classes could not be resolved.
+             */
+            bool has_unresolved_super_class;
+
+            /**
+             * \brief The values of types_bound_timestamp_ and
+             *  types_unbound_timestamp_ when the indices were built.
+             */
+            index_t types_bound_timestamp;
+            index_t types_unbound_timestamp;
+        };
+
+        /**
+         * \brief Gets the member indices.
+         * \details Does not lock anything if the indices are up to date,
+         *  else only this class (and its super classes if they changed)
+         *  is rebuilt.
+         * \return a shared pointer to the indices, that remain valid as
+         *  long as the caller keeps it, even if they are replaced meanwhile
+         */
+        std::shared_ptr<const MemberIndices> member_indices() const {
+            std::shared_ptr<const MemberIndices> result =
+                std::atomic_load_explicit(&indices_, std::memory_order_acquire);
+            if(result == nullptr || !member_indices_are_up_to_date(*result)) {
+                result = update_member_indices();
+            }
+            return result;
+        }
+
+        /**
+         * \brief Tests whether member indices are up to date.
+         * \param[in] indices the indices
+         * \retval true if no member was added to the class or to one of
+         *  its super classes, no type was unbound and, if a super class
+         *  could not be resolved, no type was bound since \p indices
+         *  were built
+         * \retval false otherwise
+         */
+        bool member_indices_are_up_to_date(
+            const MemberIndices& indices
+        ) const;
+
+        /**
+         * \brief Rebuilds and publishes the member indices.
+         * \details Holds a lock only while the members of this class
+         *  are copied, not while the super classes are resolved and the
+         *  indices are built. Several threads may rebuild the
+         *  indices at the same time: each one builds a complete snapshot,
+         *  that is never modified once published, and the last one
+         *  published wins. Concurrent lookups use the previous indices
+         *  until the new ones are published.
+         * \return a shared pointer to the new indices
+         */
+        std::shared_ptr<const MemberIndices> update_member_indices() const;
+
     private:
         std::string super_class_name_;
         std::vector<MetaMember_var> members_;
         bool abstract_;
         Factory_var factory_;
+
+        /**
+         * \brief The current indices, only accessed with
+         *  std::atomic_load() and std::atomic_store().
+         */
+        mutable std::shared_ptr<const MemberIndices> indices_;
+        std::atomic<index_t> members_timestamp_;
+        static std::atomic<index_t> indices_timestamp_;
+        static std::atomic<index_t> types_bound_timestamp_;
+        static std::atomic<index_t> types_unbound_timestamp_;
+
         friend class ::OGF::MetaConstructor;
     };
 
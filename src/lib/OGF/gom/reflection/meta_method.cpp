@@ -50,7 +50,9 @@ namespace OGF {
         const std::string& return_type_name 
     ) : MetaMember(name,container),
         return_type_name_(return_type_name), 
-        adapter_(nullptr) {
+        adapter_(nullptr),
+        typed_adapter_(nullptr),
+        typed_adapter_type_(nullptr) {
     }
     
     MetaMethod::MetaMethod(
@@ -59,7 +61,9 @@ namespace OGF {
         MetaType* return_type
     ) : MetaMember(name,container),
         return_type_name_(return_type->name()), 
-        adapter_(nullptr) {
+        adapter_(nullptr),
+        typed_adapter_(nullptr),
+        typed_adapter_type_(nullptr) {
     }
 
     MetaMethod::~MetaMethod(){
@@ -159,6 +163,9 @@ namespace OGF {
                                       << std::endl ;
             return false ;
         }
+        if(args_are_positional(args)) {
+            return method_adapter()(target, name(), args, return_value) ;
+        }
         if(!check_args(args)) {
             Logger::err("MetaMethod") << "MetaMethod "
                                       << container_meta_class()->name()
@@ -214,6 +221,18 @@ namespace OGF {
         return true ;
     }
 
+    bool MetaMethod::args_are_positional(const ArgList& args) const {
+        if(args.nb_args() != nb_args()) {
+            return false ;
+        }
+        for(index_t i=0; i<nb_args(); i++) {
+            if(args.ith_arg_name(i) != ith_arg_name(i)) {
+                return false ;
+            }
+        }
+        return true ;
+    }
+
     index_t MetaMethod::nb_used_args(const ArgList& args) {
         index_t result = 0 ;
         for(index_t i=0; i<args.nb_args(); i++) {
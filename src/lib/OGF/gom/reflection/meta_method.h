@@ -41,6 +41,8 @@
 #include <OGF/gom/reflection/meta_member.h>
 #include <OGF/gom/reflection/meta_arg.h>
 
+#include <typeinfo>
+
 /**
  * \file OGF/gom/reflection/meta_method.h
  * \brief Meta-information attached to class methods.
@@ -66,6 +68,18 @@ namespace OGF {
         Any& ret_val
     ) ;
 
+    /**
+     * \brief Generic function pointer type for typed method adapters.
+     * \details A typed method adapter directly calls a slot with its
+     *  arguments, without any ArgList. Its actual type is
+     *  void (*)(Object* target, const T1&, ..., const Tn&), it is stored
+     *  as a gom_typed_method_adapter together with the std::type_info
+     *  of its actual type, and cast back before being called (see
+     *  ConnectionList::invoke_typed()). Typed method adapters are
+     *  generated by the GOM generator for the slots.
+     */
+    typedef void (*gom_typed_method_adapter)() ;
+
     /**
      * \brief The representation of a method in the Meta repository.
      */
@@ -326,6 +340,40 @@ namespace OGF {
             adapter_ = adapter ;
         }
 
+        /**
+         * \brief Gets the typed method adapter.
+         * \return the typed method adapter if available, else nil
+         * \see gom_typed_method_adapter
+         */
+        gom_typed_method_adapter typed_method_adapter() const {
+            return typed_adapter_ ;
+        }
+
+        /**
+         * \brief Gets the actual type of the typed method adapter.
+         * \return a pointer to the std::type_info of the function
+         *  pointer type of the typed method adapter, or nil
+         */
+        const std::type_info* typed_method_adapter_type() const {
+            return typed_adapter_type_ ;
+        }
+
+        /**
+         * \brief Sets the typed method adapter.
+         * \param[in] adapter the typed method adapter, cast to
+         *  gom_typed_method_adapter
+         * \param[in] adapter_type a pointer to the std::type_info of
+         *  the function pointer type of \p adapter
+         * \see gom_typed_method_adapter
+         */
+        void set_typed_method_adapter(
+            gom_typed_method_adapter adapter,
+            const std::type_info* adapter_type
+        ) {
+            typed_adapter_ = adapter ;
+            typed_adapter_type_ = adapter_type ;
+        }
+
         /**
          * \brief Invokes this method on a target object. 
          * \details The default invokation mechanism uses the method 
@@ -369,6 +417,19 @@ namespace OGF {
          */
         virtual bool check_args(const ArgList& args) ;
 
+        /**
+         * \brief Tests whether the specified ArgList has exactly the
+         *  parameters of this MetaMethod, in declaration order.
+         * \details This is the case for standard (non-keyword) calls from
+         *  the interpreters. Then there is no need to check for missing
+         *  arguments nor to add default values.
+         * \param[in] args a const reference to the arguments list
+         * \retval true if \p args has one argument per parameter, with
+         *  the same names in the same order
+         * \retval false otherwise
+         */
+        bool args_are_positional(const ArgList& args) const ;
+
         /**
          * \brief Counts the number of arguments this method would use
          * when invoked on the specified args. 
@@ -431,6 +492,8 @@ namespace OGF {
         std::string return_type_name_ ;
         MetaArgList meta_args_ ;
         gom_method_adapter adapter_ ;
+        gom_typed_method_adapter typed_adapter_ ;
+        const std::type_info* typed_adapter_type_ ;
     } ;
 
     /**
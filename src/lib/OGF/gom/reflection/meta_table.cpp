@@ -0,0 +1,134 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/gom/reflection/meta_table.h>
+#include <OGF/gom/reflection/meta_class.h>
+#include <OGF/gom/reflection/meta_constructor.h>
+#include <OGF/gom/reflection/meta_property.h>
+#include <OGF/gom/reflection/meta_slot.h>
+#include <OGF/gom/reflection/meta_signal.h>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Copies the custom attributes of a constant table.
+     * \param[in] attributes the attributes in the constant table
+     * \param[in] nb_attributes the number of attributes
+     * \param[out] target the object that receives the attributes
+     */
+    template <class T> void create_attributes(
+        const MetaAttributeTable* attributes, index_t nb_attributes,
+        T& target
+    ) {
+        for(index_t i=0; i<nb_attributes; ++i) {
+            target.create_custom_attribute(
+                attributes[i].name, attributes[i].value
+            );
+        }
+    }
+
+    /**
+     * \brief Creates the arguments of a member from a constant table.
+     * \param[in] member the member in the constant table
+     * \param[out] method the MetaMethod that receives the arguments
+     */
+    void create_args(const MetaMemberTable& member, MetaMethod* method) {
+        for(index_t i=0; i<member.nb_args; ++i) {
+            const MetaArgTable& arg = member.args[i];
+            MetaArg cur_arg(arg.name, arg.type_name);
+            if(arg.default_value != nullptr) {
+                arg.default_value(cur_arg.default_value());
+            }
+            create_attributes(arg.attributes, arg.nb_attributes, cur_arg);
+            method->add_arg(cur_arg);
+        }
+    }
+}
+
+namespace OGF {
+
+    MetaClass* materialize_meta_class(const MetaClassTable& table) {
+        MetaClass* mclass = table.declare();
+        for(index_t i=0; i<table.nb_members; ++i) {
+            const MetaMemberTable& member = table.members[i];
+            MetaMember* cur_member = nullptr;
+            switch(member.kind) {
+            case GOM_MEMBER_CONSTRUCTOR: {
+                MetaConstructor* cur_constructor = new MetaConstructor(mclass);
+                create_args(member, cur_constructor);
+                cur_constructor->set_factory(member.create_factory());
+                cur_member = cur_constructor;
+            } break;
+            case GOM_MEMBER_PROPERTY: {
+                MetaProperty* cur_prop = new MetaProperty(
+                    member.name, mclass, member.type_name, member.read_only
+                );
+                cur_prop->meta_method_get()->set_method_adapter(
+                    member.adapter
+                );
+                if(!member.read_only) {
+                    cur_prop->meta_method_set()->set_method_adapter(
+                        member.set_adapter
+                    );
+                }
+                cur_member = cur_prop;
+            } break;
+            case GOM_MEMBER_SLOT: {
+                MetaSlot* cur_slot = new MetaSlot(
+                    member.name, mclass, member.type_name
+                );
+                create_args(member, cur_slot);
+                cur_slot->set_method_adapter(member.adapter);
+                cur_slot->set_typed_method_adapter(
+                    member.typed_adapter, member.typed_adapter_type
+                );
+                cur_member = cur_slot;
+            } break;
+            case GOM_MEMBER_SIGNAL: {
+                MetaSignal* cur_signal = new MetaSignal(member.name, mclass);
+                create_args(member, cur_signal);
+                cur_member = cur_signal;
+            } break;
+            }
+            create_attributes(
+                member.attributes, member.nb_attributes, *cur_member
+            );
+        }
+        create_attributes(table.attributes, table.nb_attributes, *mclass);
+        return mclass;
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_GOM_REFLECTION_META_TABLE_H
+#define H_OGF_GOM_REFLECTION_META_TABLE_H
+
+#include <OGF/gom/common/common.h>
+#include <OGF/gom/reflection/meta_method.h>
+
+#include <typeinfo>
+
+/**
+ * \file OGF/gom/reflection/meta_table.h
+ * \brief Constant tables that describe the meta-information of a class,
+ *  materialized on demand.
+ * \details Generated by gomgen in static tables mode (gomgen -static_tables).
+ *  Instead of creating all the MetaClass objects at startup, the generated
+ *  code registers a constant table per class, and the MetaClass is only
+ *  created the first time it is resolved.
+ * \note Used by the C++ code created by GOMGEN. 
+ *  Client code should not use these types.
+ */
+
+namespace OGF {
+
+    class MetaClass;
+    class Factory;
+
+    /**
+     * \brief Function pointer type to initialize the default value of an
+     *  argument.
+     */
+    typedef void (*gom_default_value_initializer)(Any& value);
+
+    /**
+     * \brief Function pointer type to create the Factory of a constructor.
+     */
+    typedef Factory* (*gom_factory_creator)();
+
+    /**
+     * \brief Function pointer type to declare a class, its pointer type and
+     *  the builtin and enum types used by its members.
+     * \return a pointer to the created MetaClass
+     */
+    typedef MetaClass* (*gom_class_declarator)();
+
+    /**
+     * \brief A custom attribute in a constant table.
+     */
+    struct MetaAttributeTable {
+        const char* name;
+        const char* value;
+    };
+
+    /**
+     * \brief An argument of a method, signal or constructor in a 
+     *  constant table.
+     */
+    struct MetaArgTable {
+        const char* name;
+        const char* type_name;
+        /** \brief nullptr if the argument has no default value */
+        gom_default_value_initializer default_value;
+        const MetaAttributeTable* attributes;
+        index_t nb_attributes;
+    };
+
+    /**
+     * \brief The kind of a member in a constant table.
+     */
+    enum MetaMemberKind {
+        GOM_MEMBER_CONSTRUCTOR,
+        GOM_MEMBER_PROPERTY,
+        GOM_MEMBER_SLOT,
+        GOM_MEMBER_SIGNAL
+    };
+
+    /**
+     * \brief A member of a class in a constant table.
+     */
+    struct MetaMemberTable {
+        MetaMemberKind kind;
+        const char* name;
+        /** \brief return type of slots, type of properties */
+        const char* type_name;
+        /** \brief true for read-only properties */
+        bool read_only;
+        /** \brief method adapter of slots, getter of properties */
+        gom_method_adapter adapter;
+        /** \brief setter of (non read-only) properties */
+        gom_method_adapter set_adapter;
+        /** \brief factory of constructors */
+        gom_factory_creator create_factory;
+        const MetaArgTable* args;
+        index_t nb_args;
+        const MetaAttributeTable* attributes;
+        index_t nb_attributes;
+        /** \brief typed method adapter of slots, or nullptr */
+        gom_typed_method_adapter typed_adapter;
+        /** \brief actual type of typed_adapter */
+        const std::type_info* typed_adapter_type;
+    };
+
+    /**
+     * \brief The meta-information of a class in a constant table.
+     */
+    struct MetaClassTable {
+        const char* name;
+        const std::type_info* type;
+        const std::type_info* pointer_type;
+        gom_class_declarator declare;
+        const MetaMemberTable* members;
+        index_t nb_members;
+        const MetaAttributeTable* attributes;
+        index_t nb_attributes;
+    };
+
+    /**
+     * \brief Creates the MetaClass that corresponds to a constant table.
+     * \details Declares the class, then creates all its members and
+     *  custom attributes.
+     * \param[in] table a const reference to the constant table
+     * \return a pointer to the created MetaClass
+     * \see Meta::declare_meta_class_table()
+     */
+    GOM_API MetaClass* materialize_meta_class(const MetaClassTable& table);
+}
+
+#endif
@@ -0,0 +1,518 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/gom/services/converter.h>
+#include <OGF/gom/reflection/meta.h>
+#include <OGF/gom/reflection/meta_type.h>
+#include <OGF/gom/reflection/meta_enum.h>
+#include <geogram/basic/geometry.h>
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <charconv>
+#include <typeinfo>
+#include <type_traits>
+#include <string>
+#include <cctype>
+
+namespace {
+
+    using namespace OGF;
+
+    /**
+     * \brief The key of the converters table, that is, a
+     *  (source type, destination type) pair.
+     */
+    struct ConverterKey {
+        const MetaType* from;
+        const MetaType* to;
+        bool operator==(const ConverterKey& rhs) const {
+            return from == rhs.from && to == rhs.to;
+        }
+    };
+
+    /**
+     * \brief Hashes a ConverterKey.
+     */
+    struct ConverterKeyHash {
+        size_t operator()(const ConverterKey& key) const {
+            std::hash<const void*> h;
+            return h(key.from) ^ (h(key.to) * 31);
+        }
+    };
+
+    typedef std::unordered_map<
+        ConverterKey, gom_converter, ConverterKeyHash
+    > ConverterTable;
+
+    ConverterTable* converters_ = nullptr;
+
+    /**
+     * \brief Protects converters_. Enums are declared while classes
+     *  are lazily materialized, concurrently with the lookups done by
+     *  Any in other threads.
+     */
+    std::shared_mutex converters_mutex_;
+
+    /**
+     * \brief Gets the MetaType associated with a C++ type.
+     * \return a pointer to the MetaType or nullptr if \p T is not bound.
+     */
+    template <class T> inline MetaType* meta_type_of() {
+        return Meta::instance()->resolve_meta_type_by_typeid_name(
+            typeid(T).name()
+        );
+    }
+
+    /**
+     * \brief Declares a converter if both types are bound.
+     */
+    template <class FROM, class TO> inline void declare_if_bound(
+        gom_converter converter
+    ) {
+        MetaType* from_type = meta_type_of<FROM>();
+        MetaType* to_type = meta_type_of<TO>();
+        if(from_type != nullptr && to_type != nullptr) {
+            Converters::declare(from_type, to_type, converter);
+        }
+    }
+
+    /**
+     * \brief Skips the leading whitespaces and the optional '+' sign,
+     *  that are accepted by iostreams but not by std::from_chars().
+     */
+    inline const char* skip_number_prefix(const char* begin, const char* end) {
+        while(begin != end && ::isspace(int((unsigned char)(*begin)))) {
+            ++begin;
+        }
+        if(begin != end && *begin == '+') {
+            ++begin;
+        }
+        return begin;
+    }
+
+    /**
+     * \brief Writes a number in a character buffer.
+     * \details Floating point numbers are written with 6 significant
+     *  digits, as done by iostreams with the default precision, so
+     *  that the result is the same as with the Serializer.
+     * \return a pointer past the last written character or nullptr
+     *  on error.
+     */
+    template <class T> inline char* format_number(
+        char* begin, char* end, T value
+    ) {
+        std::to_chars_result result;
+        if constexpr(std::is_floating_point<T>::value) {
+            result = std::to_chars(
+                begin, end, value, std::chars_format::general, 6
+            );
+        } else {
+            result = std::to_chars(begin, end, value);
+        }
+        return (result.ec == std::errc()) ? result.ptr : nullptr;
+    }
+
+    /**
+     * \brief Reads a number from a character buffer.
+     * \return a pointer past the last read character or nullptr
+     *  on error.
+     */
+    template <class T> inline const char* parse_number(
+        const char* begin, const char* end, T& value
+    ) {
+        begin = skip_number_prefix(begin, end);
+        std::from_chars_result result = std::from_chars(begin, end, value);
+        return (result.ec == std::errc()) ? result.ptr : nullptr;
+    }
+
+    /**
+     * \brief Tests whether std::to_chars() and std::from_chars() can
+     *  be used with a given type.
+     * \details 8-bit integers are serialized as characters, thus
+     *  they keep using the Serializer.
+     */
+    template <class T> constexpr bool has_charconv() {
+#ifdef __cpp_lib_to_chars
+        return sizeof(T) > 1;
+#else
+        return std::is_integral<T>::value && sizeof(T) > 1;
+#endif
+    }
+
+    /*******************************************************************/
+
+    template <class FROM, class TO> bool cast_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        *reinterpret_cast<TO*>(to) =
+            static_cast<TO>(*reinterpret_cast<const FROM*>(from));
+        return true;
+    }
+
+    template <class T> bool number_to_string_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        char buffer[64];
+        char* end = format_number(
+            buffer, buffer + sizeof(buffer), *reinterpret_cast<const T*>(from)
+        );
+        if(end == nullptr) {
+            return false;
+        }
+        reinterpret_cast<std::string*>(to)->assign(buffer, end);
+        return true;
+    }
+
+    template <class T> bool string_to_number_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        const std::string& str = *reinterpret_cast<const std::string*>(from);
+        T value;
+        if(parse_number(str.data(), str.data() + str.length(), value) ==
+           nullptr
+        ) {
+            return false;
+        }
+        *reinterpret_cast<T*>(to) = value;
+        return true;
+    }
+
+    bool bool_to_string_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        *reinterpret_cast<std::string*>(to) =
+            *reinterpret_cast<const bool*>(from) ? "true" : "false";
+        return true;
+    }
+
+    bool string_to_bool_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        const std::string& str = *reinterpret_cast<const std::string*>(from);
+        size_t begin = str.find_first_not_of(" \t\n\r");
+        if(begin == std::string::npos) {
+            return false;
+        }
+        size_t end = str.find_first_of(" \t\n\r", begin);
+        if(end == std::string::npos) {
+            end = str.length();
+        }
+        if(
+            str.compare(begin, end-begin, "true") == 0 ||
+            str.compare(begin, end-begin, "1") == 0
+        ) {
+            *reinterpret_cast<bool*>(to) = true;
+            return true;
+        }
+        if(
+            str.compare(begin, end-begin, "false") == 0 ||
+            str.compare(begin, end-begin, "0") == 0
+        ) {
+            *reinterpret_cast<bool*>(to) = false;
+            return true;
+        }
+        return false;
+    }
+
+    /*******************************************************************/
+
+    template <index_t DIM, class FROM, class TO> bool vector_cast_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        const vecng<DIM,FROM>& from_vec =
+            *reinterpret_cast<const vecng<DIM,FROM>*>(from);
+        vecng<DIM,TO>& to_vec = *reinterpret_cast<vecng<DIM,TO>*>(to);
+        for(index_t c=0; c<DIM; ++c) {
+            to_vec[c] = static_cast<TO>(from_vec[c]);
+        }
+        return true;
+    }
+
+    template <index_t DIM, class T> bool vector_to_string_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        const vecng<DIM,T>& vec = *reinterpret_cast<const vecng<DIM,T>*>(from);
+        char buffer[DIM*64];
+        char* cur = buffer;
+        char* end = buffer + sizeof(buffer);
+        for(index_t c=0; c<DIM; ++c) {
+            if(c != 0) {
+                *cur = ' ';
+                ++cur;
+            }
+            cur = format_number(cur, end, vec[c]);
+            if(cur == nullptr) {
+                return false;
+            }
+        }
+        reinterpret_cast<std::string*>(to)->assign(buffer, cur);
+        return true;
+    }
+
+    template <index_t DIM, class T> bool string_to_vector_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        const std::string& str = *reinterpret_cast<const std::string*>(from);
+        const char* cur = str.data();
+        const char* end = str.data() + str.length();
+        vecng<DIM,T> result;
+        for(index_t c=0; c<DIM; ++c) {
+            cur = parse_number(cur, end, result[c]);
+            if(cur == nullptr) {
+                return false;
+            }
+        }
+        *reinterpret_cast<vecng<DIM,T>*>(to) = result;
+        return true;
+    }
+
+    /*******************************************************************/
+
+    bool enum_to_string_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(to_type);
+        const MetaEnum* meta_enum = dynamic_cast<const MetaEnum*>(from_type);
+        int value = *reinterpret_cast<const int*>(from);
+        if(meta_enum == nullptr || !meta_enum->has_value(value)) {
+            return false;
+        }
+        *reinterpret_cast<std::string*>(to) =
+            meta_enum->get_name_by_value(value);
+        return true;
+    }
+
+    bool string_to_enum_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        const MetaEnum* meta_enum = dynamic_cast<const MetaEnum*>(to_type);
+        const std::string& str = *reinterpret_cast<const std::string*>(from);
+        if(meta_enum == nullptr || !meta_enum->has_value(str)) {
+            return false;
+        }
+        *reinterpret_cast<int*>(to) = meta_enum->get_value_by_name(str);
+        return true;
+    }
+
+    template <class T> bool enum_to_integer_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        geo_argused(to_type);
+        *reinterpret_cast<T*>(to) = T(*reinterpret_cast<const int*>(from));
+        return true;
+    }
+
+    template <class T> bool integer_to_enum_converter(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) {
+        geo_argused(from_type);
+        const MetaEnum* meta_enum = dynamic_cast<const MetaEnum*>(to_type);
+        int value = int(*reinterpret_cast<const T*>(from));
+        if(meta_enum == nullptr || !meta_enum->has_value(value)) {
+            return false;
+        }
+        *reinterpret_cast<int*>(to) = value;
+        return true;
+    }
+
+    /*******************************************************************/
+
+    /**
+     * \brief Declares the converters from a number type to all the
+     *  number types in \p TO, and between the number type and std::string.
+     */
+    template <class FROM, class... TO> void declare_number_converters() {
+        (declare_if_bound<FROM,TO>(&cast_converter<FROM,TO>), ...);
+        if constexpr(has_charconv<FROM>()) {
+            declare_if_bound<FROM,std::string>(
+                &number_to_string_converter<FROM>
+            );
+            declare_if_bound<std::string,FROM>(
+                &string_to_number_converter<FROM>
+            );
+        }
+    }
+
+    /**
+     * \brief Declares the converters between all the number types.
+     */
+    template <class... T> void declare_numbers_converters() {
+        (declare_number_converters<T,T...>(), ...);
+    }
+
+    /**
+     * \brief Declares the converters between vectors of dimension \p DIM
+     *  of different coordinate types and to/from std::string.
+     */
+    template <index_t DIM, class T1, class T2> void declare_vector_converters() {
+        declare_if_bound<vecng<DIM,T1>,vecng<DIM,T2>>(
+            &vector_cast_converter<DIM,T1,T2>
+        );
+        declare_if_bound<vecng<DIM,T2>,vecng<DIM,T1>>(
+            &vector_cast_converter<DIM,T2,T1>
+        );
+        if constexpr(has_charconv<T1>()) {
+            declare_if_bound<vecng<DIM,T1>,std::string>(
+                &vector_to_string_converter<DIM,T1>
+            );
+            declare_if_bound<std::string,vecng<DIM,T1>>(
+                &string_to_vector_converter<DIM,T1>
+            );
+        }
+        if constexpr(has_charconv<T2>()) {
+            declare_if_bound<vecng<DIM,T2>,std::string>(
+                &vector_to_string_converter<DIM,T2>
+            );
+            declare_if_bound<std::string,vecng<DIM,T2>>(
+                &string_to_vector_converter<DIM,T2>
+            );
+        }
+    }
+
+    /**
+     * \brief Declares the converters between an enum and an integer type.
+     */
+    template <class T> void declare_enum_integer_converters(
+        MetaEnum* meta_enum
+    ) {
+        MetaType* integer_type = meta_type_of<T>();
+        if(integer_type != nullptr) {
+            Converters::declare(
+                meta_enum, integer_type, &enum_to_integer_converter<T>
+            );
+            Converters::declare(
+                integer_type, meta_enum, &integer_to_enum_converter<T>
+            );
+        }
+    }
+}
+
+namespace OGF {
+
+    void Converters::declare(
+        const MetaType* from_type, const MetaType* to_type,
+        gom_converter converter
+    ) {
+        geo_assert(from_type != nullptr);
+        geo_assert(to_type != nullptr);
+        std::unique_lock<std::shared_mutex> lock(converters_mutex_);
+        if(converters_ == nullptr) {
+            converters_ = new ConverterTable;
+        }
+        (*converters_)[ConverterKey{from_type, to_type}] = converter;
+    }
+
+    gom_converter Converters::find(
+        const MetaType* from_type, const MetaType* to_type
+    ) {
+        if(from_type == nullptr || to_type == nullptr) {
+            return nullptr;
+        }
+        std::shared_lock<std::shared_mutex> lock(converters_mutex_);
+        if(converters_ == nullptr) {
+            return nullptr;
+        }
+        auto it = converters_->find(ConverterKey{from_type, to_type});
+        return (it == converters_->end()) ? nullptr : it->second;
+    }
+
+    void Converters::declare_enum(MetaEnum* meta_enum) {
+        MetaType* string_type = meta_type_of<std::string>();
+        if(string_type != nullptr) {
+            declare(meta_enum, string_type, &enum_to_string_converter);
+            declare(string_type, meta_enum, &string_to_enum_converter);
+        }
+        declare_enum_integer_converters<int>(meta_enum);
+        declare_enum_integer_converters<unsigned int>(meta_enum);
+    }
+
+    void Converters::initialize() {
+        declare_numbers_converters<
+            bool,
+            signed char, unsigned char,
+            short, unsigned short,
+            int, unsigned int,
+            long, unsigned long,
+            long long, unsigned long long,
+            float, double
+        >();
+
+        declare_if_bound<bool,std::string>(&bool_to_string_converter);
+        declare_if_bound<std::string,bool>(&string_to_bool_converter);
+
+        declare_vector_converters<2, Numeric::float64, Numeric::int32>();
+        declare_vector_converters<3, Numeric::float64, Numeric::int32>();
+        declare_vector_converters<4, Numeric::float64, Numeric::int32>();
+    }
+
+    void Converters::terminate() {
+        std::unique_lock<std::shared_mutex> lock(converters_mutex_);
+        delete converters_;
+        converters_ = nullptr;
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_GOM_SERVICES_CONVERTER_H
+#define H_OGF_GOM_SERVICES_CONVERTER_H
+
+#include <OGF/gom/common/common.h>
+#include <geogram/basic/memory.h>
+
+/**
+ * \file OGF/gom/services/converter.h
+ * \brief Direct conversions between types.
+ */
+
+namespace OGF {
+
+    class MetaType ;
+    class MetaEnum ;
+
+    /**
+     * \brief Function pointer type for converters.
+     * \details A converter reads a value of type \p from_type at address
+     *  \p from, and writes it as a value of type \p to_type at address
+     *  \p to, where an object of type \p to_type is already constructed.
+     *  The MetaTypes are passed so that a single converter can serve a
+     *  family of types (e.g., all the enums).
+     * \retval true if the conversion was successful
+     * \retval false otherwise
+     */
+    typedef bool (*gom_converter)(
+        const MetaType* from_type, Memory::pointer from,
+        const MetaType* to_type, Memory::pointer to
+    ) ;
+
+    /**
+     * \brief The registry of direct conversions between types.
+     * \details Converters are used by Any when the stored type differs
+     *  from the requested one. They are keyed by (source MetaType,
+     *  destination MetaType). Conversions between arithmetic types,
+     *  bool, vectors, enums and to/from std::string are pre-declared.
+     *  Conversions to/from std::string use std::to_chars() and
+     *  std::from_chars() (locale-independent). When no converter is
+     *  declared, Any falls back to a string round-trip through the
+     *  Serializers. The registry can be used from several threads
+     *  (declare() takes an exclusive lock, find() a shared one).
+     */
+    class GOM_API Converters {
+    public:
+        /**
+         * \brief Declares a converter.
+         * \details If a converter was already declared for the same
+         *  pair of types, it is replaced.
+         * \param[in] from_type the source MetaType
+         * \param[in] to_type the destination MetaType
+         * \param[in] converter the function that does the conversion
+         */
+        static void declare(
+            const MetaType* from_type, const MetaType* to_type,
+            gom_converter converter
+        ) ;
+
+        /**
+         * \brief Finds a converter.
+         * \param[in] from_type the source MetaType
+         * \param[in] to_type the destination MetaType
+         * \return the converter or nullptr if there is no converter
+         *  from \p from_type to \p to_type
+         */
+        static gom_converter find(
+            const MetaType* from_type, const MetaType* to_type
+        ) ;
+
+        /**
+         * \brief Converts a value.
+         * \param[in] from_type the source MetaType
+         * \param[in] from the address of the source value
+         * \param[in] to_type the destination MetaType
+         * \param[out] to the address of the (constructed) destination value
+         * \retval true if a converter was found and the conversion was
+         *  successful
+         * \retval false otherwise
+         */
+        static bool convert(
+            const MetaType* from_type, Memory::pointer from,
+            const MetaType* to_type, Memory::pointer to
+        ) {
+            gom_converter converter = find(from_type, to_type) ;
+            return converter != nullptr &&
+                converter(from_type, from, to_type, to) ;
+        }
+
+        /**
+         * \brief Declares the converters between an enum and std::string
+         *  and between an enum and the integer types.
+         * \param[in] meta_enum the MetaEnum
+         * \note Called by ogf_declare_enum.
+         */
+        static void declare_enum(MetaEnum* meta_enum) ;
+
+        /**
+         * \brief Declares the converters between the builtin types.
+         * \note Does not need to be called by client code, called
+         *  at Graphite initialization, once the builtin types are declared.
+         */
+        static void initialize() ;
+
+        /**
+         * \brief Removes all the converters.
+         * \note Does not need to be called by client code, called
+         *  at Graphite termination.
+         */
+        static void terminate() ;
+    } ;
+
+}
+
+#endif
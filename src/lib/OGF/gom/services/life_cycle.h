@@ -40,6 +40,7 @@
 #include <OGF/gom/common/common.h>
 #include <geogram/basic/memory.h>
 #include <geogram/basic/counted.h>
+#include <utility>
 
 /**
  * \file OGF/gom/services/serializer.h
@@ -110,6 +111,19 @@ namespace OGF {
 	 */
 	virtual void copy_construct(Memory::pointer lhs, Memory::pointer rhs) = 0;
 
+	/**
+	 * \brief Move-Constructs an object at a given address.
+	 * \param[in] lhs the address where the object should
+	 *  be constructed.
+	 * \param[in] rhs the address of the right-hand-side object
+	 *  to be moved. It is left in a valid but unspecified state.
+	 * \details No memory allocation is done. Default implementation
+	 *  calls copy_construct().
+	 */
+	virtual void move_construct(Memory::pointer lhs, Memory::pointer rhs) {
+	    copy_construct(lhs, rhs);
+	}
+
 	/**
 	 * \brief Calls the destructor of an object.
 	 * \param[in] address the address of the object to be destructed.
@@ -232,6 +246,13 @@ namespace OGF {
 	    new(lhs)T(*(T*)rhs);
 	}
 
+	/**
+	 * \copydoc LifeCycle::move_construct()
+	 */
+	void move_construct(Memory::pointer lhs, Memory::pointer rhs) override {
+	    new(lhs)T(std::move(*(T*)rhs));
+	}
+
 	/**
 	 * \copydoc LifeCycle::destroy()
 	 */
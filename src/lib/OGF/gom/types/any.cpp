@@ -45,6 +45,8 @@
 
 namespace OGF {
 
+    std::atomic<index_t> Any::meta_types_timestamp_(1);
+
     LifeCycle* Any::life_cycle() const {
 	geo_debug_assert(meta_type_ != nullptr);
 	return meta_type_->life_cycle();
@@ -63,6 +65,12 @@ namespace OGF {
         }
 #endif
         geo_assert(mtype != nullptr);
+        if(Converters::convert(
+               ogf_meta<std::string>::type(), (Memory::pointer)(&string),
+               mtype, value
+        )) {
+            return;
+        }
         Serializer* serializer = mtype->serializer();
         geo_assert(serializer != nullptr);
         std::istringstream stream(string);
@@ -83,6 +91,12 @@ namespace OGF {
         }
 #endif
         geo_assert(mtype != nullptr);
+        if(Converters::convert(
+               mtype, value,
+               ogf_meta<std::string>::type(), (Memory::pointer)(&string)
+        )) {
+            return;
+        }
         Serializer* serializer = mtype->serializer();
         geo_assert(serializer != nullptr);
         std::ostringstream stream ;
@@ -154,6 +168,9 @@ namespace OGF {
     }
 
     bool Any::copy_convert_to(Memory::pointer addr, MetaType* meta_type) const {
+	if(Converters::convert(meta_type_, value_, meta_type, addr)) {
+	    return true;
+	}
 	if(try_copy_convert_to(this, (index_t*)addr, meta_type)) {
 	    return true;
 	}
@@ -39,7 +39,11 @@
 
 #include <OGF/gom/common/common.h>
 #include <OGF/gom/services/life_cycle.h>
+#include <OGF/gom/services/converter.h>
 #include <typeinfo>
+#include <atomic>
+#include <type_traits>
+#include <utility>
 
 /**
  * \file OGF/gom/types/any.h
@@ -121,6 +125,31 @@ namespace OGF {
 	    return *this;
 	}
 
+	/**
+	 * \brief Any move constructor.
+	 * \details If the value of \p rhs is heap-allocated, its ownership
+	 *  is transfered, else it is move-constructed in the buffer. No
+	 *  memory allocation is done.
+	 * \param[in] rhs the Any to be moved. It is null on exit.
+	 */
+        Any(Any&& rhs) noexcept :
+	    value_(nullptr), in_buffer_(false), meta_type_(nullptr) {
+	    move(rhs);
+	}
+
+	/**
+	 * \brief Any move affectation operator.
+	 * \param[in] rhs the Any to be moved. It is null on exit.
+	 * \return a reference to this Any after affectation.
+	 */
+	Any& operator=(Any&& rhs) noexcept {
+	    if(&rhs != this) {
+		destroy();
+		move(rhs);
+	    }
+	    return *this;
+	}
+
 	/**
 	 * \brief Gets a string representation.
 	 * \return a string representation of the stored argument
@@ -156,7 +185,9 @@ namespace OGF {
 	 */
 	template <class T> void set_value(const T& value) {
 	    MetaType* new_type = resolve_meta_type<T>();
-	    if(new_type == meta_type_) {
+	    geo_debug_assert(new_type != nullptr);
+	    // An empty Any has no value to assign to.
+	    if(value_ != nullptr && new_type == meta_type_) {
 		life_cycle()->assign(value_, Memory::pointer(&value));
 		return;
 	    }
@@ -192,6 +223,52 @@ namespace OGF {
 
 	}
 
+	/**
+	 * \brief Sets the value of this Any from a temporary.
+	 * \details The value is moved instead of copied.
+	 * \param[in] value the value to be stored.
+	 */
+	template <
+	    class T,
+	    class = typename std::enable_if<
+		!std::is_lvalue_reference<T>::value
+	    >::type
+	> void set_value(T&& value) {
+	    typedef typename std::remove_const<T>::type U;
+	    MetaType* new_type = resolve_meta_type<U>();
+	    geo_debug_assert(new_type != nullptr);
+	    // An empty Any has no value to assign to.
+	    if(value_ != nullptr && new_type == meta_type_) {
+		*(U*)(value_) = std::move(value);
+		return;
+	    }
+	    destroy();
+	    meta_type_ = new_type;
+
+#if defined(GEO_COMPILER_GCC)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wplacement-new"
+#elif defined(GEO_COMPILER_MSVC)
+#pragma warning(push)
+#pragma warning(disable:4127)
+#endif
+
+	    if(sizeof(T) <= BUFFER_SIZE) {
+		in_buffer_ = true;
+		value_ = buffer_;
+		new(value_)U(std::move(value));
+	    } else {
+		in_buffer_ = false;
+		value_ = Memory::pointer(new U(std::move(value)));
+	    }
+
+#if defined(GEO_COMPILER_GCC)
+#pragma GCC diagnostic pop
+#elif defined(GEO_COMPILER_MSVC)
+#pragma warning(pop)
+#endif
+	}
+
 	/**
 	 * \brief Sets the value of this Any (overload for
 	 *  string literals).
@@ -218,6 +295,13 @@ namespace OGF {
 		value = value_as<T>();
 		return true;
 	    }
+	    // Try a direct conversion from the stored type to T
+	    if(Converters::convert(
+		   meta_type_, value_,
+		   resolve_meta_type<T>(), (Memory::pointer)(&value)
+	    )) {
+		return true;
+	    }
 	    // If the stored value is a string, convert it to T
 	    if(meta_type_ == resolve_meta_type<std::string>()) {
 		const std::string& string_value = value_as<std::string>();
@@ -231,154 +315,38 @@ namespace OGF {
 	}
 
 	/**
-	 * \brief Gets the stored value (std::string overload).
-	 * \param[out] value the stored value.
-	 * \retval true if the specified type was correct.
-	 * \retval false otherwise.
-	 */
-	bool get_value(std::string& value) const {
-	    value = as_string();
-	    return true;
-	}
-
-	/**
-	 * \brief Gets the stored value (index_t overload).
-	 * \param[out] value the stored value.
-	 * \retval true if the specified type was correct.
-	 * \retval false otherwise.
-	 */
-	bool get_value(index_t& value) const {
-	    if(get_value<index_t>(value)) {
-		return true;
-	    }
-	    {
-		signed_index_t tmp;
-		if(get_value<signed_index_t>(tmp)) {
-		    value = index_t(tmp);
-		    return true;
-		}
-	    }
-	    {
-		float tmp;
-		if(get_value<float>(tmp)) {
-		    value = index_t(tmp);
-		    return true;
-		}
-
-	    }
-	    {
-		double tmp;
-		if(get_value<double>(tmp)) {
-		    value = index_t(tmp);
-		    return true;
-		}
-
-	    }
-	    return false;
-	}
-
-	/**
-	 * \brief Gets the stored value (signed_index_t overload).
-	 * \param[out] value the stored value.
-	 * \retval true if the specified type was correct.
+	 * \brief Tests whether the stored value has a given type.
+	 * \details No conversion is taken into account, the stored value
+	 *  needs to be exactly of type \p T.
+	 * \tparam T the type.
+	 * \retval true if a value of type \p T is stored.
 	 * \retval false otherwise.
 	 */
-	bool get_value(signed_index_t& value) const {
-	    if(get_value<signed_index_t>(value)) {
-		return true;
-	    }
-	    {
-		index_t tmp;
-		if(get_value<index_t>(tmp)) {
-		    value = signed_index_t(tmp);
-		    return true;
-		}
-	    }
-	    {
-		float tmp;
-		if(get_value<float>(tmp)) {
-		    value = signed_index_t(tmp);
-		    return true;
-		}
-
-	    }
-	    {
-		double tmp;
-		if(get_value<double>(tmp)) {
-		    value = signed_index_t(tmp);
-		    return true;
-		}
-
-	    }
-	    return false;
+	template <class T> bool has_type() const {
+	    return value_ != nullptr && meta_type_ == resolve_meta_type<T>();
 	}
 
 	/**
-	 * \brief Gets the stored value (float overload).
-	 * \param[out] value the stored value.
-	 * \retval true if the specified type was correct.
-	 * \retval false otherwise.
+	 * \brief Gets a reference to the stored value, without any copy nor
+	 *  conversion.
+	 * \tparam T the type.
+	 * \return a const reference to the stored value.
+	 * \pre has_type<T>()
 	 */
-	bool get_value(float& value) const {
-	    if(get_value<float>(value)) {
-		return true;
-	    }
-	    {
-		double tmp;
-		if(get_value<double>(tmp)) {
-		    value = float(tmp);
-		    return true;
-		}
-	    }
-	    {
-		index_t tmp;
-		if(get_value<index_t>(tmp)) {
-		    value = float(tmp);
-		    return true;
-		}
-	    }
-	    {
-		signed_index_t tmp;
-		if(get_value<signed_index_t>(tmp)) {
-		    value = float(tmp);
-		    return true;
-		}
-	    }
-	    return false;
+	template <class T> const T& value_ref() const {
+	    geo_debug_assert(has_type<T>());
+	    return value_as<T>();
 	}
 
 	/**
-	 * \brief Gets the stored value (double overload).
+	 * \brief Gets the stored value (std::string overload).
 	 * \param[out] value the stored value.
 	 * \retval true if the specified type was correct.
 	 * \retval false otherwise.
 	 */
-	bool get_value(double& value) const {
-	    if(get_value<double>(value)) {
-		return true;
-	    }
-	    {
-		float tmp;
-		if(get_value<float>(tmp)) {
-		    value = double(tmp);
-		    return true;
-		}
-	    }
-	    {
-		index_t tmp;
-		if(get_value<index_t>(tmp)) {
-		    value = double(tmp);
-		    return true;
-		}
-	    }
-	    {
-		signed_index_t tmp;
-		if(get_value<signed_index_t>(tmp)) {
-		    value = double(tmp);
-		    return true;
-		}
-	    }
-	    return false;
+	bool get_value(std::string& value) const {
+	    value = as_string();
+	    return true;
 	}
 
 	/**
@@ -500,7 +468,9 @@ namespace OGF {
         /**
          * \brief Converts an object of a given type into a string.
          * \details It does the same thing as ogf_convert_to_string(),
-         *  namely it uses the Serializer registered in the Meta repository.
+         *  namely it uses the Converters if a direct conversion to
+         *  std::string is declared, and the Serializer registered in the
+         *  Meta repository otherwise.
          *  We cannot use ogf_convert_to_string() since it would introduce
          *  a circular dependency in Meta, that uses ArgList.
          * \param[in] meta_type a pointer to the MetaType
@@ -515,7 +485,9 @@ namespace OGF {
         /**
          * \brief Converts a string into an object of a given type.
          * \details It does the same thing as ogf_convert_from_string(),
-         *  namely it uses the Serializer registered in the Meta repository.
+         *  namely it uses the Converters if a direct conversion from
+         *  std::string is declared, and the Serializer registered in the
+         *  Meta repository otherwise.
          *  We cannot use ogf_convert_from_string() since it would introduce
          *  a circular dependency in Meta, that uses ArgList.
          * \param[in] meta_type a pointer to the MetaType
@@ -582,9 +554,33 @@ namespace OGF {
 	 * \return a pointer to the MetaType.
 	 */
 	template <class T> static MetaType* resolve_meta_type() {
-	    static MetaType* mtype =
-		resolve_meta_type_by_typeid_name(typeid(T).name());
-	    return mtype;
+	    // Cached per type. Only non-null MetaTypes are cached (T may be
+	    // queried before being declared), and the cache is invalidated
+	    // when a type is unbound. Once resolved, this is lock-free and
+	    // can be called from worker threads.
+	    static std::atomic<MetaType*> mtype(nullptr);
+	    static std::atomic<index_t> mtype_timestamp(0);
+	    index_t timestamp = meta_types_timestamp_.load(
+		std::memory_order_acquire
+	    );
+	    MetaType* result = mtype.load(std::memory_order_acquire);
+	    if(
+		result == nullptr ||
+		mtype_timestamp.load(std::memory_order_acquire) != timestamp
+	    ) {
+		result = resolve_meta_type_by_typeid_name(typeid(T).name());
+		mtype.store(result, std::memory_order_release);
+		mtype_timestamp.store(timestamp, std::memory_order_release);
+	    }
+	    return result;
+	}
+
+	/**
+	 * \brief Invalidates the MetaTypes cached by resolve_meta_type().
+	 * \details Called by Meta whenever a type is unbound.
+	 */
+	static void invalidate_meta_type_caches() {
+	    meta_types_timestamp_.fetch_add(1, std::memory_order_acq_rel);
 	}
 
       protected:
@@ -648,9 +644,35 @@ namespace OGF {
 	    }
 	}
 
+	/**
+	 * \brief Moves another Any.
+	 * \param[in] rhs the Any to be moved. It is null on exit.
+	 * \pre this Any is null
+	 */
+	void move(Any& rhs) {
+	    geo_debug_assert(&rhs != this);
+	    geo_debug_assert(is_null());
+	    if(rhs.is_null()) {
+		return;
+	    }
+	    meta_type_ = rhs.meta_type_;
+	    if(rhs.in_buffer_) {
+		in_buffer_ = true;
+		value_ = buffer_;
+		life_cycle()->move_construct(value_, rhs.value_);
+		rhs.destroy();
+	    } else {
+		in_buffer_ = false;
+		value_ = rhs.value_;
+		rhs.value_ = nullptr;
+		rhs.meta_type_ = nullptr;
+	    }
+	}
+
 	static std::string meta_type_name(const MetaType* mt);
 
       private:
+	static std::atomic<index_t> meta_types_timestamp_;
 	Memory::pointer value_;
 	Memory::byte buffer_[BUFFER_SIZE];
 	bool in_buffer_;
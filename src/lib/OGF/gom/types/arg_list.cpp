@@ -38,11 +38,99 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/reflection/meta_type.h>
 
+#include <atomic>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Number of slots in the table of interned argument names
+     *  (a power of two).
+     */
+    const index_t arg_names_capacity = 8192;
+
+    /**
+     * \brief Maximum number of interned argument names.
+     * \details The table stays at most half full, so that lookups
+     *  only probe a few slots. Beyond this number, ArgLists store copies
+     *  of the names (this only happens with dynamically generated names).
+     */
+    const index_t max_nb_arg_names = arg_names_capacity / 2;
+
+    /**
+     * \brief The table of interned argument names.
+     * \details Open addressing with linear probing. Slots are only
+     *  filled, never emptied, hence lookups do not need a lock. The
+     *  strings are never freed (ArgLists may be destroyed after the end
+     *  of main()).
+     */
+    std::atomic<const std::string*> arg_names[arg_names_capacity];
+
+    /**
+     * \brief Number of interned argument names.
+     */
+    std::atomic<index_t> nb_arg_names(0);
+
+    /**
+     * \brief Hashes an argument name (FNV-1a).
+     * \param[in] name the argument name
+     * \return the index of the first slot to probe in arg_names
+     */
+    index_t arg_name_hash(const std::string& name) {
+        Numeric::uint32 h = 2166136261u;
+        for(char c: name) {
+            h ^= Numeric::uint32(Numeric::uint8(c));
+            h *= 16777619u;
+        }
+        return index_t(h) & (arg_names_capacity - 1);
+    }
+}
+
 namespace OGF {
 
+    const std::string* ArgList::intern_arg_name(const std::string& name) {
+        std::string* created = nullptr;
+        index_t slot = arg_name_hash(name);
+        for(index_t probe=0; probe<arg_names_capacity; ++probe) {
+            std::atomic<const std::string*>& entry = arg_names[slot];
+            const std::string* current =
+                entry.load(std::memory_order_acquire);
+            if(current == nullptr) {
+                // Not found: try to insert the name in this slot.
+                if(created == nullptr) {
+                    if(nb_arg_names.fetch_add(1) >= max_nb_arg_names) {
+                        nb_arg_names.fetch_sub(1);
+                        return nullptr;
+                    }
+                    created = new std::string(name);
+                }
+                if(entry.compare_exchange_strong(
+                       current, created, std::memory_order_acq_rel
+                )) {
+                    return created;
+                }
+                // Another thread filled the slot meanwhile, current
+                // is what it stored.
+            }
+            if(*current == name) {
+                if(created != nullptr) {
+                    delete created;
+                    nb_arg_names.fetch_sub(1);
+                }
+                return current;
+            }
+            slot = (slot + 1) & (arg_names_capacity - 1);
+        }
+        if(created != nullptr) {
+            delete created;
+            nb_arg_names.fetch_sub(1);
+        }
+        return nullptr;
+    }
+
     index_t ArgList::find_arg_index(const std::string& name) const {
         for(index_t i=0; i<nb_args(); ++i) {
-            if(argname_[i] == name) {
+            if(argname(i) == name) {
                 return i;
             }
         }
@@ -59,13 +147,12 @@ namespace OGF {
         const ArgList& rhs, index_t i, bool overwrite
     ) {
         geo_debug_assert(i < rhs.nb_args());
-        index_t j = find_arg_index(rhs.argname_[i]);
+        index_t j = find_arg_index(rhs.argname(i));
         if(j == index_t(-1)) {
-	    argval_.push_back(rhs.argval_[i]);
-	    argname_.push_back(rhs.argname_[i]);
+	    push_arg(rhs.argname_entry(i)) = rhs.argval(i);
         } else {
             if(overwrite) {
-		argval_[j] = rhs.argval_[i];
+		argval(j) = rhs.argval(i);
             }
         }
     }
@@ -84,14 +171,14 @@ namespace OGF {
 	MetaType* expected_type = Meta::instance()->
 	    resolve_meta_type_by_typeid_name(expected_typeid_name);
 
-	MetaType* current_type = argval_[i].meta_type();
+	MetaType* current_type = argval(i).meta_type();
 
 	Logger::err("GOM")
             << "Arg type error:"
             << " i = " << i
-            << " name = " << argname_[i]
+            << " name = " << argname(i)
             << " type = " <<(
-	    argval_[i].is_null() ? "null" : (
+	    argval(i).is_null() ? "null" : (
 		((current_type != nullptr) ? current_type->name() : "unknown")
 	    ))
             << " expected type = "
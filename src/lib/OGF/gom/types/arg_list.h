@@ -69,17 +69,23 @@ namespace OGF {
         /**
          * \brief ArgList constructor.
          */
-        ArgList() {
-	    argval_.reserve(4);
-	    argname_.reserve(4);
+        ArgList() : nb_args_(0) {
         }
 
         /**
          * \brief ArgList copy-constructor.
          * \param[in] rhs a const reference to the ArgList to be copied
          */
-        ArgList(const ArgList& rhs) :
-           argval_(rhs.argval_), argname_(rhs.argname_) {
+        ArgList(const ArgList& rhs) : nb_args_(0) {
+            append_args(rhs);
+        }
+
+        /**
+         * \brief ArgList move-constructor.
+         * \param[in] rhs the ArgList to be moved. It is empty on exit.
+         */
+        ArgList(ArgList&& rhs) noexcept : nb_args_(0) {
+            move_args(rhs);
         }
 
         /**
@@ -87,8 +93,22 @@ namespace OGF {
          * \param[in] rhs a const reference to the ArgList to be copied
          */
         ArgList& operator=(const ArgList& rhs) {
-	    argval_ = rhs.argval_;
-	    argname_ = rhs.argname_;
+            if(&rhs != this) {
+                clear();
+                append_args(rhs);
+            }
+            return *this;
+        }
+
+        /**
+         * \brief ArgList move assignment operator
+         * \param[in] rhs the ArgList to be moved. It is empty on exit.
+         */
+        ArgList& operator=(ArgList&& rhs) noexcept {
+            if(&rhs != this) {
+                clear();
+                move_args(rhs);
+            }
             return *this;
         }
 
@@ -97,7 +117,7 @@ namespace OGF {
          * \return the number of arguments in this ArgList
          */
         index_t nb_args() const {
-            return argname_.size();
+            return nb_args_;
         }
 
         /**
@@ -146,8 +166,11 @@ namespace OGF {
          */
         void delete_ith_arg(index_t index) {
             geo_debug_assert(index < nb_args());
-            argval_.erase(argval_.begin()+index);
-	    argname_.erase(argname_.begin()+index);
+            for(index_t i=index; i+1<nb_args(); ++i) {
+                argval(i) = std::move(argval(i+1));
+                argname_entry(i) = std::move(argname_entry(i+1));
+            }
+            pop_arg();
         }
 
         /**
@@ -159,7 +182,7 @@ namespace OGF {
          */
         const std::string& ith_arg_name(index_t i) const {
             geo_debug_assert(i < nb_args());
-            return argname_[i];
+            return argname(i);
         }
 
         /**
@@ -177,14 +200,48 @@ namespace OGF {
             geo_debug_assert(i < nb_args());
 	    T result;
 	    if(
-                !argval_[i].get_value(result) &&
-                !get_name(argval_[i], result)
+                !argval(i).get_value(result) &&
+                !get_name(argval(i), result)
             ) {
 		arg_type_error(i, typeid(T).name());
 	    }
 	    return result;
         }
 
+        /**
+         * \brief Tests whether an argument has a given name and stores
+         *  a value of a given type.
+         * \details Used by the positional fast path of the method adapters
+         *  generated by gomgen, that can then use ith_arg_value_ref().
+         * \param[in] i the index of the argument
+         * \param[in] name the expected name of the argument
+         * \tparam T the expected type of the argument (no conversion is
+         *  taken into account)
+         * \retval true if argument \p i is named \p name and stores a
+         *  value of type \p T
+         * \retval false otherwise
+         * \pre \p i < nb_args()
+         */
+        template <class T> bool ith_arg_has_type(
+            index_t i, const char* name
+        ) const {
+            geo_debug_assert(i < nb_args());
+            return argval(i).has_type<T>() && argname(i) == name;
+        }
+
+        /**
+         * \brief Gets a reference to an argument value by index, without
+         *  any copy nor conversion.
+         * \param[in] i the index of the argument
+         * \return a const reference to the stored value
+         * \tparam T the type of the argument
+         * \pre \p i < nb_args() and ith_arg_value(i).has_type<T>()
+         */
+        template <class T> const T& ith_arg_value_ref(index_t i) const {
+            geo_debug_assert(i < nb_args());
+            return argval(i).value_ref<T>();
+        }
+
         /**
          * \brief Gets argument value by index, 
 	 *  stored as an Any.
@@ -195,7 +252,7 @@ namespace OGF {
          */
 	const Any& ith_arg_value(index_t i) const {
             geo_debug_assert(i < nb_args());
-	    return argval_[i];
+	    return argval(i);
 	}
 
         /**
@@ -208,7 +265,7 @@ namespace OGF {
          */
 	Any& ith_arg_value(index_t i) {
             geo_debug_assert(i < nb_args());
-	    return argval_[i];
+	    return argval(i);
 	}
 	
         /**
@@ -222,7 +279,7 @@ namespace OGF {
 	const Any& arg_value(const std::string& name) const {
 	    index_t i = find_arg_index(name);
 	    geo_debug_assert(i != index_t(-1));
-	    return argval_[i];
+	    return argval(i);
 	}
 
         /**
@@ -235,7 +292,7 @@ namespace OGF {
 	 Any& arg_value(const std::string& name) {
 	    index_t i = find_arg_index(name);
 	    geo_debug_assert(i != index_t(-1));
-	    return argval_[i];
+	    return argval(i);
 	}
 
 	
@@ -247,7 +304,7 @@ namespace OGF {
          */
         MetaType* ith_arg_type(index_t i) const {
             geo_debug_assert(i < nb_args());
-	    return argval_[i].meta_type();
+	    return argval(i).meta_type();
 	}
 
         /**
@@ -258,9 +315,7 @@ namespace OGF {
          */
         Any& create_arg(const std::string& name) {
             geo_debug_assert(!has_arg(name));
-            argval_.push_back(Any());
-	    argname_.push_back(name);
-	    return *(argval_.rbegin());
+	    return push_arg(name);
         }
 
         /**
@@ -284,9 +339,7 @@ namespace OGF {
             const std::string& name, const T& value
         ) {
             geo_debug_assert(!has_arg(name));
-            argval_.push_back(Any());
-	    argname_.push_back(name);
-	    argval_.rbegin()->set_value(value);
+	    push_arg(name).set_value(value);
         }
 
         /**
@@ -311,8 +364,20 @@ namespace OGF {
             const std::string& name, const Any& value
         ) {
             geo_debug_assert(!has_arg(name));
-            argval_.push_back(value);
-	    argname_.push_back(name);
+	    push_arg(name) = value;
+        }
+
+        /**
+         * \brief Creates an argument from a temporary Any.
+         * \param[in] name a const reference to the name of the argument
+         * \param[in] value an Any with the value, moved into this ArgList
+         * \pre !has_arg(name)
+         */
+        void create_arg(
+            const std::string& name, Any&& value
+        ) {
+            geo_debug_assert(!has_arg(name));
+	    push_arg(name) = std::move(value);
         }
 	
         /**
@@ -331,7 +396,7 @@ namespace OGF {
 	    if(i == index_t(-1)) {
 		create_arg(name, value);
 	    } else {
-		argval_[i].set_value(value);
+		argval(i).set_value(value);
 	    }
         }
 
@@ -361,7 +426,7 @@ namespace OGF {
 	    if(i == index_t(-1)) {
 		create_arg(name, value);
 	    } else {
-		argval_[i] = value;
+		argval(i) = value;
 	    }
         }
 	
@@ -374,7 +439,7 @@ namespace OGF {
          */
         template<class T> void set_ith_arg(index_t i, const T& value) {
 	    geo_debug_assert(i < nb_args());
-	    argval_[i].set_value(value);
+	    argval(i).set_value(value);
         }
 
         /**
@@ -396,7 +461,7 @@ namespace OGF {
         std::string get_arg(const std::string& name) const {
 	    index_t i = find_arg_index(name);
 	    geo_debug_assert(i != index_t(-1));
-	    return argval_[i].as_string();
+	    return argval(i).as_string();
         }
 
         /**
@@ -414,8 +479,8 @@ namespace OGF {
 	    geo_debug_assert(i != index_t(-1));
 	    T result;
 	    if(
-                !argval_[i].get_value(result) &&
-                !get_name(argval_[i], result)
+                !argval(i).get_value(result) &&
+                !get_name(argval(i), result)
             ) {
 		arg_type_error(i, typeid(T).name());
 	    }
@@ -431,15 +496,16 @@ namespace OGF {
         MetaType* get_arg_type(const std::string& name) const {
 	    index_t i = find_arg_index(name);
 	    geo_debug_assert(i != index_t(-1));
-	    return argval_[i].meta_type();
+	    return argval(i).meta_type();
 	}
         
         /**
          * \brief Removes all the arguments from this ArgList.
          */
         void clear() {
-	    argval_.resize(0);
-	    argname_.resize(0);
+	    while(nb_args_ != 0) {
+		pop_arg();
+	    }
 	}
 
         /**
@@ -513,9 +579,191 @@ namespace OGF {
         static bool get_object_name(const Any& object, Any& name);
 
         
+    protected:
+
+        /**
+         * \brief Gets the interned copy of an argument name.
+         * \details Argument names are stored once in a global table, so
+         *  that ArgLists only store (and copy) pointers. The table is
+         *  lock-free and has a bounded capacity: once it is full, new
+         *  names are no longer interned.
+         * \param[in] name the argument name
+         * \return a pointer to a string equal to \p name, that remains
+         *  valid until the end of the program, or nullptr if \p name
+         *  could not be interned
+         */
+        static const std::string* intern_arg_name(const std::string& name);
+
+        /**
+         * \brief The name of an argument.
+         * \details Points to the interned copy of the name (see
+         *  intern_arg_name()), or stores a copy of the name if it could
+         *  not be interned.
+         */
+        class ArgName {
+        public:
+            /**
+             * \brief ArgName default constructor.
+             */
+            ArgName() : interned_(nullptr) {
+            }
+
+            /**
+             * \brief ArgName constructor.
+             * \param[in] name the name of the argument
+             */
+            explicit ArgName(const std::string& name) :
+                interned_(intern_arg_name(name)) {
+                if(interned_ == nullptr) {
+                    own_ = name;
+                }
+            }
+
+            /**
+             * \brief Gets the name.
+             * \return a const reference to the name of the argument
+             */
+            const std::string& str() const {
+                return (interned_ != nullptr) ? *interned_ : own_;
+            }
+
+        private:
+            const std::string* interned_;
+            std::string own_;
+        };
+
+        /**
+         * \brief Gets an argument value by index.
+         * \param[in] i the index of the argument
+         * \return a modifiable reference to the argument value
+         */
+        Any& argval(index_t i) {
+            return (i < NB_INLINE_ARGS) ?
+                inline_argval_[i] : argval_[i - NB_INLINE_ARGS];
+        }
+
+        /**
+         * \brief Gets an argument value by index.
+         * \param[in] i the index of the argument
+         * \return a const reference to the argument value
+         */
+        const Any& argval(index_t i) const {
+            return (i < NB_INLINE_ARGS) ?
+                inline_argval_[i] : argval_[i - NB_INLINE_ARGS];
+        }
+
+        /**
+         * \brief Gets an argument name by index.
+         * \param[in] i the index of the argument
+         * \return a modifiable reference to the ArgName
+         */
+        ArgName& argname_entry(index_t i) {
+            return (i < NB_INLINE_ARGS) ?
+                inline_argname_[i] : argname_[i - NB_INLINE_ARGS];
+        }
+
+        /**
+         * \brief Gets an argument name by index.
+         * \param[in] i the index of the argument
+         * \return a const reference to the ArgName
+         */
+        const ArgName& argname_entry(index_t i) const {
+            return (i < NB_INLINE_ARGS) ?
+                inline_argname_[i] : argname_[i - NB_INLINE_ARGS];
+        }
+
+        /**
+         * \brief Gets an argument name by index.
+         * \param[in] i the index of the argument
+         * \return a const reference to the name of the argument
+         */
+        const std::string& argname(index_t i) const {
+            return argname_entry(i).str();
+        }
+
+        /**
+         * \brief Appends a new null argument.
+         * \param[in] name the name of the argument
+         * \return a reference to the Any that will store the argument.
+         */
+        Any& push_arg(const std::string& name) {
+            return push_arg(ArgName(name));
+        }
+
+        /**
+         * \brief Appends a new null argument.
+         * \param[in] name the name of the argument
+         * \return a reference to the Any that will store the argument.
+         */
+        Any& push_arg(const ArgName& name) {
+            if(nb_args_ >= NB_INLINE_ARGS) {
+                argval_.emplace_back();
+                argname_.push_back(name);
+            } else {
+                inline_argname_[nb_args_] = name;
+            }
+            ++nb_args_;
+            return argval(nb_args_ - 1);
+        }
+
+        /**
+         * \brief Removes the last argument.
+         * \pre nb_args() != 0
+         */
+        void pop_arg() {
+            geo_debug_assert(nb_args_ != 0);
+            --nb_args_;
+            if(nb_args_ >= NB_INLINE_ARGS) {
+                argval_.pop_back();
+                argname_.pop_back();
+            } else {
+                inline_argval_[nb_args_].reset();
+                inline_argname_[nb_args_] = ArgName();
+            }
+        }
+
+        /**
+         * \brief Appends copies of all the arguments of another ArgList,
+         *  without checking for duplicate names.
+         * \param[in] rhs a const reference to the ArgList to be copied
+         */
+        void append_args(const ArgList& rhs) {
+            for(index_t i=0; i<rhs.nb_args(); ++i) {
+                push_arg(rhs.argname_entry(i)) = rhs.argval(i);
+            }
+        }
+
+        /**
+         * \brief Moves all the arguments of another ArgList into this one.
+         * \param[in] rhs the ArgList to be moved. It is empty on exit.
+         * \pre nb_args() == 0
+         */
+        void move_args(ArgList& rhs) {
+            geo_debug_assert(nb_args_ == 0);
+            for(index_t i=0; i<rhs.nb_args_ && i<NB_INLINE_ARGS; ++i) {
+                inline_argval_[i] = std::move(rhs.inline_argval_[i]);
+                inline_argname_[i] = std::move(rhs.inline_argname_[i]);
+            }
+            argval_ = std::move(rhs.argval_);
+            argname_ = std::move(rhs.argname_);
+            nb_args_ = rhs.nb_args_;
+            rhs.argval_.clear();
+            rhs.argname_.clear();
+            rhs.nb_args_ = 0;
+        }
+
     private:
-        vector<Any> argval_;
-	vector<std::string> argname_;
+        /**
+         * \brief Number of arguments stored in the ArgList itself, without
+         *  any dynamic allocation.
+         */
+        enum { NB_INLINE_ARGS = 4 };
+
+        index_t nb_args_;
+        Any inline_argval_[NB_INLINE_ARGS];
+        ArgName inline_argname_[NB_INLINE_ARGS];
+        vector<Any> argval_;                // arguments after NB_INLINE_ARGS
+	vector<ArgName> argname_;           // arguments after NB_INLINE_ARGS
     };
 
 
@@ -47,6 +47,10 @@ namespace OGF {
     Callable::~Callable() {
     }
 
+    bool Callable::is_thread_safe() const {
+	return false;
+    }
+
     /*******************************************************************/
 
     Request::Request(Object* o, MetaMethod* m, bool managed) :
@@ -69,6 +73,12 @@ namespace OGF {
 	return object_->invoke_method(method_->name(), args, ret_val);	
     }
 
+    bool Request::is_thread_safe() const {
+	return
+	    method_->has_custom_attribute("thread_safe") &&
+	    method_->custom_attribute_value("thread_safe") == "true";
+    }
+
     std::string Request::get_doc() const {
         // Get documentation from the meta-method
 	return method()->get_doc();
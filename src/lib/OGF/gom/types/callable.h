@@ -70,6 +70,17 @@ namespace OGF {
          */
 	virtual bool invoke(const ArgList& args, Any& ret_val) = 0;
 
+	/**
+	 * \brief Tests whether this Callable can be invoked from several
+	 *  threads at the same time.
+	 * \details Used by Interpreter::parallel_for() and TaskGroup.
+	 *  Functions implemented in a script language are not thread-safe,
+	 *  since the interpreters are single-threaded.
+	 * \retval true if invoke() can be called concurrently
+	 * \retval false otherwise (default implementation)
+	 */
+	virtual bool is_thread_safe() const;
+
         /**
          * \brief Invokes a method by method name and argument list.
          * \details This variant of invoke() ignores the return value.
@@ -130,6 +141,13 @@ namespace OGF {
 	  */
 	  bool invoke(const ArgList& args, Any& ret_val) override;
 
+	 /**
+	  * \copydoc Callable::is_thread_safe()
+	  * \details A Request is thread-safe if its method is declared
+	  *  with gom_attribute(thread_safe,"true").
+	  */
+	  bool is_thread_safe() const override;
+
 
 	 /**
 	  * \copydoc Object::get_doc()
@@ -48,7 +48,8 @@ namespace OGF {
 
     Connection::Connection(Object* source, const std::string& sig_name)	:
 	source_(source),
-	signal_name_(sig_name)
+	signal_name_(sig_name),
+	signal_index_(Object::signal_index(sig_name))
     {
         if(source_ != nullptr) {
             source_->add_connection(this) ;
@@ -62,6 +63,14 @@ namespace OGF {
     Connection::~Connection() {
     }
 
+    gom_typed_method_adapter Connection::typed_target(
+	const std::type_info& adapter_type, Object*& target
+    ) {
+	geo_argused(adapter_type);
+	target = nullptr;
+	return nullptr;
+    }
+
     bool Connection::test_arg_condition(
         const std::string& value, const std::string& condition
     ) const {
@@ -130,6 +139,11 @@ namespace OGF {
     }
 
     bool Connection::invoke(const ArgList& args_in, Any& ret_val) {
+        // Fast path: no condition and no argument translation, directly
+        // pass the signal's arguments to the target.
+        if(!has_arg_translation()) {
+            return invoke_target(args_in, ret_val);
+        }
         if(!test_arg_conditions(args_in)) {
             return true ;
         }
@@ -146,8 +160,37 @@ namespace OGF {
     ) :
 	Connection(source, sig_name),
 	target_(target),
-	slot_name_(slot_name)
+	slot_name_(slot_name),
+	typed_adapter_(nullptr),
+	typed_adapter_type_(nullptr)
     {
+	if(
+	    source == nullptr || target_ == nullptr ||
+	    !target_->slots_can_be_called_directly()
+	) {
+	    return;
+	}
+	MetaSignal* msignal = source->meta_class()->find_signal(sig_name);
+	MetaSlot* mslot = target_->meta_class()->find_slot(slot_name);
+	if(
+	    msignal == nullptr || mslot == nullptr ||
+	    mslot->typed_method_adapter() == nullptr ||
+	    mslot->nb_args() != msignal->nb_args()
+	) {
+	    return;
+	}
+	// Arguments are matched by name: the typed adapter, that passes
+	// them by position, can only be used if they are in the same order.
+	for(index_t i=0; i<mslot->nb_args(); ++i) {
+	    if(
+		mslot->ith_arg_name(i) != msignal->ith_arg_name(i) ||
+		mslot->ith_arg_type_name(i) != msignal->ith_arg_type_name(i)
+	    ) {
+		return;
+	    }
+	}
+	typed_adapter_ = mslot->typed_method_adapter();
+	typed_adapter_type_ = mslot->typed_method_adapter_type();
     }
     
     bool SlotConnection::invoke_target(
@@ -155,6 +198,22 @@ namespace OGF {
     ) {
 	return target_->invoke_method(slot_name_, args, ret_val);
     }
+
+    gom_typed_method_adapter SlotConnection::typed_target(
+	const std::type_info& adapter_type, Object*& target
+    ) {
+	// Disabled slots, argument conditions and translations are
+	// handled by invoke().
+	if(
+	    typed_adapter_ == nullptr || *typed_adapter_type_ != adapter_type ||
+	    has_arg_translation() || !target_->get_slots_enabled()
+	) {
+	    target = nullptr;
+	    return nullptr;
+	}
+	target = target_;
+	return typed_adapter_;
+    }
     
 /******************************************************************************/
 
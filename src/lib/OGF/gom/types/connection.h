@@ -43,6 +43,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <typeinfo>
 
 /**
  * \file OGF/gom/types/connection.h
@@ -100,6 +101,23 @@ namespace OGF {
 	    const ArgList& args, Any& ret_val
 	) = 0;
 
+	/**
+	 * \brief Gets the typed method adapter that directly calls
+	 *  the target.
+	 * \details Used by ConnectionList::invoke_typed(). The base class
+	 *  implementation returns nullptr (the target is always invoked
+	 *  with an ArgList).
+	 * \param[in] adapter_type the std::type_info of the function
+	 *  pointer type expected by the caller
+	 * \param[out] target the object to be passed to the adapter
+	 * \return the typed method adapter, or nullptr if the target
+	 *  cannot be directly called with arguments of the expected types
+	 *  (then it needs to be invoked with an ArgList)
+	 */
+	virtual gom_typed_method_adapter typed_target(
+	    const std::type_info& adapter_type, Object*& target
+	);
+
 	/**
 	 * \brief Gets the source.
 	 * \return a pointer to the source object.
@@ -116,6 +134,15 @@ namespace OGF {
 	    return signal_name_;
 	}
 
+	/**
+	 * \brief Gets the signal index.
+	 * \return the index of the source signal.
+	 * \see Object::signal_index()
+	 */
+	index_t signal_index() const {
+	    return signal_index_;
+	}
+
       gom_slots:
 
         /**
@@ -234,9 +261,24 @@ namespace OGF {
          */
         void translate_args(const ArgList& args_in, ArgList& args_out);
 
+        /**
+         * \brief Tests whether the arguments are tested or translated
+         *  before being sent to the target.
+         * \retval true if there is an argument condition, or an argument
+         *  to be added, renamed or discarded
+         * \retval false otherwise
+         * \see if_arg(), add_arg(), rename_arg(), discard_arg()
+         */
+        bool has_arg_translation() const {
+            return
+                conditions_.nb_args() != 0 || args_.nb_args() != 0 ||
+                rename_args_.nb_args() != 0 || !discard_args_.empty();
+        }
+
     private:
         Object* source_;
         std::string signal_name_;
+        index_t signal_index_;
         ArgList conditions_;
         ArgList args_;
         ArgList rename_args_;
@@ -261,7 +303,10 @@ namespace OGF {
          * \param[in] sig_name the name of the source's signal
 	 * \param[in] target a pointer to the target object
 	 * \param[in] slot_name the name of the target's slot
-	 * \details Target is not reference-counted.
+	 * \details Target is not reference-counted. If the slot has
+	 *  the same arguments as the signal (same names and types, in
+	 *  the same order), its typed method adapter is resolved here
+	 *  once for all, and used by typed_target().
 	 */
 	SlotConnection(
 	    Object* source, const std::string& sig_name,
@@ -275,9 +320,18 @@ namespace OGF {
 	    const ArgList& args, Any& ret_val
 	) override;
 
+	/**
+	 * \copydoc Connection::typed_target()
+	 */
+	gom_typed_method_adapter typed_target(
+	    const std::type_info& adapter_type, Object*& target
+	) override;
+
       private:
 	Object* target_;
 	std::string slot_name_;
+	gom_typed_method_adapter typed_adapter_;
+	const std::type_info* typed_adapter_type_;
     };
 
     /**********************************************************************/
@@ -333,6 +387,42 @@ namespace OGF {
             }
         }
 
+        /**
+         * \brief Invokes all the connected slots with typed arguments.
+         * \details Used by the signal adapters generated by GOMGEN.
+         *  The connections that have a typed target are directly called
+         *  with \p args. The ArgList is only built (once) if some
+         *  connections need to be invoked with an ArgList.
+         * \param[in] build_arg_list a function that takes an ArgList&
+         *  and creates the named arguments in it
+         * \param[in] args the arguments of the signal
+         * \tparam ARGS the types of the arguments of the signal, as
+         *  declared in its MetaSignal
+         */
+        template <class... ARGS, class ARG_LIST_BUILDER>
+        void invoke_typed(
+            ARG_LIST_BUILDER build_arg_list, const ARGS&... args
+        ) {
+            typedef void (*typed_adapter)(Object*, const ARGS&...);
+            ArgList arg_list;
+            bool arg_list_is_built = false;
+	    Any ret_val;
+            for(unsigned int i=0; i<size(); i++) {
+                Object* target = nullptr;
+                gom_typed_method_adapter adapter =
+                    (*this)[i]->typed_target(typeid(typed_adapter), target);
+                if(adapter != nullptr) {
+                    reinterpret_cast<typed_adapter>(adapter)(target, args...);
+                } else {
+                    if(!arg_list_is_built) {
+                        build_arg_list(arg_list);
+                        arg_list_is_built = true;
+                    }
+                    (*this)[i]->invoke(arg_list, ret_val);
+                }
+            }
+        }
+
         /**
          * \brief Removes a connection from a ConnectionList
          * \param[in] conn the connection to remove
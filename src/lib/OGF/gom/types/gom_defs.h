@@ -66,6 +66,26 @@
 
 #endif
 
-#define gom_package_initialize(x) extern void gom_package_initialize_##x() ; gom_package_initialize_##x()  
+namespace OGF {
+
+    /**
+     * \brief Function pointer type for the package initializers
+     *  generated by gomgen.
+     */
+    typedef void (*gom_package_initializer)();
+
+    /**
+     * \brief Calls the initializer of a package, and records the time
+     *  it took.
+     * \param[in] name the name of the package
+     * \param[in] initializer the function generated by gomgen
+     * \see Meta::initialize_package()
+     */
+    void GOM_API gom_initialize_package(
+        const char* name, gom_package_initializer initializer
+    );
+}
+
+#define gom_package_initialize(x) extern void gom_package_initialize_##x() ; OGF::gom_initialize_package(#x, gom_package_initialize_##x)  
 
 #endif
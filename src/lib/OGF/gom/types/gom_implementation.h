@@ -40,11 +40,13 @@
 #include <OGF/gom/common/common.h>
 #include <OGF/gom/types/gom.h>
 #include <OGF/gom/types/arg_list.h>
+#include <OGF/gom/types/connection.h>
 #include <OGF/gom/reflection/meta_type.h>
 #include <OGF/gom/reflection/meta_builtin.h>
 #include <OGF/gom/reflection/meta_enum.h>
 #include <OGF/gom/reflection/meta_class.h>
 #include <OGF/gom/services/serializer.h>
+#include <OGF/gom/services/converter.h>
 
 /**
  * \file OGF/gom/types/gom_implementation.h
@@ -291,6 +293,7 @@ namespace OGF {
                 meta_type, typeid(T).name()
             );
 	    meta_type->set_life_cycle(new GenericLifeCycle<T>);	    	    
+            Converters::declare_enum(meta_type);
             result_ = meta_type;
         }
         
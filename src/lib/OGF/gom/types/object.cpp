@@ -41,14 +41,27 @@
 #include <OGF/gom/reflection/meta_class.h>
 #include <OGF/gom/reflection/meta_method.h>
 #include <sstream>
+#include <unordered_map>
+#include <mutex>
 
 
 namespace OGF {
 
 //___________________________________________________________________________
 
+    /**
+     * \brief The connections of an Object, indexed by signal index.
+     * \details Signals are identified by the index of their name (and
+     *  not by MetaSignal), so that connections remain valid when a module
+     *  is reloaded, and so that signals that are not declared in the
+     *  MetaClass (dynamic signals) can be emitted by name.
+     *  Note: references to the ConnectionLists remain valid when
+     *  new signals are connected (this can happen while a signal
+     *  is emitted).
+     * \see Object::signal_index()
+     */
     class GOM_API ConnectionTable :
-        public std::map<std::string, ConnectionList > {
+        public std::unordered_map<index_t, ConnectionList > {
     public:
     };
 
@@ -142,6 +155,21 @@ namespace OGF {
 	return meta_class()->find_method(method_name) != nullptr;
     }
 
+    bool Object::invoke_method(
+        const std::string& method_name,
+        ArgList&& args, Any& ret_val
+    ) {
+        MetaMethod* method = meta_class()->find_method(method_name);
+        if(
+            method != nullptr && !method->args_are_positional(args) &&
+            method->nb_default_args(args) != 0
+        ) {
+            method->add_default_args(args);
+        }
+        const ArgList& args_ref = args;
+        return invoke_method(method_name, args_ref, ret_val);
+    }
+
     bool Object::invoke_method(
         const std::string& method_name,
         const ArgList& args, Any& ret_val
@@ -267,23 +295,37 @@ namespace OGF {
         return new SlotConnection(this, signal_name, to, slot_name);
     }
 
-    void Object::add_connection(Connection* connection) {
-        auto it = connections_->find(connection->signal_name());
-        if(it == connections_->end()) {
-            (*connections_)[connection->signal_name()] = ConnectionList();
-            it = connections_->find(
-                connection->signal_name()
-            );
+    index_t Object::signal_index(const std::string& signal_name) {
+        // Signal names are never removed from the table, so that the
+        // indices remain valid when a module is reloaded.
+        static std::mutex lock;
+        static std::unordered_map<std::string, index_t> indices;
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = indices.find(signal_name);
+        if(it != indices.end()) {
+            return it->second;
         }
-        it->second.push_back(connection);
+        index_t result = index_t(indices.size());
+        indices[signal_name] = result;
+        return result;
+    }
+
+    bool Object::slots_can_be_called_directly() const {
+        return true;
+    }
+
+    void Object::add_connection(Connection* connection) {
+        (*connections_)[connection->signal_index()].push_back(connection);
 
         //   TODO: check that we have all the arguments required by
         // the slot (and that their types match).
     }
 
     void Object::remove_connection(Connection* connection) {
-        auto it = connections_->find(connection->signal_name());
+        auto it = connections_->find(connection->signal_index());
         geo_assert(it != connections_->end());
+        // Note: the (possibly empty) ConnectionList is kept, since this
+        // function may be called by a slot while the signal is emitted.
         it->second.remove(connection);
     }
 
@@ -291,26 +333,47 @@ namespace OGF {
         const std::string& signal_name, const ArgList& args,
         bool called_from_slot
     ) {
-
         ogf_argused(called_from_slot);
-
         if(!signals_enabled_) {
             return true;
         }
-
-        bool result = true;
-
         if(connections_ == nullptr) {
             return false;
         }
-
-        auto it = connections_->find(signal_name);
+        if(connections_->empty()) {
+            return true;
+        }
+        auto it = connections_->find(signal_index(signal_name));
         if(it == connections_->end()) {
             return true;
         }
         ConnectionList& connections = it->second;
-	connections.invoke(args);
-        return result;
+        connections.invoke(args);
+        return true;
+    }
+
+    bool Object::signal_is_connected(const std::string& signal_name) const {
+        if(
+            !signals_enabled_ || connections_ == nullptr ||
+            connections_->empty()
+        ) {
+            return false;
+        }
+        return connected_slots(signal_index(signal_name)) != nullptr;
+    }
+
+    ConnectionList* Object::connected_slots(index_t sig_index) const {
+        if(
+            !signals_enabled_ || connections_ == nullptr ||
+            connections_->empty()
+        ) {
+            return nullptr;
+        }
+        auto it = connections_->find(sig_index);
+        if(it == connections_->end() || it->second.empty()) {
+            return nullptr;
+        }
+        return &(it->second);
     }
 
     index_t Object::get_nb_elements() const {
@@ -337,6 +400,20 @@ namespace OGF {
 			   << std::endl;
     }
 
+    bool Object::get_element_buffer(ElementBuffer& buffer) {
+	geo_argused(buffer);
+	return false;
+    }
+
+    void Object::element_buffer_modified() {
+    }
+
+    void Object::pin_element_buffer() {
+    }
+
+    void Object::unpin_element_buffer() {
+    }
+
     std::string Object::get_doc() const {
         return meta_class()->get_doc();
     }
@@ -55,9 +55,47 @@ namespace OGF {
     class MetaClass;
     class Object;
     class Connection;
+    class ConnectionList;
     class ConnectionTable;
     class Interpreter;
 
+    /**
+     * \brief Describes the contiguous memory where the elements
+     *  of an Object that implements the array interface are stored.
+     * \see Object::get_element_buffer()
+     */
+    struct ElementBuffer {
+	/**
+	 * \brief ElementBuffer constructor.
+	 */
+	ElementBuffer() :
+	    data(nullptr),
+	    element_meta_type(nullptr),
+	    element_size(0),
+	    nb_elements(0),
+	    dimension(0),
+	    read_only(true) {
+	}
+
+	/** \brief address of the first element */
+	Memory::pointer data;
+
+	/** \brief the MetaType of the elements */
+	MetaType* element_meta_type;
+
+	/** \brief the number of bytes between two consecutive elements */
+	size_t element_size;
+
+	/** \brief the total number of elements */
+	index_t nb_elements;
+
+	/** \brief the number of elements per item */
+	index_t dimension;
+
+	/** \brief true if the elements cannot be modified */
+	bool read_only;
+    };
+
     /**
      * \brief Base class for all objects in the GOM system.
      */
@@ -141,6 +179,24 @@ namespace OGF {
             const ArgList& args, Any& ret_val
         );
 
+        /**
+         * \brief Invokes a method by method name and a temporary argument
+         *  list, and gets the return value.
+         * \details The arguments with default values that are missing in
+         *  \p args are added to it in place, so that the ArgList does not
+         *  need to be copied (see MetaMethod::invoke()).
+         * \param[in] method_name name of the method
+         * \param[in,out] args the ArgList. The missing default arguments
+         *  are appended to it.
+         * \param[out] ret_val the return value as an Any
+         * \retval true if the method could be sucessfully invoked
+         * \retval false otherwise
+         */
+        bool invoke_method(
+            const std::string& method_name,
+            ArgList&& args, Any& ret_val
+        );
+
         /**
          * \brief Invokes a method by method name and argument list.
          * \details This variant of invoke() is for methods with void
@@ -166,9 +222,8 @@ namespace OGF {
          * \retval false otherwise
          */
         bool invoke_method(const std::string& method_name) {
-            ArgList args;
             Any ret_val;
-            return invoke_method(method_name, args, ret_val);
+            return invoke_method(method_name, ArgList(), ret_val);
         }
 
 	/**
@@ -210,6 +265,30 @@ namespace OGF {
          */
         virtual void add_connection(Connection* connection);
 
+        /**
+         * \brief Gets the index of a signal name.
+         * \details Connections are stored by signal index. The index of
+         *  a name never changes, also when a module is reloaded, and
+         *  signals that are not declared in a MetaClass (dynamic signals)
+         *  also have an index. The signal adapters generated by GOMGEN
+         *  resolve it once.
+         * \param[in] signal_name the name of the signal
+         * \return the index of \p signal_name
+         */
+        static index_t signal_index(const std::string& signal_name);
+
+        /**
+         * \brief Tests whether the slots of this object can be directly
+         *  called by the signals they are connected to.
+         * \details If it is the case, the signal adapters generated
+         *  by GOMGEN call the typed method adapters of the slots,
+         *  else they go through invoke_method(). It needs to be
+         *  overloaded by the classes that overload invoke_method().
+         * \retval true if slots can be called directly (default)
+         * \retval false otherwise
+         */
+        virtual bool slots_can_be_called_directly() const;
+
         /**
          * \brief Removes a connection to this object
          * \param[in] connection a pointer to the connection to be removed
@@ -276,6 +355,43 @@ namespace OGF {
 	    set_element(item * get_dimension() + component, value);
 	}
 
+	/**
+	 * \brief Gets direct access to the memory of the elements.
+	 * \details Part of the array interface. Objects that store their
+	 *  elements contiguously can expose them, so that scripting languages
+	 *  read and write them without going through an Any. The returned
+	 *  pointer is only valid until the object is next modified.
+	 *  Clients that write to the buffer need to call
+	 *  element_buffer_modified() afterwards.
+	 * \param[out] buffer the description of the memory of the elements
+	 * \retval true if the elements are stored contiguously and buffer
+	 *  was initialized
+	 * \retval false otherwise (default implementation), then clients
+	 *  need to use get_element() and set_element()
+	 */
+	virtual bool get_element_buffer(ElementBuffer& buffer);
+
+	/**
+	 * \brief Notifies this object that the memory returned by
+	 *  get_element_buffer() was modified.
+	 */
+	virtual void element_buffer_modified();
+
+	/**
+	 * \brief Pins the memory returned by get_element_buffer().
+	 * \details Called by clients that keep a pointer to the elements
+	 *  beyond a single access (for instance a NumPy array that refers
+	 *  to them). While pinned, the object does not reallocate its
+	 *  elements. Each call needs to be matched by a call to
+	 *  unpin_element_buffer(). Default implementation does nothing.
+	 */
+	virtual void pin_element_buffer();
+
+	/**
+	 * \brief Releases a pin taken by pin_element_buffer().
+	 */
+	virtual void unpin_element_buffer();
+
         /**
          * \brief Displays the names of all objects that
          *   contain a substring
@@ -503,6 +619,28 @@ namespace OGF {
             bool called_from_slot = false
         );
 
+        /**
+         * \brief Tests whether emitting a signal would call some slots.
+         * \details Used by the signal adapters generated by GOMGEN, so
+         *  that the argument list is only built when needed.
+         * \param[in] signal_name the name of the signal
+         * \retval true if signals are enabled and there is at least
+         *  one connection to the signal.
+         * \retval false otherwise
+         */
+        bool signal_is_connected(const std::string& signal_name) const;
+
+        /**
+         * \brief Gets the connections to a signal.
+         * \details Used by the signal adapters generated by GOMGEN.
+         * \param[in] sig_index the index of the signal, as returned
+         *  by signal_index()
+         * \return a pointer to the ConnectionList, or nullptr if
+         *  signals are disabled or if there is no connection to the
+         *  signal
+         */
+        ConnectionList* connected_slots(index_t sig_index) const;
+
     private:
         MetaClass* meta_class_;
         ConnectionTable* connections_;
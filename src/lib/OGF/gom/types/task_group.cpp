@@ -0,0 +1,95 @@
+/*
+ *  GXML/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/gom/types/task_group.h>
+#include <OGF/gom/reflection/meta.h>
+
+#include <geogram/basic/process.h>
+
+#include <atomic>
+
+namespace OGF {
+
+    TaskGroup::TaskGroup() {
+    }
+
+    TaskGroup::~TaskGroup() {
+    }
+
+    void TaskGroup::add(Callable* task) {
+	if(task == nullptr) {
+	    Logger::err("TaskGroup") << "add(): missing task" << std::endl;
+	    return;
+	}
+	tasks_.push_back(task);
+    }
+
+    bool TaskGroup::run() {
+	// The tasks are moved out of the group, so that they can add
+	// tasks for the next run.
+	std::vector<Callable_var> parallel_tasks;
+	std::vector<Callable_var> sequential_tasks;
+	for(const Callable_var& task : tasks_) {
+	    if(task->is_thread_safe()) {
+		parallel_tasks.push_back(task);
+	    } else {
+		sequential_tasks.push_back(task);
+	    }
+	}
+	tasks_.clear();
+
+	std::atomic<bool> result(true);
+	GEO::parallel_for(
+	    0, index_t(parallel_tasks.size()),
+	    [&parallel_tasks, &result](index_t i) {
+		if(!parallel_tasks[i]->invoke()) {
+		    result = false;
+		}
+	    }
+	);
+
+	for(const Callable_var& task : sequential_tasks) {
+	    if(!task->invoke()) {
+		result = false;
+	    }
+	}
+	return result;
+    }
+
+    void TaskGroup::clear() {
+	tasks_.clear();
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ *  GXML/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_GOM_TYPES_TASK_GROUP_H
+#define H_OGF_GOM_TYPES_TASK_GROUP_H
+
+#include <OGF/gom/common/common.h>
+#include <OGF/gom/types/callable.h>
+
+#include <vector>
+
+/**
+ * \file OGF/gom/types/task_group.h
+ * \brief A group of tasks that can be run in parallel.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief A group of tasks, run together by run().
+     * \details Thread-safe tasks (see Callable::is_thread_safe()) are run
+     *  in parallel. The other ones (for instance functions implemented in
+     *  a script language) are run afterwards, sequentially, from the
+     *  thread that calls run().
+     */
+    gom_class GOM_API TaskGroup : public Object {
+      public:
+	/**
+	 * \brief TaskGroup constructor.
+	 */
+	TaskGroup();
+
+	/**
+	 * \brief TaskGroup destructor.
+	 */
+	~TaskGroup() override;
+
+      gom_properties:
+
+	/**
+	 * \brief Gets the number of tasks.
+	 * \return the number of tasks that were added since the last
+	 *  call to run() or clear().
+	 */
+	index_t get_nb_tasks() const {
+	    return index_t(tasks_.size());
+	}
+
+      gom_slots:
+
+	/**
+	 * \brief Adds a task.
+	 * \param[in] task the task, called without argument.
+	 */
+	void add(Callable* task);
+
+	/**
+	 * \brief Runs all the tasks and waits for their completion.
+	 * \details The group is empty afterwards.
+	 * \retval true if all tasks succeeded
+	 * \retval false otherwise
+	 */
+	bool run();
+
+	/**
+	 * \brief Removes all the tasks.
+	 */
+	void clear();
+
+      private:
+	std::vector<Callable_var> tasks_;
+    };
+
+    /**
+     * \brief An automatic reference-counted pointer to a TaskGroup.
+     */
+    typedef SmartPointer<TaskGroup> TaskGroup_var;
+}
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ *
+ * As an exception to the GPL, Graphite can be linked 
+ *  with the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+ 
+
+#include <OGF/luagrob/grob/lua_glup_recording.h>
+
+#include <sstream>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The key of a recording that was never started.
+     */
+    const Numeric::uint64 NO_KEY = Numeric::uint64(-1);
+}
+
+namespace OGF {
+
+    const index_t LuaGLUPRecording::ATTRIB_DIMENSION[NB_ATTRIBS] = {
+	4, 4, 3
+    };
+
+    bool LuaGLUPRecording::Batch::operator==(const Batch& rhs) const {
+	if(
+	    primitive != rhs.primitive ||
+	    nb_vertices_per_primitive != rhs.nb_vertices_per_primitive ||
+	    first_vertex != rhs.first_vertex ||
+	    nb_vertices != rhs.nb_vertices
+	) {
+	    return false;
+	}
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    if(has_attrib[a] != rhs.has_attrib[a]) {
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    LuaGLUPRecording::LuaGLUPRecording() :
+	key_(NO_KEY),
+	generation_(0),
+	recording_(false),
+	valid_(false),
+	in_primitive_(false),
+	primitive_first_vertex_(0) {
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    has_current_attrib_[a] = false;
+	}
+    }
+
+    void LuaGLUPRecording::clear() {
+	abort();
+	key_ = NO_KEY;
+	recording_ = false;
+    }
+
+    void LuaGLUPRecording::begin(Numeric::uint64 key) {
+	calls_.clear();
+	args_.clear();
+	batches_.clear();
+	vertices_.clear();
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    attribs_[a].clear();
+	    has_current_attrib_[a] = false;
+	}
+	key_ = key;
+	++generation_;
+	recording_ = true;
+	valid_ = true;
+	in_primitive_ = false;
+    }
+
+    void LuaGLUPRecording::end() {
+	// GLUP.Begin() without GLUP.End()
+	if(in_primitive_) {
+	    abort();
+	}
+	recording_ = false;
+    }
+
+    void LuaGLUPRecording::abort() {
+	// Keeps the key, so that recording is not attempted at each frame,
+	// and frees the memory.
+	valid_ = false;
+	in_primitive_ = false;
+	calls_.clear();
+	args_.clear();
+	batches_.clear();
+	vertices_.clear();
+	calls_.shrink_to_fit();
+	args_.shrink_to_fit();
+	batches_.shrink_to_fit();
+	vertices_.shrink_to_fit();
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    attribs_[a].clear();
+	    attribs_[a].shrink_to_fit();
+	}
+    }
+
+    void LuaGLUPRecording::add_call(index_t function) {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	// Changing the GLUP state between GLUP.Begin() and GLUP.End()
+	// cannot be replayed with a single draw call.
+	if(in_primitive_) {
+	    abort();
+	    return;
+	}
+	Call call;
+	call.function = function;
+	call.first_arg = index_t(args_.size());
+	call.nb_args = 0;
+	calls_.push_back(call);
+    }
+
+    void LuaGLUPRecording::add_arg(double value, ArgType type) {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	Arg arg;
+	arg.value = value;
+	arg.type = type;
+	args_.push_back(arg);
+	++calls_.back().nb_args;
+    }
+
+    void LuaGLUPRecording::begin_primitive(
+	index_t primitive, index_t nb_vertices_per_primitive
+    ) {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	if(in_primitive_ || nb_vertices_per_primitive == 0) {
+	    abort();
+	    return;
+	}
+	// Continues the previous batch if nothing was called since it
+	// was drawn.
+	bool new_batch = true;
+	if(!calls_.empty() && calls_.back().function == DRAW_BATCH) {
+	    const Batch& last = batches_[calls_.back().first_arg];
+	    new_batch = (last.primitive != primitive);
+	    for(index_t a=0; a<NB_ATTRIBS; ++a) {
+		new_batch = new_batch ||
+		    (last.has_attrib[a] != has_current_attrib_[a]);
+	    }
+	}
+	if(new_batch) {
+	    Batch batch;
+	    batch.primitive = primitive;
+	    batch.nb_vertices_per_primitive = nb_vertices_per_primitive;
+	    batch.first_vertex = nb_vertices();
+	    batch.nb_vertices = 0;
+	    for(index_t a=0; a<NB_ATTRIBS; ++a) {
+		batch.has_attrib[a] = has_current_attrib_[a];
+	    }
+	    Call call;
+	    call.function = DRAW_BATCH;
+	    call.first_arg = index_t(batches_.size());
+	    call.nb_args = 0;
+	    calls_.push_back(call);
+	    batches_.push_back(batch);
+	}
+	in_primitive_ = true;
+	primitive_first_vertex_ = nb_vertices();
+    }
+
+    void LuaGLUPRecording::end_primitive() {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	if(!in_primitive_) {
+	    abort();
+	    return;
+	}
+	Batch& batch = batches_.back();
+	index_t nb_new_vertices = nb_vertices() - primitive_first_vertex_;
+	index_t nb_ignored = nb_new_vertices % batch.nb_vertices_per_primitive;
+	if(nb_ignored != 0) {
+	    index_t nb = nb_vertices() - nb_ignored;
+	    vertices_.resize(4 * size_t(nb));
+	    for(index_t a=0; a<NB_ATTRIBS; ++a) {
+		attribs_[a].resize(ATTRIB_DIMENSION[a] * size_t(nb));
+	    }
+	}
+	batch.nb_vertices = nb_vertices() - batch.first_vertex;
+	in_primitive_ = false;
+    }
+
+    void LuaGLUPRecording::add_vertex(const double* coords, index_t nb_coords) {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	if(!in_primitive_ || nb_coords < 2 || nb_coords > 4) {
+	    abort();
+	    return;
+	}
+	Batch& batch = batches_.back();
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    if(has_current_attrib_[a] && !batch.has_attrib[a]) {
+		// An attribute specified after the first vertices of the
+		// batch: they would need the value it had before recording.
+		if(nb_vertices() != batch.first_vertex) {
+		    abort();
+		    return;
+		}
+		batch.has_attrib[a] = true;
+	    }
+	}
+	const double defaults[4] = { 0.0, 0.0, 0.0, 1.0 };
+	for(index_t c=0; c<4; ++c) {
+	    vertices_.push_back(float(c < nb_coords ? coords[c] : defaults[c]));
+	}
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    for(index_t c=0; c<ATTRIB_DIMENSION[a]; ++c) {
+		attribs_[a].push_back(
+		    has_current_attrib_[a] ? current_attrib_[a][c] : 0.0f
+		);
+	    }
+	}
+    }
+
+    void LuaGLUPRecording::set_attribute(
+	Attribute attrib, const double* values, index_t nb_values
+    ) {
+	if(!recording_ || !valid_) {
+	    return;
+	}
+	if(nb_values == 0 || nb_values > ATTRIB_DIMENSION[attrib]) {
+	    abort();
+	    return;
+	}
+	const double defaults[4] = { 0.0, 0.0, 0.0, 1.0 };
+	for(index_t c=0; c<ATTRIB_DIMENSION[attrib]; ++c) {
+	    current_attrib_[attrib][c] = float(
+		c < nb_values ? values[c] : defaults[c]
+	    );
+	}
+	has_current_attrib_[attrib] = true;
+    }
+
+    std::string LuaGLUPRecording::to_string(
+	const std::vector<std::string>& function_names
+    ) const {
+	static const char* attrib_names[NB_ATTRIBS] = {
+	    "color", "tex_coord", "normal"
+	};
+	std::ostringstream out;
+	if(!valid_) {
+	    out << "invalid" << std::endl;
+	    return out.str();
+	}
+	for(index_t i=0; i<nb_calls(); ++i) {
+	    if(call_function(i) == DRAW_BATCH) {
+		const Batch& B = batch(call_batch(i));
+		out << "batch primitive=" << B.primitive
+		    << " vertices=" << B.nb_vertices << std::endl;
+		for(index_t v=B.first_vertex; v<B.first_vertex+B.nb_vertices; ++v) {
+		    out << "  vertex";
+		    for(index_t c=0; c<4; ++c) {
+			out << " " << vertices_[4*v+c];
+		    }
+		    for(index_t a=0; a<NB_ATTRIBS; ++a) {
+			if(B.has_attrib[a]) {
+			    out << " " << attrib_names[a];
+			    index_t dim = ATTRIB_DIMENSION[a];
+			    for(index_t c=0; c<dim; ++c) {
+				out << " " << attribs_[a][dim*v+c];
+			    }
+			}
+		    }
+		    out << std::endl;
+		}
+		continue;
+	    }
+	    if(call_function(i) < function_names.size()) {
+		out << function_names[call_function(i)];
+	    } else {
+		out << "function_" << call_function(i);
+	    }
+	    out << "(";
+	    for(index_t j=0; j<call_nb_args(i); ++j) {
+		if(j != 0) {
+		    out << ",";
+		}
+		out << call_arg(i,j).value;
+	    }
+	    out << ")" << std::endl;
+	}
+	return out.str();
+    }
+
+    bool LuaGLUPRecording::operator==(const LuaGLUPRecording& rhs) const {
+	if(
+	    calls_.size() != rhs.calls_.size() || args_ != rhs.args_ ||
+	    batches_ != rhs.batches_ || vertices_ != rhs.vertices_
+	) {
+	    return false;
+	}
+	for(index_t a=0; a<NB_ATTRIBS; ++a) {
+	    if(attribs_[a] != rhs.attribs_[a]) {
+		return false;
+	    }
+	}
+	for(index_t i=0; i<nb_calls(); ++i) {
+	    if(
+		calls_[i].function != rhs.calls_[i].function ||
+		calls_[i].first_arg != rhs.calls_[i].first_arg ||
+		calls_[i].nb_args != rhs.calls_[i].nb_args
+	    ) {
+		return false;
+	    }
+	}
+	return true;
+    }
+}
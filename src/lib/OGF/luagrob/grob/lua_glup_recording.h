@@ -0,0 +1,414 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ *
+ * As an exception to the GPL, Graphite can be linked 
+ *  with the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+ 
+
+#ifndef H_OGF_LUAGROB_GROB_LUA_GLUP_RECORDING_H
+#define H_OGF_LUAGROB_GROB_LUA_GLUP_RECORDING_H
+
+#include <OGF/luagrob/common/common.h>
+
+#include <vector>
+#include <string>
+
+/**
+ * \file OGF/luagrob/grob/lua_glup_recording.h
+ * \brief the LuaGLUPRecording class.
+ */
+namespace OGF {
+
+    /**
+     * \brief A recording of the GLUP functions called by the draw()
+     *  function of a LuaGrob.
+     * \details The vertices sent in immediate mode (between GLUP.Begin()
+     *  and GLUP.End()) are stored in vertex buffers, grouped in batches
+     *  that can be drawn with a single glupDrawArrays(). Consecutive
+     *  Begin() / End() blocks with the same primitive and no other call
+     *  in-between go to the same batch. The other calls (GLUP state) are
+     *  stored with their arguments, and replayed. The recording is valid
+     *  as long as its key (computed from the version of the LuaGrob and
+     *  from the globals of its LUA state) did not change. Recordings do
+     *  not depend on OpenGL, and can be compared.
+     */
+    class LUAGROB_API LuaGLUPRecording {
+    public:
+	/**
+	 * \brief The LUA type of an argument of a recorded call.
+	 * \details Integers and booleans are distinguished from numbers,
+	 *  so that they are passed back with the same type when the
+	 *  recording is replayed.
+	 */
+	enum ArgType {
+	    ARG_NUMBER,
+	    ARG_INTEGER,
+	    ARG_BOOLEAN
+	};
+
+	/**
+	 * \brief An argument of a recorded call.
+	 */
+	struct Arg {
+	    double value;
+	    ArgType type;
+
+	    /**
+	     * \brief Tests whether two arguments are equal.
+	     * \param[in] rhs the other argument.
+	     * \retval true if both arguments have the same type and value.
+	     * \retval false otherwise.
+	     */
+	    bool operator==(const Arg& rhs) const {
+		return value == rhs.value && type == rhs.type;
+	    }
+	};
+
+	/**
+	 * \brief The per-vertex attributes of the immediate mode.
+	 */
+	enum Attribute {
+	    ATTRIB_COLOR,
+	    ATTRIB_TEX_COORD,
+	    ATTRIB_NORMAL,
+	    NB_ATTRIBS
+	};
+
+	/**
+	 * \brief Number of components of each attribute in the buffers.
+	 */
+	static const index_t ATTRIB_DIMENSION[NB_ATTRIBS];
+
+	/**
+	 * \brief The function index of the calls that draw a batch.
+	 * \see call_batch()
+	 */
+	static const index_t DRAW_BATCH = NO_INDEX;
+
+	/**
+	 * \brief A sequence of vertices drawn with the same primitive.
+	 */
+	struct Batch {
+	    index_t primitive;
+	    index_t nb_vertices_per_primitive;
+	    index_t first_vertex;
+	    index_t nb_vertices;
+	    bool has_attrib[NB_ATTRIBS];
+
+	    /**
+	     * \brief Tests whether two batches are equal.
+	     * \param[in] rhs the other batch.
+	     * \retval true if both batches draw the same range of
+	     *  vertices with the same primitive and attributes.
+	     * \retval false otherwise.
+	     */
+	    bool operator==(const Batch& rhs) const;
+	};
+
+	/**
+	 * \brief LuaGLUPRecording constructor.
+	 */
+	LuaGLUPRecording();
+
+	/**
+	 * \brief Removes all the calls and resets the key.
+	 */
+	void clear();
+
+	/**
+	 * \brief Starts a new recording.
+	 * \param[in] key the key of the recording, that changes when
+	 *  the LuaGrob or the globals of its LUA state change.
+	 */
+	void begin(Numeric::uint64 key);
+
+	/**
+	 * \brief Terminates the current recording.
+	 */
+	void end();
+
+	/**
+	 * \brief Indicates that the current recording cannot be replayed.
+	 * \details This happens when a GLUP function is called with
+	 *  arguments that cannot be recorded, or when the LUA program
+	 *  animates the drawing. Then the recording is not attempted again
+	 *  before the key changes.
+	 */
+	void abort();
+
+	/**
+	 * \brief Tests whether a recording is in progress.
+	 * \retval true if calls are recorded
+	 * \retval false otherwise
+	 */
+	bool is_recording() const {
+	    return recording_;
+	}
+
+	/**
+	 * \brief Tests whether this recording was done for a given key.
+	 * \param[in] key the key of the recording.
+	 * \retval true if this recording was done (or aborted) for
+	 *  \p key.
+	 * \retval false otherwise.
+	 */
+	bool has_key(Numeric::uint64 key) const {
+	    return !recording_ && key_ == key;
+	}
+
+	/**
+	 * \brief Tests whether this recording can be replayed.
+	 * \param[in] key the key of the recording.
+	 * \retval true if this recording was completed for \p key.
+	 * \retval false otherwise.
+	 */
+	bool can_replay(Numeric::uint64 key) const {
+	    return has_key(key) && valid_;
+	}
+
+	/**
+	 * \brief Gets a number that changes each time a recording starts.
+	 * \details Used to know when the vertex buffers need to be
+	 *  uploaded to the GPU again.
+	 * \return the generation of the recording.
+	 */
+	index_t generation() const {
+	    return generation_;
+	}
+
+	/**
+	 * \brief Starts recording a new call.
+	 * \details The arguments are recorded by subsequent calls of
+	 *  add_arg(). Calling a GLUP function between GLUP.Begin() and
+	 *  GLUP.End() aborts the recording.
+	 * \param[in] function the index of the called GLUP function.
+	 */
+	void add_call(index_t function);
+
+	/**
+	 * \brief Records an argument of the current call.
+	 * \param[in] value the value of the argument.
+	 * \param[in] type the LUA type of the argument.
+	 */
+	void add_arg(double value, ArgType type = ARG_NUMBER);
+
+	/**
+	 * \brief Records a call of GLUP.Begin().
+	 * \param[in] primitive the GLUP primitive.
+	 * \param[in] nb_vertices_per_primitive the number of vertices of
+	 *  the primitive.
+	 */
+	void begin_primitive(
+	    index_t primitive, index_t nb_vertices_per_primitive
+	);
+
+	/**
+	 * \brief Records a call of GLUP.End().
+	 * \details As in GLUP, the vertices of an incomplete primitive
+	 *  are ignored.
+	 */
+	void end_primitive();
+
+	/**
+	 * \brief Records a call of GLUP.Vertex().
+	 * \details The current values of the attributes are copied to
+	 *  the vertex.
+	 * \param[in] coords the coordinates.
+	 * \param[in] nb_coords the number of coordinates, in 2..4.
+	 */
+	void add_vertex(const double* coords, index_t nb_coords);
+
+	/**
+	 * \brief Records a call of GLUP.Color(), GLUP.TexCoord() or
+	 *  GLUP.Normal().
+	 * \param[in] attrib the attribute.
+	 * \param[in] values the values.
+	 * \param[in] nb_values the number of values.
+	 */
+	void set_attribute(
+	    Attribute attrib, const double* values, index_t nb_values
+	);
+
+	/**
+	 * \brief Gets the number of recorded calls.
+	 * \return the number of recorded calls.
+	 */
+	index_t nb_calls() const {
+	    return index_t(calls_.size());
+	}
+
+	/**
+	 * \brief Gets the function of a recorded call.
+	 * \param[in] i the index of the call, in 0..nb_calls()-1.
+	 * \return the index of the GLUP function, or DRAW_BATCH.
+	 */
+	index_t call_function(index_t i) const {
+	    geo_debug_assert(i < nb_calls());
+	    return calls_[i].function;
+	}
+
+	/**
+	 * \brief Gets the batch drawn by a recorded call.
+	 * \param[in] i the index of the call, in 0..nb_calls()-1.
+	 * \pre call_function(i) == DRAW_BATCH
+	 * \return the index of the batch, in 0..nb_batches()-1.
+	 */
+	index_t call_batch(index_t i) const {
+	    geo_debug_assert(call_function(i) == DRAW_BATCH);
+	    return calls_[i].first_arg;
+	}
+
+	/**
+	 * \brief Gets the number of arguments of a recorded call.
+	 * \param[in] i the index of the call, in 0..nb_calls()-1.
+	 * \return the number of arguments.
+	 */
+	index_t call_nb_args(index_t i) const {
+	    geo_debug_assert(i < nb_calls());
+	    return calls_[i].nb_args;
+	}
+
+	/**
+	 * \brief Gets an argument of a recorded call.
+	 * \param[in] i the index of the call, in 0..nb_calls()-1.
+	 * \param[in] j the index of the argument, in 0..call_nb_args(i)-1.
+	 * \return a const reference to the argument.
+	 */
+	const Arg& call_arg(index_t i, index_t j) const {
+	    geo_debug_assert(j < call_nb_args(i));
+	    return args_[calls_[i].first_arg + j];
+	}
+
+	/**
+	 * \brief Gets the number of batches.
+	 * \return the number of batches.
+	 */
+	index_t nb_batches() const {
+	    return index_t(batches_.size());
+	}
+
+	/**
+	 * \brief Gets a batch.
+	 * \param[in] b the index of the batch, in 0..nb_batches()-1.
+	 * \return a const reference to the batch.
+	 */
+	const Batch& batch(index_t b) const {
+	    geo_debug_assert(b < nb_batches());
+	    return batches_[b];
+	}
+
+	/**
+	 * \brief Gets the number of vertices in the buffers.
+	 * \return the number of vertices.
+	 */
+	index_t nb_vertices() const {
+	    return index_t(vertices_.size() / 4);
+	}
+
+	/**
+	 * \brief Gets the buffer with the coordinates of the vertices.
+	 * \return a const reference to the buffer, with 4 floats
+	 *  per vertex.
+	 */
+	const std::vector<float>& vertices() const {
+	    return vertices_;
+	}
+
+	/**
+	 * \brief Gets the buffer with the values of an attribute.
+	 * \param[in] attrib the attribute.
+	 * \return a const reference to the buffer, with
+	 *  ATTRIB_DIMENSION[attrib] floats per vertex.
+	 */
+	const std::vector<float>& attribute(Attribute attrib) const {
+	    return attribs_[attrib];
+	}
+
+	/**
+	 * \brief Gets a description of the recording.
+	 * \details One line per call, with its arguments, and one line
+	 *  per vertex of the batches. Used to compare recordings from
+	 *  scripts.
+	 * \param[in] function_names the names of the GLUP functions,
+	 *  indexed by function index (an empty vector displays indices).
+	 * \return the description.
+	 */
+	std::string to_string(
+	    const std::vector<std::string>& function_names
+	) const;
+
+	/**
+	 * \brief Tests whether two recordings have the same calls.
+	 * \details Keys are not compared.
+	 * \param[in] rhs the other recording.
+	 * \retval true if both recordings have the same calls with the
+	 *  same arguments, and the same batches and vertices.
+	 * \retval false otherwise.
+	 */
+	bool operator==(const LuaGLUPRecording& rhs) const;
+
+	/**
+	 * \brief Tests whether two recordings differ.
+	 * \param[in] rhs the other recording.
+	 * \retval true if the calls or their arguments differ.
+	 * \retval false otherwise.
+	 */
+	bool operator!=(const LuaGLUPRecording& rhs) const {
+	    return !(*this == rhs);
+	}
+
+    private:
+	struct Call {
+	    index_t function;
+	    index_t first_arg;
+	    index_t nb_args;
+	};
+
+	std::vector<Call> calls_;
+	std::vector<Arg> args_;
+	std::vector<Batch> batches_;
+	std::vector<float> vertices_;
+	std::vector<float> attribs_[NB_ATTRIBS];
+	float current_attrib_[NB_ATTRIBS][4];
+	bool has_current_attrib_[NB_ATTRIBS];
+	Numeric::uint64 key_;
+	index_t generation_;
+	bool recording_;
+	bool valid_;
+	bool in_primitive_;
+	index_t primitive_first_vertex_;
+    };
+}
+#endif
@@ -46,8 +46,13 @@
 #include <OGF/gom/interpreter/interpreter.h>
 
 #include <geogram_gfx/lua/lua_glup.h>
+#include <geogram_gfx/basic/GL.h>
+#include <geogram_gfx/GLUP/GLUP.h>
 #include <geogram/lua/lua_io.h>
 
+#include <algorithm>
+#include <cstring>
+
 extern "C" {
 #include <geogram/third_party/lua/lauxlib.h>
 #include <geogram/third_party/lua/lualib.h>
@@ -63,22 +68,367 @@ namespace {
 	    );
 	}
 	lua_getglobal(L,"this");
-	Grob* thisgrob = static_cast<Grob*>(lua_touserdata(L,-1));
+	LuaGrob* thisgrob = static_cast<LuaGrob*>(lua_touserdata(L,-1));
 	lua_pop(L,1);
+	// An animated drawing cannot be replayed.
+	if(thisgrob->glup_recording().is_recording()) {
+	    thisgrob->glup_recording().abort();
+	}
 	Object* render_area = thisgrob->scene_graph()->get_render_area();
 	if(render_area != nullptr) {
 	    render_area->invoke_method("update");
 	}
 	return 0;
     }
+
+    /**
+     * \brief What a wrapped GLUP function does, regarding recording.
+     */
+    enum GLUPWrapperKind {
+	GLUP_WRAP_CALL,
+	GLUP_WRAP_BEGIN,
+	GLUP_WRAP_END,
+	GLUP_WRAP_VERTEX,
+	GLUP_WRAP_COLOR,
+	GLUP_WRAP_TEX_COORD,
+	GLUP_WRAP_NORMAL
+    };
+
+    /**
+     * \brief Gets the kind of a GLUP function from its name.
+     * \param[in] name the name of the function in the GLUP table.
+     * \return the kind of the function.
+     */
+    GLUPWrapperKind glup_wrapper_kind(const std::string& name) {
+	if(name == "Begin") {
+	    return GLUP_WRAP_BEGIN;
+	}
+	if(name == "End") {
+	    return GLUP_WRAP_END;
+	}
+	if(name == "Vertex") {
+	    return GLUP_WRAP_VERTEX;
+	}
+	if(name == "Color") {
+	    return GLUP_WRAP_COLOR;
+	}
+	if(name == "TexCoord") {
+	    return GLUP_WRAP_TEX_COORD;
+	}
+	if(name == "Normal") {
+	    return GLUP_WRAP_NORMAL;
+	}
+	return GLUP_WRAP_CALL;
+    }
+
+    /**
+     * \brief Gets the number of vertices of a GLUP primitive.
+     * \param[in] primitive the GLUP primitive, as passed to GLUP.Begin().
+     * \return the number of vertices, or 0 for an unknown primitive.
+     */
+    index_t glup_primitive_nb_vertices(lua_Integer primitive) {
+	switch(primitive) {
+	case GLUP_POINTS:
+	case GLUP_SPHERES:
+	    return 1;
+	case GLUP_LINES:
+	    return 2;
+	case GLUP_TRIANGLES:
+	    return 3;
+	case GLUP_QUADS:
+	case GLUP_TETRAHEDRA:
+	case GLUP_CONNECTORS:
+	    return 4;
+	case GLUP_PYRAMIDS:
+	    return 5;
+	case GLUP_PRISMS:
+	    return 6;
+	case GLUP_HEXAHEDRA:
+	    return 8;
+	default:
+	    return 0;
+	}
+    }
+
+    /**
+     * \brief The locations of the vertex attributes in the GLUP
+     *  shaders, used to draw the batches of a recording with
+     *  glupDrawArrays(): the vertices, then the attributes in the
+     *  order of LuaGLUPRecording::Attribute.
+     */
+    const GLuint GLUP_ATTRIB_LOCATION[1 + LuaGLUPRecording::NB_ATTRIBS] = {
+	0, 1, 2, 3
+    };
+
+    /**
+     * \brief Records a call of a GLUP function that changes the state.
+     * \param[in] L a pointer to the LUA state
+     * \param[in] recording the recording
+     * \param[in] function the index of the function
+     * \param[in] nb_args the number of arguments on the stack
+     */
+    void record_GLUP_call(
+	lua_State* L, LuaGLUPRecording& recording,
+	index_t function, int nb_args
+    ) {
+	recording.add_call(function);
+	for(int i=1; i<=nb_args; ++i) {
+	    switch(lua_type(L,i)) {
+	    case LUA_TNUMBER:
+		recording.add_arg(
+		    double(lua_tonumber(L,i)),
+		    lua_isinteger(L,i) ?
+		    LuaGLUPRecording::ARG_INTEGER :
+		    LuaGLUPRecording::ARG_NUMBER
+		);
+		break;
+	    case LUA_TBOOLEAN:
+		recording.add_arg(
+		    lua_toboolean(L,i) ? 1.0 : 0.0,
+		    LuaGLUPRecording::ARG_BOOLEAN
+		);
+		break;
+	    default:
+		// Tables, strings... cannot be recorded.
+		recording.abort();
+		break;
+	    }
+	}
+    }
+
+    /**
+     * \brief Records a call of a GLUP immediate mode function.
+     * \param[in] L a pointer to the LUA state
+     * \param[in] recording the recording
+     * \param[in] kind the kind of the function
+     * \param[in] nb_args the number of arguments on the stack
+     */
+    void record_GLUP_immediate_call(
+	lua_State* L, LuaGLUPRecording& recording,
+	GLUPWrapperKind kind, int nb_args
+    ) {
+	if(kind == GLUP_WRAP_BEGIN) {
+	    if(nb_args != 1 || !lua_isinteger(L,1)) {
+		recording.abort();
+		return;
+	    }
+	    lua_Integer primitive = lua_tointeger(L,1);
+	    recording.begin_primitive(
+		index_t(primitive), glup_primitive_nb_vertices(primitive)
+	    );
+	    return;
+	}
+	if(kind == GLUP_WRAP_END) {
+	    recording.end_primitive();
+	    return;
+	}
+	double values[4];
+	if(nb_args > 4) {
+	    recording.abort();
+	    return;
+	}
+	for(int i=1; i<=nb_args; ++i) {
+	    if(lua_type(L,i) != LUA_TNUMBER) {
+		recording.abort();
+		return;
+	    }
+	    values[i-1] = double(lua_tonumber(L,i));
+	}
+	switch(kind) {
+	case GLUP_WRAP_VERTEX:
+	    recording.add_vertex(values, index_t(nb_args));
+	    break;
+	case GLUP_WRAP_COLOR:
+	    recording.set_attribute(
+		LuaGLUPRecording::ATTRIB_COLOR, values, index_t(nb_args)
+	    );
+	    break;
+	case GLUP_WRAP_TEX_COORD:
+	    recording.set_attribute(
+		LuaGLUPRecording::ATTRIB_TEX_COORD, values, index_t(nb_args)
+	    );
+	    break;
+	case GLUP_WRAP_NORMAL:
+	    recording.set_attribute(
+		LuaGLUPRecording::ATTRIB_NORMAL, values, index_t(nb_args)
+	    );
+	    break;
+	default:
+	    break;
+	}
+    }
+
+    /**
+     * \brief Wrapper around a GLUP function, that records its calls
+     *  in the LuaGLUPRecording of the LuaGrob.
+     * \details Upvalue 1 is the wrapped function, upvalue 2 its index in
+     *  the table of the recorded functions, upvalue 3 the LuaGrob and
+     *  upvalue 4 the GLUPWrapperKind of the function.
+     */
+    int wrapper_recorded_GLUP_function(lua_State* L) {
+	LuaGrob* grob = static_cast<LuaGrob*>(
+	    lua_touserdata(L, lua_upvalueindex(3))
+	);
+	LuaGLUPRecording& recording = grob->glup_recording();
+	int nb_args = lua_gettop(L);
+	if(recording.is_recording()) {
+	    GLUPWrapperKind kind = GLUPWrapperKind(
+		lua_tointeger(L, lua_upvalueindex(4))
+	    );
+	    if(kind == GLUP_WRAP_CALL) {
+		record_GLUP_call(
+		    L, recording,
+		    index_t(lua_tointeger(L, lua_upvalueindex(2))), nb_args
+		);
+	    } else {
+		record_GLUP_immediate_call(L, recording, kind, nb_args);
+	    }
+	}
+	if(grob->glup_dry_run()) {
+	    return 0;
+	}
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_insert(L, 1);
+	lua_call(L, nb_args, LUA_MULTRET);
+	return lua_gettop(L);
+    }
+
+    /**
+     * \brief Replays a LuaGLUPRecording.
+     * \details Called through lua_pcall(). Argument 1 is the LuaGrob
+     *  (as a light user data) and argument 2 the table of the recorded
+     *  GLUP functions. The calls that change the GLUP state are replayed,
+     *  and each batch of vertices is drawn with a single call.
+     */
+    int replay_GLUP_recording(lua_State* L) {
+	LuaGrob* grob = static_cast<LuaGrob*>(lua_touserdata(L,1));
+	const LuaGLUPRecording* recording = &grob->glup_recording();
+	for(index_t i=0; i<recording->nb_calls(); ++i) {
+	    if(recording->call_function(i) == LuaGLUPRecording::DRAW_BATCH) {
+		grob->draw_recorded_batch(recording->call_batch(i));
+		continue;
+	    }
+	    index_t nb_args = recording->call_nb_args(i);
+	    luaL_checkstack(L, int(nb_args)+1, "GLUP recording replay");
+	    lua_rawgeti(L, 2, lua_Integer(recording->call_function(i)));
+	    for(index_t j=0; j<nb_args; ++j) {
+		const LuaGLUPRecording::Arg& arg = recording->call_arg(i,j);
+		switch(arg.type) {
+		case LuaGLUPRecording::ARG_NUMBER:
+		    lua_pushnumber(L, lua_Number(arg.value));
+		    break;
+		case LuaGLUPRecording::ARG_INTEGER:
+		    lua_pushinteger(L, lua_Integer(arg.value));
+		    break;
+		case LuaGLUPRecording::ARG_BOOLEAN:
+		    lua_pushboolean(L, arg.value != 0.0);
+		    break;
+		}
+	    }
+	    lua_call(L, int(nb_args), 0);
+	}
+	return 0;
+    }
+
+    /**
+     * \brief Maximum number of entries of a table covered by the hash
+     *  of the globals.
+     */
+    const index_t MAX_HASHED_TABLE_ENTRIES = 4096;
+
+    /**
+     * \brief Combines a value with a hash.
+     * \param[in,out] h the hash
+     * \param[in] x the value
+     */
+    inline void hash_combine(Numeric::uint64& h, Numeric::uint64 x) {
+	h ^= x + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    }
+
+    /**
+     * \brief Hashes a LUA value.
+     * \param[in] L a pointer to the LUA state
+     * \param[in] index the stack index of the value
+     * \param[in] builtins the stack index of a table with the tables of
+     *  the standard libraries as keys (they are not traversed)
+     * \param[in] depth the number of levels of tables to traverse
+     * \param[in,out] h the hash
+     */
+    void hash_lua_value(
+	lua_State* L, int index, int builtins, int depth, Numeric::uint64& h
+    ) {
+	index = lua_absindex(L, index);
+	int type = lua_type(L, index);
+	hash_combine(h, Numeric::uint64(type));
+	switch(type) {
+	case LUA_TNUMBER: {
+	    lua_Number x = lua_tonumber(L, index);
+	    Numeric::uint64 bits = 0;
+	    memcpy(&bits, &x, std::min(sizeof(x), sizeof(bits)));
+	    hash_combine(h, bits);
+	} break;
+	case LUA_TBOOLEAN: {
+	    hash_combine(h, Numeric::uint64(lua_toboolean(L, index)));
+	} break;
+	case LUA_TSTRING: {
+	    // Only called on strings: lua_tolstring() does not convert the
+	    // keys during the traversal.
+	    size_t len = 0;
+	    const char* str = lua_tolstring(L, index, &len);
+	    Numeric::uint64 s = 14695981039346656037ull;
+	    for(size_t i=0; i<len; ++i) {
+		s = (s ^ Numeric::uint64(Numeric::uint8(str[i]))) *
+		    1099511628211ull;
+	    }
+	    hash_combine(h, s);
+	} break;
+	case LUA_TTABLE: {
+	    hash_combine(h, Numeric::uint64(size_t(lua_topointer(L, index))));
+	    lua_pushvalue(L, index);
+	    bool builtin = (lua_rawget(L, builtins) != LUA_TNIL);
+	    lua_pop(L,1);
+	    if(depth == 0 || builtin) {
+		return;
+	    }
+	    index_t nb_entries = 0;
+	    lua_pushnil(L);
+	    while(lua_next(L, index) != 0) {
+		hash_lua_value(L, -2, builtins, depth-1, h);
+		hash_lua_value(L, -1, builtins, depth-1, h);
+		lua_pop(L,1);
+		++nb_entries;
+		if(nb_entries == MAX_HASHED_TABLE_ENTRIES) {
+		    lua_pop(L,1);
+		    break;
+		}
+	    }
+	} break;
+	case LUA_TNIL:
+	    break;
+	default:
+	    // Functions, userdata, threads: identified by their address.
+	    hash_combine(h, Numeric::uint64(size_t(lua_topointer(L, index))));
+	    break;
+	}
+    }
 }
 
 namespace OGF {
     
     LuaGrob::LuaGrob(CompositeGrob* parent) :
         Grob(parent),
-	autorun_(false)
+	draw_function_ref_(LUA_NOREF),
+	autorun_(false),
+	record_drawing_(false),
+	version_(0),
+	glup_wrappers_installed_(false),
+	glup_dry_run_(false),
+	recording_vertex_array_(0),
+	recording_buffers_generation_(NO_INDEX)
     {
+	for(index_t k=0; k<1+LuaGLUPRecording::NB_ATTRIBS; ++k) {
+	    recording_buffers_[k] = 0;
+	}
         initialize_name("lua");
 	box_.add_point(vec3(0.0, 0.0, 0.0));
 	box_.add_point(vec3(1.0, 1.0, 1.0));
@@ -93,6 +443,24 @@ namespace OGF {
 	lua_settable(lua_shader_state_,-3);
 	lua_pop(lua_shader_state_,1);
 
+	// The tables of the standard libraries, that are not covered by
+	// shader_globals_hash().
+	lua_newtable(lua_shader_state_);
+	lua_pushglobaltable(lua_shader_state_);
+	lua_pushnil(lua_shader_state_);
+	while(lua_next(lua_shader_state_, -2) != 0) {
+	    if(lua_istable(lua_shader_state_, -1)) {
+		lua_pushboolean(lua_shader_state_, 1);
+		lua_rawset(lua_shader_state_, -5);
+	    } else {
+		lua_pop(lua_shader_state_, 1);
+	    }
+	}
+	lua_pop(lua_shader_state_, 1);
+	lua_setfield(
+	    lua_shader_state_, LUA_REGISTRYINDEX, "graphite_builtin_globals"
+	);
+
 	lua_pushlightuserdata(lua_shader_state_,this);
 	lua_setglobal(lua_shader_state_,"this");
 	
@@ -101,10 +469,29 @@ namespace OGF {
     }
 
     LuaGrob::~LuaGrob() {
+	delete_recording_buffers();
 	lua_close(lua_shader_state_);
     }
+
+    void LuaGrob::set_record_drawing(bool x) {
+	record_drawing_ = x;
+	glup_recording_.clear();
+	if(x == glup_wrappers_installed_) {
+	    update();
+	    return;
+	}
+	if(x) {
+	    install_glup_recording_wrappers();
+	} else {
+	    remove_glup_recording_wrappers();
+	}
+	// Programs that keep local copies of the GLUP functions get
+	// the new ones (calls update()).
+	execute_shader_program();
+    }
     
     void LuaGrob::update() {
+	++version_;
         Grob::update();
     }
     
@@ -120,6 +507,7 @@ namespace OGF {
 	result->autorun_ = autorun_;
 	result->source_ = source_;
 	result->shader_source_ = shader_source_;
+	result->set_record_drawing(record_drawing_);
         result->update();
         return result;
     }
@@ -186,10 +574,19 @@ namespace OGF {
 		ArgList args;
 		in.read_arg_list(args);
 		autorun_ = args.get_arg<bool>("autorun");
+		if(args.has_arg("record_drawing")) {
+		    record_drawing_ = args.get_arg<bool>("record_drawing");
+		}
 		source_ = args.get_arg("program_source");
 		shader_source_ = args.get_arg("shader_source");
 	    }
         }
+	glup_recording_.clear();
+	if(record_drawing_) {
+	    install_glup_recording_wrappers();
+	} else {
+	    remove_glup_recording_wrappers();
+	}
 	execute_shader_program();
 	if(autorun_) {
 	    execute_program();
@@ -215,6 +612,7 @@ namespace OGF {
 	args.clear();
 	
 	args.create_arg("autorun",autorun_);
+	args.create_arg("record_drawing",record_drawing_);
 	args.create_arg("program_source",source_);
 	args.create_arg("shader_source",shader_source_);
         out.write_chunk_header("LUAG", out.arg_list_size(args));
@@ -238,11 +636,255 @@ namespace OGF {
 	    lua_error_occured_ = true;
 	} else {
 	    lua_error_occured_ = false;
+	    bind_shader_draw();
 	}
 	update();
 	return !lua_error_occured_;
     }
 
+    void LuaGrob::bind_shader_draw() {
+	luaL_unref(lua_shader_state_, LUA_REGISTRYINDEX, draw_function_ref_);
+	draw_function_ref_ = LUA_NOREF;
+	lua_getglobal(lua_shader_state_, "draw");
+	if(lua_isfunction(lua_shader_state_, -1)) {
+	    draw_function_ref_ = luaL_ref(lua_shader_state_, LUA_REGISTRYINDEX);
+	} else {
+	    lua_pop(lua_shader_state_, 1);
+	}
+    }
+
+    bool LuaGrob::call_shader_draw() {
+	if(draw_function_ref_ == LUA_NOREF) {
+	    return true;
+	}
+	if(record_drawing_) {
+	    Numeric::uint64 key = shader_globals_hash();
+	    hash_combine(key, Numeric::uint64(version_));
+	    if(glup_recording_.can_replay(key)) {
+		return replay_shader_draw();
+	    }
+	    // If recording was aborted for this key, draw()
+	    // is called without recording.
+	    if(!glup_recording_.has_key(key)) {
+		glup_recording_.begin(key);
+	    }
+	}
+	lua_rawgeti(
+	    lua_shader_state_, LUA_REGISTRYINDEX, lua_Integer(draw_function_ref_)
+	);
+	bool result = (lua_pcall(lua_shader_state_, 0, 0, 0) == LUA_OK);
+	if(glup_recording_.is_recording()) {
+	    glup_recording_.end();
+	    if(!result) {
+		glup_recording_.abort();
+	    }
+	}
+	if(!result) {
+	    adjust_lua_glup_state(lua_shader_state_);
+	    const char* msg = lua_tostring(lua_shader_state_,-1);
+	    LuaInterpreter::display_error_message(msg);
+	    lua_pop(lua_shader_state_, 1);
+	    lua_error_occured_ = true;
+	}
+	return result;
+    }
+
+    bool LuaGrob::replay_shader_draw() {
+	lua_pushcfunction(lua_shader_state_, replay_GLUP_recording);
+	lua_pushlightuserdata(lua_shader_state_, this);
+	lua_getfield(
+	    lua_shader_state_, LUA_REGISTRYINDEX, "GLUP_recorded_functions"
+	);
+	if(lua_pcall(lua_shader_state_, 2, 0, 0) != LUA_OK) {
+	    adjust_lua_glup_state(lua_shader_state_);
+	    const char* msg = lua_tostring(lua_shader_state_,-1);
+	    LuaInterpreter::display_error_message(msg);
+	    lua_pop(lua_shader_state_, 1);
+	    glup_recording_.abort();
+	    lua_error_occured_ = true;
+	    return false;
+	}
+	return true;
+    }
+
+    void LuaGrob::install_glup_recording_wrappers() {
+	if(glup_wrappers_installed_) {
+	    return;
+	}
+	lua_State* L = lua_shader_state_;
+	lua_newtable(L);
+	int functions = lua_gettop(L);
+	lua_getglobal(L, "GLUP");
+	if(!lua_istable(L,-1)) {
+	    lua_pop(L,2);
+	    return;
+	}
+	int glup = lua_gettop(L);
+	lua_Integer nb_functions = 0;
+	glup_function_names_.assign(1, std::string());
+	lua_pushnil(L);
+	while(lua_next(L, glup) != 0) {
+	    // Replacing the values of existing fields is allowed
+	    // during the traversal. GLUP.Update() is not a GLUP
+	    // function (see wrapper_Update()).
+	    if(
+		lua_type(L,-2) == LUA_TSTRING && lua_iscfunction(L,-1) &&
+		std::string(lua_tostring(L,-2)) != "Update"
+	    ) {
+		std::string name(lua_tostring(L,-2));
+		++nb_functions;
+		glup_function_names_.push_back(name);
+		lua_pushvalue(L,-1);
+		lua_rawseti(L, functions, nb_functions);
+		lua_pushinteger(L, nb_functions);
+		lua_pushlightuserdata(L, this);
+		lua_pushinteger(L, lua_Integer(glup_wrapper_kind(name)));
+		lua_pushcclosure(L, wrapper_recorded_GLUP_function, 4);
+		lua_pushvalue(L,-2);
+		lua_insert(L,-2);
+		lua_rawset(L, glup);
+	    } else {
+		lua_pop(L,1);
+	    }
+	}
+	lua_pop(L,1);
+	lua_setfield(L, LUA_REGISTRYINDEX, "GLUP_recorded_functions");
+	glup_wrappers_installed_ = true;
+    }
+
+    void LuaGrob::remove_glup_recording_wrappers() {
+	if(!glup_wrappers_installed_) {
+	    return;
+	}
+	lua_State* L = lua_shader_state_;
+	lua_getglobal(L, "GLUP");
+	lua_getfield(L, LUA_REGISTRYINDEX, "GLUP_recorded_functions");
+	for(index_t i=1; i<glup_function_names_.size(); ++i) {
+	    lua_pushstring(L, glup_function_names_[i].c_str());
+	    lua_rawgeti(L, -2, lua_Integer(i));
+	    lua_rawset(L, -4);
+	}
+	lua_pop(L,2);
+	lua_pushnil(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, "GLUP_recorded_functions");
+	glup_wrappers_installed_ = false;
+    }
+
+    Numeric::uint64 LuaGrob::shader_globals_hash() {
+	lua_State* L = lua_shader_state_;
+	Numeric::uint64 result = 0;
+	lua_getfield(L, LUA_REGISTRYINDEX, "graphite_builtin_globals");
+	int builtins = lua_gettop(L);
+	lua_pushglobaltable(L);
+	lua_pushnil(L);
+	while(lua_next(L, -2) != 0) {
+	    hash_lua_value(L, -2, builtins, 0, result);
+	    hash_lua_value(L, -1, builtins, 1, result);
+	    lua_pop(L,1);
+	}
+	lua_pop(L,2);
+	return result;
+    }
+
+    std::string LuaGrob::record_shader_draw() {
+	if(!record_drawing_) {
+	    Logger::err("LuaGrob")
+		<< "record_shader_draw(): record_drawing is not set"
+		<< std::endl;
+	    return "";
+	}
+	Numeric::uint64 key = shader_globals_hash();
+	hash_combine(key, Numeric::uint64(version_));
+	glup_recording_.begin(key);
+	if(draw_function_ref_ != LUA_NOREF) {
+	    glup_dry_run_ = true;
+	    lua_rawgeti(
+		lua_shader_state_, LUA_REGISTRYINDEX,
+		lua_Integer(draw_function_ref_)
+	    );
+	    bool OK = (lua_pcall(lua_shader_state_, 0, 0, 0) == LUA_OK);
+	    glup_dry_run_ = false;
+	    if(!OK) {
+		const char* msg = lua_tostring(lua_shader_state_,-1);
+		LuaInterpreter::display_error_message(msg);
+		lua_pop(lua_shader_state_, 1);
+		glup_recording_.abort();
+	    }
+	}
+	glup_recording_.end();
+	return glup_recording_.to_string(glup_function_names_);
+    }
+
+    void LuaGrob::draw_recorded_batch(index_t b) {
+	const LuaGLUPRecording::Batch& batch = glup_recording_.batch(b);
+	if(batch.nb_vertices == 0) {
+	    return;
+	}
+	if(
+	    recording_vertex_array_ == 0 ||
+	    recording_buffers_generation_ != glup_recording_.generation()
+	) {
+	    if(recording_vertex_array_ == 0) {
+		GLuint vertex_array = 0;
+		glupGenVertexArrays(1, &vertex_array);
+		recording_vertex_array_ = vertex_array;
+	    }
+	    glupBindVertexArray(recording_vertex_array_);
+	    for(index_t k=0; k<1+LuaGLUPRecording::NB_ATTRIBS; ++k) {
+		const std::vector<float>& data = (k == 0) ?
+		    glup_recording_.vertices() :
+		    glup_recording_.attribute(
+			LuaGLUPRecording::Attribute(k-1)
+		    );
+		GLint dim = (k == 0) ? 4 : GLint(
+		    LuaGLUPRecording::ATTRIB_DIMENSION[k-1]
+		);
+		GLuint buffer = recording_buffers_[k];
+		update_buffer_object(
+		    buffer, GL_ARRAY_BUFFER, data.size() * sizeof(float),
+		    data.data()
+		);
+		recording_buffers_[k] = buffer;
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glVertexAttribPointer(
+		    GLUP_ATTRIB_LOCATION[k], dim, GL_FLOAT, GL_FALSE, 0, nullptr
+		);
+	    }
+	    glEnableVertexAttribArray(GLUP_ATTRIB_LOCATION[0]);
+	    glBindBuffer(GL_ARRAY_BUFFER, 0);
+	    recording_buffers_generation_ = glup_recording_.generation();
+	} else {
+	    glupBindVertexArray(recording_vertex_array_);
+	}
+	for(index_t a=0; a<LuaGLUPRecording::NB_ATTRIBS; ++a) {
+	    if(batch.has_attrib[a]) {
+		glEnableVertexAttribArray(GLUP_ATTRIB_LOCATION[a+1]);
+	    } else {
+		glDisableVertexAttribArray(GLUP_ATTRIB_LOCATION[a+1]);
+	    }
+	}
+	glupDrawArrays(
+	    GLUPprimitive(batch.primitive),
+	    GLUPint(batch.first_vertex), GLUPsizei(batch.nb_vertices)
+	);
+	glupBindVertexArray(0);
+    }
+
+    void LuaGrob::delete_recording_buffers() {
+	if(recording_vertex_array_ != 0) {
+	    GLuint vertex_array = recording_vertex_array_;
+	    glupDeleteVertexArrays(1, &vertex_array);
+	    recording_vertex_array_ = 0;
+	}
+	for(index_t k=0; k<1+LuaGLUPRecording::NB_ATTRIBS; ++k) {
+	    if(recording_buffers_[k] != 0) {
+		GLuint buffer = recording_buffers_[k];
+		glDeleteBuffers(1, &buffer);
+		recording_buffers_[k] = 0;
+	    }
+	}
+    }
+
     void LuaGrob::execute_shader_program() {
 	execute_shader_command(shader_source_);
     }
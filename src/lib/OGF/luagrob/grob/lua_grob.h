@@ -41,6 +41,7 @@
 #define H_OGF_GRAPHITE_LUAGROB_LUA_GROB_H
 
 #include <OGF/luagrob/common/common.h>
+#include <OGF/luagrob/grob/lua_glup_recording.h>
 #include <OGF/scene_graph/grob/grob.h>
 
 #ifdef GOMGEN
@@ -82,6 +83,58 @@ namespace OGF {
 	bool shader_OK() const {
 	    return !lua_error_occured_;
 	}
+
+	/**
+	 * \brief Calls the draw() function of the LUA shader program.
+	 * \details The function is called through a reference obtained
+	 *  when the shader program was executed, thus nothing is compiled
+	 *  at each frame. Unlike execute_shader_command(), it does not
+	 *  call update(), so that the object is only redrawn on demand
+	 *  (the shader program can call GLUP.Update() to animate).
+	 * \retval true if draw() was successfully called
+	 * \retval false if an error occured
+	 */
+	bool call_shader_draw();
+
+	/**
+	 * \brief Gets the recording of the GLUP calls of draw().
+	 * \return a reference to the recording.
+	 * \see get_record_drawing()
+	 */
+	LuaGLUPRecording& glup_recording() {
+	    return glup_recording_;
+	}
+
+	/**
+	 * \brief Gets the version of this LuaGrob.
+	 * \details The version is incremented each time update() is called.
+	 *  It is part of the key of the recording of the GLUP calls of
+	 *  draw().
+	 * \return the version.
+	 */
+	index_t version() const {
+	    return version_;
+	}
+
+	/**
+	 * \brief Tests whether the recorded GLUP functions are only
+	 *  recorded, and not called.
+	 * \retval true if GLUP functions are not called (see
+	 *  record_shader_draw())
+	 * \retval false otherwise
+	 */
+	bool glup_dry_run() const {
+	    return glup_dry_run_;
+	}
+
+	/**
+	 * \brief Draws a batch of the recording of the GLUP calls of
+	 *  draw().
+	 * \details The vertex buffers are uploaded to the GPU the first
+	 *  time a batch of a new recording is drawn.
+	 * \param[in] b the index of the batch.
+	 */
+	void draw_recorded_batch(index_t b);
 	
     gom_properties:
 
@@ -105,6 +158,31 @@ namespace OGF {
 	void set_autorun(bool x) {
 	    autorun_ = x;
 	}
+
+	/**
+	 * \brief Tests whether the GLUP calls of draw() are recorded.
+	 * \details If set, the GLUP functions called by draw() are
+	 *  recorded the first time it is called, then replayed without
+	 *  executing the LUA program until this LuaGrob is updated or
+	 *  the globals of the shader program change. The vertices sent
+	 *  between GLUP.Begin() and GLUP.End() are stored in vertex
+	 *  buffers, drawn with a single call per batch. Drawings that call
+	 *  GLUP.Update() or that pass tables to GLUP functions are not
+	 *  recorded.
+	 * \retval true if the GLUP calls of draw() are recorded.
+	 * \retval false otherwise.
+	 */
+	bool get_record_drawing() const {
+	    return record_drawing_;
+	}
+
+	/**
+	 * \brief Sets whether the GLUP calls of draw() are recorded.
+	 * \param[in] x true if the GLUP calls of draw() should be recorded,
+	 *  false otherwise.
+	 * \see get_record_drawing()
+	 */
+	void set_record_drawing(bool x);
 	
 	/**
 	 * \brief Sets the source of the LUA program.
@@ -185,6 +263,19 @@ namespace OGF {
 	 * \param[in] value the filename.
 	 */
 	void save_shader_source(const std::string& value);
+
+	/**
+	 * \brief Calls draw() and records its GLUP calls, without
+	 *  calling the GLUP functions.
+	 * \details Does not need an OpenGL context, so that recordings
+	 *  can be compared in batch mode (see
+	 *  tools/lua_grob_recording_test.lua). The recording is kept, and
+	 *  replayed by the next draw if nothing changed.
+	 * \return a description of the recording, one line per call and
+	 *  per vertex, or "invalid" if draw() cannot be recorded.
+	 * \pre get_record_drawing()
+	 */
+	std::string record_shader_draw();
 	
     public:
 	
@@ -250,11 +341,78 @@ namespace OGF {
          */
         static LuaGrob* find(SceneGraph* sg, const std::string& name);
 
+    protected:
+	/**
+	 * \brief Gets a reference to the draw() function of the LUA
+	 *  shader program.
+	 * \details Called each time a command was successfully executed
+	 *  in the shader interpreter, since it may have redefined draw().
+	 */
+	void bind_shader_draw();
+
+	/**
+	 * \brief Replaces the functions of the GLUP table of the shader
+	 *  interpreter with wrappers that can record the calls.
+	 * \details The original functions are stored in the LUA registry.
+	 *  Wrappers are only installed when drawings are recorded, so that
+	 *  GLUP calls do not pay for them otherwise. The shader program
+	 *  needs to be executed again after (un)installing them, so that
+	 *  programs that keep local copies of the GLUP functions use the
+	 *  right ones.
+	 */
+	void install_glup_recording_wrappers();
+
+	/**
+	 * \brief Restores the original functions of the GLUP table.
+	 * \see install_glup_recording_wrappers()
+	 */
+	void remove_glup_recording_wrappers();
+
+	/**
+	 * \brief Computes a hash of the globals of the shader interpreter.
+	 * \details Covers the numbers, booleans, strings and functions
+	 *  stored in the globals, and in the tables they reference (except
+	 *  the standard libraries). Deeper tables are only identified by
+	 *  their address. Combined with the version, it is the key of the
+	 *  recording, so that changing a parameter read by draw() records
+	 *  it again.
+	 * \return the hash
+	 */
+	Numeric::uint64 shader_globals_hash();
+
+	/**
+	 * \brief Deletes the vertex buffers of the recording.
+	 * \details Only calls OpenGL if buffers were created.
+	 */
+	void delete_recording_buffers();
+
+	/**
+	 * \brief Replays the recorded GLUP calls of draw().
+	 * \retval true if the calls were replayed
+	 * \retval false if an error occured
+	 */
+	bool replay_shader_draw();
+
     private:
 	lua_State* lua_shader_state_;
+	int draw_function_ref_;
 	bool lua_error_occured_;
 	Box3d box_;
 	bool autorun_;
+	bool record_drawing_;
+	index_t version_;
+	LuaGLUPRecording glup_recording_;
+	bool glup_wrappers_installed_;
+	bool glup_dry_run_;
+	std::vector<std::string> glup_function_names_;
+
+	/**
+	 * \brief The OpenGL vertex array and buffers of the recording
+	 *  (vertices, then one per attribute), 0 if not created.
+	 */
+	unsigned int recording_vertex_array_;
+	unsigned int recording_buffers_[1 + LuaGLUPRecording::NB_ATTRIBS];
+	index_t recording_buffers_generation_;
 	std::string source_;
 	std::string shader_source_;
     };
@@ -103,8 +103,10 @@ namespace OGF {
             draw_wireframe_box();
         }
 
+	// Note: does not use execute_shader_command(), that would recompile
+	// the command and trigger a new redraw through update().
 	if(lua_grob()->shader_OK()) {
-	    lua_grob()->execute_shader_command("draw()");
+	    lua_grob()->call_shader_draw();
 	}
 	
         if(!clipping_ && clipping_backup) {
@@ -75,6 +75,7 @@ namespace OGF {
          *  be attached to.
          * \param[in] type attribute type
          * \param[in] dimension number of components (1 for scalar)
+         * \modifies attributes
          */
 	gom_arg_attribute(where, handler, "combo_box")
 	gom_arg_attribute(where, values, "vertices;edges;facets;cells")
@@ -91,6 +92,7 @@ namespace OGF {
          * \brief Deletes an attribute.
          * \param[in] name the name of the attribute,
          *   for instance "vertices.distance
+         * \modifies attributes
          */
 	gom_arg_attribute(name, handler, "combo_box")
 	gom_arg_attribute(name, values, "$grob.attributes")
@@ -101,6 +103,7 @@ namespace OGF {
          * \brief Stores the vertices ids in an attribute.
          * \param[in] attribute the name of the vertex attribute
          * \menu Vertices
+         * \modifies attributes
          */
         void compute_vertices_id(const std::string& attribute="id");
 
@@ -108,6 +111,7 @@ namespace OGF {
          * \brief Stores the edges ids in an attribute.
          * \param[in] attribute the name of the edge attribute
          * \menu Edges
+         * \modifies attributes
          */
         void compute_edges_id(const std::string& attribute="id");
 
@@ -115,6 +119,7 @@ namespace OGF {
          * \brief Stores the facets ids in an attribute.
          * \param[in] attribute the name of the facet attribute
          * \menu Facets
+         * \modifies attributes
          */
         void compute_facets_id(const std::string& attribute="id");
 
@@ -122,6 +127,7 @@ namespace OGF {
          * \brief Stores the chart (connected component) id in an attribute.
          * \param[in] attribute the name of the facet attribute
          * \menu Facets
+         * \modifies attributes
          */
         void compute_chart_id(const std::string& attribute="chart");
 
@@ -129,6 +135,7 @@ namespace OGF {
          * \brief Stores the cells ids in an attribute.
          * \param[in] attribute the name of the cell attribute
          * \menu Cells
+         * \modifies attributes
          */
         void compute_cells_id(const std::string& attribute="id");
 
@@ -188,6 +195,7 @@ namespace OGF {
          * \brief Computes per-vertex surface normals..
          * \param[in] attribute the name of the vertex attribute
          * \menu Vertices
+         * \modifies attributes
          */
         void compute_vertices_normals(
             const std::string& attribute = "normal"
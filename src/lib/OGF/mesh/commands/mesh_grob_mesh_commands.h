@@ -68,11 +68,13 @@ namespace OGF {
 
         /**
          * \brief displays some statistics about the current mesh.
+         * \readonly
          */
         void display_statistics();
 
         /**
          * \brief computes and displays some topological invariants.
+         * \readonly
          */
         void display_topology();
 
@@ -123,6 +125,7 @@ namespace OGF {
          * \param[in] Cy y coordinate of the center.
          * \param[in] Cz z coordinate of the center.
          * \param[in] radius radius of the bounding sphere.
+         * \modifies vertices
          */
         void normalize_mesh(
             double Cx = 0.0,
@@ -137,6 +140,7 @@ namespace OGF {
 	 *  box.
 	 * \param[in] uniform if true, coordinates are scaled uniformly,
 	 *  else they are scaled to fit the box exactly.
+	 * \modifies vertices
 	 */
 	void normalize_mesh_box(
 	    double xmin = 0.0,
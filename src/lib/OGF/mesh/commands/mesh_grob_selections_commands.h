@@ -102,12 +102,14 @@ namespace OGF {
         /**
          * \brief Selects all the vertices on the border of a surface.
          * \menu Vertices
+         * \modifies attributes(selection)
          */
         void select_vertices_on_surface_border();
 
         /**
          * \brief Unselects all the vertices on the border of a surface.
          * \menu Vertices
+         * \modifies attributes(selection)
          */
         void unselect_vertices_on_surface_border();
 
@@ -117,6 +119,7 @@ namespace OGF {
 	 * \param[in] tolerance maximum distance for considering
 	 *  that two vertices are duplicated.
          * \menu Vertices
+         * \modifies attributes(selection)
 	 */
 	void select_duplicated_vertices(double tolerance=0.0);
 
@@ -124,6 +127,7 @@ namespace OGF {
          * \brief Selects all the vertices on triangles with
          *  their three vertices that are colinear.
          * \menu Vertices
+         * \modifies attributes(selection)
          */
         void select_vertices_on_degenerate_facets();
 
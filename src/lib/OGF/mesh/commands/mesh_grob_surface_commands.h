@@ -175,6 +175,7 @@ namespace OGF {
          * \param[in] LFS_samples number of samples.
          *  used to compute gradation.
          */
+        gom_attribute(long_running,"true")
         MeshGrob* remesh_smooth(
             const NewMeshGrobName& remesh = "remesh",
             unsigned int nb_points = 30000,
@@ -416,6 +417,7 @@ namespace OGF {
 	/**
 	 * \brief Smooths the mesh by optimizing the vertices that
 	 *   are not selected. Selected vertices are locked.
+	 * \modifies vertices
 	 */
 	void smooth();
 
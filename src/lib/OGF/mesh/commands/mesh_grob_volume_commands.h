@@ -83,6 +83,7 @@ namespace OGF {
          * \param[in] quality 1.0 for high quality, 5.0 for low quality.
          * \param[in] verbose enables tetgen statistics and messages.
          */
+        gom_attribute(long_running,"true")
         void tet_meshing(
             bool preprocess=false,
 	    bool merge_coplanar_facets=false,
@@ -174,6 +175,7 @@ namespace OGF {
          * \param[in] save_histo if true, save dihedral and facet angle
          *  histograms
          * \param[in] nb_bins number of bins in the computed histograms
+         * \readonly
          */
         void volume_mesh_statistics(
             bool save_histo=false,
@@ -239,6 +241,7 @@ namespace OGF {
 
 	/**
 	 * \brief Displays the volume of a mesh.
+	 * \readonly
 	 */
 	void display_volume();
 
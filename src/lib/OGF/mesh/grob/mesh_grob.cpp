@@ -47,6 +47,783 @@
 #include <geogram/mesh/mesh_geometry.h>
 #include <geogram/basic/file_system.h>
 
+#include <unordered_map>
+#include <set>
+#include <cstring>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The mesh elements copied by MeshGrob::duplicate() and
+     *  MeshGrob::create_state().
+     */
+    const MeshElementsFlags mesh_grob_elements = MeshElementsFlags(
+        MESH_VERTICES | MESH_EDGES | MESH_FACETS | MESH_CELLS
+    );
+
+    /**
+     * \brief Tests whether an attribute stores the geometry of
+     *  the vertices.
+     * \param[in] name the name of the attribute
+     * \retval true if this is the "point" attribute (or "point_fp32", used
+     *  by single-precision meshes)
+     * \retval false otherwise
+     */
+    bool is_point_attribute(const std::string& name) {
+        return (name == "point" || name == "point_fp32");
+    }
+
+    /**
+     * \brief The subsets of mesh elements that can have attributes.
+     */
+    const MeshElementsFlags mesh_grob_subsets[] = {
+        MESH_VERTICES, MESH_EDGES, MESH_FACETS, MESH_FACET_CORNERS,
+        MESH_CELLS, MESH_CELL_CORNERS, MESH_CELL_FACETS
+    };
+
+    /**
+     * \brief Gets the size of the contents of an attribute store.
+     * \param[in] store the attribute store
+     * \return the number of bytes used by the values of \p store
+     */
+    size_t attribute_store_bytes(const AttributeStore* store) {
+        return size_t(store->size()) * store->dimension() *
+            store->element_size();
+    }
+
+    /**
+     * \brief Adds an attribute store to a hash.
+     * \param[in,out] h the hash
+     * \param[in] name the name of the attribute
+     * \param[in] store the attribute store
+     * \param[in] contents if set, the contents of the attribute is hashed,
+     *  else only its name, type and size are hashed
+     */
+    void hash_attribute_store(
+        Numeric::uint64& h, const std::string& name,
+        const AttributeStore* store, bool contents
+    ) {
+        GrobState::hash_string(h, name);
+        GrobState::hash_string(h, store->element_typeid_name());
+        GrobState::hash_value(h, store->dimension());
+        GrobState::hash_value(h, store->size());
+        if(contents) {
+            GrobState::hash_bytes(
+                h, store->data(), attribute_store_bytes(store)
+            );
+        }
+    }
+
+    /**
+     * \brief Tests whether two attribute stores have the same contents.
+     * \param[in] store1 , store2 the two attribute stores, or nullptr
+     * \retval true if both have the same type, dimension, size and values,
+     *  or if both are nullptr
+     * \retval false otherwise
+     */
+    bool same_attribute_stores(
+        const AttributeStore* store1, const AttributeStore* store2
+    ) {
+        if(store1 == nullptr || store2 == nullptr) {
+            return (store1 == store2);
+        }
+        return
+            store1->element_typeid_name() == store2->element_typeid_name() &&
+            store1->dimension() == store2->dimension() &&
+            store1->size() == store2->size() &&
+            ::memcmp(
+                store1->data(), store2->data(), attribute_store_bytes(store1)
+            ) == 0;
+    }
+
+    /**
+     * \brief Adds the attributes of mesh elements to a hash.
+     * \param[in,out] h the hash
+     * \param[in] elements the mesh elements
+     * \param[in] points if set, only the "point" attribute is hashed,
+     *  else all attributes but "point" are hashed
+     * \param[in] contents if set, the contents of the attributes is hashed,
+     *  else only their names, types and sizes are hashed
+     */
+    void hash_attributes(
+        Numeric::uint64& h, const MeshSubElementsStore& elements,
+        bool points, bool contents
+    ) {
+        vector<std::string> names;
+        elements.attributes().list_attribute_names(names);
+        for(const std::string& name: names) {
+            if(is_point_attribute(name) != points) {
+                continue;
+            }
+            hash_attribute_store(
+                h, name, elements.attributes().find_attribute_store(name),
+                contents
+            );
+        }
+    }
+
+    /**
+     * \brief Computes the memory used by the attributes of mesh elements.
+     * \param[in] elements the mesh elements
+     * \return the number of bytes used by the attributes
+     */
+    size_t attributes_memory_size(const MeshSubElementsStore& elements) {
+        size_t result = 0;
+        vector<std::string> names;
+        elements.attributes().list_attribute_names(names);
+        for(const std::string& name: names) {
+            result += attribute_store_bytes(
+                elements.attributes().find_attribute_store(name)
+            );
+        }
+        return result;
+    }
+
+    /**
+     * \brief Adds the vertices of a mesh (number, dimension and
+     *  coordinates) to a hash.
+     * \param[in,out] h the hash
+     * \param[in] M the mesh
+     * \param[in] contents if set, the coordinates are hashed, else only
+     *  the number of vertices and their dimension are hashed
+     */
+    void hash_vertices(Numeric::uint64& h, const Mesh& M, bool contents) {
+        GrobState::hash_value(h, M.vertices.nb());
+        GrobState::hash_value(h, M.vertices.dimension());
+        hash_attributes(h, M.vertices, true, contents);
+    }
+
+    /**
+     * \brief Adds the edges of a mesh to a hash.
+     * \param[in,out] h the hash
+     * \param[in] M the mesh
+     * \param[in] contents if set, the vertices of the edges are hashed,
+     *  else only the number of edges is hashed
+     */
+    void hash_edges(Numeric::uint64& h, const Mesh& M, bool contents) {
+        GrobState::hash_value(h, M.edges.nb());
+        if(contents) {
+            for(index_t e: M.edges) {
+                GrobState::hash_value(h, M.edges.vertex(e,0));
+                GrobState::hash_value(h, M.edges.vertex(e,1));
+            }
+        }
+    }
+
+    /**
+     * \brief Adds the facets of a mesh to a hash.
+     * \param[in,out] h the hash
+     * \param[in] M the mesh
+     * \param[in] contents if set, the vertices and adjacencies of the
+     *  facets are hashed, else only the number of facets and corners
+     *  are hashed
+     */
+    void hash_facets(Numeric::uint64& h, const Mesh& M, bool contents) {
+        GrobState::hash_value(h, M.facets.nb());
+        GrobState::hash_value(h, M.facet_corners.nb());
+        if(contents) {
+            for(index_t f: M.facets) {
+                GrobState::hash_value(h, M.facets.corners_end(f));
+            }
+            for(index_t c: M.facet_corners) {
+                GrobState::hash_value(h, M.facet_corners.vertex(c));
+                GrobState::hash_value(h, M.facet_corners.adjacent_facet(c));
+            }
+        }
+    }
+
+    /**
+     * \brief Adds the cells of a mesh to a hash.
+     * \param[in,out] h the hash
+     * \param[in] M the mesh
+     * \param[in] contents if set, the types, vertices and adjacencies of
+     *  the cells are hashed, else only the number of cells and corners
+     *  are hashed
+     */
+    void hash_cells(Numeric::uint64& h, const Mesh& M, bool contents) {
+        GrobState::hash_value(h, M.cells.nb());
+        GrobState::hash_value(h, M.cell_corners.nb());
+        if(contents) {
+            for(index_t c: M.cells) {
+                GrobState::hash_value(h, index_t(M.cells.type(c)));
+                GrobState::hash_value(h, M.cells.corners_end(c));
+                for(index_t lf=0; lf<M.cells.nb_facets(c); ++lf) {
+                    GrobState::hash_value(h, M.cells.adjacent(c,lf));
+                }
+            }
+            for(index_t cc: M.cell_corners) {
+                GrobState::hash_value(h, M.cell_corners.vertex(cc));
+            }
+        }
+    }
+
+    /**
+     * \brief Tests whether two meshes have the same vertices.
+     * \details Compares the same things as hash_vertices().
+     * \param[in] M1 , M2 the two meshes
+     * \retval true if \p M1 and \p M2 have the same vertices
+     * \retval false otherwise
+     */
+    bool same_vertices(const Mesh& M1, const Mesh& M2) {
+        if(
+            M1.vertices.nb() != M2.vertices.nb() ||
+            M1.vertices.dimension() != M2.vertices.dimension() ||
+            M1.vertices.single_precision() != M2.vertices.single_precision()
+        ) {
+            return false;
+        }
+        const char* name =
+            M1.vertices.single_precision() ? "point_fp32" : "point";
+        return same_attribute_stores(
+            M1.vertices.attributes().find_attribute_store(name),
+            M2.vertices.attributes().find_attribute_store(name)
+        );
+    }
+
+    /**
+     * \brief Tests whether two meshes have the same edges.
+     * \details Compares the same things as hash_edges().
+     * \param[in] M1 , M2 the two meshes
+     * \retval true if \p M1 and \p M2 have the same edges
+     * \retval false otherwise
+     */
+    bool same_edges(const Mesh& M1, const Mesh& M2) {
+        if(M1.edges.nb() != M2.edges.nb()) {
+            return false;
+        }
+        for(index_t e: M1.edges) {
+            if(
+                M1.edges.vertex(e,0) != M2.edges.vertex(e,0) ||
+                M1.edges.vertex(e,1) != M2.edges.vertex(e,1)
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Tests whether two meshes have the same facets.
+     * \details Compares the same things as hash_facets().
+     * \param[in] M1 , M2 the two meshes
+     * \retval true if \p M1 and \p M2 have the same facets
+     * \retval false otherwise
+     */
+    bool same_facets(const Mesh& M1, const Mesh& M2) {
+        if(
+            M1.facets.nb() != M2.facets.nb() ||
+            M1.facet_corners.nb() != M2.facet_corners.nb() ||
+            M1.facets.are_simplices() != M2.facets.are_simplices()
+        ) {
+            return false;
+        }
+        for(index_t f: M1.facets) {
+            if(M1.facets.corners_end(f) != M2.facets.corners_end(f)) {
+                return false;
+            }
+        }
+        for(index_t c: M1.facet_corners) {
+            if(
+                M1.facet_corners.vertex(c) != M2.facet_corners.vertex(c) ||
+                M1.facet_corners.adjacent_facet(c) !=
+                M2.facet_corners.adjacent_facet(c)
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Tests whether two meshes have the same cells.
+     * \details Compares the same things as hash_cells().
+     * \param[in] M1 , M2 the two meshes
+     * \retval true if \p M1 and \p M2 have the same cells
+     * \retval false otherwise
+     */
+    bool same_cells(const Mesh& M1, const Mesh& M2) {
+        if(
+            M1.cells.nb() != M2.cells.nb() ||
+            M1.cell_corners.nb() != M2.cell_corners.nb() ||
+            M1.cells.are_simplices() != M2.cells.are_simplices()
+        ) {
+            return false;
+        }
+        for(index_t c: M1.cells) {
+            if(
+                M1.cells.type(c) != M2.cells.type(c) ||
+                M1.cells.corners_end(c) != M2.cells.corners_end(c)
+            ) {
+                return false;
+            }
+            for(index_t lf=0; lf<M1.cells.nb_facets(c); ++lf) {
+                if(M1.cells.adjacent(c,lf) != M2.cells.adjacent(c,lf)) {
+                    return false;
+                }
+            }
+        }
+        for(index_t cc: M1.cell_corners) {
+            if(M1.cell_corners.vertex(cc) != M2.cell_corners.vertex(cc)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief A part of a snapshot of a MeshGrob: its vertices, edges,
+     *  facets or cells, or one of its attributes.
+     * \details MeshParts are never modified once created, so that they
+     *  can be shared by all the MeshGrobStates that have the same contents
+     *  for this part. The existing MeshParts are indexed by the hash of
+     *  their contents, find() uses it to find the candidates, then
+     *  compares their contents (the hash alone could collide).
+     */
+    class MeshPart : public Counted {
+    public:
+        /**
+         * \brief MeshPart constructor.
+         * \param[in] key identifies the part of the mesh ("vertices",
+         *  "edges", "facets", "cells" or the subset and name of an
+         *  attribute)
+         * \param[in] hash the hash of the contents of the part
+         */
+        MeshPart(const std::string& key, Numeric::uint64 hash) :
+            key_(key),
+            hash_(hash) {
+            pool().insert(std::make_pair(hash_, this));
+        }
+
+        /**
+         * \brief MeshPart destructor.
+         * \details Removes this MeshPart from the pool.
+         */
+        ~MeshPart() override {
+            auto range = pool().equal_range(hash_);
+            for(auto it = range.first; it != range.second; ++it) {
+                if(it->second == this) {
+                    pool().erase(it);
+                    break;
+                }
+            }
+        }
+
+        /**
+         * \brief Gets the memory used by this MeshPart.
+         * \return the (approximate) number of bytes
+         */
+        virtual size_t memory_size() const = 0;
+
+        /**
+         * \brief Tests whether this MeshPart has the same contents
+         *  as the corresponding part of a mesh.
+         * \param[in] M the mesh
+         */
+        virtual bool same_contents(const Mesh& M) const = 0;
+
+        /**
+         * \brief Copies this MeshPart to a mesh.
+         * \param[in,out] M the mesh
+         */
+        virtual void restore(Mesh& M) const = 0;
+
+        /**
+         * \brief Finds an existing MeshPart.
+         * \param[in] key the part of the mesh
+         * \param[in] hash the hash of the contents of the part of \p M
+         * \param[in] M the mesh
+         * \return a MeshPart with the same contents as the part of \p M
+         *  or nullptr if there is no such MeshPart
+         */
+        static MeshPart* find(
+            const std::string& key, Numeric::uint64 hash, const Mesh& M
+        ) {
+            auto range = pool().equal_range(hash);
+            for(auto it = range.first; it != range.second; ++it) {
+                if(it->second->key_ == key && it->second->same_contents(M)) {
+                    return it->second;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        static std::unordered_multimap<Numeric::uint64, MeshPart*>& pool() {
+            static std::unordered_multimap<Numeric::uint64, MeshPart*> result;
+            return result;
+        }
+
+        std::string key_;
+        Numeric::uint64 hash_;
+    };
+
+    /**
+     * \brief An automatic reference-counted pointer to a MeshPart.
+     */
+    typedef SmartPointer<MeshPart> MeshPart_var;
+
+    /**
+     * \brief A MeshPart with the vertices (and their coordinates),
+     *  the edges, the facets or the cells of a mesh, without attributes.
+     */
+    class MeshElementsPart : public MeshPart {
+    public:
+        MeshElementsPart(
+            const std::string& key, Numeric::uint64 hash,
+            const Mesh& M, MeshElementsFlags what
+        ) : MeshPart(key, hash), what_(what) {
+            mesh_.copy(M, false, what);
+        }
+
+        size_t memory_size() const override {
+            switch(what_) {
+            case MESH_VERTICES:
+                return attributes_memory_size(mesh_.vertices);
+            case MESH_EDGES:
+                return sizeof(index_t) * 2 * size_t(mesh_.edges.nb());
+            case MESH_FACETS:
+                return sizeof(index_t) * (
+                    size_t(mesh_.facets.nb()) +
+                    2 * size_t(mesh_.facet_corners.nb())
+                );
+            case MESH_CELLS:
+                return sizeof(index_t) * (
+                    2 * size_t(mesh_.cells.nb()) +
+                    size_t(mesh_.cell_corners.nb()) +
+                    size_t(mesh_.cell_facets.nb())
+                );
+            default:
+                return 0;
+            }
+        }
+
+        bool same_contents(const Mesh& M) const override {
+            switch(what_) {
+            case MESH_VERTICES:
+                return same_vertices(mesh_, M);
+            case MESH_EDGES:
+                return same_edges(mesh_, M);
+            case MESH_FACETS:
+                return same_facets(mesh_, M);
+            case MESH_CELLS:
+                return same_cells(mesh_, M);
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * \copydoc MeshPart::restore()
+         * \details The vertices need to be restored first (it clears
+         *  the mesh), then the elements are created in the same order,
+         *  so that they have the same corner and facet indices.
+         */
+        void restore(Mesh& M) const override {
+            switch(what_) {
+            case MESH_VERTICES: {
+                M.copy(mesh_, false, MESH_VERTICES);
+            } break;
+            case MESH_EDGES: {
+                if(mesh_.edges.nb() == 0) {
+                    break;
+                }
+                M.edges.create_edges(mesh_.edges.nb());
+                for(index_t e: mesh_.edges) {
+                    M.edges.set_vertex(e, 0, mesh_.edges.vertex(e,0));
+                    M.edges.set_vertex(e, 1, mesh_.edges.vertex(e,1));
+                }
+            } break;
+            case MESH_FACETS: {
+                if(mesh_.facets.nb() == 0) {
+                    break;
+                }
+                if(mesh_.facets.are_simplices()) {
+                    M.facets.create_triangles(mesh_.facets.nb());
+                } else {
+                    for(index_t f: mesh_.facets) {
+                        M.facets.create_polygon(mesh_.facets.nb_vertices(f));
+                    }
+                }
+                for(index_t c: mesh_.facet_corners) {
+                    M.facet_corners.set_vertex(
+                        c, mesh_.facet_corners.vertex(c)
+                    );
+                    M.facet_corners.set_adjacent_facet(
+                        c, mesh_.facet_corners.adjacent_facet(c)
+                    );
+                }
+            } break;
+            case MESH_CELLS: {
+                if(mesh_.cells.nb() == 0) {
+                    break;
+                }
+                if(mesh_.cells.are_simplices()) {
+                    M.cells.create_tets(mesh_.cells.nb());
+                } else {
+                    for(index_t c: mesh_.cells) {
+                        M.cells.create_cells(1, mesh_.cells.type(c));
+                    }
+                }
+                for(index_t c: mesh_.cells) {
+                    for(index_t lf=0; lf<mesh_.cells.nb_facets(c); ++lf) {
+                        M.cells.set_adjacent(
+                            c, lf, mesh_.cells.adjacent(c,lf)
+                        );
+                    }
+                }
+                for(index_t cc: mesh_.cell_corners) {
+                    M.cell_corners.set_vertex(
+                        cc, mesh_.cell_corners.vertex(cc)
+                    );
+                }
+            } break;
+            default:
+                break;
+            }
+        }
+
+    private:
+        MeshElementsFlags what_;
+        Mesh mesh_;
+    };
+
+    /**
+     * \brief A MeshPart with one of the attributes of a mesh.
+     */
+    class MeshAttributePart : public MeshPart {
+    public:
+        MeshAttributePart(
+            const std::string& key, Numeric::uint64 hash,
+            MeshElementsFlags subset, const std::string& name,
+            const AttributeStore* store
+        ) :
+            MeshPart(key, hash),
+            subset_(subset),
+            name_(name),
+            store_(store->clone()) {
+        }
+
+        ~MeshAttributePart() override {
+            delete store_;
+        }
+
+        size_t memory_size() const override {
+            return attribute_store_bytes(store_);
+        }
+
+        bool same_contents(const Mesh& M) const override {
+            return same_attribute_stores(
+                store_,
+                M.get_subelements_by_type(subset_).attributes().
+                find_attribute_store(name_)
+            );
+        }
+
+        /**
+         * \copydoc MeshPart::restore()
+         * \details The elements need to be restored first.
+         */
+        void restore(Mesh& M) const override {
+            M.get_subelements_by_type(subset_).attributes().
+                bind_attribute_store(name_, store_->clone());
+        }
+
+    private:
+        MeshElementsFlags subset_;
+        std::string name_;
+        AttributeStore* store_;
+    };
+
+    /**
+     * \brief A snapshot of a MeshGrob, used by undo/redo.
+     * \details The snapshot is made of MeshParts. The parts that did not
+     *  change since another snapshot (or that have the same contents as
+     *  the part of another snapshot) are shared with it. When spilled,
+     *  the whole mesh is saved to a .geogram file (the parts are only
+     *  freed if they are not shared), and split into parts again when
+     *  reloaded.
+     */
+    class MeshGrobState : public GrobState {
+    public:
+        MeshGrobState(const Mesh& mesh) {
+            split(mesh);
+        }
+
+        size_t memory_size() const override {
+            size_t result = 0;
+            for(const MeshPart_var& part: parts_) {
+                result += part->memory_size();
+            }
+            return result;
+        }
+
+        size_t unshared_memory_size(
+            std::set<const void*>& counted
+        ) const override {
+            size_t result = 0;
+            for(const MeshPart_var& part: parts_) {
+                if(counted.insert(part.get()).second) {
+                    result += part->memory_size();
+                }
+            }
+            return result;
+        }
+
+        bool spill(const std::string& file_name) override {
+            std::string geogram_file_name = file_name + ".geogram";
+            Mesh mesh;
+            restore(mesh);
+            MeshIOFlags flags;
+            flags.set_elements(mesh_grob_elements);
+            flags.set_attributes(MESH_ALL_ATTRIBUTES);
+            if(!mesh_save(mesh, geogram_file_name, flags)) {
+                return false;
+            }
+            parts_.clear();
+            set_spill_file_name(geogram_file_name);
+            return true;
+        }
+
+        bool unspill() override {
+            if(!is_spilled()) {
+                return true;
+            }
+            Mesh mesh;
+            MeshIOFlags flags;
+            flags.set_elements(mesh_grob_elements);
+            flags.set_attributes(MESH_ALL_ATTRIBUTES);
+            if(!mesh_load(spill_file_name(), mesh, flags)) {
+                return false;
+            }
+            split(mesh);
+            FileSystem::delete_file(spill_file_name());
+            set_spill_file_name("");
+            return true;
+        }
+
+        /**
+         * \brief Copies this snapshot to a mesh.
+         * \param[out] mesh the mesh
+         */
+        void restore(Mesh& mesh) const {
+            mesh.clear(false, false);
+            for(const MeshPart_var& part: parts_) {
+                part->restore(mesh);
+            }
+        }
+
+    protected:
+        /**
+         * \brief Splits a mesh into MeshParts.
+         * \details Reuses the existing MeshParts that have the same
+         *  contents. The MeshParts with the elements come first, so that
+         *  restore() creates them before the attributes.
+         * \param[in] mesh the mesh
+         */
+        void split(const Mesh& mesh) {
+            parts_.clear();
+
+            Numeric::uint64 h = 1;
+            hash_vertices(h, mesh, true);
+            add_elements_part("vertices", h, mesh, MESH_VERTICES);
+
+            h = 1;
+            hash_edges(h, mesh, true);
+            add_elements_part("edges", h, mesh, MESH_EDGES);
+
+            h = 1;
+            hash_facets(h, mesh, true);
+            add_elements_part("facets", h, mesh, MESH_FACETS);
+
+            h = 1;
+            hash_cells(h, mesh, true);
+            add_elements_part("cells", h, mesh, MESH_CELLS);
+
+            for(MeshElementsFlags subset: mesh_grob_subsets) {
+                const AttributesManager& attributes =
+                    mesh.get_subelements_by_type(subset).attributes();
+                vector<std::string> names;
+                attributes.list_attribute_names(names);
+                for(const std::string& name: names) {
+                    if(is_point_attribute(name)) {
+                        continue;
+                    }
+                    const AttributeStore* store =
+                        attributes.find_attribute_store(name);
+                    std::string key =
+                        String::to_string(index_t(subset)) + "." + name;
+                    h = 1;
+                    GrobState::hash_value(h, index_t(subset));
+                    hash_attribute_store(h, name, store, true);
+                    MeshPart* part = MeshPart::find(key, h, mesh);
+                    if(part == nullptr) {
+                        part = new MeshAttributePart(
+                            key, h, subset, name, store
+                        );
+                    }
+                    parts_.push_back(part);
+                }
+            }
+        }
+
+        /**
+         * \brief Adds the MeshPart with the elements of a given type,
+         *  reusing an existing one if possible.
+         * \param[in] key the part of the mesh
+         * \param[in] hash the hash of the elements
+         * \param[in] mesh the mesh
+         * \param[in] what the type of the elements
+         */
+        void add_elements_part(
+            const std::string& key, Numeric::uint64 hash,
+            const Mesh& mesh, MeshElementsFlags what
+        ) {
+            MeshPart* part = MeshPart::find(key, hash, mesh);
+            if(part == nullptr) {
+                part = new MeshElementsPart(key, hash, mesh, what);
+            }
+            parts_.push_back(part);
+        }
+
+    private:
+        std::vector<MeshPart_var> parts_;
+    };
+
+    /**
+     * \brief Converts a mesh that was just loaded to the representation
+     *  used by MeshGrob.
+     * \details Vertices are converted to double precision, and 2d
+     *  vertices to 3d.
+     * \param[in,out] M the mesh
+     */
+    void normalize_loaded_mesh(Mesh& M) {
+        if(M.vertices.single_precision()) {
+            M.vertices.set_double_precision();
+        }
+        if(M.vertices.dimension() == 2) {
+            M.vertices.set_dimension(3);
+        }
+    }
+
+    /**
+     * \brief Activates points display if a MeshGrob only has
+     *  vertices.
+     * \param[in] mesh_grob a pointer to the MeshGrob
+     */
+    void show_vertices_if_pointset(MeshGrob* mesh_grob) {
+        Object* shader = mesh_grob->get_shader();
+        if(shader != nullptr &&
+           mesh_grob->vertices.nb() != 0 &&
+           mesh_grob->edges.nb() == 0 &&
+           mesh_grob->facets.nb() == 0 &&
+           mesh_grob->cells.nb() == 0
+        ) {
+            shader->set_property("vertices_style", "true;0 1 0 1;2");
+        }
+    }
+}
+
 namespace OGF {
 
     MeshGrob::MeshGrob(
@@ -77,34 +854,73 @@ namespace OGF {
     }
 
     bool MeshGrob::load(const FileName& value) {
+        if(!check_elements_not_pinned("load")) {
+            return false;
+        }
         MeshIOFlags flags;
 	flags.set_attributes(MESH_ALL_ATTRIBUTES);
         bool result = GEO::mesh_load(value, *this, flags);
 	if(result) {
-	    if(vertices.single_precision()) {
-		vertices.set_double_precision();
-	    }
-	    if(vertices.dimension() == 2) {
-		vertices.set_dimension(3);
-	    }
+	    normalize_loaded_mesh(*this);
 	}
         update();
 
         // If the mesh only has points,
         // then activate points display.
-        Object* shader = get_shader();
-        if(shader != nullptr &&
-           vertices.nb() != 0 &&
-           edges.nb() == 0 &&
-           facets.nb() == 0 &&
-           cells.nb() == 0
-        ) {
-            shader->set_property("vertices_style", "true;0 1 0 1;2");
-        }
+        show_vertices_if_pointset(this);
         return result;
     }
 
+    bool MeshGrob::can_load_in_thread() const {
+        return true;
+    }
+
+    bool MeshGrob::load_in_thread(
+        const std::string& file_name, GrobLoadMessages& messages
+    ) {
+        if(elements_are_pinned()) {
+            messages.err(name() + ": elements are referenced by buffer views");
+            return false;
+        }
+        // The mesh is read directly into this MeshGrob (no copy).
+        MeshIOFlags flags;
+	flags.set_attributes(MESH_ALL_ATTRIBUTES);
+        bool loaded = false;
+        {
+            // mesh_load() and the readers use the Logger.
+            std::lock_guard<std::mutex> lock(
+                GrobLoadMessages::logger_mutex()
+            );
+            loaded = GEO::mesh_load(file_name, *this, flags);
+        }
+        if(!loaded) {
+            messages.err("Could not load file: " + file_name);
+            clear(false, false);
+            return false;
+        }
+        normalize_loaded_mesh(*this);
+        if(vertices.nb() == 0) {
+            messages.warn(file_name + ": empty mesh");
+        } else {
+            messages.out(
+                "Loaded " + file_name + ": " +
+                String::to_string(vertices.nb()) + " vertices, " +
+                String::to_string(facets.nb()) + " facets, " +
+                String::to_string(cells.nb()) + " cells"
+            );
+        }
+        return true;
+    }
+
+    void MeshGrob::end_load_in_thread() {
+        update();
+        show_vertices_if_pointset(this);
+    }
+
     bool MeshGrob::append(const FileName& value) {
+        if(!check_elements_not_pinned("append")) {
+            return false;
+        }
         Logger::warn("MeshGrob") << "append() not implemented"
                                  << std::endl;
         bool result = GEO::mesh_load(value, *this);
@@ -120,6 +936,9 @@ namespace OGF {
     }
 
     void MeshGrob::clear() {
+        if(!check_elements_not_pinned("clear")) {
+            return;
+        }
         GEO::Mesh::clear();
         update();
     }
@@ -127,14 +946,57 @@ namespace OGF {
     Grob* MeshGrob::duplicate(SceneGraph* sg) {
         MeshGrob* result = dynamic_cast<MeshGrob*>(Grob::duplicate(sg));
         ogf_assert(result != nullptr);
-        MeshElementsFlags what = MeshElementsFlags(
-            MESH_VERTICES | MESH_EDGES | MESH_FACETS | MESH_CELLS
-        );
-        result->copy(*this, true, what);
+        result->copy(*this, true, mesh_grob_elements);
         result->update();
         return result;
     }
 
+    void MeshGrob::get_part_hashes(
+        std::map<std::string, Numeric::uint64>& hashes, bool contents
+    ) const {
+        Numeric::uint64 h = 1;
+        hash_vertices(h, *this, contents);
+        hashes["vertices"] = h;
+
+        h = 1;
+        hash_edges(h, *this, contents);
+        hashes["edges"] = h;
+
+        h = 1;
+        hash_facets(h, *this, contents);
+        hashes["facets"] = h;
+
+        h = 1;
+        hash_cells(h, *this, contents);
+        hashes["cells"] = h;
+
+        h = 1;
+        hash_attributes(h, vertices, false, contents);
+        hash_attributes(h, edges, false, contents);
+        hash_attributes(h, facets, false, contents);
+        hash_attributes(h, facet_corners, false, contents);
+        hash_attributes(h, cells, false, contents);
+        hash_attributes(h, cell_corners, false, contents);
+        hash_attributes(h, cell_facets, false, contents);
+        hashes["attributes"] = h;
+    }
+
+    GrobState* MeshGrob::create_state() {
+        return new MeshGrobState(*this);
+    }
+
+    bool MeshGrob::restore_state(GrobState* state) {
+        MeshGrobState* mesh_state = dynamic_cast<MeshGrobState*>(state);
+        if(
+            mesh_state == nullptr ||
+            !check_elements_not_pinned("restore_state")
+        ) {
+            return false;
+        }
+        mesh_state->restore(*this);
+        return true;
+    }
+
     Box3d MeshGrob::bbox() const {
         Box3d result;
 
@@ -274,6 +1136,9 @@ namespace OGF {
     }
 
     bool MeshGrob::serialize_read(InputGraphiteFile& geofile) {
+        if(!check_elements_not_pinned("serialize_read")) {
+            return false;
+        }
         bool result = mesh_load(geofile, *this);
         update();
         return result;
@@ -99,6 +99,46 @@ namespace OGF {
          */
         Grob* duplicate(SceneGraph* sg) override;
 
+        /**
+         * \copydoc Grob::get_part_hashes()
+         * \details The parts of a MeshGrob are "vertices" (number of
+         *  vertices and geometry), "edges", "facets", "cells"
+         *  (combinatorics) and "attributes" (all other attributes).
+         */
+        void get_part_hashes(
+            std::map<std::string, Numeric::uint64>& hashes, bool contents
+        ) const override;
+
+        /**
+         * \copydoc Grob::create_state()
+         * \details The GrobState stores the vertices, edges, facets,
+         *  cells and each attribute separately. The ones that have the
+         *  same contents as in another GrobState are shared with it.
+         */
+        GrobState* create_state() override;
+
+        /**
+         * \copydoc Grob::restore_state()
+         */
+        bool restore_state(GrobState* state) override;
+
+        /**
+         * \copydoc Grob::can_load_in_thread()
+         */
+        bool can_load_in_thread() const override;
+
+        /**
+         * \copydoc Grob::load_in_thread()
+         */
+        bool load_in_thread(
+            const std::string& file_name, GrobLoadMessages& messages
+        ) override;
+
+        /**
+         * \copydoc Grob::end_load_in_thread()
+         */
+        void end_load_in_thread() override;
+
         /**
          * \copydoc Grob::is_serializable()
          */
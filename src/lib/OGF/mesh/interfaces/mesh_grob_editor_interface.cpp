@@ -51,8 +51,8 @@ namespace OGF {
     }
 
     void MeshGrobEditor::clear() {
-	if(mesh_grob() == nullptr) {
-	    Logger::err("MeshEditor") << "No MeshGrob" << std::endl;
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return;
 	}
 	mesh_grob()->clear();
     }
@@ -65,7 +65,7 @@ namespace OGF {
     }
 
     void MeshGrobEditor::set_dimension(index_t dim) {
-	if(!check_mesh_grob()) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
 	    return;
 	}
 	if(dim < 2 || dim > 3) {
@@ -104,7 +104,7 @@ namespace OGF {
 
 
     index_t MeshGrobEditor::create_vertex(const vec3& V) {
-	if(!check_mesh_grob()) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
 	    return 0;
 	}
 	index_t result = mesh_grob()->vertices.create_vertex(V.data());
@@ -129,7 +129,7 @@ namespace OGF {
     }
 
     index_t MeshGrobEditor::create_vertices(index_t nb) {
-	if(!check_mesh_grob()) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
 	    return 0;
 	}
 	index_t result = mesh_grob()->vertices.create_vertices(nb);
@@ -138,6 +138,9 @@ namespace OGF {
     }
 
     index_t MeshGrobEditor::create_facet(index_t nb_vertices) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return 0;
+	}
         index_t result = mesh_grob()->facets.create_facets(1,nb_vertices);
 	for(index_t lv=0; lv<nb_vertices; ++lv) {
 	    mesh_grob()->facets.set_vertex(result,lv,0);
@@ -151,6 +154,7 @@ namespace OGF {
     ) {
 	if(
 	    !check_mesh_grob() ||
+	    !check_not_pinned() ||
 	    !check_vertex_index(v1) ||
 	    !check_vertex_index(v2) ||
 	    !check_vertex_index(v3)
@@ -165,7 +169,7 @@ namespace OGF {
     index_t MeshGrobEditor::create_facets(
 	index_t nb_facets, index_t nb_vertices_per_facet
     ) {
-	if(!check_mesh_grob()) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
 	    return 0;
 	}
 	index_t result = mesh_grob()->facets.create_facets(
@@ -193,6 +197,7 @@ namespace OGF {
     ) {
 	if(
 	    !check_mesh_grob() ||
+	    !check_not_pinned() ||
 	    !check_vertex_index(v1) ||
 	    !check_vertex_index(v2) ||
 	    !check_vertex_index(v3) ||
@@ -208,6 +213,7 @@ namespace OGF {
     index_t MeshGrobEditor::create_edge(index_t v1, index_t v2) {
 	if(
 	    !check_mesh_grob() ||
+	    !check_not_pinned() ||
 	    !check_vertex_index(v1) ||
 	    !check_vertex_index(v2)
 	) {
@@ -276,6 +282,18 @@ namespace OGF {
 	return true;
     }
 
+    bool MeshGrobEditor::check_not_pinned() const {
+	if(mesh_grob()->elements_are_pinned()) {
+	    Logger::err("MeshGrobEditor")
+		<< mesh_grob()->name()
+		<< ": elements are referenced by buffer views"
+		<< " (release them before resizing the mesh)"
+		<< std::endl;
+	    return false;
+	}
+	return true;
+    }
+
     bool MeshGrobEditor::check_vertex_index(index_t v) const {
 	if(v >= mesh_grob()->vertices.nb()) {
 	    Logger::err("MeshGrobEditor") << v << ": invalid vertex index"
@@ -533,6 +551,9 @@ namespace OGF {
     }
 
     void MeshGrobEditor::delete_vertices(NL::Vector* to_delete) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return;
+	}
 	MetaType* type = to_delete->get_element_meta_type();
 	if(
 	    type != ogf_meta<unsigned int>::type() &&
@@ -563,6 +584,9 @@ namespace OGF {
     void MeshGrobEditor::delete_edges(
 	NL::Vector* to_delete, bool delete_isolated_vertices
     ) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return;
+	}
 	MetaType* type = to_delete->get_element_meta_type();
 	if(
 	    type != ogf_meta<unsigned int>::type() &&
@@ -595,6 +619,9 @@ namespace OGF {
     void MeshGrobEditor::delete_facets(
 	NL::Vector* to_delete, bool delete_isolated_vertices
     ) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return;
+	}
 	MetaType* type = to_delete->get_element_meta_type();
 	if(
 	    type != ogf_meta<unsigned int>::type() &&
@@ -627,6 +654,9 @@ namespace OGF {
     void MeshGrobEditor::delete_cells(
 	NL::Vector* to_delete, bool delete_isolated_vertices
     ) {
+	if(!check_mesh_grob() || !check_not_pinned()) {
+	    return;
+	}
 	MetaType* type = to_delete->get_element_meta_type();
 	if(
 	    type != ogf_meta<unsigned int>::type() &&
@@ -384,6 +384,16 @@ namespace OGF {
 	 */
 	bool check_mesh_grob() const;
 
+	/**
+	 * \brief Checks whether the elements of the MeshGrob can be
+	 *  reallocated.
+	 * \details Displays an error message if not.
+	 * \retval true if no buffer view refers to the elements.
+	 * \retval false otherwise.
+	 * \see Grob::pin_elements()
+	 */
+	bool check_not_pinned() const;
+
 	/**
 	 * \brief Checks whether a vertex index is valid.
 	 * \details Displays an error message if not.
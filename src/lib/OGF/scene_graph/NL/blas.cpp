@@ -146,5 +146,60 @@ namespace OGF {
 	    );
 	    
 	}
+
+	/*********************************************************/
+
+	AxpyKernel::AxpyKernel() : a_(1.0) {
+	}
+
+	AxpyKernel::~AxpyKernel() {
+	}
+
+	void AxpyKernel::set_x(Vector* x) {
+	    if(x != nullptr && !check_vector_type(x, "AxpyKernel", "x")) {
+		return;
+	    }
+	    x_ = x;
+	}
+
+	Vector* AxpyKernel::get_x() const {
+	    return x_;
+	}
+
+	void AxpyKernel::set_y(Vector* y) {
+	    if(y != nullptr && !check_vector_type(y, "AxpyKernel", "y")) {
+		return;
+	    }
+	    y_ = y;
+	}
+
+	Vector* AxpyKernel::get_y() const {
+	    return y_;
+	}
+
+	void AxpyKernel::apply(index_t i) {
+	    // Called concurrently: nothing is modified, except item i of y.
+	    if(x_.is_null() || y_.is_null()) {
+		Logger::err("NL") << "AxpyKernel::apply "
+				  << "Vectors x and y need to be set"
+				  << std::endl;
+		return;
+	    }
+	    index_t dim = x_->dimension();
+	    if(
+		y_->dimension() != dim ||
+		i >= x_->size() || i >= y_->size()
+	    ) {
+		Logger::err("NL") << "AxpyKernel::apply "
+				  << i << ": invalid item"
+				  << std::endl;
+		return;
+	    }
+	    const double* x = x_->data_double() + i*dim;
+	    double* y = y_->data_double() + i*dim;
+	    for(index_t c=0; c<dim; ++c) {
+		y[c] += a_ * x[c];
+	    }
+	}
     }
 }
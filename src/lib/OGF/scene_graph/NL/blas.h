@@ -115,6 +115,92 @@ namespace OGF {
 	 * \brief A reference-counted pointer to a Blas.
 	 */
 	typedef SmartPointer<Blas> Blas_var;
+
+	/**
+	 * \brief Computes a linear combination of two vectors, item by item.
+	 * \details In formula: \f$ y_i \leftarrow a x_i + y_i \f$. An
+	 *  example of kernel for gom.parallel_for(): apply() is declared
+	 *  thread-safe, thus it is run by several threads.
+	 *  \code
+	 *   K = gom.create('OGF::NL::AxpyKernel')
+	 *   K.a = 2.0
+	 *   K.x = X
+	 *   K.y = Y
+	 *   gom.parallel_for(0, X.size, K.apply)
+	 *  \endcode
+	 *  If y is a view on an attribute, the Grob is not updated by
+	 *  apply(), the script needs to call update() afterwards.
+	 */
+	gom_class SCENE_GRAPH_API AxpyKernel : public Object {
+	  public:
+	    /**
+	     * \brief AxpyKernel constructor.
+	     */
+	    AxpyKernel();
+
+	    /**
+	     * \brief AxpyKernel destructor.
+	     */
+	     ~AxpyKernel() override;
+
+	  gom_properties:
+
+	    /**
+	     * \brief Sets the scaling coefficient.
+	     * \param[in] a the coefficient applied to x
+	     */
+	    void set_a(double a) {
+		a_ = a;
+	    }
+
+	    /**
+	     * \brief Gets the scaling coefficient.
+	     * \return the coefficient applied to x
+	     */
+	    double get_a() const {
+		return a_;
+	    }
+
+	    /**
+	     * \brief Sets the source vector.
+	     * \param[in] x the vector to be scaled and added
+	     */
+	    void set_x(Vector* x);
+
+	    /**
+	     * \brief Gets the source vector.
+	     * \return the vector to be scaled and added
+	     */
+	    Vector* get_x() const;
+
+	    /**
+	     * \brief Sets the destination vector.
+	     * \param[in] y the vector that a x should be added to
+	     */
+	    void set_y(Vector* y);
+
+	    /**
+	     * \brief Gets the destination vector.
+	     * \return the vector that a x should be added to
+	     */
+	    Vector* get_y() const;
+
+	  gom_slots:
+
+	    /**
+	     * \brief Computes item \p i of y.
+	     * \details Only reads item \p i of x and writes item \p i
+	     *  of y, thus it can be called concurrently for different items.
+	     * \param[in] i the index of the item, in 0..x.size-1
+	     */
+	    gom_attribute(thread_safe,"true")
+	    void apply(index_t i);
+
+	  private:
+	    double a_;
+	    SmartPointer<Vector> x_;
+	    SmartPointer<Vector> y_;
+	};
     }
 }
     
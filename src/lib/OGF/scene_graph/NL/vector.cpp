@@ -59,6 +59,8 @@ namespace OGF {
 		element_meta_type_ = ogf_meta<double>::type();
 	    }
 	    element_size_ = element_meta_type_->life_cycle()->object_size();
+	    nb_pins_ = 0;
+	    pinned_addr_ = nullptr;
 	    if(size != 0) {
 		resize(size, dimension, get_element_meta_type());
 	    }
@@ -69,8 +71,14 @@ namespace OGF {
 	Vector::Vector(Grob* grob, AttributeStore* attribute_store) {
 	    owns_memory_ = false;
 	    read_only_ = false;
+	    // Views keep their Grob alive: a NumPy array over the view can
+	    // outlive the Python wrapper of the Grob, and the Grob can be
+	    // removed from the SceneGraph meanwhile. The attribute store
+	    // then stays valid as long as the view exists.
 	    grob_ = grob;
 	    attribute_store_ = attribute_store;
+	    nb_pins_ = 0;
+	    pinned_addr_ = nullptr;
 	    size_ = 0;
 	    dimension_ = 0;
 	    base_addr_ = nullptr;
@@ -100,6 +108,8 @@ namespace OGF {
 	    read_only_ = read_only;
 	    grob_ = grob;
 	    attribute_store_ = nullptr;
+	    nb_pins_ = 0;
+	    pinned_addr_ = nullptr;
 	    size_ = size;
 	    dimension_ = dimension;
 	    base_addr_ = Memory::pointer(data);
@@ -139,6 +149,13 @@ namespace OGF {
 		return;
 	    }
 
+	    if(nb_pins_ != 0) {
+		Logger::err("NL::Vector")
+		    << "Cannot resize, memory is referenced by a buffer view"
+		    << std::endl;
+		return;
+	    }
+
 	    element_meta_type_->life_cycle()->delete_array(base_addr_);
 
 	    if(element_meta_type != nullptr) {
@@ -196,11 +213,59 @@ namespace OGF {
 	    value.copy_to(base_addr_ + index*element_size_, element_meta_type_);
 	    // If this vector is an attribute of an object, mark this object
 	    // as dirty for graphics update.
-	    if(grob_ != nullptr) {
+	    if(!grob_.is_null()) {
 		grob_->update();
 	    }
 	}
 
+	bool Vector::get_element_buffer(ElementBuffer& buffer) {
+	    if(base_addr_ == nullptr && nb_elements() != 0) {
+		return false;
+	    }
+	    buffer.data = base_addr_;
+	    buffer.element_meta_type = element_meta_type_;
+	    buffer.element_size = element_size_;
+	    buffer.nb_elements = nb_elements();
+	    buffer.dimension = dimension();
+	    buffer.read_only = read_only_;
+	    return true;
+	}
+
+	void Vector::element_buffer_modified() {
+	    if(!grob_.is_null()) {
+		grob_->update();
+	    }
+	}
+
+	void Vector::pin_element_buffer() {
+	    if(nb_pins_ == 0) {
+		pinned_addr_ = base_addr_;
+	    }
+	    ++nb_pins_;
+	    // The elements of the Grob (vertices, facets, attributes) cannot
+	    // be reallocated by commands and editing functions while pinned.
+	    if(!grob_.is_null()) {
+		grob_->pin_elements();
+	    }
+	}
+
+	void Vector::unpin_element_buffer() {
+	    geo_assert(nb_pins_ != 0);
+	    --nb_pins_;
+	    if(!grob_.is_null()) {
+		grob_->unpin_elements();
+	    }
+	    // C++ code that resizes the mesh directly bypasses the pins,
+	    // this is reported here.
+	    if(base_addr_ != pinned_addr_) {
+		Logger::warn("NL::Vector")
+		    << "Attribute was reallocated while referenced by a "
+		    << "buffer view (the view was invalid)"
+		    << std::endl;
+		pinned_addr_ = base_addr_;
+	    }
+	}
+
 	double* Vector::data_double() const {
 	    if(get_element_meta_type() != ogf_meta<double>::type()) {
 		return nullptr;
@@ -109,6 +109,31 @@ namespace OGF {
 	     */
 	    void set_element(index_t i, const Any& value) override;
 
+	    /**
+	     * \copydoc Object::get_element_buffer()
+	     */
+	    bool get_element_buffer(ElementBuffer& buffer) override;
+
+	    /**
+	     * \copydoc Object::element_buffer_modified()
+	     */
+	    void element_buffer_modified() override;
+
+	    /**
+	     * \copydoc Object::pin_element_buffer()
+	     * \details A pinned Vector cannot be resized, and pins the
+	     *  elements of its Grob (see Grob::pin_elements()), so that the
+	     *  commands and editing functions that may reallocate them are
+	     *  refused. A reallocation by C++ code that bypasses the pins is
+	     *  reported when the pin is released.
+	     */
+	    void pin_element_buffer() override;
+
+	    /**
+	     * \copydoc Object::unpin_element_buffer()
+	     */
+	    void unpin_element_buffer() override;
+
 	    /**
 	     * \brief Gets the data pointer.
 	     * \return a pointer to the first element. All elements are stored
@@ -202,9 +227,11 @@ namespace OGF {
 	    size_t element_size_;
 	    MetaType* element_meta_type_;
 	    bool owns_memory_;
-	    Grob* grob_;
+	    SmartPointer<Grob> grob_;
 	    AttributeStore* attribute_store_;
 	    bool read_only_;
+	    index_t nb_pins_;
+	    Memory::pointer pinned_addr_;
 	};
 
 	/**********************************************************/
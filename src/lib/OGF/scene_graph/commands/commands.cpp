@@ -44,6 +44,98 @@
 #include <geogram/basic/stopwatch.h>
 #include <geogram/basic/command_line.h>
 #include <sstream>
+#include <set>
+#include <map>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Gets the write set declared by a command.
+     * \details The write set is declared with the "readonly" or
+     *  "modifies" tags in the documentation of the command.
+     * \param[in] mmethod the MetaMethod of the command
+     * \param[out] parts the parts of the Grob modified by the command,
+     *  empty if the command is read-only
+     * \retval true if the command declares its write set
+     * \retval false otherwise (then the command may modify anything)
+     */
+    bool get_write_set(MetaMethod* mmethod, std::set<std::string>& parts) {
+        parts.clear();
+        if(mmethod == nullptr) {
+            return false;
+        }
+        if(
+            mmethod->has_custom_attribute("readonly") &&
+            mmethod->custom_attribute_value("readonly") == "true"
+        ) {
+            return true;
+        }
+        if(!mmethod->has_custom_attribute("modifies")) {
+            return false;
+        }
+        // Parts are separated by spaces or commas. What is between
+        // parentheses, for instance attribute names in attributes(weight),
+        // is documentation.
+        std::string value = mmethod->custom_attribute_value("modifies");
+        value += " ";
+        std::string part;
+        index_t depth = 0;
+        for(char c: value) {
+            if(c == '(') {
+                ++depth;
+            } else if(c == ')') {
+                if(depth != 0) {
+                    --depth;
+                }
+            } else if(depth == 0) {
+                if(c == ' ' || c == ',' || c == ';' || c == '\t') {
+                    if(part != "") {
+                        parts.insert(part);
+                    }
+                    part = "";
+                } else {
+                    part.push_back(c);
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Reports the parts of a Grob that were modified by a command
+     *  but that were not declared in its write set.
+     * \param[in] command the name of the command
+     * \param[in] grob the Grob
+     * \param[in] parts the declared write set
+     * \param[in] before the hashes of the parts before the command
+     * \param[in] contents true if the hashes depend on the contents of
+     *  the parts, false if they only depend on their sizes
+     */
+    void check_write_set(
+        const std::string& command, Grob* grob,
+        const std::set<std::string>& parts,
+        const std::map<std::string, Numeric::uint64>& before,
+        bool contents
+    ) {
+        std::map<std::string, Numeric::uint64> after;
+        grob->get_part_hashes(after, contents);
+        for(const auto& it: before) {
+            if(parts.find(it.first) != parts.end()) {
+                continue;
+            }
+            auto jt = after.find(it.first);
+            if(jt == after.end() || jt->second != it.second) {
+                Logger::warn("Commands")
+                    << command << " modified " << it.first
+                    << " of " << grob->name()
+                    << (parts.empty() ? " but is declared readonly" :
+                                        " but does not declare it (modifies)")
+                    << std::endl;
+            }
+        }
+    }
+}
 
 namespace OGF {
 
@@ -74,6 +166,10 @@ namespace OGF {
     Commands::~Commands() {
     }
 
+    bool Commands::slots_can_be_called_directly() const {
+        return false;
+    }
+
     bool Commands::invoke_method(
         const std::string& method_name,
         const ArgList& args_in, Any& ret_val
@@ -96,24 +192,61 @@ namespace OGF {
 
         bool invoked_from_gui = false;
         
-        // Copy argument list, ignore arguments that start with '_'
-        ArgList args;
+        // Ignore arguments that start with '_'. The argument list is
+        // only copied if there are such arguments.
+        ArgList filtered_args;
+        bool has_hidden_args = false;
         for(index_t i=0; i<args_in.nb_args(); ++i) {
             const std::string& name = args_in.ith_arg_name(i);
-            const Any& value = args_in.ith_arg_value(i);
             if(name.length() > 0 && name[0] == '_') {
-                if(name == "_invoked_from_gui" && value.as_string() == "true") {
-                    invoked_from_gui = true;
+                has_hidden_args = true;
+                break;
+            }
+        }
+        if(has_hidden_args) {
+            for(index_t i=0; i<args_in.nb_args(); ++i) {
+                const std::string& name = args_in.ith_arg_name(i);
+                const Any& value = args_in.ith_arg_value(i);
+                if(name.length() > 0 && name[0] == '_') {
+                    if(
+                        name == "_invoked_from_gui" &&
+                        value.as_string() == "true"
+                    ) {
+                        invoked_from_gui = true;
+                    }
+                    continue;
                 }
-                continue;
-            } 
-            args.create_arg(name, value);
+                filtered_args.create_arg(name, value);
+            }
+        }
+        const ArgList& args = has_hidden_args ? filtered_args : args_in;
+
+
+        MetaMethod* mmethod = meta_class()->find_method(method_name) ;
+
+        // Commands can declare what they modify. Read-only commands do not
+        // need a saved state for undo.
+        std::set<std::string> write_set;
+        bool has_write_set = get_write_set(mmethod, write_set);
+
+        // Commands may reallocate the elements of the Grob, that
+        // can be referenced by buffer views (e.g., NumPy arrays).
+        // Read-only commands can run.
+        if(
+            get_grob()->elements_are_pinned() &&
+            !(has_write_set && write_set.empty())
+        ) {
+            Logger::err("Commands")
+                << method_name << "(): " << get_grob()->name()
+                << " elements are referenced by buffer views"
+                << std::endl;
+            command_is_running_ = false ;
+            return false ;
         }
 
-        
         if(interpreter() != nullptr) {
 
-            if(invoked_from_gui) {
+            if(invoked_from_gui && !(has_write_set && write_set.empty())) {
                 Object* main = interpreter()->resolve_object("main");
                 main->invoke_method("save_state");
             }
@@ -160,10 +293,24 @@ namespace OGF {
 
         // Do not display timings for methods with continuous updates
         // (e.g. set_multiresolution_level)
-        MetaMethod* mmethod = meta_class()->find_method(method_name) ;
         bool do_timings = chrono_ && mmethod != nullptr && 
             !mmethod->has_custom_attribute("continuous_update") ;
 
+        // Detect the writes that are not declared. Comparing the sizes of
+        // the parts is cheap and always done, comparing their contents
+        // is done if gui:undo_check_writes is set.
+        Grob* grob = get_grob();
+        std::map<std::string, Numeric::uint64> part_hashes;
+        bool check_contents = false;
+        if(has_write_set && grob != nullptr) {
+            check_contents =
+                CmdLine::arg_is_declared("gui:undo_check_writes") &&
+                CmdLine::get_arg_bool("gui:undo_check_writes");
+            grob->get_part_hashes(part_hashes, check_contents);
+        }
+        // The Grob may be deleted by the command.
+        Grob_var grob_ref = grob;
+
         if(get_grob() != nullptr) {
             if(do_timings) {
 
@@ -182,6 +329,13 @@ namespace OGF {
                     << "(" << full_name << ") Elapsed time: " 
                     << timer.elapsed_time() << std::endl ;
 
+                if(!part_hashes.empty()) {
+                    check_write_set(
+                        full_name, grob, write_set, part_hashes,
+                        check_contents
+                    );
+                }
+
 		// TODO: re-enable changing current object here.
 
 		//   If the user clicked on the object list attempting
@@ -192,8 +346,17 @@ namespace OGF {
 		command_is_running_ = false ;
                 return result ;
             } else {
+                bool result = Interface::invoke_method(
+                    method_name, args, ret_val
+                ) ;
+                if(!part_hashes.empty()) {
+                    check_write_set(
+                        meta_class()->name() + "::" + method_name,
+                        grob, write_set, part_hashes, check_contents
+                    );
+                }
                 command_is_running_ = false ;
-                return Interface::invoke_method(method_name, args, ret_val) ;
+                return result ;
             }
         }
 
@@ -140,6 +140,14 @@ namespace OGF {
      *  - "advanced" all subsequent parameters are in the
      *   advanced section of the command (displayed when
      *   clicking on it)
+     *  - "readonly": the command does not modify the object. No state
+     *   is saved for undo() before invoking it.
+     *  - "modifies": followed by the parts of the object that the command
+     *   modifies, for instance "modifies vertices facets" or
+     *   "modifies attributes(weight)" (see Grob::get_part_hashes() for
+     *   the names of the parts). Commands without it may modify anything.
+     *  When gui:undo_check_writes is set, the parts that are not declared
+     *  are checked after each command, and modifications are reported.
      * \note To be taken into account by the system, a 
      *  Commands object has to satisfy the following 
      *  requirements:
@@ -175,6 +183,13 @@ namespace OGF {
             const ArgList& args, Any& ret_val
         ) override;
 
+        /**
+         * \copydoc Object::slots_can_be_called_directly()
+         * \details Commands are always invoked through invoke_method(),
+         *  that records them in the history.
+         */
+        bool slots_can_be_called_directly() const override;
+
 	/**
 	 * \brief Gets the main Interpreter.
 	 * \return a pointer to the main Interpreter.
@@ -128,12 +128,14 @@ namespace OGF {
          * \menu Current
          * \brief Displays the bounding box and dimensions of the
          *  current object.
+         * \readonly
          */
         void display_current_dimensions();
 
         /**
          * \menu Current
          * \brief Displays the attributes of the current object.
+         * \readonly
          */
         void display_current_attributes();
 
@@ -150,18 +152,21 @@ namespace OGF {
         /**
          * \menu System/Parameters
          * \brief Lists all the parameters and their values.
+         * \readonly
          */
         void list_parameters();
 
         /**
          * \menu System/Logger
          * \brief Enables logger messages.
+         * \readonly
          */
         void enable_verbose();
 
         /**
          * \menu System/Logger
          * \brief Disables logger messages.
+         * \readonly
          */
         void disable_verbose();
     };
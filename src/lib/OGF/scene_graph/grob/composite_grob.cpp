@@ -59,13 +59,11 @@ namespace OGF {
     }
     
     Grob* CompositeGrob::resolve(const std::string& name) const {
-        for(index_t i=0; i<get_nb_children(); i++) {
-            Grob* cur = ith_child(i) ;
-            if(cur != nullptr && cur->get_name() == name) {
-                return cur ;
-            }
+        auto it = children_by_name_.find(name);
+        if(it == children_by_name_.end()) {
+            return nullptr ;
         }
-        return nullptr ;
+        return it->second ;
     }
 
     Box3d CompositeGrob::bbox() const {
@@ -98,11 +96,40 @@ namespace OGF {
     
     void CompositeGrob::add_child(Node* child) {
         Grob::add_child(child) ;
+        // Note: when called from the constructor of the child, the
+        // child is not a Grob yet (and does not have a name yet), it
+        // is indexed later, by child_name_changed().
+        Grob* grob = dynamic_cast<Grob*>(child) ;
+        if(grob != nullptr && grob->name() != "") {
+            children_by_name_[grob->name()] = grob ;
+        }
     }
 
     void CompositeGrob::remove_child(Node* child) {
+        Grob* grob = dynamic_cast<Grob*>(child) ;
+        if(grob != nullptr) {
+            auto it = children_by_name_.find(grob->name()) ;
+            if(it != children_by_name_.end() && it->second == grob) {
+                children_by_name_.erase(it) ;
+            }
+            if(scene_graph() != nullptr) {
+                scene_graph()->cancel_grob_update(grob) ;
+            }
+        }
         Grob::remove_child(child) ;
     }
+
+    void CompositeGrob::child_name_changed(
+        Grob* child, const std::string& old_name
+    ) {
+        auto it = children_by_name_.find(old_name) ;
+        if(it != children_by_name_.end() && it->second == child) {
+            children_by_name_.erase(it) ;
+        }
+        if(child->name() != "") {
+            children_by_name_[child->name()] = child ;
+        }
+    }
     
 /************************************************************/
 
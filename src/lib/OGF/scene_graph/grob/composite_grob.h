@@ -42,6 +42,7 @@
 #include <OGF/gom/interpreter/interpreter.h>
 
 #include <map>
+#include <unordered_map>
 
 /**
  * \file OGF/scene_graph/grob/composite_grob.h
@@ -88,7 +89,8 @@ namespace OGF {
      * \details Each children has a unique name. 
      *  Functionalities are provided
      *  to retreive a child given its name or given its
-     *  index. 
+     *  index. Children are indexed by name, so that retreiving
+     *  a child given its name takes constant time.
      */
     gom_class SCENE_GRAPH_API CompositeGrob : public Grob {
     public:
@@ -157,6 +159,21 @@ namespace OGF {
          * \copydoc Grob::world_bbox()
          */
 	 Box3d world_bbox() const override;
+
+        /**
+         * \brief Updates the index of the children names.
+         * \details Called by Grob::initialize_name() each time a child
+         *  changes its name.
+         * \param[in] child a pointer to the child
+         * \param[in] old_name the previous name of the child, or
+         *  an empty string if the child is named for the first time
+         */
+        virtual void child_name_changed(
+            Grob* child, const std::string& old_name
+        );
+
+    private:
+        std::unordered_map<std::string, Grob*> children_by_name_;
     };
 
     
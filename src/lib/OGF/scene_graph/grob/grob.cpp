@@ -47,6 +47,7 @@
 
 #include <geogram/basic/file_system.h>
 #include <sstream>
+#include <atomic>
 
 namespace OGF {
 
@@ -63,6 +64,8 @@ namespace OGF {
         obj_to_world_.load_identity();
         dirty_ = false;
         nb_graphics_locks_ = 0;
+        nb_element_pins_ = 0;
+        timestamp_ = new_timestamp();
     }
 
     Grob::Grob() {
@@ -78,6 +81,8 @@ namespace OGF {
         obj_to_world_.load_identity();
         dirty_ = false;
         nb_graphics_locks_ = 0;
+        nb_element_pins_ = 0;
+        timestamp_ = new_timestamp();
     }
 
     Grob::~Grob() {
@@ -87,6 +92,7 @@ namespace OGF {
 
     void Grob::initialize_name(const std::string& name) {
 	CompositeGrob* parent = dynamic_cast<CompositeGrob*>(get_parent());
+        std::string old_name = name_;
         if((parent != nullptr) && parent->is_bound(name)) {
             int id=0;
             std::string cur_name;
@@ -100,6 +106,9 @@ namespace OGF {
         } else {
             name_ = name;
         }
+        if(parent != nullptr) {
+            parent->child_name_changed(this, old_name);
+        }
     }
 
     void Grob::rename(const std::string& value) {
@@ -156,6 +165,10 @@ namespace OGF {
 
     void Grob::update() {
         dirty_ = true;
+        timestamp_ = new_timestamp();
+        if(scene_graph()->defer_grob_update(this)) {
+            return;
+        }
         value_changed(this);
         scene_graph()->update();
     }
@@ -188,6 +201,90 @@ namespace OGF {
         return o;
     }
 
+    Numeric::uint64 Grob::new_timestamp() {
+        static std::atomic<Numeric::uint64> last_timestamp(0);
+        return ++last_timestamp;
+    }
+
+    void Grob::get_part_hashes(
+        std::map<std::string, Numeric::uint64>& hashes, bool contents
+    ) const {
+        geo_argused(contents);
+        hashes.clear();
+    }
+
+    bool Grob::check_elements_not_pinned(
+        const std::string& operation
+    ) const {
+        if(elements_are_pinned()) {
+            Logger::err("Grob")
+                << name() << ": " << operation << "() refused, elements "
+                << "are referenced by buffer views" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    GrobState* Grob::create_state() {
+        return nullptr;
+    }
+
+    bool Grob::restore_state(GrobState* state) {
+        geo_argused(state);
+        return false;
+    }
+
+    bool Grob::can_load_in_thread() const {
+        return false;
+    }
+
+    bool Grob::load_in_thread(
+        const std::string& file_name, GrobLoadMessages& messages
+    ) {
+        messages.err("Cannot load file from a thread: " + file_name);
+        return false;
+    }
+
+    void Grob::end_load_in_thread() {
+        update();
+    }
+
+    /*************************************************************/
+
+    std::mutex& GrobLoadMessages::logger_mutex() {
+        static std::mutex result;
+        return result;
+    }
+
+    void GrobLoadMessages::out(const std::string& message) {
+        messages_.push_back(std::make_pair(OUT, message));
+    }
+
+    void GrobLoadMessages::warn(const std::string& message) {
+        messages_.push_back(std::make_pair(WARN, message));
+    }
+
+    void GrobLoadMessages::err(const std::string& message) {
+        messages_.push_back(std::make_pair(ERR, message));
+    }
+
+    void GrobLoadMessages::flush(const std::string& feature) {
+        for(const auto& message : messages_) {
+            switch(message.first) {
+            case OUT:
+                Logger::out(feature) << message.second << std::endl;
+                break;
+            case WARN:
+                Logger::warn(feature) << message.second << std::endl;
+                break;
+            case ERR:
+                Logger::err(feature) << message.second << std::endl;
+                break;
+            }
+        }
+        messages_.clear();
+    }
+
     bool Grob::is_serializable() const {
         return false;
     }
@@ -239,6 +336,9 @@ namespace OGF {
             try {
                 OutputGraphiteFile out(value);
                 result = serialize_write(out);
+                if(result) {
+                    out.close();
+                }
             } catch(const std::logic_error& e) {
                 Logger::err("I/O") << "Caught exception: " << e.what()
                                    << std::endl;
@@ -266,6 +366,9 @@ namespace OGF {
     void Grob::set_visible(bool x) {
 	if(x != visible_) {
 	    visible_ = x;
+            if(scene_graph() != nullptr && scene_graph() != this) {
+                scene_graph()->grob_visibility_changed_notify(this);
+            }
 	    update();
 	}
     }
@@ -40,10 +40,13 @@
 
 #include <OGF/scene_graph/common/common.h>
 #include <OGF/scene_graph/types/properties.h>
+#include <OGF/scene_graph/grob/grob_state.h>
 #include <OGF/gom/types/node.h>
 #include <OGF/basic/math/geometry.h>
 
 #include <map>
+#include <vector>
+#include <mutex>
 
 /**
  * \file OGF/scene_graph/grob/grob.h
@@ -61,6 +64,57 @@ namespace OGF {
     class OutputGraphiteFile;
     class Interpreter;
 
+    /**
+     * \brief Messages emitted while a file is loaded from a worker
+     *  thread.
+     * \details The Logger cannot be used from several threads, messages
+     *  are stored and displayed afterwards by flush().
+     * \see Grob::load_in_thread()
+     */
+    class SCENE_GRAPH_API GrobLoadMessages {
+    public:
+        /**
+         * \brief Gets the mutex that serializes the use of the Logger
+         *  by the worker threads.
+         * \details The streams of the Logger are shared by all threads,
+         *  also in quiet mode. Implementations of Grob::load_in_thread()
+         *  that call functions that may use the Logger (e.g. the file
+         *  readers of geogram) need to lock it meanwhile.
+         * \return a reference to the mutex
+         */
+        static std::mutex& logger_mutex();
+
+        /**
+         * \brief Stores an information message.
+         * \param[in] message the message
+         */
+        void out(const std::string& message);
+
+        /**
+         * \brief Stores a warning.
+         * \param[in] message the message
+         */
+        void warn(const std::string& message);
+
+        /**
+         * \brief Stores an error message.
+         * \param[in] message the message
+         */
+        void err(const std::string& message);
+
+        /**
+         * \brief Displays the stored messages with the Logger, in the
+         *  order they were stored, and clears them.
+         * \details Needs to be called from the main thread.
+         * \param[in] feature the Logger feature
+         */
+        void flush(const std::string& feature);
+
+    private:
+        enum Kind { OUT, WARN, ERR };
+        std::vector< std::pair<Kind, std::string> > messages_;
+    };
+
     /**
      * \brief Base class for all 3D Graphite objects.
      */
@@ -220,6 +274,18 @@ namespace OGF {
             dirty_ = false;
         }
 
+        /**
+         * \brief Gets the timestamp of this Grob.
+         * \details The timestamp changes each time this Grob is modified,
+         *  i.e. each time update() or lock_graphics() is called. Timestamps
+         *  are unique among all Grobs, thus a Grob and its timestamp
+         *  identify a version of its contents.
+         * \return the timestamp
+         */
+        Numeric::uint64 timestamp() const {
+            return timestamp_;
+        }
+
         /**
          * \brief Tests whether this VoxelGrob is locked
          *  for graphics display.
@@ -249,6 +315,7 @@ namespace OGF {
         void lock_graphics() {
             ++nb_graphics_locks_;
             dirty_ = true;
+            timestamp_ = new_timestamp();
         }
 
         /**
@@ -269,6 +336,51 @@ namespace OGF {
             --nb_graphics_locks_;
         }
 
+        /**
+         * \brief Pins the elements of this Grob.
+         * \details Called by the views that refer directly to the memory
+         *  of the elements, for instance NumPy arrays over the attributes
+         *  of a mesh (see NL::Vector::pin_element_buffer()). While the
+         *  elements are pinned, everything that may reallocate them is
+         *  refused: the commands that are not read-only, the editing
+         *  functions, load(), append(), clear(), restore_state(), undo
+         *  and redo. Multiple pins can be nested, each one needs to be
+         *  released by unpin_elements().
+         */
+        void pin_elements() {
+            ++nb_element_pins_;
+        }
+
+        /**
+         * \brief Releases a pin taken by pin_elements().
+         */
+        void unpin_elements() {
+            geo_assert(nb_element_pins_ != 0);
+            --nb_element_pins_;
+        }
+
+        /**
+         * \brief Tests whether the elements of this Grob are pinned.
+         * \retval true if a view refers to the memory of the elements
+         * \retval false otherwise
+         * \see pin_elements()
+         */
+        bool elements_are_pinned() const {
+            return (nb_element_pins_ != 0);
+        }
+
+        /**
+         * \brief Checks that the elements of this Grob are not pinned,
+         *  before an operation that may reallocate them.
+         * \param[in] operation the name of the operation, displayed in
+         *  the error message
+         * \retval true if the elements are not pinned
+         * \retval false otherwise, then an error message is displayed and
+         *  the operation needs to be refused
+         * \see pin_elements()
+         */
+        bool check_elements_not_pinned(const std::string& operation) const;
+
         /**
          * \brief Finds a Grob by name
          * \param[in] sg a pointer to the SceneGraph
@@ -285,6 +397,75 @@ namespace OGF {
 	 */
 	virtual Interpreter* interpreter();
 
+        /**
+         * \brief Computes hashes of the parts of this Grob.
+         * \details Used to check that commands only modify the parts they
+         *  declare with gom_attribute(modifies, ...), see Commands.
+         * \param[out] hashes the hash of each part, indexed by part name.
+         *  Left empty if this type of Grob has no parts (default).
+         * \param[in] contents if set, the hashes depend on the whole
+         *  contents of the parts, else they only depend on their sizes
+         *  (which is much cheaper to compute)
+         */
+        virtual void get_part_hashes(
+            std::map<std::string, Numeric::uint64>& hashes, bool contents
+        ) const;
+
+        /**
+         * \brief Creates an in-memory snapshot of this Grob.
+         * \details Used by undo()/redo(). The UndoStore saves the grob
+         *  attributes, shader and visibility, this function only copies
+         *  the contents specific to each type of Grob.
+         * \return a new GrobState, or nullptr if this type of Grob does
+         *  not support in-memory snapshots (default). The UndoStore then
+         *  serializes it to a file.
+         */
+        virtual GrobState* create_state();
+
+        /**
+         * \brief Restores a snapshot of this Grob.
+         * \param[in] state a GrobState created by create_state() on a
+         *  Grob of the same type
+         * \retval true if the GrobState could be restored
+         * \retval false otherwise
+         */
+        virtual bool restore_state(GrobState* state);
+
+        /**
+         * \brief Tests whether this type of Grob supports
+         *  load_in_thread().
+         * \retval true if load_in_thread() is implemented
+         * \retval false otherwise (default)
+         */
+        virtual bool can_load_in_thread() const;
+
+        /**
+         * \brief Loads a file from a worker thread.
+         * \details Used by SceneGraph::load_objects() to read several
+         *  files in parallel, each one into a Grob that was just created.
+         *  It is called from worker threads, and should only modify this
+         *  Grob: neither update() it nor modify the SceneGraph. The Logger
+         *  is silent meanwhile, messages are stored in \p messages, and
+         *  displayed in the order of the files once they are all loaded.
+         *  Functions that may use the Logger need to be called with
+         *  GrobLoadMessages::logger_mutex() locked.
+         *  Then end_load_in_thread() is called from the main thread.
+         * \param[in] file_name the name of the file
+         * \param[out] messages the messages for the file
+         * \retval true on success
+         * \retval false otherwise, then the reason is in \p messages
+         */
+        virtual bool load_in_thread(
+            const std::string& file_name, GrobLoadMessages& messages
+        );
+
+        /**
+         * \brief Finishes loading a file read by load_in_thread().
+         * \details Called from the main thread. Default implementation
+         *  calls update().
+         */
+        virtual void end_load_in_thread();
+
     gom_slots:
         /**
          * \brief Triggers update events.
@@ -431,6 +612,17 @@ namespace OGF {
             return name_;
         }
 
+        /**
+         * \brief Gets the identifier of this Grob.
+         * \details The identifier does not change when the Grob is
+         *  renamed. It is the one passed to the signals of the SceneGraph
+         *  (SceneGraph::grob_added(), SceneGraph::grob_removed() ...).
+         * \return the unique identifier of this Grob, see Object::id()
+         */
+        index_t get_id() const {
+            return id();
+        }
+
         /**
          * \brief Sets the name of this Grob.
          * \details The system stores for each grob the
@@ -526,6 +718,13 @@ namespace OGF {
             shader_manager_ = s;
         }
 
+        /**
+         * \brief Generates a new timestamp.
+         * \return a timestamp that is different from all the previous ones
+         * \see timestamp()
+         */
+        static Numeric::uint64 new_timestamp();
+
     protected:
         std::string name_;
         std::string filename_;
@@ -536,6 +735,8 @@ namespace OGF {
         ArgList grob_attributes_;
         bool dirty_;
         index_t nb_graphics_locks_;
+        index_t nb_element_pins_;
+        Numeric::uint64 timestamp_;
 
         friend class SceneGraph;
         friend class SceneGraphShaderManager;
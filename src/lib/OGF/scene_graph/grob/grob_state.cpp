@@ -0,0 +1,86 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/scene_graph/grob/grob_state.h>
+#include <geogram/basic/file_system.h>
+
+#include <cstring>
+
+namespace OGF {
+
+    GrobState::GrobState() {
+    }
+
+    GrobState::~GrobState() {
+        if(is_spilled() && FileSystem::is_file(spill_file_name_)) {
+            FileSystem::delete_file(spill_file_name_);
+        }
+    }
+
+    size_t GrobState::unshared_memory_size(
+        std::set<const void*>& counted
+    ) const {
+        return counted.insert(this).second ? memory_size() : 0;
+    }
+
+    bool GrobState::spill(const std::string& file_name) {
+        geo_argused(file_name);
+        return false;
+    }
+
+    bool GrobState::unspill() {
+        return !is_spilled();
+    }
+
+    void GrobState::hash_bytes(
+        Numeric::uint64& h, const void* data, size_t size
+    ) {
+        // Mixes 8 bytes at a time (most of the time is spent hashing
+        // attribute arrays, that can be large).
+        const char* p = static_cast<const char*>(data);
+        Numeric::uint64 word;
+        size_t i = 0;
+        for(; i+8 <= size; i += 8) {
+            ::memcpy(&word, p+i, 8);
+            hash_value(h, word);
+        }
+        word = 0;
+        ::memcpy(&word, p+i, size-i);
+        hash_value(h, word);
+        hash_value(h, Numeric::uint64(size));
+    }
+
+}
@@ -0,0 +1,186 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_SCENE_GRAPH_GROB_GROB_STATE_H
+#define H_OGF_SCENE_GRAPH_GROB_GROB_STATE_H
+
+#include <OGF/scene_graph/common/common.h>
+#include <geogram/basic/counted.h>
+#include <geogram/basic/smart_pointer.h>
+#include <geogram/basic/numeric.h>
+
+#include <string>
+#include <set>
+
+/**
+ * \file OGF/scene_graph/grob/grob_state.h
+ * \brief In-memory snapshots of Grobs, used by undo/redo.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief An in-memory snapshot of the contents of a Grob.
+     * \details GrobStates are created by Grob::create_state() and
+     *  copied back by Grob::restore_state(). They are stored by the
+     *  UndoStore. When the UndoStore exceeds its memory budget, some
+     *  GrobStates are spilled to disk, and reloaded when needed.
+     */
+    class SCENE_GRAPH_API GrobState : public Counted {
+    public:
+        /**
+         * \brief GrobState constructor.
+         */
+        GrobState();
+
+        /**
+         * \brief GrobState destructor.
+         * \details Deletes the spill file if there is one.
+         */
+        ~GrobState() override;
+
+        /**
+         * \brief Gets the memory used by this GrobState.
+         * \return the (approximate) number of bytes used in memory,
+         *  or 0 if this GrobState is spilled to disk
+         */
+        virtual size_t memory_size() const = 0;
+
+        /**
+         * \brief Gets the memory used by this GrobState and not already
+         *  counted.
+         * \details GrobStates can share some of their contents. This
+         *  function only counts the shared contents once.
+         * \param[in,out] counted the contents already counted. The
+         *  contents of this GrobState are inserted into it.
+         * \return the (approximate) number of bytes used in memory by the
+         *  contents of this GrobState that were not in \p counted.
+         *  The default implementation counts the whole GrobState once.
+         */
+        virtual size_t unshared_memory_size(
+            std::set<const void*>& counted
+        ) const;
+
+        /**
+         * \brief Writes this GrobState to disk and releases its memory.
+         * \param[in] file_name the name of the file, without extension.
+         *  Implementations append the extension they need and record the
+         *  actual file name with set_spill_file_name().
+         * \retval true if this GrobState could be spilled
+         * \retval false otherwise (it stays in memory)
+         */
+        virtual bool spill(const std::string& file_name);
+
+        /**
+         * \brief Reloads a spilled GrobState in memory.
+         * \details Does nothing if this GrobState is not spilled. The
+         *  spill file is deleted once reloaded.
+         * \retval true if this GrobState is in memory
+         * \retval false otherwise
+         */
+        virtual bool unspill();
+
+        /**
+         * \brief Tests whether this GrobState is spilled to disk.
+         * \retval true if this GrobState is stored in a file
+         * \retval false if it is in memory
+         */
+        bool is_spilled() const {
+            return spill_file_name_ != "";
+        }
+
+        /**
+         * \brief Gets the name of the spill file.
+         * \return the name of the file where this GrobState is stored,
+         *  or the empty string if it is in memory
+         */
+        const std::string& spill_file_name() const {
+            return spill_file_name_;
+        }
+
+        /**
+         * \brief Combines a value with a hash.
+         * \param[in,out] h the hash
+         * \param[in] value the value to be combined with \p h
+         */
+        static void hash_value(Numeric::uint64& h, Numeric::uint64 value) {
+            value *= 0xff51afd7ed558ccdull;
+            value ^= (value >> 33);
+            h ^= value;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= (h >> 29);
+        }
+
+        /**
+         * \brief Combines a memory area with a hash.
+         * \param[in,out] h the hash
+         * \param[in] data a pointer to the memory area
+         * \param[in] size the size of the memory area, in bytes
+         */
+        static void hash_bytes(
+            Numeric::uint64& h, const void* data, size_t size
+        );
+
+        /**
+         * \brief Combines a string with a hash.
+         * \param[in,out] h the hash
+         * \param[in] s the string
+         */
+        static void hash_string(Numeric::uint64& h, const std::string& s) {
+            hash_bytes(h, s.data(), s.length());
+        }
+
+    protected:
+        /**
+         * \brief Sets the name of the spill file.
+         * \param[in] file_name the name of the file where this GrobState
+         *  is stored, or the empty string once it is back in memory
+         */
+        void set_spill_file_name(const std::string& file_name) {
+            spill_file_name_ = file_name;
+        }
+
+    private:
+        std::string spill_file_name_;
+    };
+
+    /**
+     * \brief An automatic reference-counted pointer to a GrobState.
+     */
+    typedef SmartPointer<GrobState> GrobState_var;
+}
+
+#endif
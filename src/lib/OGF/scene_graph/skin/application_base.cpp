@@ -36,6 +36,7 @@
 
 #include <OGF/scene_graph/skin/application_base.h>
 #include <OGF/scene_graph/skin/preferences.h>
+#include <OGF/scene_graph/types/scene_graph.h>
 #include <OGF/gom/interpreter/interpreter.h>
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/basic/modules/modmgr.h>
@@ -68,28 +69,10 @@ namespace OGF {
 	progress_client_ = new ApplicationBaseProgressClient(this);
 	Logger::instance()->register_client(logger_client_);
 	Progress::set_client(progress_client_);
-        state_buffer_size_    =
-            CmdLine::arg_is_declared("gui:undo_depth") ?
-            CmdLine::get_arg_uint("gui:undo_depth")    : 0;
-        state_buffer_begin_   = 0;
-        state_buffer_end_     = 0;
-        state_buffer_current_ = 0;
-        undo_redo_called_ = false;
         started_callback_called_ = false;
     }
 
     ApplicationBase::~ApplicationBase() {
-
-        // Cleanup saved states for undo and redo
-        if(Environment::instance()->get_value("gui:undo") == "true") {
-            for(index_t i=0; i<state_buffer_size_; ++i) {
-                std::string filename = state_buffer_filename(i);
-                if(FileSystem::is_file(filename)) {
-                    FileSystem::delete_file(filename);
-                }
-            }
-        }
-
         geo_assert(instance_ == this);
 	if(logger_client_ != nullptr) {
 	    Logger::instance()->unregister_client(logger_client_);
@@ -199,101 +182,54 @@ namespace OGF {
     }
 
 
-    void ApplicationBase::save_state_to_file(const std::string& filename) {
+    UndoStore* ApplicationBase::undo_store() const {
         if(Environment::instance()->get_value("gui:undo") != "true") {
-            return;
-        }
-        // If latest command is undo or redo, state is already saved
-        if(undo_redo_called_) {
-            undo_redo_called_ = false;
-            return;
-        }
-
-        Object* scene_graph = interpreter()->resolve_object("scene_graph");
-        if(scene_graph != nullptr) {
-            ArgList args;
-            args.create_arg("value",filename);
-            scene_graph->invoke_method("save", args);
+            return nullptr;
         }
-    }
-
-    void ApplicationBase::load_state_from_file(const std::string& filename) {
-        if(Environment::instance()->get_value("gui:undo") != "true") {
-            return;
-        }
-        if(!FileSystem::is_file(filename)) {
-            Logger::err("App") << "No saved state to restore"
-                               << std::endl;
-            return;
-        }
-
-        Object* scene_graph = interpreter()->resolve_object("scene_graph");
-        if(scene_graph != nullptr) {
-            ArgList args;
-            scene_graph->invoke_method("clear",args);
-            args.create_arg("value",filename);
-            scene_graph->invoke_method("load_object", args);
-        }
-    }
-
-    std::string ApplicationBase::state_buffer_filename(index_t i) const {
-        return String::format("graphite_state_%02d.graphite",int(i));
+        SceneGraph* scene_graph = dynamic_cast<SceneGraph*>(
+            interpreter_->resolve_object("scene_graph")
+        );
+        return (scene_graph == nullptr) ? nullptr :
+                                          scene_graph->get_undo_store();
     }
 
     bool ApplicationBase::get_can_undo() const {
-        return (state_buffer_current_ != state_buffer_begin_);
+        UndoStore* store = undo_store();
+        return (store != nullptr && store->get_can_undo());
     }
 
     bool ApplicationBase::get_can_redo() const {
-        return (state_buffer_current_ != state_buffer_end_);
+        UndoStore* store = undo_store();
+        return (store != nullptr && store->get_can_redo());
     }
 
-
     void ApplicationBase::save_state() {
-        if(Environment::instance()->get_value("gui:undo") != "true") {
+        UndoStore* store = undo_store();
+        if(store == nullptr) {
             return;
         }
-
-        save_state_to_file(state_buffer_filename(state_buffer_current_));
-        state_buffer_current_ = (state_buffer_current_ + 1) % state_buffer_size_;
-        state_buffer_end_ = state_buffer_current_;
-        if(state_buffer_current_ == state_buffer_begin_) {
-            state_buffer_begin_ = (state_buffer_begin_+1) % state_buffer_size_;
+        // Preferences may have been changed since last time.
+        if(CmdLine::arg_is_declared("gui:undo_depth")) {
+            store->set_max_states(CmdLine::get_arg_uint("gui:undo_depth"));
+        }
+        if(CmdLine::arg_is_declared("gui:undo_memory")) {
+            store->set_memory_budget(CmdLine::get_arg_uint("gui:undo_memory"));
         }
+        store->save_state();
     }
 
     void ApplicationBase::undo() {
-        if(Environment::instance()->get_value("gui:undo") != "true") {
-            return;
-        }
-        if(!get_can_undo()) {
-            return;
+        UndoStore* store = undo_store();
+        if(store != nullptr) {
+            store->undo();
         }
-
-
-        // Make it possible to call redo()
-        if(state_buffer_current_ == state_buffer_end_) {
-            save_state_to_file(state_buffer_filename(state_buffer_current_));
-        }
-
-        state_buffer_current_ =
-            (state_buffer_current_ + state_buffer_size_ - 1) %
-            state_buffer_size_;
-
-        load_state_from_file(state_buffer_filename(state_buffer_current_));
-        undo_redo_called_ = true;
     }
 
     void ApplicationBase::redo() {
-        if(Environment::instance()->get_value("gui:undo") != "true") {
-            return;
-        }
-        if(!get_can_redo()) {
-            return;
+        UndoStore* store = undo_store();
+        if(store != nullptr) {
+            store->redo();
         }
-        state_buffer_current_ = (state_buffer_current_ + 1) % state_buffer_size_;
-        load_state_from_file(state_buffer_filename(state_buffer_current_));
-        undo_redo_called_ = true;
     }
 
     void ApplicationBase::progress_cancel() {
@@ -50,6 +50,8 @@
 
 namespace OGF {
 
+    class UndoStore;
+
     /**
      * \brief Base class for Application.
      * \details Contains all the toolkit-independent
@@ -366,26 +368,11 @@ namespace OGF {
     protected:
 
         /**
-         * \brief Saves Graphite state to a file.
+         * \brief Gets the UndoStore used by undo() and redo().
+         * \return a pointer to the UndoStore of the SceneGraph, or nullptr
+         *  if undo is deactivated (gui:undo) or if there is no SceneGraph
          */
-        virtual void save_state_to_file(const std::string& filename);
-
-        /**
-         * \brief Saves Graphite state to a file.
-         */
-        virtual void load_state_from_file(const std::string& filename);
-
-
-        /**
-         * \brief Gets the file name to be used to store a state buffer.
-         * \details Used by undo() / redo(). State buffers are stored
-         *  as .graphite files, that store the scene graph and the
-         *  complete state of Graphite.
-         * \param[in] i the index of the state buffer
-         * \return the file name to be used to store or retreive the
-         *  state buffer.
-         */
-        std::string state_buffer_filename(index_t i) const;
+        UndoStore* undo_store() const;
 
 
 	/**
@@ -468,12 +455,6 @@ namespace OGF {
         ProgressClient_var progress_client_;
         std::string tooltip_;
 
-        index_t state_buffer_begin_;
-        index_t state_buffer_end_;
-        index_t state_buffer_size_;
-        index_t state_buffer_current_;
-        bool undo_redo_called_;
-
         static ApplicationBase* instance_;
 	static bool stopping_;
         bool started_callback_called_;
@@ -36,13 +36,527 @@
 
 #include <OGF/scene_graph/types/geofile.h>
 
+#include <geogram/basic/file_system.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/string.h>
+#include <geogram/basic/stopwatch.h>
+
+// Note: zlib is included by geogram/basic/geofile.h
+
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <exception>
+
+namespace {
+    using namespace OGF;
+
+    const char block_file_magic[8] = {'G','R','P','H','B','L','K','S'};
+
+    /**
+     * \brief The revision of the block-compressed format written by
+     *  this version.
+     */
+    const Numeric::uint32 block_file_revision = 2;
+
+    /**
+     * \brief The size of the header of block-compressed files.
+     * \details magic, revision, compression level, block size,
+     *  uncompressed size and number of blocks.
+     */
+    const Numeric::uint64 block_file_header_size = 8 + 4 + 4 + 8 + 8 + 8;
+
+    /**
+     * \brief The maximum size of the (uncompressed) blocks.
+     * \details Used to reject corrupted headers before allocating
+     *  memory for the blocks.
+     */
+    const Numeric::uint64 max_block_size = 64*1024*1024;
+
+    /**
+     * \brief Tests whether a .graphite file uses the ASCII GeoFile format.
+     * \details ASCII files are not block-compressed.
+     */
+    bool is_ascii_file(const std::string& filename) {
+        return String::string_ends_with(filename, "_ascii");
+    }
+
+    /**
+     * \brief Generates the name of a temporary uncompressed .graphite file.
+     * \param[in] prefix the beginning of the file name
+     * \return a file name that starts with \p prefix, that is unique
+     *  to this process, and that has the .graphite extension
+     */
+    std::string temp_graphite_file_name(const std::string& prefix) {
+        static std::atomic<unsigned int> counter(0);
+        return prefix + String::format(
+            "%llx_%u.graphite",
+            (unsigned long long)(
+                std::chrono::system_clock::now().time_since_epoch().count()
+            ),
+            (unsigned int)(counter++)
+        );
+    }
+
+    /**
+     * \brief Gets a directory where temporary files can be created.
+     * \details Uses the system temporary directory (TMPDIR, TEMP or TMP
+     *  environment variables, or /tmp), and the directory of \p filename
+     *  if there is none, so that it does not depend on the current
+     *  working directory, that may be read-only.
+     * \param[in] filename the name of the file being processed
+     * \return the name of the directory, without trailing '/'
+     */
+    std::string temp_directory(const std::string& filename) {
+        static const char* variables[] = { "TMPDIR", "TEMP", "TMP" };
+        for(const char* variable : variables) {
+            const char* value = ::getenv(variable);
+            if(value != nullptr && FileSystem::is_directory(value)) {
+                return std::string(value);
+            }
+        }
+#ifndef GEO_OS_WINDOWS
+        if(FileSystem::is_directory("/tmp")) {
+            return std::string("/tmp");
+        }
+#endif
+        std::string result = FileSystem::dir_name(filename);
+        return (result == "") ? std::string(".") : result;
+    }
+
+    /**
+     * \brief Replaces a file with another one.
+     * \param[in] from the name of the new file, deleted on success
+     * \param[in] to the name of the file to be replaced
+     * \throw GeoFileException if the file could not be replaced
+     */
+    void replace_file(const std::string& from, const std::string& to) {
+        // rename() replaces the file atomically under POSIX systems. Under
+        // Windows, it fails if the target exists, then the target is
+        // deleted before retrying.
+        if(FileSystem::rename_file(from, to)) {
+            return;
+        }
+        if(FileSystem::is_file(to) && FileSystem::delete_file(to) &&
+           FileSystem::rename_file(from, to)
+        ) {
+            return;
+        }
+        throw GeoFileException("Could not replace file: " + to);
+    }
+
+    template <class T> void write_value(std::ofstream& out, T x) {
+        out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+    }
+
+    template <class T> T read_value(std::ifstream& in) {
+        T result = T(0);
+        in.read(reinterpret_cast<char*>(&result), sizeof(T));
+        return result;
+    }
+
+    /**
+     * \brief Gets the number of blocks processed in parallel.
+     * \details Blocks are processed by batches, so that memory
+     *  consumption does not depend on the size of the file.
+     */
+    index_t blocks_per_batch() {
+        return std::max(index_t(1), 2*Process::maximum_concurrent_threads());
+    }
+
+    /**
+     * \brief Displays the (wall-clock) throughput of block compression
+     *  or decompression.
+     * \param[in] what "compressed" or "uncompressed"
+     * \param[in] raw_size the uncompressed size in bytes
+     * \param[in] elapsed the elapsed time in seconds
+     */
+    void log_throughput(
+        const char* what, Numeric::uint64 raw_size, double elapsed
+    ) {
+        double mb = double(raw_size) / (1024.0 * 1024.0);
+        Logger::out("GeoFile")
+            << what << " " << String::format("%.2f", mb) << " Mb in "
+            << String::format("%.3f", elapsed) << "s ("
+            << String::format("%.1f", elapsed > 0.0 ? mb / elapsed : 0.0)
+            << " Mb/s)" << std::endl;
+    }
+
+    /**
+     * \brief Writes the header, the block table and the compressed blocks
+     *  of a block-compressed file.
+     * \param[in] in the uncompressed file
+     * \param[in] out the block-compressed file
+     * \param[in] from the name of the uncompressed file
+     * \param[in] to the name of the block-compressed file
+     * \param[in] raw_size the size of the uncompressed file
+     * \param[in] compression_level the zlib compression level
+     * \param[in] block_size the size of the uncompressed blocks
+     * \throw GeoFileException if a file could not be read or written
+     */
+    void write_blocks(
+        std::ifstream& in, std::ofstream& out,
+        const std::string& from, const std::string& to,
+        Numeric::uint64 raw_size,
+        index_t compression_level, size_t block_size
+    ) {
+        Numeric::uint64 nb_blocks = (raw_size + block_size - 1) / block_size;
+
+        out.write(block_file_magic, sizeof(block_file_magic));
+        write_value(out, block_file_revision);
+        write_value(out, Numeric::uint32(compression_level));
+        write_value(out, Numeric::uint64(block_size));
+        write_value(out, raw_size);
+        write_value(out, nb_blocks);
+
+        // Block table: offset and compressed size of each block. It is
+        // written once all the blocks are compressed.
+        std::streamoff table_offset = out.tellp();
+        std::vector<Numeric::uint64> table(2*nb_blocks, 0);
+        out.write(
+            reinterpret_cast<const char*>(table.data()),
+            std::streamsize(table.size() * sizeof(Numeric::uint64))
+        );
+
+        index_t batch_size = blocks_per_batch();
+        std::vector< std::vector<Numeric::uint8> > raw(batch_size);
+        std::vector< std::vector<Numeric::uint8> > packed(batch_size);
+        std::vector<int> status(batch_size);
+
+        for(Numeric::uint64 b0=0; b0<nb_blocks; b0+=batch_size) {
+            index_t n = index_t(
+                std::min(Numeric::uint64(batch_size), nb_blocks - b0)
+            );
+            for(index_t i=0; i<n; ++i) {
+                Numeric::uint64 b = b0 + i;
+                raw[i].resize(
+                    size_t(std::min(
+                        Numeric::uint64(block_size), raw_size - b*block_size
+                    ))
+                );
+                in.read(
+                    reinterpret_cast<char*>(raw[i].data()),
+                    std::streamsize(raw[i].size())
+                );
+            }
+            if(!in) {
+                throw GeoFileException("Could not read file: " + from);
+            }
+            parallel_for(
+                0, n,
+                [&](index_t i) {
+                    uLongf packed_size = compressBound(uLong(raw[i].size()));
+                    packed[i].resize(size_t(packed_size));
+                    status[i] = compress2(
+                        packed[i].data(), &packed_size,
+                        raw[i].data(), uLong(raw[i].size()),
+                        int(compression_level)
+                    );
+                    packed[i].resize(size_t(packed_size));
+                }
+            );
+            for(index_t i=0; i<n; ++i) {
+                if(status[i] != Z_OK) {
+                    throw GeoFileException(
+                        "Could not compress block of file: " + to
+                    );
+                }
+                Numeric::uint64 b = b0 + i;
+                table[2*b]   = Numeric::uint64(out.tellp());
+                table[2*b+1] = Numeric::uint64(packed[i].size());
+                out.write(
+                    reinterpret_cast<const char*>(packed[i].data()),
+                    std::streamsize(packed[i].size())
+                );
+            }
+        }
+
+        out.seekp(table_offset);
+        out.write(
+            reinterpret_cast<const char*>(table.data()),
+            std::streamsize(table.size() * sizeof(Numeric::uint64))
+        );
+        if(!out) {
+            throw GeoFileException("Could not write file: " + to);
+        }
+    }
+}
+
 namespace OGF {
-    
+
+    /*************************************************************/
+
+    bool GraphiteFileBlocks::is_block_file(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        if(!in) {
+            return false;
+        }
+        char magic[sizeof(block_file_magic)];
+        in.read(magic, sizeof(magic));
+        return in && std::equal(
+            magic, magic + sizeof(magic), block_file_magic
+        );
+    }
+
+    void GraphiteFileBlocks::compress(
+        const std::string& from, const std::string& to,
+        index_t compression_level, size_t block_size
+    ) {
+        double start = Stopwatch::now();
+        std::ifstream in(from, std::ios::binary);
+        if(!in) {
+            throw GeoFileException("Could not open file: " + from);
+        }
+        in.seekg(0, std::ios::end);
+        Numeric::uint64 raw_size = Numeric::uint64(in.tellg());
+        in.seekg(0, std::ios::beg);
+        if(block_size == 0 || block_size > max_block_size) {
+            throw GeoFileException(
+                "Invalid block size: " + String::to_string(block_size)
+            );
+        }
+
+        // The blocks are written to a temporary file next to the target,
+        // that replaces it only once completely written, so that a failure
+        // does not leave a truncated file in place of the previous one.
+        std::string temp_file_name = temp_graphite_file_name(to + "_");
+        std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+        if(!out) {
+            throw GeoFileException("Could not create file: " + temp_file_name);
+        }
+        try {
+            write_blocks(
+                in, out, from, to, raw_size, compression_level, block_size
+            );
+        } catch(...) {
+            out.close();
+            FileSystem::delete_file(temp_file_name);
+            throw;
+        }
+        out.close();
+        if(!out) {
+            FileSystem::delete_file(temp_file_name);
+            throw GeoFileException("Could not write file: " + to);
+        }
+        try {
+            replace_file(temp_file_name, to);
+        } catch(...) {
+            FileSystem::delete_file(temp_file_name);
+            throw;
+        }
+        log_throughput("compressed", raw_size, Stopwatch::now() - start);
+    }
+
+    void GraphiteFileBlocks::uncompress(
+        const std::string& from, const std::string& to
+    ) {
+        double start = Stopwatch::now();
+        std::ifstream in(from, std::ios::binary);
+        if(!in) {
+            throw GeoFileException("Could not open file: " + from);
+        }
+        in.seekg(0, std::ios::end);
+        Numeric::uint64 file_size = Numeric::uint64(in.tellg());
+        in.seekg(0, std::ios::beg);
+        char magic[sizeof(block_file_magic)];
+        in.read(magic, sizeof(magic));
+        if(
+            !in || !std::equal(magic, magic + sizeof(magic), block_file_magic)
+        ) {
+            throw GeoFileException(from + ": not a block-compressed file");
+        }
+        Numeric::uint32 revision = read_value<Numeric::uint32>(in);
+        if(revision > block_file_revision) {
+            throw GeoFileException(
+                from + ": file format revision " + String::to_string(revision)
+                + " is not supported (file written by a newer version)"
+            );
+        }
+        read_value<Numeric::uint32>(in); // compression level
+        Numeric::uint64 block_size = read_value<Numeric::uint64>(in);
+        Numeric::uint64 raw_size = read_value<Numeric::uint64>(in);
+        Numeric::uint64 nb_blocks = read_value<Numeric::uint64>(in);
+        // The values read from the header are checked against the size
+        // of the file before being used to allocate memory, so that a
+        // corrupted file is reported as such.
+        if(
+            !in || block_size == 0 || block_size > max_block_size ||
+            nb_blocks != (raw_size + block_size - 1) / block_size ||
+            nb_blocks > (file_size - block_file_header_size) /
+                        (2*sizeof(Numeric::uint64))
+        ) {
+            throw GeoFileException(from + ": invalid block-compressed file");
+        }
+        std::vector<Numeric::uint64> table(size_t(2*nb_blocks));
+        in.read(
+            reinterpret_cast<char*>(table.data()),
+            std::streamsize(table.size() * sizeof(Numeric::uint64))
+        );
+        if(!in) {
+            throw GeoFileException(from + ": invalid block table");
+        }
+        Numeric::uint64 data_offset = block_file_header_size +
+            2*nb_blocks*sizeof(Numeric::uint64);
+        for(Numeric::uint64 b=0; b<nb_blocks; ++b) {
+            Numeric::uint64 offset = table[2*b];
+            Numeric::uint64 size = table[2*b+1];
+            if(
+                offset < data_offset || size > file_size ||
+                offset > file_size - size
+            ) {
+                throw GeoFileException(from + ": invalid block table");
+            }
+        }
+
+        std::ofstream out(to, std::ios::binary | std::ios::trunc);
+        if(!out) {
+            throw GeoFileException("Could not create file: " + to);
+        }
+
+        index_t batch_size = blocks_per_batch();
+        std::vector< std::vector<Numeric::uint8> > raw(batch_size);
+        std::vector< std::vector<Numeric::uint8> > packed(batch_size);
+        std::vector<int> status(batch_size);
+
+        for(Numeric::uint64 b0=0; b0<nb_blocks; b0+=batch_size) {
+            index_t n = index_t(
+                std::min(Numeric::uint64(batch_size), nb_blocks - b0)
+            );
+            for(index_t i=0; i<n; ++i) {
+                Numeric::uint64 b = b0 + i;
+                packed[i].resize(size_t(table[2*b+1]));
+                in.seekg(std::streamoff(table[2*b]));
+                in.read(
+                    reinterpret_cast<char*>(packed[i].data()),
+                    std::streamsize(packed[i].size())
+                );
+                raw[i].resize(
+                    size_t(std::min(block_size, raw_size - b*block_size))
+                );
+            }
+            if(!in) {
+                throw GeoFileException("Could not read file: " + from);
+            }
+            parallel_for(
+                0, n,
+                [&](index_t i) {
+                    uLongf raw_block_size = uLongf(raw[i].size());
+                    status[i] = ::uncompress(
+                        raw[i].data(), &raw_block_size,
+                        packed[i].data(), uLong(packed[i].size())
+                    );
+                    if(
+                        status[i] == Z_OK &&
+                        size_t(raw_block_size) != raw[i].size()
+                    ) {
+                        status[i] = -1;
+                    }
+                }
+            );
+            for(index_t i=0; i<n; ++i) {
+                if(status[i] != Z_OK) {
+                    throw GeoFileException(from + ": corrupted block");
+                }
+                out.write(
+                    reinterpret_cast<const char*>(raw[i].data()),
+                    std::streamsize(raw[i].size())
+                );
+            }
+        }
+        if(!out) {
+            throw GeoFileException("Could not write file: " + to);
+        }
+        log_throughput("uncompressed", raw_size, Stopwatch::now() - start);
+    }
+
+    /*************************************************************/
+
+    GraphiteFileUnpacker::GraphiteFileUnpacker(
+        const std::string& filename
+    ) : geofile_name_(filename) {
+        if(is_ascii_file(filename) ||
+           !GraphiteFileBlocks::is_block_file(filename)
+        ) {
+            return;
+        }
+        temp_file_name_ = temp_graphite_file_name(
+            temp_directory(filename) + "/graphite_unpack_"
+        );
+        try {
+            GraphiteFileBlocks::uncompress(filename, temp_file_name_);
+        } catch(...) {
+            FileSystem::delete_file(temp_file_name_);
+            throw;
+        }
+        geofile_name_ = temp_file_name_;
+    }
+
+    GraphiteFileUnpacker::~GraphiteFileUnpacker() {
+        if(temp_file_name_ != "") {
+            FileSystem::delete_file(temp_file_name_);
+        }
+    }
+
+    /*************************************************************/
+
+    GraphiteFilePacker::GraphiteFilePacker(
+        const std::string& filename, index_t compression_level
+    ) : filename_(filename),
+        geofile_name_(filename),
+        compression_level_(compression_level),
+        nb_uncaught_exceptions_(std::uncaught_exceptions()),
+        packed_(false) {
+        if(is_ascii_file(filename) || compression_level == 0) {
+            return;
+        }
+        temp_file_name_ = temp_graphite_file_name(filename + "_");
+        geofile_name_ = temp_file_name_;
+    }
+
+    GraphiteFilePacker::~GraphiteFilePacker() {
+        if(packed_ || temp_file_name_ == "") {
+            return;
+        }
+        // Do not replace the file with an incomplete one if writing
+        // failed. Errors cannot be reported to the caller from here,
+        // this is why OutputGraphiteFile::close() should be used.
+        if(std::uncaught_exceptions() == nb_uncaught_exceptions_) {
+            try {
+                GraphiteFileBlocks::compress(
+                    temp_file_name_, filename_, compression_level_
+                );
+            } catch(const std::exception& e) {
+                Logger::err("GeoFile") << e.what() << std::endl;
+            }
+        }
+        FileSystem::delete_file(temp_file_name_);
+    }
+
+    void GraphiteFilePacker::pack() {
+        if(packed_) {
+            return;
+        }
+        packed_ = true;
+        if(temp_file_name_ == "") {
+            return;
+        }
+        try {
+            GraphiteFileBlocks::compress(
+                temp_file_name_, filename_, compression_level_
+            );
+        } catch(...) {
+            FileSystem::delete_file(temp_file_name_);
+            throw;
+        }
+        FileSystem::delete_file(temp_file_name_);
+    }
+
     /*************************************************************/
     
     InputGraphiteFile::InputGraphiteFile(
         const std::string& filename
-    ) : InputGeoFile(filename) {
+    ) : GraphiteFileUnpacker(filename), InputGeoFile(geofile_name()) {
     }
 
     void InputGraphiteFile::read_scene_graph_header(ArgList& args) {
@@ -84,7 +598,26 @@ namespace OGF {
 
     OutputGraphiteFile::OutputGraphiteFile(
         const std::string& filename, index_t compression_level
-    ) : OutputGeoFile(filename, compression_level) {
+    ) : GraphiteFilePacker(filename, compression_level),
+        OutputGeoFile(geofile_name(), geofile_compression_level()) {
+    }
+
+    void OutputGraphiteFile::close() {
+        if(file_ != nullptr) {
+            gzFile file = file_;
+            file_ = nullptr;
+            if(gzclose(file) != Z_OK) {
+                throw GeoFileException("Could not close file: " + GeoFile::filename_);
+            }
+        }
+        if(ascii_file_ != nullptr) {
+            FILE* file = ascii_file_;
+            ascii_file_ = nullptr;
+            if(fclose(file) != 0) {
+                throw GeoFileException("Could not close file: " + GeoFile::filename_);
+            }
+        }
+        pack();
     }
 
 
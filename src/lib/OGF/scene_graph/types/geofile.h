@@ -50,6 +50,178 @@ namespace OGF {
 
     /***************************************************************/
 
+    /**
+     * \brief Block-compressed container used by .graphite files.
+     * \details Revision 2 of the .graphite file format. The GeoFile
+     *  stream is split into blocks of fixed size, that are compressed
+     *  independently, by all the cores, and indexed by a block table:
+     *  - header: magic "GRPHBLKS", revision, compression level,
+     *    block size, uncompressed size and number of blocks
+     *    (32 bits and 64 bits native integers)
+     *  - block table: for each block, its offset in the file and its
+     *    compressed size
+     *  - the blocks, compressed with zlib
+     *
+     *  Files written by previous versions, that store the GeoFile
+     *  stream as a single gzip stream, do not have the magic, and are
+     *  read directly by InputGeoFile.
+     */
+    class SCENE_GRAPH_API GraphiteFileBlocks {
+    public:
+        /**
+         * \brief Default size of the (uncompressed) blocks.
+         */
+        static const size_t DEFAULT_BLOCK_SIZE = 4*1024*1024;
+
+        /**
+         * \brief Tests whether a file uses the block-compressed format.
+         * \param[in] filename the name of the file
+         * \retval true if the file starts with the magic of
+         *  block-compressed files
+         * \retval false otherwise
+         */
+        static bool is_block_file(const std::string& filename);
+
+        /**
+         * \brief Compresses a file.
+         * \details Blocks are compressed in parallel. They are written to
+         *  a temporary file in the same directory as \p to, that replaces
+         *  \p to only once it is complete, hence an existing file is left
+         *  untouched if an error occurs.
+         * \param[in] from the name of the file to be compressed
+         * \param[in] to the name of the block-compressed file
+         * \param[in] compression_level the zlib compression level, in
+         *  1 (fastest) ... 9 (smallest)
+         * \param[in] block_size the size of the uncompressed blocks, at
+         *  most 64 Mb
+         * \throw GeoFileException if a file could not be read or written,
+         *  or if \p block_size is invalid
+         */
+        static void compress(
+            const std::string& from, const std::string& to,
+            index_t compression_level,
+            size_t block_size = DEFAULT_BLOCK_SIZE
+        );
+
+        /**
+         * \brief Uncompresses a file.
+         * \details Blocks are uncompressed in parallel. The header and the
+         *  block table are checked against the size of the file before
+         *  anything is allocated.
+         * \param[in] from the name of the block-compressed file
+         * \param[in] to the name of the uncompressed file
+         * \throw GeoFileException if a file could not be read or written,
+         *  or if \p from is not a valid block-compressed file
+         */
+        static void uncompress(const std::string& from, const std::string& to);
+    };
+
+    /**
+     * \brief Uncompresses a block-compressed .graphite file to a
+     *  temporary file before it is opened by InputGraphiteFile.
+     * \details It is a base class of InputGraphiteFile, constructed before
+     *  and destroyed after InputGeoFile. The temporary file is created in
+     *  the system temporary directory (the current working directory may
+     *  be read-only), and deleted once InputGeoFile closed it.
+     */
+    class SCENE_GRAPH_API GraphiteFileUnpacker {
+    protected:
+        /**
+         * \brief GraphiteFileUnpacker constructor.
+         * \param[in] filename the name of the .graphite file
+         * \throw GeoFileException if the file could not be uncompressed
+         */
+        GraphiteFileUnpacker(const std::string& filename);
+
+        /**
+         * \brief GraphiteFileUnpacker destructor.
+         * \details Deletes the temporary file.
+         */
+        ~GraphiteFileUnpacker();
+
+        /**
+         * \brief Gets the name of the file to be read by InputGeoFile.
+         * \return the temporary file if the file is block-compressed, or
+         *  the file itself otherwise
+         */
+        const std::string& geofile_name() const {
+            return geofile_name_;
+        }
+
+    private:
+        std::string geofile_name_;
+        std::string temp_file_name_;
+    };
+
+    /**
+     * \brief Compresses a .graphite file by blocks once it is written.
+     * \details It is a base class of OutputGraphiteFile, constructed before
+     *  and destroyed after OutputGeoFile. OutputGeoFile writes an
+     *  uncompressed temporary file, that is compressed to the
+     *  .graphite file once OutputGeoFile closed it.
+     */
+    class SCENE_GRAPH_API GraphiteFilePacker {
+    protected:
+        /**
+         * \brief GraphiteFilePacker constructor.
+         * \param[in] filename the name of the .graphite file
+         * \param[in] compression_level the zlib compression level, 0 means
+         *  uncompressed
+         */
+        GraphiteFilePacker(
+            const std::string& filename, index_t compression_level
+        );
+
+        /**
+         * \brief GraphiteFilePacker destructor.
+         * \details If pack() was not called, compresses the temporary
+         *  file, unless the destructor is called because an exception
+         *  was thrown, then deletes it. Errors can only be logged, use
+         *  pack() to have them reported.
+         */
+        ~GraphiteFilePacker();
+
+        /**
+         * \brief Compresses the temporary file to the .graphite file and
+         *  deletes it.
+         * \details Does nothing if it was already called, or if the file
+         *  is not block-compressed.
+         * \pre the temporary file is closed
+         * \throw GeoFileException if the file could not be compressed, then
+         *  the previous .graphite file (if any) is left untouched
+         */
+        void pack();
+
+        /**
+         * \brief Gets the name of the file to be written by OutputGeoFile.
+         * \return the temporary file if the file is block-compressed, or
+         *  the file itself otherwise (ASCII files, no compression)
+         */
+        const std::string& geofile_name() const {
+            return geofile_name_;
+        }
+
+        /**
+         * \brief Gets the compression level to be used by OutputGeoFile.
+         * \return 0 if the file is block-compressed (then OutputGeoFile
+         *  writes an uncompressed temporary file), or the compression
+         *  level otherwise
+         */
+        index_t geofile_compression_level() const {
+            return temp_file_name_ == "" ? compression_level_ : 0;
+        }
+
+    private:
+        std::string filename_;
+        std::string geofile_name_;
+        std::string temp_file_name_;
+        index_t compression_level_;
+        int nb_uncaught_exceptions_;
+        bool packed_;
+    };
+
+    /***************************************************************/
+
     /**
      * \brief An extension of InputGeoFile for storing a complete 
      *  Graphite scenegraph in a structured binary file.
@@ -63,8 +235,12 @@ namespace OGF {
      *   a grob (name and classname)
      *  - SHDR (Shader): an ArgList with the attributes that define a shader
      *   attached to a grob (classname and all the properties)
+     *
+     *  Both block-compressed files (see GraphiteFileBlocks) and files
+     *  written by previous versions can be read.
      */
-    class SCENE_GRAPH_API InputGraphiteFile : public InputGeoFile {
+    class SCENE_GRAPH_API InputGraphiteFile :
+        private GraphiteFileUnpacker, public InputGeoFile {
     public:
         /**
          * \copydoc InputGeoFile::InputGeoFile()
@@ -125,8 +301,13 @@ namespace OGF {
      *   a grob (name and classname)
      *  - SHDR (Shader): an ArgList with the attributes that define a shader
      *   attached to a grob (classname and all the properties)
+     *
+     *  Binary files are block-compressed (see GraphiteFileBlocks), when
+     *  close() is called or when the OutputGraphiteFile is destroyed. Only
+     *  close() reports errors to the caller.
      */
-    class SCENE_GRAPH_API OutputGraphiteFile : public OutputGeoFile {
+    class SCENE_GRAPH_API OutputGraphiteFile :
+        private GraphiteFilePacker, public OutputGeoFile {
     public:
         /**
          * \copydoc OutputGeoFile::OutputGeoFile()
@@ -135,6 +316,15 @@ namespace OGF {
             const std::string& filename, index_t compression_level=3
         );
 
+        /**
+         * \brief Closes the file.
+         * \details Finishes writing the file, and compresses it by blocks.
+         *  Nothing can be written to the file afterwards.
+         * \throw GeoFileException if the file could not be written, then
+         *  the previous file (if any) is left untouched
+         */
+        void close();
+
         /**
          * \brief Writes the commands history into the geofile.
          * \param[in] history a vector of strings with the history
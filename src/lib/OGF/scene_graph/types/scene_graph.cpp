@@ -43,6 +43,7 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/reflection/meta_class.h>
 #include <OGF/gom/services/factory.h>
+#include <OGF/gom/types/callable.h>
 #include <OGF/gom/interpreter/interpreter.h>
 #include <OGF/basic/os/file_manager.h>
 #include <OGF/basic/os/text_utils.h>
@@ -51,9 +52,27 @@
 #include <geogram/basic/file_system.h>
 #include <geogram/basic/stopwatch.h>
 #include <geogram/basic/command_line.h>
+#include <geogram/basic/process.h>
 
 #include <sstream>
 
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Gets the name of the object loaded from a file.
+     * \param[in] file_name the name of the file
+     * \return the base name of the file, without extension
+     *  (and without .gz extension for compressed files)
+     */
+    std::string grob_name_from_file(const std::string& file_name) {
+        std::string result = FileSystem::base_name(file_name);
+        if(FileSystem::extension(file_name) == "gz") {
+            result = FileSystem::base_name(result);
+        }
+        return result;
+    }
+}
 
 namespace OGF {
 
@@ -66,7 +85,14 @@ namespace OGF {
             Interpreter::default_interpreter()
         ),
 	render_area_(nullptr),
-	application_(nullptr) {
+	application_(nullptr),
+        nb_update_transactions_(0),
+        flushing_updates_(false),
+        update_pending_(false),
+        update_values_pending_(false),
+        values_dirty_(true),
+        visibilities_dirty_(true),
+        types_dirty_(true) {
         Grob::scene_graph_ = this;
         SceneGraphLibrary::instance()->set_scene_graph(this, transfer_ownership);
     }
@@ -84,6 +110,13 @@ namespace OGF {
 	return scene_graph_shader_manager_;
     }
 
+    UndoStore* SceneGraph::get_undo_store() const {
+        if(undo_store_.is_null()) {
+            undo_store_ = new UndoStore(const_cast<SceneGraph*>(this));
+        }
+        return undo_store_;
+    }
+
     void SceneGraph::set_visibility(index_t index, bool value) {
         Grob* g = ith_child(index);
         if(g != nullptr) {
@@ -100,6 +133,7 @@ namespace OGF {
     }
 
     void SceneGraph::set_visibilities(const std::string& x) {
+        UpdateTransaction transaction(this);
         std::vector< std::string > values;
         String::split_string( x, ';', values );
         for( index_t i = 0; i < get_nb_children(); i++ ) {
@@ -113,37 +147,165 @@ namespace OGF {
     }
 
     std::string SceneGraph::get_visibilities() const {
-        std::string result;
-        for(index_t i=0; i<get_nb_children(); i++) {
-            Grob* g = ith_child(i);
-            if(g != nullptr) {
-                if(result.length() != 0) {
-                    result += ";";
+        if(visibilities_dirty_) {
+            visibilities_.clear();
+            for(index_t i=0; i<get_nb_children(); i++) {
+                Grob* g = ith_child(i);
+                if(g != nullptr) {
+                    if(visibilities_.length() != 0) {
+                        visibilities_ += ";";
+                    }
+                    visibilities_ += (g->get_visible() ? "true" : "false");
                 }
-                result = result + (g->get_visible() ? "true" : "false");
             }
+            visibilities_dirty_ = false;
         }
-        return result;
+        return visibilities_;
     }
 
     std::string SceneGraph::get_types() const {
-        std::string result;
-        for(index_t i=0; i<get_nb_children(); i++) {
-            Grob* g = ith_child(i);
-            if(g != nullptr) {
-                if(result.length() != 0) {
-                    result += ";";
+        if(types_dirty_) {
+            types_.clear();
+            for(index_t i=0; i<get_nb_children(); i++) {
+                Grob* g = ith_child(i);
+                if(g != nullptr) {
+                    if(types_.length() != 0) {
+                        types_ += ";";
+                    }
+                    types_ += g->meta_class()->name();
                 }
-                result = result + g->meta_class()->name();
             }
+            types_dirty_ = false;
+        }
+        return types_;
+    }
+
+    Grob* SceneGraph::resolve_id(index_t id) const {
+        Grob* result = dynamic_cast<Grob*>(Object::id_to_object(id));
+        // The object may have been removed from this SceneGraph and
+        // still be referenced elsewhere.
+        if(result == nullptr || resolve(result->name()) != result) {
+            return nullptr;
         }
         return result;
     }
 
+    bool SceneGraph::has_connections(const std::string& signal_name) const {
+        return signal_is_connected(signal_name);
+    }
+
+    void SceneGraph::add_child(Node* child) {
+        CompositeGrob::add_child(child);
+        invalidate_values(true);
+        // Children created by their constructor are named afterwards,
+        // they are reported by child_name_changed().
+        Grob* grob = dynamic_cast<Grob*>(child);
+        if(grob != nullptr && grob->name() != "") {
+            grob_events_.push_back(GrobEvent(GROB_ADDED, grob->id()));
+            pending_added_.insert(grob->id());
+        }
+    }
+
+    void SceneGraph::remove_child(Node* child) {
+        Grob* grob = dynamic_cast<Grob*>(child);
+        if(grob != nullptr) {
+            // An object that was never reported is not reported either
+            // when it is removed.
+            if(pending_added_.erase(grob->id()) == 0) {
+                grob_events_.push_back(
+                    GrobEvent(GROB_REMOVED, grob->id(), grob->name())
+                );
+            }
+        }
+        CompositeGrob::remove_child(child);
+        invalidate_values(true);
+    }
+
+    void SceneGraph::child_name_changed(
+        Grob* child, const std::string& old_name
+    ) {
+        CompositeGrob::child_name_changed(child, old_name);
+        invalidate_values(true);
+        if(pending_added_.find(child->id()) != pending_added_.end()) {
+            // grob_added() will report the new name
+            return;
+        }
+        if(old_name == "") {
+            // First time the child is named (from its constructor):
+            // it is reported by the next update_values(), once it is
+            // completely created.
+            grob_events_.push_back(GrobEvent(GROB_ADDED, child->id()));
+            pending_added_.insert(child->id());
+        } else {
+            grob_events_.push_back(
+                GrobEvent(GROB_RENAMED, child->id(), child->name(), old_name)
+            );
+        }
+    }
+
+    void SceneGraph::grob_visibility_changed_notify(Grob* grob) {
+        invalidate_values(false);
+        if(pending_added_.find(grob->id()) == pending_added_.end()) {
+            grob_events_.push_back(
+                GrobEvent(GROB_VISIBILITY_CHANGED, grob->id())
+            );
+        }
+    }
+
+    void SceneGraph::flush_grob_events(bool added) {
+        if(grob_events_.empty()) {
+            return;
+        }
+        // The slots may change this SceneGraph, and queue other events.
+        std::vector<GrobEvent> events;
+        std::swap(events, grob_events_);
+        for(const GrobEvent& event: events) {
+            switch(event.type) {
+            case GROB_ADDED: {
+                if(!added) {
+                    grob_events_.push_back(event);
+                    break;
+                }
+                if(pending_added_.erase(event.id) == 0) {
+                    break; // removed before being reported
+                }
+                Grob* grob = resolve_id(event.id);
+                if(grob != nullptr) {
+                    grob_added(event.id, grob->name());
+                }
+            } break;
+            case GROB_REMOVED: {
+                grob_removed(event.id, event.name);
+            } break;
+            case GROB_RENAMED: {
+                grob_name_changed(event.id, event.old_name, event.name);
+            } break;
+            case GROB_VISIBILITY_CHANGED: {
+                Grob* grob = resolve_id(event.id);
+                if(grob != nullptr) {
+                    grob_visibility_changed(event.id, grob->get_visible());
+                }
+            } break;
+            }
+        }
+    }
+
     void SceneGraph::update_values() {
-        values_changed(get_values());
-        visibilities_changed(get_visibilities());
-        types_changed(get_types());
+        if(update_is_deferred()) {
+            update_values_pending_ = true;
+            return;
+        }
+        flush_grob_events(true);
+        // The ';'-separated lists are only computed if needed.
+        if(has_connections("values_changed")) {
+            values_changed(get_values());
+        }
+        if(has_connections("visibilities_changed")) {
+            visibilities_changed(get_visibilities());
+        }
+        if(has_connections("types_changed")) {
+            types_changed(get_types());
+        }
         value_changed(this);
         if(this == SceneGraphLibrary::instance()->scene_graph()) {
             SceneGraphLibrary::instance()->
@@ -152,9 +314,85 @@ namespace OGF {
     }
 
     void SceneGraph::update() {
+        if(update_is_deferred()) {
+            update_pending_ = true;
+            return;
+        }
+        flush_grob_events(false);
         value_changed(this);
     }
 
+    bool SceneGraph::defer_grob_update(Grob* grob) {
+        if(!update_is_deferred() || flushing_updates_) {
+            return false;
+        }
+        if(pending_grobs_set_.insert(grob).second) {
+            pending_grobs_.push_back(grob);
+        }
+        return true;
+    }
+
+    void SceneGraph::cancel_grob_update(Grob* grob) {
+        pending_grobs_set_.erase(grob);
+    }
+
+    bool SceneGraph::update_transaction(Callable* body) {
+        if(body == nullptr) {
+            Logger::err("SceneGraph") << "update_transaction(): missing body"
+                                      << std::endl;
+            return false;
+        }
+        UpdateTransaction transaction(this);
+        ArgList args;
+        Any ret_val;
+        return body->invoke(args, ret_val);
+    }
+
+    void SceneGraph::begin_update() {
+        ++nb_update_transactions_;
+    }
+
+    void SceneGraph::end_update() {
+        if(nb_update_transactions_ == 0) {
+            Logger::err("SceneGraph")
+                << "end_update() without matching begin_update()"
+                << std::endl;
+            return;
+        }
+        if(nb_update_transactions_ > 1 || flushing_updates_) {
+            --nb_update_transactions_;
+            return;
+        }
+
+        // Update each pending Grob once. The transaction remains
+        // active for the SceneGraph itself, so that its own events
+        // are triggered only once, below.
+        flushing_updates_ = true;
+        while(!pending_grobs_.empty()) {
+            std::vector<Grob*> grobs;
+            std::swap(grobs, pending_grobs_);
+            for(Grob* grob: grobs) {
+                // Skips the Grobs removed during the transaction.
+                if(pending_grobs_set_.erase(grob) != 0) {
+                    grob->update();
+                }
+            }
+        }
+        pending_grobs_set_.clear();
+        flushing_updates_ = false;
+        nb_update_transactions_ = 0;
+
+        if(update_values_pending_) {
+            update_values_pending_ = false;
+            update_pending_ = false;
+            // update_values() also triggers value_changed()
+            update_values();
+        } else if(update_pending_) {
+            update_pending_ = false;
+            update();
+        }
+    }
+
 
     void SceneGraph::begin_graphite_file(
         OutputGraphiteFile& out, bool all_scene
@@ -169,18 +407,7 @@ namespace OGF {
                 args.create_arg("version", version);
                 args.create_arg("current_object", get_current_object());
 
-		// skin_imgui version
-
-		copy_property_to_arglist("camera.auto_focus",args);
-		copy_property_to_arglist("camera.draw_selected_only",args);
-		copy_property_to_arglist("camera.clipping",args);
-		copy_property_to_arglist("camera.lighting_matrix",args);
-
-		copy_property_to_arglist("xform.u", args);
-		copy_property_to_arglist("xform.v", args);
-		copy_property_to_arglist("xform.w", args);
-		copy_property_to_arglist("xform.zoom", args);
-		copy_property_to_arglist("xform.look_at", args);
+		copy_viewer_properties_to_arglist(args);
 
                 out.write_scene_graph_header(args);
             }
@@ -214,17 +441,20 @@ namespace OGF {
     }
 
     std::string SceneGraph::get_values() const {
-        std::string result;
-        for(index_t i=0; i<get_nb_children(); i++) {
-            Grob* cur = ith_child(i);
-            if(cur != nullptr) {
-                if(result.length() > 0) {
-                    result += ";";
+        if(values_dirty_) {
+            values_.clear();
+            for(index_t i=0; i<get_nb_children(); i++) {
+                Grob* cur = ith_child(i);
+                if(cur != nullptr) {
+                    if(values_.length() > 0) {
+                        values_ += ";";
+                    }
+                    values_ += cur->get_name();
                 }
-                result += cur->get_name();
             }
+            values_dirty_ = false;
         }
-        return result;
+        return values_;
     }
 
     Grob* SceneGraph::duplicate_current() {
@@ -258,6 +488,7 @@ namespace OGF {
             return;
         }
         swap_children(prev, current());
+        invalidate_values(true);
     }
 
     void SceneGraph::move_current_down() {
@@ -275,6 +506,7 @@ namespace OGF {
             return;
         }
         swap_children(next, current());
+        invalidate_values(true);
     }
 
     void SceneGraph::delete_current_object() {
@@ -379,27 +611,13 @@ namespace OGF {
             return this;
         }
 
-        std::string base_name = FileSystem::base_name(file_name);
-        if(extension == "gz") {
-            base_name = FileSystem::base_name(base_name);
-        }
-
+        std::string base_name = grob_name_from_file(file_name);
 
         std::vector<std::string> class_names;
-
-        if(type == "default") {
-            std::string class_name_str =
-                SceneGraphLibrary::instance()->file_extension_to_grob(
-                    extension
-                );
-            String::split_string(class_name_str, ';', class_names);
-            if(class_names.size() == 0) {
-                Logger::err("SceneGraph")
-                    << "invalid extension: " << extension << std::endl;
-                return nullptr;
-            }
-        } else {
-            class_names.push_back(type);
+        if(!get_grob_classes_for_file(file_name, type, class_names)) {
+            Logger::err("SceneGraph")
+                << "invalid extension: " << extension << std::endl;
+            return nullptr;
         }
 
         Grob* result = nullptr;
@@ -428,6 +646,45 @@ namespace OGF {
             }
         }
 
+        record_load_object(file_name, invoked_from_gui);
+        return result;
+    }
+
+    bool SceneGraph::get_grob_classes_for_file(
+        const std::string& file_name, const std::string& type,
+        std::vector<std::string>& class_names
+    ) {
+        class_names.clear();
+        if(type != "default") {
+            class_names.push_back(type);
+            return true;
+        }
+        std::string extension = FileSystem::extension(file_name);
+        std::string class_name_str =
+            SceneGraphLibrary::instance()->file_extension_to_grob(
+                extension
+            );
+        // File extensions are registered when modules are initialized,
+        // the extension may be handled by a module that is not loaded
+        // yet (see ModuleManager::defer_module()).
+        if(
+            class_name_str == "" &&
+            ModuleManager::instance()->load_module_for_registration(
+                "file_extension", extension
+            )
+        ) {
+            class_name_str =
+                SceneGraphLibrary::instance()->file_extension_to_grob(
+                    extension
+                );
+        }
+        String::split_string(class_name_str, ';', class_names);
+        return (class_names.size() != 0);
+    }
+
+    void SceneGraph::record_load_object(
+        const std::string& file_name, bool invoked_from_gui
+    ) {
         if(interpreter() != nullptr) {
             std::ostringstream out;
             out << "scene_graph.load_object(\""
@@ -441,8 +698,6 @@ namespace OGF {
                 FileSystem::set_current_working_directory(dir);
             }
         }
-
-        return result;
     }
 
     void SceneGraph::load_objects(
@@ -451,8 +706,111 @@ namespace OGF {
     ) {
         std::vector<std::string> file_names;
         String::split_string(file_names_str, ';', file_names);
-        for(unsigned int i=0; i<file_names.size(); i++) {
-            load_object(file_names[i],type,invoked_from_gui);
+
+        if(file_names.size() < 2) {
+            for(unsigned int i=0; i<file_names.size(); i++) {
+                load_object(file_names[i],type,invoked_from_gui);
+            }
+            return;
+        }
+
+        UpdateTransaction transaction(this);
+
+        // Step 1: create the objects, in the order of the files, so that
+        // they are named as if the files were loaded one by one. Files
+        // that cannot be read in parallel (scene files, alignment files,
+        // objects that do not support Grob::load_in_thread()) are
+        // loaded here.
+        std::vector<Grob_var> grobs(file_names.size());
+        index_t nb_parallel = 0;
+        for(index_t i=0; i<index_t(file_names.size()); ++i) {
+            std::string& file_name = file_names[i];
+#ifdef GEO_OS_WINDOWS
+            FileSystem::flip_slashes(file_name);
+#endif
+            std::string extension = FileSystem::extension(file_name);
+            std::vector<std::string> class_names;
+            if(
+                !FileSystem::is_file(file_name) ||
+                extension == "aln" ||
+                extension == "graphite" ||
+                extension == "graphite_ascii" ||
+                !get_grob_classes_for_file(file_name, type, class_names)
+            ) {
+                load_object(file_name, type, invoked_from_gui);
+                continue;
+            }
+            disable_signals();
+            Grob* grob = create_object(class_names[0]);
+            enable_signals();
+            if(grob == nullptr) {
+                load_object(file_name, type, invoked_from_gui);
+                continue;
+            }
+            if(!grob->can_load_in_thread()) {
+                set_current_object("", false);
+                remove_child(grob);
+                load_object(file_name, type, invoked_from_gui);
+                continue;
+            }
+            grob->rename(grob_name_from_file(file_name));
+            grob->set_filename(file_name);
+            grobs[i] = grob;
+            ++nb_parallel;
+        }
+
+        if(nb_parallel == 0) {
+            return;
+        }
+
+        // Step 2: read the files in parallel, each one into its object.
+        // The SceneGraph is not modified. The Logger is not thread-safe:
+        // it is silent meanwhile, the loaders serialize the calls that
+        // use it (GrobLoadMessages::logger_mutex()), and the messages of
+        // each file are stored, to be displayed in order in step 3.
+        std::vector<GrobLoadMessages> messages(file_names.size());
+        std::vector<char> loaded(file_names.size(), 0);
+        {
+            Stopwatch W("Load",false);
+            bool quiet = Logger::instance()->is_quiet();
+            Logger::instance()->set_quiet(true);
+            parallel_for(
+                0, index_t(file_names.size()),
+                [&](index_t i) {
+                    if(!grobs[i].is_null()) {
+                        loaded[i] = grobs[i]->load_in_thread(
+                            file_names[i], messages[i]
+                        );
+                    }
+                },
+                1, true // interleaved: files can have very different sizes
+            );
+            Logger::instance()->set_quiet(quiet);
+            Logger::out("SceneGraph")
+                << "Read " << nb_parallel << " file(s) in "
+                << W.elapsed_time() << " s" << std::endl;
+        }
+
+        // Step 3: display the messages and finish loading the objects,
+        // in order.
+        for(index_t i=0; i<index_t(file_names.size()); ++i) {
+            if(grobs[i].is_null()) {
+                continue;
+            }
+            Grob* grob = grobs[i];
+            messages[i].flush("SceneGraph");
+            if(!loaded[i]) {
+                if(current() == grob) {
+                    set_current_object("", false);
+                }
+                remove_child(grob);
+                grobs[i].reset();
+                continue;
+            }
+            grob->end_load_in_thread();
+            grob_created(grob->name());
+            set_current_object(grob->name(),false);
+            record_load_object(file_names[i], invoked_from_gui);
         }
     }
 
@@ -467,11 +825,12 @@ namespace OGF {
                         << std::endl;
                     return false;
                 }
-                OutputGraphiteFile out(std::string(file_name).c_str());
                 try {
+                    OutputGraphiteFile out(std::string(file_name).c_str());
                     begin_graphite_file(out,false);
                     serialize_grob_write(grob,out);
                     end_graphite_file(out);
+                    out.close();
                 } catch(const std::logic_error& e) {
                     Logger::err("GeoFile") << "Caught exception: " << e.what()
                                        << std::endl;
@@ -650,6 +1009,7 @@ namespace OGF {
 	    OutputGraphiteFile out(filename);
 	    begin_graphite_file(out,true);
 	    end_graphite_file(out);
+	    out.close();
 	} catch(const std::logic_error& e) {
 	    Logger::err("I/O") << "Caught exception: " << e.what()
 			       << std::endl;
@@ -791,8 +1151,25 @@ namespace OGF {
         return result;
     }
 
+    void SceneGraph::copy_viewer_properties_to_arglist(
+	ArgList& args, bool warn
+    ) {
+	// skin_imgui version
+
+	copy_property_to_arglist("camera.auto_focus",args,warn);
+	copy_property_to_arglist("camera.draw_selected_only",args,warn);
+	copy_property_to_arglist("camera.clipping",args,warn);
+	copy_property_to_arglist("camera.lighting_matrix",args,warn);
+
+	copy_property_to_arglist("xform.u", args, warn);
+	copy_property_to_arglist("xform.v", args, warn);
+	copy_property_to_arglist("xform.w", args, warn);
+	copy_property_to_arglist("xform.zoom", args, warn);
+	copy_property_to_arglist("xform.look_at", args, warn);
+    }
+
     void SceneGraph::copy_property_to_arglist(
-	const std::string& obj_prop_name, ArgList& args
+	const std::string& obj_prop_name, ArgList& args, bool warn
     ) {
 	std::string obj_name;
 	std::string prop_name;
@@ -803,11 +1180,11 @@ namespace OGF {
 	    std::string prop_val;
 	    if(obj->get_property(prop_name, prop_val)) {
 		args.create_arg(obj_prop_name, prop_val);
-	    } else {
+	    } else if(warn) {
 		Logger::warn("Geofile")
 		    << obj_prop_name << " not found" << std::endl;
 	    }
-	} else {
+	} else if(warn) {
 	    Logger::warn("Geofile") << obj_name << " not found" << std::endl;
 	}
     }
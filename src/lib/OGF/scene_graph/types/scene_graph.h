@@ -40,8 +40,11 @@
 
 #include <OGF/scene_graph/common/common.h>
 #include <OGF/scene_graph/grob/composite_grob.h>
+#include <OGF/scene_graph/types/undo_store.h>
 #include <OGF/gom/types/node.h>
 
+#include <unordered_set>
+
 /**
  * \file OGF/scene_graph/types/scene_graph.h
  * \brief the class that represents the scene graph.
@@ -50,6 +53,7 @@ namespace OGF {
 
     class Grob;
     class RenderingContext;
+    class Callable;
 
 /*************************************************************************/
 
@@ -57,7 +61,13 @@ namespace OGF {
      * \brief Represents the list of objects loaded in Graphite.
      * \details A SceneGraph stores a list of Grob and
      *  manages the associated events. It has a current object,
-     *  that is the target of commands invocation.
+     *  that is the target of commands invocation. Listeners can be
+     *  notified of each individual change (grob_added(), grob_removed(),
+     *  grob_name_changed(), grob_visibility_changed()), that refer to
+     *  the objects by their identifier (Grob::get_id()). The aggregated
+     *  ';'-separated lists (values, visibilities, types) are only
+     *  computed when they are read or when a slot is connected to the
+     *  corresponding signal.
      */
     gom_class SCENE_GRAPH_API SceneGraph : public CompositeGrob {
     public:
@@ -86,9 +96,45 @@ namespace OGF {
         /**
          * \brief Triggers the values_changed(), visibilities_changed(),
          *  types_changed() and value_changed() signals.
+         * \details The pending grob_added(), grob_removed(),
+         *  grob_name_changed() and grob_visibility_changed() signals are
+         *  triggered first. The signals with the ';'-separated lists are
+         *  only triggered if they are connected to a slot.
          */
         void update_values();
 
+        /**
+         * \brief Tests whether the update of a Grob should be deferred.
+         * \details Called by Grob::update(). Within an update transaction,
+         *  the Grob is recorded and updated once when the outermost
+         *  transaction ends.
+         * \param[in] grob a pointer to the Grob
+         * \retval true if the update was deferred, then the caller should
+         *  not trigger any update event
+         * \retval false otherwise
+         * \see begin_update(), end_update(), UpdateTransaction
+         */
+        bool defer_grob_update(Grob* grob);
+
+        /**
+         * \brief Cancels the deferred update of a Grob.
+         * \details Called when a Grob is removed during an update
+         *  transaction, so that it is not updated (nor kept alive) when
+         *  the transaction ends.
+         * \param[in] grob a pointer to the Grob
+         */
+        void cancel_grob_update(Grob* grob);
+
+        /**
+         * \brief Tests whether an update transaction is active.
+         * \retval true if begin_update() was called more times than
+         *  end_update()
+         * \retval false otherwise
+         */
+        bool update_is_deferred() const {
+            return (nb_update_transactions_ != 0);
+        }
+
         /**
          * \copydoc Grob::is_serializable()
          */
@@ -106,6 +152,43 @@ namespace OGF {
 
     gom_slots:
 
+        /**
+         * \brief Starts an update transaction.
+         * \details Until the matching end_update(), calls to Grob::update()
+         *  and to update_values() do not trigger any event. Transactions
+         *  can be nested. In C++, use an UpdateTransaction rather than
+         *  calling this function directly.
+         */
+        void begin_update();
+
+        /**
+         * \brief Ends an update transaction.
+         * \details When the outermost transaction ends, each Grob updated
+         *  during the transaction is updated once, then the SceneGraph
+         *  signals are triggered once.
+         */
+        void end_update();
+
+        /**
+         * \brief Calls a function within an update transaction.
+         * \details This is the scoped version of begin_update() and
+         *  end_update() for scripts: the transaction ends when the
+         *  function returns, also if it fails. For instance, in Lua:
+         * \code
+         *   scene_graph.update_transaction(function()
+         *      for i=1,1000 do E.create_vertex() end
+         *   end)
+         * \endcode
+         *  and in Python:
+         * \code
+         *   scene_graph.update_transaction(lambda: E.create_vertices(1000))
+         * \endcode
+         * \param[in] body the function, called without argument
+         * \retval true if the function could be called
+         * \retval false otherwise
+         */
+        bool update_transaction(Callable* body);
+
 	/**
 	 * \brief Saves viewer properties to a file.
 	 * \details This saves current viewpoint, clipping and background
@@ -172,6 +255,13 @@ namespace OGF {
         /**
          * \brief Loads objects from a list of files, and stores them in this
          *  SceneGraph.
+         * \details The files are read in parallel, when the objects
+         *  support it (see Grob::load_in_thread()), except the calls
+         *  that use the Logger, that are serialized (see
+         *  GrobLoadMessages::logger_mutex()). The objects are
+         *  created and named in the order of the files, and the messages
+         *  of each file are displayed in the same order, as if
+         *  load_object() was called for each file.
          * \param[in] value the list of file names, separated with ';'
          * \param[in] type the class name that should be used to
          *  create the objects, or "default" (then it is deduced from
@@ -235,6 +325,15 @@ namespace OGF {
          */
         Grob* current();
 
+        /**
+         * \brief Finds an object by identifier.
+         * \param[in] id the identifier of the object, as returned by
+         *  Grob::get_id() and passed to the signals of this SceneGraph
+         * \return a pointer to the object or nullptr if there is no
+         *  such object in this SceneGraph
+         */
+        Grob* resolve_id(index_t id) const;
+
         /**
          * \brief Sets the visibility flag of one of the objects.
          * \param[in] index the index of the object, in O..nb_children()-1
@@ -342,6 +441,14 @@ namespace OGF {
 	 */
 	Object* get_scene_graph_shader_manager() const;
 
+	/**
+	 * \brief Gets the UndoStore.
+	 * \details The UndoStore is created the first time it is accessed.
+	 * \return a pointer to the UndoStore, that stores the states of
+	 *  this SceneGraph for undo/redo
+	 */
+	UndoStore* get_undo_store() const;
+
     gom_signals:
         /**
          * \brief a signal that is triggered whenever the list of objects
@@ -399,6 +506,44 @@ namespace OGF {
          */
         void grob_renamed();
 
+        /**
+         * \brief a signal that is triggered when an object was added
+         *  to this SceneGraph.
+         * \details It is triggered by update_values(), once the object
+         *  is completely created.
+         * \param[in] id the identifier of the object
+         * \param[in] name the name of the object
+         */
+        void grob_added(index_t id, const std::string& name);
+
+        /**
+         * \brief a signal that is triggered when an object was removed
+         *  from this SceneGraph.
+         * \param[in] id the identifier of the object
+         * \param[in] name the name that the object had
+         */
+        void grob_removed(index_t id, const std::string& name);
+
+        /**
+         * \brief a signal that is triggered when an object of this
+         *  SceneGraph was renamed.
+         * \param[in] id the identifier of the object
+         * \param[in] old_name the previous name of the object
+         * \param[in] new_name the new name of the object
+         */
+        void grob_name_changed(
+            index_t id,
+            const std::string& old_name, const std::string& new_name
+        );
+
+        /**
+         * \brief a signal that is triggered when the visibility flag of
+         *  an object of this SceneGraph changed.
+         * \param[in] id the identifier of the object
+         * \param[in] visible the new value of the visibility flag
+         */
+        void grob_visibility_changed(index_t id, bool visible);
+
     public:
         /**
          * \brief Sets the current object.
@@ -414,6 +559,32 @@ namespace OGF {
 	 */
 	Interpreter* interpreter() override;
 
+        /**
+         * \copydoc CompositeGrob::add_child()
+         */
+        void add_child(Node* child) override;
+
+        /**
+         * \copydoc CompositeGrob::remove_child()
+         */
+        void remove_child(Node* child) override;
+
+        /**
+         * \copydoc CompositeGrob::child_name_changed()
+         */
+        void child_name_changed(
+            Grob* child, const std::string& old_name
+        ) override;
+
+        /**
+         * \brief Records that the visibility flag of an object changed.
+         * \details Called by Grob::set_visible(). The
+         *  grob_visibility_changed() signal is triggered by the next
+         *  update() or update_values().
+         * \param[in] grob a pointer to the object
+         */
+        void grob_visibility_changed_notify(Grob* grob);
+
     protected:
         /**
          * \brief Loads alignment data for pointsets.
@@ -428,6 +599,32 @@ namespace OGF {
          */
         static bool load_aln(const std::string& filename, SceneGraph* sg);
 
+        /**
+         * \brief Gets the classes of the objects that can load a file.
+         * \param[in] file_name the name of the file
+         * \param[in] type the class name that should be used to
+         *  create the object, or "default" (then it is deduced from
+         *  the file extension)
+         * \param[out] class_names the class names, in the order they
+         *  should be tried
+         * \retval true if at least one class can load the file
+         * \retval false otherwise
+         */
+        bool get_grob_classes_for_file(
+            const std::string& file_name, const std::string& type,
+            std::vector<std::string>& class_names
+        );
+
+        /**
+         * \brief Records the loading of a file in the history.
+         * \param[in] file_name the name of the file
+         * \param[in] invoked_from_gui if true, the current directory is
+         *  changed to the directory that contains the file
+         */
+        void record_load_object(
+            const std::string& file_name, bool invoked_from_gui
+        );
+
         /**
          * \brief Writes the preamble of a gsg file to a stream.
          * \param[in,out] out the stream
@@ -477,11 +674,25 @@ namespace OGF {
 	 *   of a property of the object.
 	 * \param[in,out] args the ArgList where the value of the property
 	 *   should be copied. Its name will be "objectid.propname".
+	 * \param[in] warn if set, a warning is displayed if the object or
+	 *   the property does not exist
 	 */
 	void copy_property_to_arglist(
-	    const std::string& obj_prop_name, ArgList& args
+	    const std::string& obj_prop_name, ArgList& args, bool warn = true
 	);
 
+	/**
+	 * \brief Copies the properties of the viewer (camera and
+	 *   transform) to an arglist.
+	 * \details They are saved in .graphite files and in the states of
+	 *   the UndoStore, and restored by copy_arglist_to_properties().
+	 * \param[in,out] args the ArgList where the properties should be
+	 *   copied
+	 * \param[in] warn if set, a warning is displayed for each object or
+	 *   property that does not exist (there is no viewer in batch mode)
+	 */
+	void copy_viewer_properties_to_arglist(ArgList& args, bool warn = true);
+
 	/**
 	 * \brief Copies all the object properties previously recorded by
 	 *   copy_property_to_arglist() from an ArgList to the gom objects.
@@ -492,12 +703,137 @@ namespace OGF {
 	 */
 	void copy_arglist_to_properties(const ArgList& args);
 
+        /**
+         * \brief Tests whether a signal of this SceneGraph is connected
+         *  to a slot.
+         * \param[in] signal_name the name of the signal
+         * \retval true if the signal is connected to at least one slot
+         * \retval false otherwise
+         */
+        bool has_connections(const std::string& signal_name) const;
+
+        /**
+         * \brief Marks the cached ';'-separated lists as invalid.
+         * \param[in] names true if the list of objects changed, false if
+         *  only visibility flags changed
+         */
+        void invalidate_values(bool names) {
+            if(names) {
+                values_dirty_ = true;
+                types_dirty_ = true;
+            }
+            visibilities_dirty_ = true;
+        }
+
+        /**
+         * \brief Triggers the pending grob_added(), grob_removed(),
+         *  grob_name_changed() and grob_visibility_changed() signals.
+         * \param[in] added if false, the pending grob_added() signals
+         *  remain pending (they are triggered by update_values())
+         */
+        void flush_grob_events(bool added);
+
     private:
         std::string current_object_;
 	Interpreter* interpreter_;
 	Object* render_area_;
 	Object* application_;
 	Object_var scene_graph_shader_manager_;
+        index_t nb_update_transactions_;
+        bool flushing_updates_;
+        bool update_pending_;
+        bool update_values_pending_;
+        // Grobs to be updated at the end of the transaction, in order.
+        // Raw pointers: a removed Grob is erased from pending_grobs_set_
+        // (see cancel_grob_update()) and is then skipped.
+        std::vector<Grob*> pending_grobs_;
+        std::unordered_set<Grob*> pending_grobs_set_;
+        mutable UndoStore_var undo_store_;
+
+        mutable std::string values_;
+        mutable std::string visibilities_;
+        mutable std::string types_;
+        mutable bool values_dirty_;
+        mutable bool visibilities_dirty_;
+        mutable bool types_dirty_;
+
+        enum GrobEventType {
+            GROB_ADDED, GROB_REMOVED, GROB_RENAMED, GROB_VISIBILITY_CHANGED
+        };
+        struct GrobEvent {
+            GrobEvent(
+                GrobEventType type_in, index_t id_in,
+                const std::string& name_in = "",
+                const std::string& old_name_in = ""
+            ) : type(type_in), id(id_in),
+                name(name_in), old_name(old_name_in) {
+            }
+            GrobEventType type;
+            index_t id;
+            std::string name;
+            std::string old_name;
+        };
+        std::vector<GrobEvent> grob_events_;
+        std::unordered_set<index_t> pending_added_;
+
+        friend class UndoStore;
+    };
+
+/*************************************************************************/
+
+    /**
+     * \brief Defers all the updates of a SceneGraph and of its objects
+     *  while in scope.
+     * \details Each Grob updated in the scope is updated once when the
+     *  outermost UpdateTransaction is destroyed. Example of use:
+     * \code
+     *  {
+     *     UpdateTransaction transaction(mesh_grob->scene_graph());
+     *     for(index_t i=0; i<n; ++i) {
+     *        editor->create_vertex(p[i]); // calls mesh_grob->update()
+     *     }
+     *  } // mesh_grob updated once here
+     * \endcode
+     *  From scripts, use SceneGraph::update_transaction(), or
+     *  SceneGraph::begin_update() and SceneGraph::end_update().
+     */
+    class SCENE_GRAPH_API UpdateTransaction {
+    public:
+        /**
+         * \brief UpdateTransaction constructor.
+         * \param[in] scene_graph a pointer to the SceneGraph, or nullptr
+         *  (then the UpdateTransaction does nothing).
+         */
+        explicit UpdateTransaction(SceneGraph* scene_graph) :
+            scene_graph_(scene_graph) {
+            if(scene_graph_ != nullptr) {
+                scene_graph_->begin_update();
+            }
+        }
+
+        /**
+         * \brief UpdateTransaction destructor.
+         * \details Ends the transaction, and flushes the deferred
+         *  updates if this is the outermost one.
+         */
+        ~UpdateTransaction() {
+            if(scene_graph_ != nullptr) {
+                scene_graph_->end_update();
+            }
+        }
+
+        /**
+         * \brief Forbid copy.
+         */
+        UpdateTransaction(const UpdateTransaction& rhs) = delete;
+
+        /**
+         * \brief Forbid copy.
+         */
+        UpdateTransaction& operator=(const UpdateTransaction& rhs) = delete;
+
+    private:
+        SceneGraph* scene_graph_;
     };
 
 /*************************************************************************/
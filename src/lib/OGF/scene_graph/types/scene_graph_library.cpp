@@ -36,6 +36,7 @@
 
 #include <OGF/scene_graph/types/scene_graph_library.h>
 #include <OGF/scene_graph/types/scene_graph.h>
+#include <OGF/basic/modules/modmgr.h>
 #include <geogram/basic/algorithm.h>
 
 namespace {
@@ -126,6 +127,13 @@ namespace OGF {
         auto it = grob_infos_.find(grob_class_name);
         ogf_assert(it != grob_infos_.end());
         it->second.read_file_extensions.push_back(extension);
+        // Cached for the module being loaded, see
+        // ModuleManager::defer_module().
+        if(ModuleManager::instance() != nullptr) {
+            ModuleManager::instance()->record_registration(
+                "file_extension", extension
+            );
+        }
         Environment::notify_observers("grob_read_extensions");
         Environment::notify_observers(grob_class_name + "_read_extensions");
     }
@@ -0,0 +1,432 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/scene_graph/types/undo_store.h>
+#include <OGF/scene_graph/types/scene_graph.h>
+#include <OGF/scene_graph/types/geofile.h>
+#include <OGF/scene_graph/grob/grob.h>
+#include <OGF/gom/reflection/meta_class.h>
+
+#include <geogram/basic/file_system.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/stopwatch.h>
+
+#include <set>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The GrobState of a Grob that does not support in-memory
+     *  snapshots.
+     * \details The Grob is serialized to a .graphite file, that is
+     *  read back by UndoStore::restore().
+     */
+    class SerializedGrobState : public GrobState {
+    public:
+        SerializedGrobState(const std::string& file_name) {
+            set_spill_file_name(file_name);
+        }
+
+        size_t memory_size() const override {
+            return 0;
+        }
+    };
+}
+
+namespace OGF {
+
+    UndoStore::UndoStore(SceneGraph* scene_graph) :
+        scene_graph_(scene_graph),
+        current_(0),
+        max_states_(4),
+        memory_budget_(size_t(1024)*1024*1024),
+        spill_counter_(0) {
+        if(CmdLine::arg_is_declared("gui:undo_depth")) {
+            max_states_ = std::max(CmdLine::get_arg_uint("gui:undo_depth"),2u);
+        }
+        if(CmdLine::arg_is_declared("gui:undo_memory")) {
+            memory_budget_ =
+                size_t(CmdLine::get_arg_uint("gui:undo_memory"))*1024*1024;
+        }
+        // Spill files are created in the initial working directory (the
+        // working directory changes when files are loaded from the GUI),
+        // with a prefix that is unique to this UndoStore.
+        spill_prefix_ =
+            FileSystem::get_current_working_directory() + "/" +
+            String::format(
+                "graphite_undo_%llx_",
+                (unsigned long long)(
+                    std::chrono::system_clock::now().time_since_epoch().count()
+                )
+            );
+    }
+
+    UndoStore::~UndoStore() {
+        // GrobStates delete their spill files.
+        clear();
+    }
+
+    void UndoStore::set_max_states(index_t value) {
+        max_states_ = std::max(value, index_t(2));
+        enforce_limits();
+    }
+
+    void UndoStore::set_memory_budget(index_t value) {
+        memory_budget_ = size_t(value)*1024*1024;
+        enforce_limits();
+    }
+
+    index_t UndoStore::get_nb_spilled() const {
+        std::set<const GrobState*> spilled;
+        for(const SceneState& state: states_) {
+            for(const GrobEntry& entry: state.grobs) {
+                if(!entry.state.is_null() && entry.state->is_spilled()) {
+                    spilled.insert(entry.state.get());
+                }
+            }
+        }
+        return index_t(spilled.size());
+    }
+
+    void UndoStore::save_state() {
+        double start = Stopwatch::now();
+        states_.resize(current_);
+        states_.push_back(SceneState());
+        snapshot(states_.back());
+        current_ = index_t(states_.size());
+        enforce_limits();
+        Logger::out("Undo") << "Saved state in "
+                            << (Stopwatch::now() - start) << "s"
+                            << std::endl;
+    }
+
+    bool UndoStore::undo() {
+        if(!get_can_undo() || !check_no_pinned_grobs("undo")) {
+            return false;
+        }
+        double start = Stopwatch::now();
+        // Save the current state, so that redo() can go back to it.
+        if(current_ == states_.size()) {
+            states_.push_back(SceneState());
+            snapshot(states_.back());
+        }
+        --current_;
+        restore(states_[current_]);
+        enforce_limits();
+        Logger::out("Undo") << "Undo in "
+                            << (Stopwatch::now() - start) << "s"
+                            << std::endl;
+        return true;
+    }
+
+    bool UndoStore::redo() {
+        if(!get_can_redo() || !check_no_pinned_grobs("redo")) {
+            return false;
+        }
+        double start = Stopwatch::now();
+        ++current_;
+        restore(states_[current_]);
+        enforce_limits();
+        Logger::out("Undo") << "Redo in "
+                            << (Stopwatch::now() - start) << "s"
+                            << std::endl;
+        return true;
+    }
+
+    void UndoStore::clear() {
+        states_.clear();
+        live_grobs_.clear();
+        current_ = 0;
+    }
+
+    void UndoStore::snapshot(SceneState& state) {
+        state.current_object = scene_graph_->get_current_object();
+        scene_graph_->copy_viewer_properties_to_arglist(
+            state.viewer_properties, false
+        );
+        std::map<std::string, LiveGrob> live_grobs;
+        for(index_t i=0; i<scene_graph_->get_nb_children(); ++i) {
+            Grob* grob = scene_graph_->ith_child(i);
+            GrobEntry entry;
+            entry.name = grob->name();
+            entry.class_name = grob->meta_class()->name();
+            entry.attributes = grob->attributes();
+            grob->get_shader_and_shader_properties(
+                entry.shader_class_name, entry.shader_properties, false
+            );
+            entry.visible = grob->get_visible();
+            entry.obj_to_world = grob->get_obj_to_world_transform();
+            entry.state = snapshot_grob(grob);
+            auto it = live_grobs_.find(entry.name);
+            if(it != live_grobs_.end()) {
+                live_grobs[entry.name] = it->second;
+            }
+            state.grobs.push_back(entry);
+        }
+        // Forget about the Grobs that no longer exist.
+        live_grobs_.swap(live_grobs);
+    }
+
+    GrobState* UndoStore::snapshot_grob(Grob* grob) {
+        LiveGrob& live = live_grobs_[grob->name()];
+        if(live.grob == grob && live.timestamp == grob->timestamp()) {
+            return live.state;
+        }
+
+        std::string class_name = grob->meta_class()->name();
+        GrobState_var result = grob->create_state();
+        if(result.is_null() && grob->is_serializable()) {
+            std::string file_name = new_spill_file_name() + ".graphite";
+            try {
+                OutputGraphiteFile out(file_name);
+                scene_graph_->begin_graphite_file(out, false);
+                scene_graph_->serialize_grob_write(grob, out);
+                scene_graph_->end_graphite_file(out);
+                out.close();
+                result = new SerializedGrobState(file_name);
+            } catch(const std::logic_error& e) {
+                Logger::err("Undo") << "Caught exception: " << e.what()
+                                    << std::endl;
+            }
+        }
+
+        if(result.is_null()) {
+            Logger::warn("Undo") << grob->name()
+                                 << ": cannot save state of a "
+                                 << class_name << std::endl;
+        }
+
+        live.grob = grob;
+        live.timestamp = grob->timestamp();
+        live.state = result;
+        return result;
+    }
+
+    bool UndoStore::check_no_pinned_grobs(
+        const std::string& operation
+    ) const {
+        // Refused as a whole, a partially restored scene would mix
+        // states.
+        for(index_t i=0; i<scene_graph_->get_nb_children(); ++i) {
+            if(!scene_graph_->ith_child(i)->check_elements_not_pinned(
+                   operation
+            )) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void UndoStore::restore(const SceneState& state) {
+        std::set<std::string> names;
+        for(const GrobEntry& entry: state.grobs) {
+            names.insert(entry.name);
+        }
+
+        // Remove the Grobs that did not exist in the restored state.
+        for(index_t i=scene_graph_->get_nb_children(); i>0; --i) {
+            Grob* grob = scene_graph_->ith_child(i-1);
+            if(names.find(grob->name()) == names.end()) {
+                live_grobs_.erase(grob->name());
+                delete_grob(grob);
+            }
+        }
+
+        for(const GrobEntry& entry: state.grobs) {
+            Grob* grob = Grob::find(scene_graph_, entry.name);
+
+            if(entry.state.is_null()) {
+                // Grob that cannot be snapshotted, leave it as is.
+                continue;
+            }
+
+            if(
+                grob != nullptr &&
+                entry.class_name != grob->meta_class()->name()
+            ) {
+                live_grobs_.erase(entry.name);
+                delete_grob(grob);
+                grob = nullptr;
+            }
+
+            // Skip the Grobs that are already in the restored state.
+            LiveGrob& live = live_grobs_[entry.name];
+            if(
+                grob != nullptr && live.grob == grob &&
+                live.timestamp == grob->timestamp() &&
+                live.state == entry.state
+            ) {
+                continue;
+            }
+
+            SerializedGrobState* serialized =
+                dynamic_cast<SerializedGrobState*>(entry.state.get());
+
+            if(serialized != nullptr) {
+                if(grob != nullptr) {
+                    delete_grob(grob);
+                    grob = nullptr;
+                }
+                try {
+                    InputGraphiteFile in(serialized->spill_file_name());
+                    for(
+                        std::string chunk_class = in.current_chunk_class();
+                        chunk_class != "EOFL";
+                        chunk_class = in.next_chunk()
+                    ) {
+                        if(chunk_class == "GROB") {
+                            grob = scene_graph_->serialize_grob_read(in);
+                        }
+                    }
+                } catch(const std::logic_error& e) {
+                    Logger::err("Undo") << "Caught exception: " << e.what()
+                                        << std::endl;
+                }
+                if(grob == nullptr) {
+                    live_grobs_.erase(entry.name);
+                    continue;
+                }
+            } else {
+                if(grob == nullptr) {
+                    grob = scene_graph_->create_object(
+                        entry.class_name, entry.name
+                    );
+                    if(grob == nullptr) {
+                        live_grobs_.erase(entry.name);
+                        continue;
+                    }
+                }
+                if(
+                    !entry.state->unspill() ||
+                    !grob->restore_state(entry.state)
+                ) {
+                    Logger::err("Undo") << entry.name
+                                        << ": could not restore state"
+                                        << std::endl;
+                }
+                grob->attributes() = entry.attributes;
+                grob->set_shader_and_shader_properties(
+                    entry.shader_class_name, entry.shader_properties
+                );
+                grob->set_visible(entry.visible);
+            }
+            grob->set_obj_to_world_transform(entry.obj_to_world);
+            grob->update();
+
+            live.grob = grob;
+            live.timestamp = grob->timestamp();
+            live.state = entry.state;
+        }
+
+        scene_graph_->update_values();
+        if(Grob::find(scene_graph_, state.current_object) != nullptr) {
+            scene_graph_->set_current_object(state.current_object, false);
+        }
+        scene_graph_->copy_arglist_to_properties(state.viewer_properties);
+    }
+
+    void UndoStore::delete_grob(Grob* grob) {
+        std::string name = grob->name(); // copy it before deletion
+        if(scene_graph_->get_current_object() == name) {
+            scene_graph_->set_current_object(std::string(), false);
+        }
+        scene_graph_->remove_child(grob);
+        scene_graph_->grob_deleted(name);
+    }
+
+    void UndoStore::enforce_limits() {
+        while(states_.size() > max_states_) {
+            states_.erase(states_.begin());
+            if(current_ != 0) {
+                --current_;
+            }
+        }
+
+        size_t used = memory_used();
+        if(used <= memory_budget_) {
+            return;
+        }
+
+        // Spill the GrobStates of the oldest states first. The GrobStates
+        // of the live Grobs are only needed if they are modified and then
+        // undone, they are spilled last.
+        std::set<const GrobState*> live;
+        for(const auto& it: live_grobs_) {
+            live.insert(it.second.state.get());
+        }
+        for(index_t pass=0; pass<2; ++pass) {
+            for(SceneState& state: states_) {
+                for(GrobEntry& entry: state.grobs) {
+                    if(used <= memory_budget_) {
+                        return;
+                    }
+                    if(
+                        entry.state.is_null() || entry.state->is_spilled() ||
+                        (pass == 0 && live.find(entry.state.get()) != live.end())
+                    ) {
+                        continue;
+                    }
+                    // The memory freed by spilling depends on how much
+                    // of the GrobState is shared with other GrobStates.
+                    if(entry.state->spill(new_spill_file_name())) {
+                        used = memory_used();
+                    }
+                }
+            }
+        }
+    }
+
+    size_t UndoStore::memory_used() const {
+        std::set<const void*> counted;
+        size_t result = 0;
+        for(const SceneState& state: states_) {
+            for(const GrobEntry& entry: state.grobs) {
+                if(!entry.state.is_null()) {
+                    result += entry.state->unshared_memory_size(counted);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::string UndoStore::new_spill_file_name() {
+        ++spill_counter_;
+        return spill_prefix_ + String::to_string(spill_counter_);
+    }
+}
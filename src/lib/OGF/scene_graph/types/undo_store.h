@@ -0,0 +1,309 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_SCENE_GRAPH_TYPES_UNDO_STORE_H
+#define H_OGF_SCENE_GRAPH_TYPES_UNDO_STORE_H
+
+#include <OGF/scene_graph/common/common.h>
+#include <OGF/scene_graph/grob/grob_state.h>
+#include <OGF/gom/types/object.h>
+#include <OGF/gom/types/arg_list.h>
+#include <OGF/basic/math/geometry.h>
+
+#include <vector>
+#include <map>
+
+/**
+ * \file OGF/scene_graph/types/undo_store.h
+ * \brief The saved states of a SceneGraph, used by undo/redo.
+ */
+
+namespace OGF {
+
+    class SceneGraph;
+    class Grob;
+
+    /**
+     * \brief Stores the successive states of a SceneGraph for undo/redo.
+     * \details Each state records, for each Grob, a GrobState with its
+     *  contents, and the properties of the viewer (camera). Contents are
+     *  shared between states:
+     *  - a Grob that was not modified since the previous state (same
+     *    timestamp, see Grob::timestamp()) reuses its previous GrobState;
+     *  - a GrobState can share the parts of a Grob that did not change
+     *    with the other GrobStates (for instance, MeshGrob shares its
+     *    vertices, elements and attributes separately);
+     *  - undo() and redo() only restore the Grobs that differ from the
+     *    target state.
+     *  Grobs that do not support in-memory snapshots (see
+     *  Grob::create_state()) are serialized to .graphite files. When the
+     *  memory used by the stored GrobStates exceeds the memory budget,
+     *  the oldest ones are spilled to disk.
+     */
+    gom_class SCENE_GRAPH_API UndoStore : public Object {
+    public:
+        /**
+         * \brief UndoStore constructor.
+         * \param[in] scene_graph the SceneGraph
+         * \details The maximum number of states and the memory budget are
+         *  initialized from the gui:undo_depth and gui:undo_memory
+         *  command line arguments if they are declared.
+         */
+        UndoStore(SceneGraph* scene_graph);
+
+        /**
+         * \brief UndoStore destructor.
+         */
+        ~UndoStore() override;
+
+    gom_properties:
+
+        /**
+         * \brief Tests whether undo() can be called.
+         * \retval true if there is a saved state before the current one
+         * \retval false otherwise
+         */
+        bool get_can_undo() const {
+            return current_ != 0;
+        }
+
+        /**
+         * \brief Tests whether redo() can be called.
+         * \retval true if there is a saved state after the current one
+         * \retval false otherwise
+         */
+        bool get_can_redo() const {
+            return current_ + 1 < states_.size();
+        }
+
+        /**
+         * \brief Gets the number of stored states.
+         * \return the number of states
+         */
+        index_t get_nb_states() const {
+            return index_t(states_.size());
+        }
+
+        /**
+         * \brief Sets the maximum number of stored states.
+         * \param[in] value the maximum number of states. The oldest states
+         *  are discarded when there are more.
+         */
+        void set_max_states(index_t value);
+
+        /**
+         * \brief Gets the maximum number of stored states.
+         * \return the maximum number of states
+         */
+        index_t get_max_states() const {
+            return max_states_;
+        }
+
+        /**
+         * \brief Sets the memory budget.
+         * \param[in] value the maximum memory used by the stored states,
+         *  in megabytes. Beyond this limit, the oldest states are spilled
+         *  to disk.
+         */
+        void set_memory_budget(index_t value);
+
+        /**
+         * \brief Gets the memory budget.
+         * \return the maximum memory used by the stored states,
+         *  in megabytes
+         */
+        index_t get_memory_budget() const {
+            return index_t(memory_budget_ / (1024*1024));
+        }
+
+        /**
+         * \brief Gets the memory used by the stored states.
+         * \return the memory used by the stored states, in megabytes
+         */
+        double get_memory_used() const {
+            return double(memory_used()) / (1024.0*1024.0);
+        }
+
+        /**
+         * \brief Gets the number of GrobStates spilled to disk.
+         * \return the number of GrobStates that are stored in files
+         */
+        index_t get_nb_spilled() const;
+
+    gom_slots:
+
+        /**
+         * \brief Saves the current state of the SceneGraph.
+         * \details Called before each command. The states after the
+         *  current one (that could be restored by redo()) are discarded.
+         */
+        void save_state();
+
+        /**
+         * \brief Restores the previous state.
+         * \retval true if the previous state was restored
+         * \retval false if there is no previous state, or if the
+         *  elements of a Grob are pinned (see Grob::pin_elements())
+         */
+        bool undo();
+
+        /**
+         * \brief Restores the next state.
+         * \retval true if the next state was restored
+         * \retval false if there is no next state, or if the
+         *  elements of a Grob are pinned (see Grob::pin_elements())
+         */
+        bool redo();
+
+        /**
+         * \brief Discards all the stored states.
+         */
+        void clear();
+
+    protected:
+
+        /**
+         * \brief The saved state of a Grob.
+         */
+        struct GrobEntry {
+            std::string name;
+            std::string class_name;
+            ArgList attributes;
+            std::string shader_class_name;
+            ArgList shader_properties;
+            bool visible;
+            mat4 obj_to_world;
+            GrobState_var state;
+        };
+
+        /**
+         * \brief The saved state of a SceneGraph.
+         */
+        struct SceneState {
+            std::vector<GrobEntry> grobs;
+            std::string current_object;
+            ArgList viewer_properties;
+        };
+
+        /**
+         * \brief What is known about a Grob of the SceneGraph.
+         * \details If the Grob still has the same timestamp, then its
+         *  contents are the ones stored in state.
+         */
+        struct LiveGrob {
+            LiveGrob() : grob(nullptr), timestamp(0) {
+            }
+            Grob* grob;
+            Numeric::uint64 timestamp;
+            GrobState_var state;
+        };
+
+        /**
+         * \brief Creates a snapshot of the SceneGraph.
+         * \param[out] state the snapshot
+         */
+        void snapshot(SceneState& state);
+
+        /**
+         * \brief Gets a GrobState with the contents of a Grob.
+         * \details Reuses the previous GrobState if the Grob was not
+         *  modified.
+         * \param[in] grob the Grob
+         * \return a GrobState with the contents of the Grob or nullptr if
+         *  the Grob cannot be snapshotted
+         */
+        GrobState* snapshot_grob(Grob* grob);
+
+        /**
+         * \brief Restores a saved state of the SceneGraph.
+         * \param[in] state the state to be restored
+         */
+        void restore(const SceneState& state);
+
+        /**
+         * \brief Checks that the elements of the Grobs are not pinned
+         *  (referenced by buffer views), before restoring a state.
+         * \param[in] operation the name of the operation, displayed in
+         *  the error message
+         * \retval true if no Grob is pinned
+         * \retval false otherwise, then an error message is displayed
+         */
+        bool check_no_pinned_grobs(const std::string& operation) const;
+
+        /**
+         * \brief Removes a Grob from the SceneGraph.
+         * \param[in] grob the Grob
+         */
+        void delete_grob(Grob* grob);
+
+        /**
+         * \brief Discards the oldest states if there are more than
+         *  max_states, and spills GrobStates to disk if the memory budget
+         *  is exceeded.
+         */
+        void enforce_limits();
+
+        /**
+         * \brief Gets the memory used by the stored states.
+         * \return the memory used in memory by the GrobStates, in bytes.
+         *  The contents shared by several GrobStates are counted once.
+         */
+        size_t memory_used() const;
+
+        /**
+         * \brief Generates a new file name to spill a GrobState.
+         * \return the file name, without extension
+         */
+        std::string new_spill_file_name();
+
+    private:
+        SceneGraph* scene_graph_;
+        std::vector<SceneState> states_;
+        index_t current_;
+        index_t max_states_;
+        size_t memory_budget_;
+        std::map<std::string, LiveGrob> live_grobs_;
+        std::string spill_prefix_;
+        index_t spill_counter_;
+    };
+
+    /**
+     * \brief An automatic reference-counted pointer to an UndoStore.
+     */
+    typedef SmartPointer<UndoStore> UndoStore_var;
+}
+
+#endif
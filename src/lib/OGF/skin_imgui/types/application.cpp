@@ -44,6 +44,7 @@
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/basic/math/geometry.h>
 #include <OGF/basic/os/file_manager.h>
+#include <OGF/basic/os/startup_profiler.h>
 
 #include <geogram_gfx/gui/application.h>
 #include <geogram_gfx/gui/status_bar.h>
@@ -140,6 +141,15 @@ namespace OGF {
 	    if(application_->is_stopping()) {
 		return;
 	    }
+	    // Startup is complete once the first frame is displayed.
+	    if(StartupProfiler::is_enabled()) {
+		{
+		    StartupTimer timer("gui", "first frame");
+		    GEO::Application::one_frame();
+		}
+		StartupProfiler::finish();
+		return;
+	    }
 	    GEO::Application::one_frame();
 	}
 
@@ -246,6 +256,7 @@ namespace OGF {
 	 * \copydoc GEO::Application::ImGui_initialize()
 	 */
 	void ImGui_initialize() override {
+	    StartupTimer timer("gui", "ImGui initialization");
 	    GEO::Application::ImGui_initialize();
 	    Logger::instance()->register_client(console_);
 	    Progress::set_client(status_bar_);
@@ -264,6 +275,7 @@ namespace OGF {
 	 * \copydoc GEO::Application::create_window()
 	 */
 	void create_window() override {
+	    StartupTimer timer("gui", "window creation");
 	    GEO::Application::create_window();
 	    std::string icon_file_name = "icons/logos/small-graphite-logo.xpm";
 	    if(!FileManager::instance()->find_file(icon_file_name)) {
@@ -297,6 +309,7 @@ namespace OGF {
     Application::Application(Interpreter* interpreter) :
 	ApplicationBase(interpreter)
     {
+	StartupTimer timer("gui", "Application construction");
 	picked_grob_ = nullptr;
 	impl_ = new ApplicationImpl(this);
         icon_repository_ = new IconRepository;
@@ -37,6 +37,7 @@
 
 #include <OGF/skin_imgui/types/icon_repository.h>
 #include <OGF/basic/os/file_manager.h>
+#include <OGF/basic/os/startup_profiler.h>
 #include <OGF/renderer/context/texture.h>
 #include <geogram/image/image_library.h>
 
@@ -143,6 +144,7 @@ namespace OGF {
             return it->second.im_texture_id;
         }
 
+	StartupTimer timer("gui", "icon loading");
 	std::string icon_file_name = "icons/" + icon_name + ".png";
 	Image_var image;
         if(FileManager::instance()->find_file(icon_file_name, false, "lib/")) {
@@ -0,0 +1,97 @@
+-- arg_list_benchmark.lua
+--
+-- Usage: graphite batch=true tools/arg_list_benchmark.lua [nb_calls=<n>]
+--
+--  Measures the cost of calling GOM methods from Lua (building the
+-- ArgList, finding the method, invoking it), with 0 to 8 arguments
+-- (100000 calls by default, times are wall-clock times).
+--  Then checks that ArgLists keep the right names and values when
+-- there are more arguments than the ones stored inline, long names and
+-- more distinct names than the table of interned argument names can
+-- hold (the names are then stored in the ArgLists).
+
+local N = tonumber(gom.get_environment_value('nb_calls') or '') or 100000
+
+package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+                './')..'?.lua;'..package.path
+local check, finish =
+   require('test_helpers').checker('arg list')
+
+-- A class with a slot that takes all its arguments as an ArgList and
+-- stores them in 'received' (the slot calls a Lua function with a
+-- table that has the arguments, plus 'self' and 'method').
+
+local received = nil
+
+function echo(args)
+   received = args
+end
+
+local mclass = gom.meta_types.OGF.Object.create_subclass('OGF::ArgListCheck')
+mclass.add_constructor()
+local mecho = mclass.add_slot('echo', echo)
+mecho.add_arg('args', gom.meta_types.OGF.ArgList)
+local obj = mclass.create()
+
+local function timed(what, f)
+   local start = gom.wall_clock_time()
+   for i=1,N do
+      f(i)
+   end
+   local elapsed = gom.wall_clock_time() - start
+   print(string.format(
+      '%-32s %8.4f s   %8.3f us/call', what, elapsed, elapsed * 1e6 / N
+   ))
+end
+
+timed('0 args (C++)', function(i)
+   gom.wall_clock_time()
+end)
+
+timed('1 arg (C++)', function(i)
+   gom.get_environment_value('version')
+end)
+
+timed('2 args (C++)', function(i)
+   gom.set_environment_value('arg_list_benchmark', 'x')
+end)
+
+timed('4 args (Lua slot)', function(i)
+   obj.echo({x=1, y=2, z=3, w=4})
+end)
+
+timed('8 args (Lua slot)', function(i)
+   obj.echo({a=1, b=2, c=3, d=4, e=5, f=6, g=7, h=8})
+end)
+
+-- More arguments than the ones stored inline.
+local args = {}
+for i=1,10 do
+   args['arg_'..i] = i
+end
+obj.echo(args)
+local ok = (received ~= nil)
+for i=1,10 do
+   ok = ok and (tonumber(received['arg_'..i]) == i)
+end
+check(ok, '10 arguments')
+
+-- Dynamic names: more than the table of interned names can hold, some
+-- of them longer than the strings stored without allocation.
+ok = true
+for i=1,10000 do
+   local short_name = 'n'..i
+   local long_name = 'a_rather_long_dynamic_argument_name_'..i
+   obj.echo({[short_name]=i, [long_name]=-i, fixed='value'})
+   ok = ok and received ~= nil and
+      tonumber(received[short_name]) == i and
+      tonumber(received[long_name]) == -i and
+      received.fixed == 'value'
+   if not ok then
+      print('mismatch for '..short_name)
+      break
+   end
+end
+check(ok, '10000 distinct dynamic names')
+
+finish()
@@ -0,0 +1,47 @@
+#!/bin/sh
+# batch_server_benchmark.sh
+#
+# Usage: tools/batch_server_benchmark.sh <bindir> <script> [nb_jobs]
+#
+#  Compares the time taken to run the same script nb_jobs times
+# with a cold start of graphite for each run and with a batch server
+# (graphite server=<socket>) that is started once.
+
+BINDIR=$1
+SCRIPT=$2
+NB_JOBS=${3:-20}
+SOCKET=/tmp/graphite_benchmark_$$.sock
+
+if [ -z "$BINDIR" ] || [ -z "$SCRIPT" ]; then
+    echo "usage: $0 <bindir> <script> [nb_jobs]"
+    exit 1
+fi
+
+now() {
+    date +%s.%N
+}
+
+start=$(now)
+i=0
+while [ $i -lt $NB_JOBS ]; do
+    $BINDIR/graphite batch=true $SCRIPT > /dev/null 2>&1
+    i=$((i+1))
+done
+cold=$(echo "$(now) - $start" | bc)
+
+start=$(now)
+$BINDIR/graphite server=$SOCKET > /dev/null 2>&1 &
+while [ ! -S $SOCKET ]; do
+    sleep 0.05
+done
+i=0
+while [ $i -lt $NB_JOBS ]; do
+    $BINDIR/graphite_client $SOCKET $SCRIPT > /dev/null 2>&1
+    i=$((i+1))
+done
+$BINDIR/graphite_client $SOCKET quit
+wait
+server=$(echo "$(now) - $start" | bc)
+
+echo "$NB_JOBS jobs, cold starts: $cold s"
+echo "$NB_JOBS jobs, batch server (including its startup): $server s"
@@ -0,0 +1,96 @@
+# gompy_buffer_test.py
+#
+# Usage: graphite batch=true tools/gompy_buffer_test.py
+#    or: python3 tools/gompy_buffer_test.py (with gompy installed, needs numpy)
+#
+#  Checks the buffer views (PEP 3118) over the elements of a mesh:
+#  - a NumPy array over the points refers to the mesh memory (no copy),
+#  - while the array is alive, resizing the mesh (editor functions,
+#    MeshGrob.clear() and commands) is refused and the array stays valid,
+#    read-only commands still run,
+#  - once the array is released, the mesh can be resized again,
+#  - releasing a writable view notifies the mesh (value_changed) only if
+#    the view was written.
+
+import gc
+import os
+import sys
+
+import numpy
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import test_helpers
+
+try:
+    import gompy
+except ImportError:
+    pass # Run from Graphite, gom is already there
+
+OGF = gom.meta_types.OGF
+
+check, finish = test_helpers.checker('gompy buffer')
+
+S = OGF.MeshGrob()
+S.I.Shapes.create_sphere()
+E = S.I.Editor
+nv = E.nb_vertices
+
+nb_changed = [0]
+def on_changed(grob):
+    nb_changed[0] = nb_changed[0] + 1
+gom.connect(S.value_changed, on_changed)
+
+# Resizing while a view is alive is refused.
+
+points = numpy.asarray(E.get_points())
+check(points.shape == (nv, 3), 'view has shape (nb_vertices, 3)')
+first = points[0].copy()
+
+E.create_vertices(1000)
+check(E.nb_vertices == nv, 'create_vertices() refused while pinned')
+E.clear()
+check(E.nb_vertices == nv, 'clear() refused while pinned')
+S.clear()
+check(E.nb_vertices == nv, 'MeshGrob.clear() refused while pinned')
+S.I.Surface.remesh_smooth(nb_points=1000)
+check(E.nb_vertices == nv, 'commands refused while pinned')
+try:
+    S.I.Mesh.display_statistics()
+    readonly_ok = True
+except Exception:
+    readonly_ok = False
+check(readonly_ok, 'read-only commands run while pinned')
+check(
+    numpy.array_equal(points[0], first) and
+    numpy.array_equal(points, numpy.asarray(E.get_points())),
+    'view still refers to the mesh'
+)
+
+# Releasing a view that was not written does not notify the mesh.
+
+nb_changed[0] = 0
+del points
+gc.collect()
+check(nb_changed[0] == 0, 'unmodified view does not notify the mesh')
+
+E.create_vertices(1000)
+check(E.nb_vertices == nv + 1000, 'create_vertices() works once released')
+
+# Releasing a written view notifies the mesh.
+
+points = numpy.asarray(E.get_points())
+points[0] = [1.0, 2.0, 3.0]
+nb_changed[0] = 0
+del points
+gc.collect()
+check(nb_changed[0] == 1, 'written view notifies the mesh once')
+check(
+    list(numpy.asarray(E.get_points())[0]) == [1.0, 2.0, 3.0],
+    'writes go to the mesh memory'
+)
+
+gc.collect()
+S.I.Editor.clear()
+check(E.nb_vertices == 0, 'clear() works once all views are released')
+
+finish()
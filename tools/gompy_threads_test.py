@@ -0,0 +1,92 @@
+# gompy_threads_test.py
+#
+# Usage: graphite batch=true tools/gompy_threads_test.py
+#    or: python3 tools/gompy_threads_test.py (with gompy installed)
+#
+#  Checks that Python threads can call Graphite concurrently:
+#  - a thread runs a long-running command (remesh_smooth, declared with
+#    gom_attribute(long_running,"true"), that releases the GIL) while
+#    another thread creates vertices in another mesh with short calls
+#    (that keep the GIL), both go through the GOM lock (so the second
+#    thread waits for the command) and both results are complete,
+#  - a pure Python thread keeps running while the long-running command
+#    executes (the GIL is released).
+
+import os
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import test_helpers
+
+try:
+    import gompy
+except ImportError:
+    pass # Run from Graphite, gom is already there
+
+OGF = gom.meta_types.OGF
+
+check, finish = test_helpers.checker('gompy threads')
+
+NB_VERTICES = 20000
+NB_POINTS = 20000
+
+results = {}
+ticks = [0]
+done = threading.Event()
+
+def long_command():
+    S = OGF.MeshGrob()
+    S.I.Shapes.create_sphere()
+    start_ticks = ticks[0]
+    start = time.time()
+    R = S.I.Surface.remesh_smooth(nb_points=NB_POINTS)
+    results['remesh_time'] = time.time() - start
+    results['remesh_ticks'] = ticks[0] - start_ticks
+    results['remesh_nb_vertices'] = R.I.Editor.nb_vertices
+
+def short_calls():
+    M = OGF.MeshGrob()
+    E = M.I.Editor
+    for i in range(NB_VERTICES):
+        E.create_vertex('%d 0 0' % i)
+    results['nb_vertices'] = E.nb_vertices
+
+def ticker():
+    while not done.is_set():
+        ticks[0] = ticks[0] + 1
+        time.sleep(0.001)
+
+tick_thread = threading.Thread(target=ticker)
+tick_thread.start()
+threads = [
+    threading.Thread(target=long_command),
+    threading.Thread(target=short_calls)
+]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+done.set()
+tick_thread.join()
+
+check(
+    results.get('nb_vertices') == NB_VERTICES,
+    'short calls created %d vertices' % NB_VERTICES
+)
+check(
+    results.get('remesh_nb_vertices', 0) > 0,
+    'long-running command completed'
+)
+
+# If the command holds the GIL, the ticker cannot run during the whole
+# command (at most a couple of ticks when it starts and ends).
+if results.get('remesh_time', 0.0) > 0.1:
+    check(
+        results['remesh_ticks'] >= 10,
+        'Python threads run during a long-running command (%d ticks)' %
+        results['remesh_ticks']
+    )
+
+finish()
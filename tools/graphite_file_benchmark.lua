@@ -0,0 +1,88 @@
+-- graphite_file_benchmark.lua
+--
+-- Usage: graphite batch=true tools/graphite_file_benchmark.lua
+--                     [benchmark_precision=<n>] [benchmark_nb_meshes=<n>]
+--
+--  Measures the throughput of saving and loading .graphite files
+-- (block-compressed, see GraphiteFileBlocks), and checks that the
+-- loaded scene is identical to the saved one (number of elements and
+-- attributes of each mesh). Run it with different numbers of threads
+-- (sys:max_threads=<n>) to see how it scales. The times printed below
+-- are wall-clock times (os.clock() would sum the CPU time of all the
+-- threads), the throughput of block compression and decompression alone
+-- is displayed by the GeoFile logger. The block format itself is checked
+-- by tools/graphite_file_blocks_test.lua.
+
+local precision = tonumber(
+   gom.get_environment_value('benchmark_precision') or ''
+) or 8
+
+local nb_meshes = tonumber(
+   gom.get_environment_value('benchmark_nb_meshes') or ''
+) or 4
+
+local file_name = 'graphite_file_benchmark.graphite'
+
+local function file_size(name)
+   local f = io.open(name, 'rb')
+   if f == nil then
+      return 0
+   end
+   local result = f:seek('end')
+   f:close()
+   return result
+end
+
+local function signature(grob)
+   local E = grob.I.Editor
+   return string.format(
+      '%s: %d vertices %d facets %d cells [%s]',
+      grob.name, E.nb_vertices, E.nb_facets, E.nb_cells, grob.attributes
+   )
+end
+
+scene_graph.clear()
+for i=1,nb_meshes do
+   local S = scene_graph.create_object('OGF::MeshGrob','mesh_'..i)
+   S.query_interface('OGF::MeshGrobShapesCommands').create_sphere(
+      {center=tostring(3*i)..' 0 0', radius=1.0, precision=precision}
+   )
+   S.query_interface('OGF::MeshGrobAttributesCommands').compute_vertices_id(
+      {attribute='id'}
+   )
+end
+
+local before = {}
+for i=1,nb_meshes do
+   before[i] = signature(scene_graph.resolve('mesh_'..i))
+end
+
+local start = gom.wall_clock_time()
+local saved = scene_graph.save(file_name)
+local save_time = gom.wall_clock_time() - start
+local size = file_size(file_name) / (1024*1024)
+
+scene_graph.clear()
+
+start = gom.wall_clock_time()
+scene_graph.load_object(file_name)
+local load_time = gom.wall_clock_time() - start
+
+local ok = saved
+for i=1,nb_meshes do
+   local grob = scene_graph.resolve('mesh_'..i)
+   local after = (grob ~= nil) and signature(grob) or ('mesh_'..i..': missing')
+   if after ~= before[i] then
+      print('MISMATCH: '..before[i]..' / '..after)
+      ok = false
+   end
+end
+
+print(string.format(
+   'file: %8.2f Mb   save: %8.4f s   load: %8.4f s',
+   size, save_time, load_time
+))
+print(ok and 'round trip: OK' or 'round trip: FAILED')
+
+os.remove(file_name)
+scene_graph.clear()
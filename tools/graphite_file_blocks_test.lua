@@ -0,0 +1,139 @@
+-- graphite_file_blocks_test.lua
+--
+-- Usage: graphite batch=true tools/graphite_file_blocks_test.lua
+--
+--  Checks the block-compressed .graphite format (GraphiteFileBlocks),
+-- through scene_graph.save() and scene_graph.load_object():
+--  - saving then loading a scene gives back the same scene, for an
+--    empty scene, a scene that fits in a single block and a scene that
+--    spans several blocks (the last one being incomplete),
+--  - corrupted files (truncated, invalid header, invalid block table)
+--    are rejected without allocating what the header claims, and do
+--    not create any object.
+-- Run it with different numbers of threads (sys:max_threads=<n>).
+
+local file_name = 'graphite_file_blocks_test.graphite'
+
+package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+                './')..'?.lua;'..package.path
+local check, finish =
+   require('test_helpers').checker('graphite file blocks')
+
+local function write_file(name, data)
+   local f = assert(io.open(name, 'wb'))
+   f:write(data)
+   f:close()
+end
+
+local function read_file(name)
+   local f = io.open(name, 'rb')
+   if f == nil then
+      return nil
+   end
+   local result = f:read('a')
+   f:close()
+   return result
+end
+
+-- Header: magic, revision, compression level, block size,
+-- uncompressed size, number of blocks.
+local header_format = '=c8I4I4I8I8I8'
+
+local function header(block_size, raw_size, nb_blocks)
+   return string.pack(
+      header_format, 'GRPHBLKS', 2, 3, block_size, raw_size, nb_blocks
+   )
+end
+
+local function signature()
+   local result = {}
+   for i=0,scene_graph.nb_children-1 do
+      local grob = scene_graph.ith_child(i)
+      local E = grob.I.Editor
+      result[#result+1] = string.format(
+         '%s: %d vertices %d facets [%s]',
+         grob.name, E.nb_vertices, E.nb_facets, grob.attributes
+      )
+   end
+   return table.concat(result, '\n')
+end
+
+local function create_scene(nb_meshes, precision)
+   scene_graph.clear()
+   for i=1,nb_meshes do
+      local S = scene_graph.create_object('OGF::MeshGrob','mesh_'..i)
+      S.query_interface('OGF::MeshGrobShapesCommands').create_sphere(
+         {center=tostring(3*i)..' 0 0', radius=1.0, precision=precision}
+      )
+      S.query_interface(
+         'OGF::MeshGrobAttributesCommands'
+      ).compute_vertices_id({attribute='id'})
+   end
+end
+
+-- Saves the current scene, loads it back and compares, returns the
+-- number of blocks of the file.
+local function round_trip(what)
+   local before = signature()
+   local saved = scene_graph.save(file_name)
+   local packed = read_file(file_name) or ''
+   local magic, _, _, block_size, raw_size, nb_blocks = '', 0, 0, 0, 0, 0
+   if #packed >= string.packsize(header_format) then
+      magic, _, _, block_size, raw_size, nb_blocks =
+         string.unpack(header_format, packed)
+   end
+   scene_graph.clear()
+   scene_graph.load_object(file_name)
+   check(
+      saved and magic == 'GRPHBLKS' and signature() == before,
+      string.format(
+         'round trip %-28s %10d bytes, %3d block(s) of %d',
+         what, raw_size, nb_blocks, block_size
+      )
+   )
+   return nb_blocks, block_size, raw_size
+end
+
+round_trip('empty scene')
+
+create_scene(1, 1)
+round_trip('single block')
+
+create_scene(6, 6)
+local nb_blocks, block_size, raw_size = round_trip('several blocks')
+check(
+   nb_blocks > 1 and raw_size % block_size ~= 0,
+   'scene spans several blocks, the last one incomplete'
+)
+
+-- Corrupted files: loading them must not create any object.
+
+local packed = read_file(file_name)
+
+local function check_rejected(data, what)
+   write_file(file_name, data)
+   scene_graph.clear()
+   scene_graph.load_object(file_name)
+   check(scene_graph.nb_children == 0, what..' is rejected')
+end
+
+check_rejected(packed:sub(1, #packed - 10), 'truncated file')
+check_rejected(
+   header(4096, 4096 * 2^40, 2^40), 'huge number of blocks'
+)
+check_rejected(
+   header(2^40, 2^40, 1)..string.pack('=I8I8', 56, 8), 'huge block size'
+)
+check_rejected(
+   header(4096, 4096, 1)..string.pack('=I8I8', 56, 2^40),
+   'block past the end of the file'
+)
+check_rejected(
+   header(4096, 4096, 1)..string.pack('=I8I8', 0, 8),
+   'block overlapping the header'
+)
+
+os.remove(file_name)
+scene_graph.clear()
+
+finish()
@@ -0,0 +1,83 @@
+-- load_objects_benchmark.lua
+--
+-- Usage: graphite batch=true tools/load_objects_benchmark.lua
+--                     [nb_files=<n>] [benchmark_precision=<n>]
+--                     [benchmark_format=obj|geogram]
+--
+--  Compares loading a list of files (500 by default) one by one with
+-- load_object() and all at once with load_objects(), that reads them in
+-- parallel. Checks that both give the same objects, with the same names,
+-- in the same order. Run it with different numbers of threads
+-- (sys:max_threads=<n>) to see how it scales. Times are wall-clock times.
+
+local nb_files = tonumber(gom.get_environment_value('nb_files') or '') or 500
+
+local precision = tonumber(
+   gom.get_environment_value('benchmark_precision') or ''
+) or 3
+
+local format = gom.get_environment_value('benchmark_format') or ''
+if format == '' then
+   format = 'obj'
+end
+
+local file_names = {}
+
+scene_graph.clear()
+for i=1,nb_files do
+   local S = scene_graph.create_object('OGF::MeshGrob','load_'..i)
+   S.query_interface('OGF::MeshGrobShapesCommands').create_sphere(
+      {center=tostring(i)..' 0 0', radius=0.5, precision=precision}
+   )
+   file_names[i] = 'load_objects_benchmark_'..i..'.'..format
+   S.save(file_names[i])
+end
+scene_graph.clear()
+
+local function signature()
+   local result = {}
+   for i=0,scene_graph.nb_children-1 do
+      local grob = scene_graph.ith_child(i)
+      local E = grob.I.Editor
+      result[#result+1] = string.format(
+         '%s:%d:%d', grob.name, E.nb_vertices, E.nb_facets
+      )
+   end
+   return table.concat(result, ';')
+end
+
+local function timed(what, f)
+   local start = gom.wall_clock_time()
+   f()
+   local elapsed = gom.wall_clock_time() - start
+   print(string.format(
+      '%-16s %8.4f s   %8.2f ms/file   %d object(s)',
+      what, elapsed, elapsed * 1e3 / nb_files, scene_graph.nb_children
+   ))
+   return elapsed
+end
+
+local sequential_time = timed('load_object', function()
+   for i=1,nb_files do
+      scene_graph.load_object(file_names[i])
+   end
+end)
+local sequential = signature()
+scene_graph.clear()
+
+local parallel_time = timed('load_objects', function()
+   scene_graph.load_objects(table.concat(file_names, ';'))
+end)
+local parallel = signature()
+scene_graph.clear()
+
+print(string.format('speed-up: %.2f', sequential_time / parallel_time))
+local _,nb_sequential = sequential:gsub(';','')
+print(
+   (parallel == sequential and nb_sequential + 1 == nb_files) and
+   'same objects: OK' or 'same objects: FAILED'
+)
+
+for i=1,nb_files do
+   os.remove(file_names[i])
+end
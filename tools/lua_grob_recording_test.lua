@@ -0,0 +1,88 @@
+-- lua_grob_recording_test.lua
+--
+-- Usage: graphite batch=true tools/lua_grob_recording_test.lua
+--
+--  Checks the recording of the GLUP calls of the draw() function of a
+-- LuaGrob (record_drawing=true), without an OpenGL context: the recording
+-- is made with record_shader_draw(), that runs draw() without calling the
+-- GLUP functions and returns a textual dump of the recording:
+--  - recording twice gives the same result,
+--  - changing a global variable or a field of a global table used by
+--    draw() changes the recording (the recording is keyed by the globals),
+--  - consecutive Begin()/End() blocks with the same primitive are merged
+--    into a single batch of vertices,
+--  - a draw() that cannot be recorded gives an invalid recording.
+
+package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+                './')..'?.lua;'..package.path
+local check, finish =
+   require('test_helpers').checker('lua grob recording')
+
+local function count(s, pattern)
+   local _,result = s:gsub(pattern, '')
+   return result
+end
+
+scene_graph.clear()
+local grob = scene_graph.create_object('OGF::LuaGrob', 'recording_test')
+grob.record_drawing = true
+grob.shader_source = [[
+n = 3
+params = { scale = 1.0 }
+
+function draw()
+   GLUP.SetPointSize(5)
+   GLUP.Begin(GLUP.POINTS)
+   for i=1,n do
+      GLUP.Color(1,0,0)
+      GLUP.Vertex(i*params.scale, 0, 0)
+   end
+   GLUP.End()
+   GLUP.Begin(GLUP.POINTS)
+   for i=1,n do
+      GLUP.Color(0,1,0)
+      GLUP.Vertex(0, i*params.scale, 0)
+   end
+   GLUP.End()
+end
+]]
+
+local first = grob.record_shader_draw()
+local second = grob.record_shader_draw()
+print(first)
+
+check(
+   first ~= '' and first:match('^invalid') == nil, 'draw() is recorded'
+)
+check(first == second, 'recording twice gives the same result')
+check(count(first, 'batch ') == 1, 'the two blocks are merged in one batch')
+check(count(first, '\n  vertex ') == 6, 'the batch has all the vertices')
+check(count(first, 'SetPointSize') == 1, 'state changes are recorded')
+
+grob.execute_shader_command('n = 5')
+local changed = grob.record_shader_draw()
+check(changed ~= first, 'changing a global changes the recording')
+check(count(changed, '\n  vertex ') == 10, 'the new recording has 10 vertices')
+
+grob.execute_shader_command('params.scale = 2.0')
+check(
+   grob.record_shader_draw() ~= changed,
+   'changing a field of a global table changes the recording'
+)
+
+grob.execute_shader_command([[
+function draw()
+   GLUP.Vertex(0,0,0)
+end
+]])
+check(
+   grob.record_shader_draw():match('^invalid') ~= nil,
+   'a vertex outside Begin()/End() gives an invalid recording'
+)
+
+grob.record_drawing = false
+check(grob.record_shader_draw() == '', 'nothing is recorded when disabled')
+
+scene_graph.clear()
+
+finish()
@@ -0,0 +1,105 @@
+-- parallel_for_test.lua
+--
+-- Usage: graphite batch=true tools/parallel_for_test.lua [nb_items=<n>]
+--
+--  Checks gom.parallel_for() (1000000 items by default):
+--  - with a C++ kernel declared thread-safe (OGF::NL::AxpyKernel, run by
+--    several threads), compared with the same kernel called in a loop,
+--  - with a Lua function (run by worker LUA states), that reads a
+--    captured table and writes to a buffer view,
+--  - with a Lua function that captures a table with a metatable (cannot
+--    be sent to the workers, runs sequentially, same result).
+-- Run it with different numbers of threads (sys:max_threads=<n>) to see
+-- how it scales. Times are wall-clock times.
+
+local N = tonumber(gom.get_environment_value('nb_items') or '') or 1000000
+
+package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+                './')..'?.lua;'..package.path
+local check, finish =
+   require('test_helpers').checker('parallel_for')
+
+local function timed(what, f)
+   local start = gom.wall_clock_time()
+   f()
+   local elapsed = gom.wall_clock_time() - start
+   print(string.format('%-32s %8.4f s', what, elapsed))
+end
+
+local X = NL.create_vector(N)
+local Y = NL.create_vector(N)
+local Z = NL.create_vector(N)
+local XB = X.buffer
+local YB = Y.buffer
+local ZB = Z.buffer
+for i=0,N-1 do
+   XB[i] = i
+   YB[i] = 1.0
+   ZB[i] = 1.0
+end
+
+-- C++ kernel, run in parallel.
+
+local K = gom.create('OGF::NL::AxpyKernel')
+K.a = 2.0
+K.x = X
+K.y = Y
+timed('AxpyKernel, parallel_for', function()
+   gom.parallel_for(0, N, K.apply)
+end)
+
+-- Same kernel, called in a loop.
+
+local K2 = gom.create('OGF::NL::AxpyKernel')
+K2.a = 2.0
+K2.x = X
+K2.y = Z
+timed('AxpyKernel, loop', function()
+   for i=0,N-1 do
+      K2.apply(i)
+   end
+end)
+
+local ok = true
+for i=0,N-1 do
+   if YB[i] ~= 1.0 + 2.0*i or ZB[i] ~= YB[i] then
+      print('mismatch at '..i)
+      ok = false
+      break
+   end
+end
+check(ok, 'thread-safe C++ kernel')
+
+-- Lua function, run by the workers.
+
+local coeffs = { scale = 3.0 }
+timed('Lua function, parallel_for', function()
+   gom.parallel_for(0, N, function(i)
+      YB[i] = XB[i] * coeffs.scale
+   end)
+end)
+ok = true
+for i=0,N-1 do
+   if YB[i] ~= 3.0*i then
+      print('mismatch at '..i)
+      ok = false
+      break
+   end
+end
+check(ok, 'Lua function')
+
+-- Table with a metatable: runs sequentially, with a warning.
+
+local with_metatable = setmetatable({}, {
+   __index = function(t, k) return 5.0 end
+})
+gom.parallel_for(0, 1000, function(i)
+   YB[i] = with_metatable.anything
+end)
+ok = true
+for i=0,999 do
+   ok = ok and (YB[i] == 5.0)
+end
+check(ok, 'table with a metatable (sequential fallback)')
+
+finish()
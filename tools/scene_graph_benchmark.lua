@@ -0,0 +1,101 @@
+-- scene_graph_benchmark.lua
+--
+-- Usage: graphite batch=true tools/scene_graph_benchmark.lua [nb_grobs=<n>]
+--
+--  Measures the cost of creating, finding, renaming, hiding and deleting
+-- a large number of objects in the SceneGraph (10000 by default). A
+-- listener counts the individual change notifications (grob_added(),
+-- grob_removed(), grob_name_changed(), grob_visibility_changed()). The
+-- time per object should not depend on the number of objects in the
+-- scene, unless a slot is connected to values_changed() (then each
+-- update rebuilds the ';'-separated list of names).
+
+local N = tonumber(gom.get_environment_value('nb_grobs') or '') or 10000
+
+local counts = { added=0, removed=0, renamed=0, visibility=0 }
+
+function on_grob_added(id, name)
+   counts.added = counts.added + 1
+end
+
+function on_grob_removed(id, name)
+   counts.removed = counts.removed + 1
+end
+
+function on_grob_name_changed(id, old_name, new_name)
+   counts.renamed = counts.renamed + 1
+end
+
+function on_grob_visibility_changed(id, visible)
+   counts.visibility = counts.visibility + 1
+end
+
+gom.connect(scene_graph.grob_added, on_grob_added)
+gom.connect(scene_graph.grob_removed, on_grob_removed)
+gom.connect(scene_graph.grob_name_changed, on_grob_name_changed)
+gom.connect(scene_graph.grob_visibility_changed, on_grob_visibility_changed)
+
+local function timed(what, f)
+   local start = os.clock()
+   f()
+   local elapsed = os.clock() - start
+   print(string.format(
+      '%-32s %8.4f s   %8.2f us/object   %d object(s)',
+      what, elapsed, elapsed * 1e6 / N, scene_graph.nb_children
+   ))
+end
+
+timed('create', function()
+   for i=1,N do
+      scene_graph.create_object('OGF::MeshGrob', 'part_'..i)
+   end
+end)
+
+timed('resolve', function()
+   for i=1,N do
+      assert(scene_graph.resolve('part_'..i) ~= nil)
+   end
+end)
+
+timed('rename', function()
+   for i=1,N do
+      scene_graph.resolve('part_'..i).rename('renamed_'..i)
+   end
+end)
+
+timed('hide', function()
+   for i=1,N do
+      scene_graph.resolve('renamed_'..i).visible = false
+   end
+end)
+
+timed('show (in transaction)', function()
+   scene_graph.begin_update()
+   for i=1,N do
+      scene_graph.resolve('renamed_'..i).visible = true
+   end
+   scene_graph.end_update()
+end)
+
+timed('read values', function()
+   for i=1,10 do
+      local values = scene_graph.values
+   end
+end)
+
+timed('clear', function() scene_graph.clear() end)
+
+scene_graph.begin_update()
+timed('create (in transaction)', function()
+   for i=1,N do
+      scene_graph.create_object('OGF::MeshGrob', 'part_'..i)
+   end
+end)
+scene_graph.end_update()
+
+print(string.format(
+   'notifications: %d added, %d removed, %d renamed, %d visibility',
+   counts.added, counts.removed, counts.renamed, counts.visibility
+))
+
+scene_graph.clear()
@@ -0,0 +1,40 @@
+-- test_helpers.lua
+--
+--  Shared by the test scripts in this directory (registered with ctest,
+-- see tools/CMakeLists.txt). A script loads it with:
+--
+--   package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+--                   './')..'?.lua;'..package.path
+--   local check, finish =
+--      require('test_helpers').checker('my test')
+--
+--  check(condition, what) prints one line per check, finish() prints
+-- 'my test: OK' (that ctest looks for) or raises an error with the
+-- number of failed checks.
+
+local M = {}
+
+function M.checker(name)
+   local nb_failed = 0
+
+   local function check(condition, what)
+      if condition then
+         print('OK     '..what)
+      else
+         print('FAILED '..what)
+         nb_failed = nb_failed + 1
+      end
+   end
+
+   local function finish()
+      if nb_failed == 0 then
+         print(name..': OK')
+      else
+         error(name..': '..nb_failed..' check(s) FAILED')
+      end
+   end
+
+   return check, finish
+end
+
+return M
@@ -0,0 +1,33 @@
+# test_helpers.py
+#
+#  Shared by the test scripts in this directory (registered with ctest,
+# see tools/CMakeLists.txt). A script loads it with:
+#
+#   import os, sys
+#   sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+#   import test_helpers
+#   check, finish = test_helpers.checker('my test')
+#
+#  check(condition, what) prints one line per check, finish() prints
+# 'my test: OK' (that ctest looks for) or raises an error with the
+# number of failed checks.
+
+def checker(name):
+    nb_failed = [0]
+
+    def check(condition, what):
+        if condition:
+            print('OK     ' + what)
+        else:
+            print('FAILED ' + what)
+            nb_failed[0] = nb_failed[0] + 1
+
+    def finish():
+        if nb_failed[0] == 0:
+            print(name + ': OK')
+        else:
+            raise RuntimeError(
+                '%s: %d check(s) FAILED' % (name, nb_failed[0])
+            )
+
+    return check, finish
@@ -0,0 +1,77 @@
+-- undo_benchmark.lua
+--
+-- Usage: graphite batch=true tools/undo_benchmark.lua [undo_precision=<n>]
+--
+--  Measures the latency and the memory used by undo/redo
+-- (scene_graph.undo_store) on a scripted sequence of commands. The scene
+-- has a large mesh, that is not modified by the commands, and a small
+-- one, that is. Saving a state should not depend on the size of the
+-- large mesh.
+
+local precision = tonumber(
+   gom.get_environment_value('undo_precision') or ''
+) or 8
+
+local store = scene_graph.undo_store
+store.max_states = 10
+
+local function timed(what, f)
+   local start = os.clock()
+   f()
+   local elapsed = os.clock() - start
+   print(string.format(
+      '%-30s %8.4f s   %8.2f Mb in memory   %d state(s)   %d spilled',
+      what, elapsed, store.memory_used, store.nb_states, store.nb_spilled
+   ))
+end
+
+local big = scene_graph.create_object('OGF::MeshGrob','big')
+big.query_interface('OGF::MeshGrobShapesCommands').create_sphere(
+   {center='0 0 0', radius=1.0, precision=precision}
+)
+print('big mesh: '..big.I.Editor.nb_facets..' facets')
+
+local small = scene_graph.create_object('OGF::MeshGrob','small')
+small.query_interface('OGF::MeshGrobShapesCommands').create_sphere(
+   {center='3 0 0', radius=1.0, precision=3}
+)
+
+timed('save (initial)', function() store.save_state() end)
+for i=1,5 do
+   timed('save (after smooth '..i..')', function()
+      small.query_interface('OGF::MeshGrobSurfaceCommands').smooth()
+      store.save_state()
+   end)
+end
+for i=1,5 do
+   timed('undo '..i, function() store.undo() end)
+end
+for i=1,5 do
+   timed('redo '..i, function() store.redo() end)
+end
+
+-- Add an attribute to the large mesh: only the attribute is stored, the
+-- vertices and facets are shared with the previous states.
+local used_before = store.memory_used
+timed('save (after id on big)', function()
+   big.query_interface('OGF::MeshGrobAttributesCommands').compute_vertices_id(
+      {attribute='id'}
+   )
+   store.save_state()
+end)
+local points_size = big.I.Editor.nb_vertices * 3 * 8 / (1024*1024)
+print(string.format(
+   'added %.2f Mb (points: %.2f Mb): %s',
+   store.memory_used - used_before, points_size,
+   (store.memory_used - used_before < 0.5 * points_size) and
+      'shared' or 'NOT SHARED'
+))
+
+-- Modify the large mesh, then force spilling to disk.
+timed('save (after split big)', function()
+   big.query_interface('OGF::MeshGrobSurfaceCommands').split_triangles()
+   store.save_state()
+end)
+store.memory_budget = 1
+timed('undo (spilled)', function() store.undo() end)
+timed('redo (spilled)', function() store.redo() end)
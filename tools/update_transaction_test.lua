@@ -0,0 +1,126 @@
+-- update_transaction_test.lua
+--
+-- Usage: graphite batch=true tools/update_transaction_test.lua
+--                     [nb_vertices=<n>]
+--
+--  Checks update transactions (SceneGraph::begin_update(), end_update()
+-- and update_transaction()) by counting the signals they emit:
+--  - each Grob modified in a transaction is updated (and emits
+--    value_changed()) exactly once, when the outermost transaction ends,
+--  - the SceneGraph emits value_changed() once per transaction,
+--  - nested transactions are flushed by the outermost one only,
+--  - a Grob deleted during a transaction is not updated,
+--  - update_transaction() ends the transaction also if its body fails.
+-- It also displays the time taken by the same edits with and without a
+-- transaction.
+
+local N = tonumber(gom.get_environment_value('nb_vertices') or '') or 10000
+
+package.path = (debug.getinfo(1,'S').source:match('^@(.*[/\\])') or
+                './')..'?.lua;'..package.path
+local check, finish =
+   require('test_helpers').checker('update transactions')
+
+local counts = {}
+
+local function reset_counts()
+   counts.grob = 0
+   counts.other_grob = 0
+   counts.scene_graph = 0
+end
+
+scene_graph.clear()
+local S = scene_graph.create_object('OGF::MeshGrob', 'transaction_mesh')
+local T = scene_graph.create_object('OGF::MeshGrob', 'transaction_other')
+local E = S.I.Editor
+
+function on_grob_changed(grob)
+   counts.grob = counts.grob + 1
+end
+
+function on_other_grob_changed(grob)
+   counts.other_grob = counts.other_grob + 1
+end
+
+function on_scene_graph_changed(grob)
+   counts.scene_graph = counts.scene_graph + 1
+end
+
+gom.connect(S.value_changed, on_grob_changed)
+gom.connect(T.value_changed, on_other_grob_changed)
+gom.connect(scene_graph.value_changed, on_scene_graph_changed)
+
+local function create_vertices()
+   for i=1,N do
+      E.create_vertex()
+   end
+end
+
+-- Without transaction: one update per vertex.
+reset_counts()
+local start = gom.wall_clock_time()
+create_vertices()
+local time_without = gom.wall_clock_time() - start
+check(counts.grob == N, 'without transaction: one update per edit')
+
+-- Transaction: one update in total.
+reset_counts()
+start = gom.wall_clock_time()
+scene_graph.begin_update()
+create_vertices()
+T.update()
+check(counts.grob == 0 and counts.scene_graph == 0, 'no signal in transaction')
+scene_graph.end_update()
+local time_with = gom.wall_clock_time() - start
+check(counts.grob == 1, 'transaction: grob updated once')
+check(counts.other_grob == 1, 'transaction: other grob updated once')
+check(counts.scene_graph == 1, 'transaction: one scene graph signal')
+
+-- Nested transactions.
+reset_counts()
+scene_graph.begin_update()
+E.create_vertex()
+scene_graph.begin_update()
+E.create_vertex()
+scene_graph.end_update()
+check(counts.grob == 0, 'nested: inner end_update() does not flush')
+E.create_vertex()
+scene_graph.end_update()
+check(counts.grob == 1, 'nested: grob updated once')
+check(counts.scene_graph == 1, 'nested: one scene graph signal')
+
+-- Grob deleted during a transaction.
+reset_counts()
+scene_graph.begin_update()
+T.update()
+E.create_vertex()
+scene_graph.current_object = 'transaction_other'
+scene_graph.delete_current_object()
+scene_graph.end_update()
+check(counts.other_grob == 0, 'deleted grob is not updated')
+check(counts.grob == 1, 'remaining grob updated once')
+
+-- Scoped helper.
+reset_counts()
+scene_graph.update_transaction(create_vertices)
+check(counts.grob == 1, 'update_transaction(): grob updated once')
+check(counts.scene_graph == 1, 'update_transaction(): one scene graph signal')
+
+reset_counts()
+scene_graph.update_transaction(function()
+   E.create_vertex()
+   error('failure in transaction (expected)')
+end)
+check(counts.grob == 1, 'update_transaction(): flushed after an error')
+reset_counts()
+E.create_vertex()
+check(counts.grob == 1, 'update_transaction(): ended after an error')
+
+print(string.format(
+   '%d vertices: %.4f s without transaction, %.4f s with transaction',
+   N, time_without, time_with
+))
+
+scene_graph.clear()
+
+finish()